@@ -41,6 +41,7 @@ PRIVATE_HEADERS += \
     qgstreamermessage_p.h \
     qgstutils_p.h \
     qgstvideobuffer_p.h \
+    qgstaudiobuffer_p.h \
     qvideosurfacegstsink_p.h \
     qgstreamervideorendererinterface_p.h \
     qgstreameraudioinputselector_p.h \
@@ -50,6 +51,7 @@ PRIVATE_HEADERS += \
     qgstcodecsinfo_p.h \
     qgstreamervideoprobecontrol_p.h \
     qgstreameraudioprobecontrol_p.h \
+    qgstreamerprobequeue_p.h \
     qgstreamervideowindow_p.h
 
 SOURCES += \
@@ -58,6 +60,7 @@ SOURCES += \
     qgstreamermessage.cpp \
     qgstutils.cpp \
     qgstvideobuffer.cpp \
+    qgstaudiobuffer.cpp \
     qvideosurfacegstsink.cpp \
     qgstreamervideorendererinterface.cpp \
     qgstreameraudioinputselector.cpp \
@@ -67,6 +70,7 @@ SOURCES += \
     gstvideoconnector.c \
     qgstreamervideoprobecontrol.cpp \
     qgstreameraudioprobecontrol.cpp \
+    qgstreamerprobequeue.cpp \
     qgstreamervideowindow.cpp
 
 qtHaveModule(widgets) {
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstaudiobuffer_p.h"
+
+QT_BEGIN_NAMESPACE
+
+QGstAudioBuffer::QGstAudioBuffer(GstBuffer *buffer, const QAudioFormat &format, qint64 startTime)
+    : m_buffer(buffer)
+    , m_format(format)
+    , m_startTime(startTime)
+{
+    gst_buffer_ref(m_buffer);
+}
+
+QGstAudioBuffer::~QGstAudioBuffer()
+{
+    gst_buffer_unref(m_buffer);
+}
+
+void QGstAudioBuffer::release()
+{
+    delete this;
+}
+
+QAudioFormat QGstAudioBuffer::format() const
+{
+    return m_format;
+}
+
+qint64 QGstAudioBuffer::startTime() const
+{
+    return m_startTime;
+}
+
+int QGstAudioBuffer::frameCount() const
+{
+    return m_format.framesForBytes(GST_BUFFER_SIZE(m_buffer));
+}
+
+void *QGstAudioBuffer::constData() const
+{
+    return GST_BUFFER_DATA(m_buffer);
+}
+
+void *QGstAudioBuffer::writableData()
+{
+    // Only write in place when nobody else, the pipeline included, can see
+    // the buffer; otherwise QAudioBuffer falls back to a copy in memory.
+    if (!gst_buffer_is_writable(m_buffer))
+        return 0;
+
+    return GST_BUFFER_DATA(m_buffer);
+}
+
+QAbstractAudioBuffer *QGstAudioBuffer::clone() const
+{
+    // A plain memory copy is as good as a GstBuffer copy here
+    return 0;
+}
+
+QT_END_NAMESPACE
@@ -41,9 +41,20 @@
 
 #include "qgstreameraudioprobecontrol_p.h"
 #include <private/qgstutils_p.h>
+#include <private/qgstaudiobuffer_p.h>
+
+// Analysis of audio usually breaks on a gap, and the buffers are small, so
+// room is left for several seconds of a busy event loop. Beyond that the
+// oldest buffers go, an event loop that never catches up must not make the
+// queue grow forever; droppedCount() tells. Blocking instead could deadlock
+// against a state change made from the thread that drains the queue.
+static const QGstreamerProbeQueueSettings defaultAudioQueueSettings(
+        QGstreamerProbeQueueSettings::DropOldest, 256);
 
 QGstreamerAudioProbeControl::QGstreamerAudioProbeControl(QObject *parent)
     : QMediaAudioProbeControl(parent)
+    , m_queue(QGstreamerProbeQueueSettings::fromEnvironment("QT_GSTREAMER_AUDIO_PROBE_QUEUE",
+                                                            defaultAudioQueueSettings))
 {
 
 }
@@ -64,23 +75,23 @@ void QGstreamerAudioProbeControl::bufferProbed(GstBuffer* buffer)
     if (!format.isValid())
         return;
 
-    QAudioBuffer audioBuffer = QAudioBuffer(QByteArray((const char*)buffer->data, buffer->size), format);
+    QAudioBuffer audioBuffer = QAudioBuffer(new QGstAudioBuffer(buffer, format));
 
-    {
-        QMutexLocker locker(&m_bufferMutex);
-        m_pendingBuffer = audioBuffer;
+    if (m_queue.enqueue(audioBuffer))
         QMetaObject::invokeMethod(this, "bufferProbed", Qt::QueuedConnection);
-    }
 }
 
 void QGstreamerAudioProbeControl::bufferProbed()
 {
-    QAudioBuffer audioBuffer;
-    {
-        QMutexLocker locker(&m_bufferMutex);
-        if (!m_pendingBuffer.isValid())
-            return;
-        audioBuffer = m_pendingBuffer;
-    }
-    emit audioBufferProbed(audioBuffer);
+    QVector<QAudioBuffer> buffers;
+    m_queue.takeAll(&buffers);
+
+    foreach (const QAudioBuffer &audioBuffer, buffers)
+        emit audioBufferProbed(audioBuffer);
+}
+
+// Buffers lost because the queue was full, see QT_GSTREAMER_AUDIO_PROBE_QUEUE
+quint64 QGstreamerAudioProbeControl::droppedCount() const
+{
+    return m_queue.droppedCount();
 }
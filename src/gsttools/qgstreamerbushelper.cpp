@@ -40,7 +40,6 @@
 ****************************************************************************/
 
 #include <QtCore/qmap.h>
-#include <QtCore/qtimer.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qlist.h>
 
@@ -59,13 +58,8 @@ public:
         m_helper(parent)
     {
 #ifdef QT_NO_GLIB
+        // Messages are forwarded by the sync handler, see syncGstBusFilter()
         Q_UNUSED(bus);
-
-        m_intervalTimer = new QTimer(this);
-        m_intervalTimer->setInterval(250);
-
-        connect(m_intervalTimer, SIGNAL(timeout()), SLOT(interval()));
-        m_intervalTimer->start();
 #else
         m_tag = gst_bus_add_watch_full(bus, 0, busCallback, this, NULL);
 #endif
@@ -75,32 +69,13 @@ public:
     ~QGstreamerBusHelperPrivate()
     {
         m_helper = 0;
-#ifdef QT_NO_GLIB
-        m_intervalTimer->stop();
-#else
+#ifndef QT_NO_GLIB
         g_source_remove(m_tag);
 #endif
     }
 
     GstBus* bus() const { return m_bus; }
 
-private slots:
-    void interval()
-    {
-        GstMessage* message;
-        while ((message = gst_bus_poll(m_bus, GST_MESSAGE_ANY, 0)) != 0) {
-            processMessage(message);
-            gst_message_unref(message);
-        }
-    }
-
-private:
-    void processMessage(GstMessage* message)
-    {
-        QGstreamerMessage msg(message);
-        doProcessMessage(msg);
-    }
-
     void queueMessage(GstMessage* message)
     {
         QGstreamerMessage msg(message);
@@ -108,6 +83,7 @@ private:
                                   Q_ARG(QGstreamerMessage, msg));
     }
 
+private:
     static gboolean busCallback(GstBus *bus, GstMessage *message, gpointer data)
     {
         Q_UNUSED(bus);
@@ -118,9 +94,6 @@ private:
     guint m_tag;
     GstBus* m_bus;
     QGstreamerBusHelper*  m_helper;
-#ifdef QT_NO_GLIB
-    QTimer*     m_intervalTimer;
-#endif
 
 private slots:
     void doProcessMessage(const QGstreamerMessage& msg)
@@ -149,7 +122,15 @@ static GstBusSyncReply syncGstBusFilter(GstBus* bus, GstMessage* message, QGstre
             return GST_BUS_DROP;
     }
 
+#ifdef QT_NO_GLIB
+    // Nothing dispatches the bus without a glib main loop, and GStreamer 0.10
+    // has no pollable bus fd. Post the message straight to the helper's
+    // thread instead of polling for it.
+    d->queueMessage(message);
+    return GST_BUS_DROP;
+#else
     return GST_BUS_PASS;
+#endif
 }
 
 
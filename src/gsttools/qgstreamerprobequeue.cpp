@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgstreamerprobequeue_p.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+
+QGstreamerProbeQueueSettings QGstreamerProbeQueueSettings::fromEnvironment(const char *variable,
+                                                                           const QGstreamerProbeQueueSettings &defaults)
+{
+    QGstreamerProbeQueueSettings settings = defaults;
+
+    const QList<QByteArray> fields = qgetenv(variable).trimmed().split(':');
+    if (fields.isEmpty() || fields.first().isEmpty())
+        return settings;
+
+    const QByteArray policy = fields.at(0).toLower();
+    if (policy == "drop-oldest") {
+        settings.policy = DropOldest;
+    } else if (policy == "drop-newest") {
+        settings.policy = DropNewest;
+    } else if (policy == "block") {
+        settings.policy = Block;
+    } else if (policy == "unbounded") {
+        settings.policy = Unbounded;
+    } else {
+        qWarning("%s: unknown probe queue policy \"%s\"", variable, policy.constData());
+        return defaults;
+    }
+
+    bool ok = false;
+    if (fields.size() > 1) {
+        const int capacity = fields.at(1).toInt(&ok);
+        if (ok && capacity > 0)
+            settings.capacity = capacity;
+    }
+
+    if (fields.size() > 2) {
+        const int timeout = fields.at(2).toInt(&ok);
+        if (ok && timeout >= 0)
+            settings.blockTimeout = timeout;
+    }
+
+    return settings;
+}
+
+QT_END_NAMESPACE
@@ -43,10 +43,16 @@
 #include <private/qvideosurfacegstsink_p.h>
 #include <private/qgstvideobuffer_p.h>
 
+// Every queued frame pins a buffer of the pipeline, keep only a couple.
+static const QGstreamerProbeQueueSettings defaultVideoQueueSettings(
+        QGstreamerProbeQueueSettings::DropOldest, 2, 40);
+
 QGstreamerVideoProbeControl::QGstreamerVideoProbeControl(QObject *parent)
     : QMediaVideoProbeControl(parent)
     , m_flushing(false)
     , m_frameProbed(false)
+    , m_queue(QGstreamerProbeQueueSettings::fromEnvironment("QT_GSTREAMER_VIDEO_PROBE_QUEUE",
+                                                            defaultVideoQueueSettings))
 {
 
 }
@@ -60,10 +66,7 @@ void QGstreamerVideoProbeControl::startFlushing()
 {
     m_flushing = true;
 
-    {
-        QMutexLocker locker(&m_frameMutex);
-        m_pendingFrame = QVideoFrame();
-    }
+    m_queue.clear();
 
     // only emit flush if at least one frame was probed
     if (m_frameProbed)
@@ -86,32 +89,34 @@ void QGstreamerVideoProbeControl::bufferProbed(GstBuffer* buffer)
 
     int bytesPerLine = 0;
     QVideoSurfaceFormat format = QVideoSurfaceGstSink::formatForCaps(caps, &bytesPerLine);
+    const QGstVideoBuffer::PlaneLayout planeLayout = QGstVideoBuffer::planeLayoutForCaps(caps);
     gst_caps_unref(caps);
     if (!format.isValid() || !bytesPerLine)
         return;
 
-    QVideoFrame frame = QVideoFrame(new QGstVideoBuffer(buffer, bytesPerLine),
-                                    format.frameSize(), format.pixelFormat());
+    QGstVideoBuffer *videoBuffer = new QGstVideoBuffer(buffer, bytesPerLine);
+    videoBuffer->setPlaneLayout(planeLayout);
+    QVideoFrame frame = QVideoFrame(videoBuffer, format.frameSize(), format.pixelFormat());
 
     QVideoSurfaceGstSink::setFrameTimeStamps(&frame, buffer);
 
     m_frameProbed = true;
 
-    {
-        QMutexLocker locker(&m_frameMutex);
-        m_pendingFrame = frame;
+    if (m_queue.enqueue(frame))
         QMetaObject::invokeMethod(this, "frameProbed", Qt::QueuedConnection);
-    }
 }
 
 void QGstreamerVideoProbeControl::frameProbed()
 {
-    QVideoFrame frame;
-    {
-        QMutexLocker locker(&m_frameMutex);
-        if (!m_pendingFrame.isValid())
-            return;
-        frame = m_pendingFrame;
-    }
-    emit videoFrameProbed(frame);
+    QVector<QVideoFrame> frames;
+    m_queue.takeAll(&frames);
+
+    foreach (const QVideoFrame &frame, frames)
+        emit videoFrameProbed(frame);
+}
+
+// Buffers lost because the queue was full, see QT_GSTREAMER_VIDEO_PROBE_QUEUE
+quint64 QGstreamerVideoProbeControl::droppedCount() const
+{
+    return m_queue.droppedCount();
 }
@@ -41,10 +41,12 @@
 
 #include "qgstvideobuffer_p.h"
 
+#include <gst/video/video.h>
+
 QT_BEGIN_NAMESPACE
 
 QGstVideoBuffer::QGstVideoBuffer(GstBuffer *buffer, int bytesPerLine)
-    : QAbstractVideoBuffer(NoHandle)
+    : QAbstractPlanarVideoBuffer(NoHandle)
     , m_buffer(buffer)
     , m_bytesPerLine(bytesPerLine)
     , m_mode(NotMapped)
@@ -55,7 +57,7 @@ QGstVideoBuffer::QGstVideoBuffer(GstBuffer *buffer, int bytesPerLine)
 QGstVideoBuffer::QGstVideoBuffer(GstBuffer *buffer, int bytesPerLine,
                 QGstVideoBuffer::HandleType handleType,
                 const QVariant &handle)
-    : QAbstractVideoBuffer(handleType)
+    : QAbstractPlanarVideoBuffer(handleType)
     , m_buffer(buffer)
     , m_bytesPerLine(bytesPerLine)
     , m_mode(NotMapped)
@@ -70,27 +72,79 @@ QGstVideoBuffer::~QGstVideoBuffer()
 }
 
 
+/*
+    Returns the plane layout of buffers with the given \a caps, or an empty
+    layout if they are not of a planar format QVideoFrame knows.
+*/
+QGstVideoBuffer::PlaneLayout QGstVideoBuffer::planeLayoutForCaps(GstCaps *caps)
+{
+    PlaneLayout layout;
+
+    GstVideoFormat format = GST_VIDEO_FORMAT_UNKNOWN;
+    int width = 0;
+    int height = 0;
+    if (!caps || !gst_video_format_parse_caps(caps, &format, &width, &height))
+        return layout;
+
+    // The components making up each plane, in memory order.
+    int components[3] = { 0, 1, 2 };
+    switch (format) {
+    case GST_VIDEO_FORMAT_I420:
+        layout.planeCount = 3;
+        break;
+    case GST_VIDEO_FORMAT_YV12:
+        layout.planeCount = 3;
+        components[1] = 2;
+        components[2] = 1;
+        break;
+    case GST_VIDEO_FORMAT_NV12:
+        layout.planeCount = 2;
+        break;
+    case GST_VIDEO_FORMAT_NV21:
+        layout.planeCount = 2;
+        components[1] = 2;
+        break;
+    default:
+        return layout;
+    }
+
+    for (int i = 0; i < layout.planeCount; ++i) {
+        layout.bytesPerLine[i] = gst_video_format_get_row_stride(format, components[i], width);
+        layout.offsets[i] = gst_video_format_get_component_offset(format, components[i], width, height);
+    }
+    layout.size = gst_video_format_get_size(format, width, height);
+
+    return layout;
+}
+
 QAbstractVideoBuffer::MapMode QGstVideoBuffer::mapMode() const
 {
     return m_mode;
 }
 
-uchar *QGstVideoBuffer::map(MapMode mode, int *numBytes, int *bytesPerLine)
+int QGstVideoBuffer::mapPlanes(MapMode mode, int *numBytes, int bytesPerLine[4], uchar *data[4])
 {
-    if (mode != NotMapped && m_mode == NotMapped) {
-        if (numBytes)
-            *numBytes = m_buffer->size;
+    if (mode == NotMapped || m_mode != NotMapped)
+        return 0;
 
-        if (bytesPerLine)
-            *bytesPerLine = m_bytesPerLine;
+    if (numBytes)
+        *numBytes = m_buffer->size;
 
-        m_mode = mode;
+    m_mode = mode;
 
-        return m_buffer->data;
-    } else {
-        return 0;
+    if (m_planeLayout.planeCount > 0 && int(m_buffer->size) >= m_planeLayout.size) {
+        for (int i = 0; i < m_planeLayout.planeCount; ++i) {
+            bytesPerLine[i] = m_planeLayout.bytesPerLine[i];
+            data[i] = m_buffer->data + m_planeLayout.offsets[i];
+        }
+        return m_planeLayout.planeCount;
     }
+
+    bytesPerLine[0] = m_bytesPerLine;
+    data[0] = m_buffer->data;
+    return 1;
 }
+
 void QGstVideoBuffer::unmap()
 {
     m_mode = NotMapped;
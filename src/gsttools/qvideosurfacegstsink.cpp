@@ -47,6 +47,7 @@
 #include <QThread>
 
 #include <private/qmediapluginloader_p.h>
+#include <private/qmultimediaenvironment_p.h>
 #include "qgstvideobuffer_p.h"
 
 #include "qvideosurfacegstsink_p.h"
@@ -58,6 +59,11 @@ QT_BEGIN_NAMESPACE
 Q_GLOBAL_STATIC_WITH_ARGS(QMediaPluginLoader, bufferPoolLoader,
         (QGstBufferPoolInterface_iid, QLatin1String("video/bufferpool"), Qt::CaseInsensitive))
 
+static bool useAsyncRender()
+{
+    return qt_multimedia_envFlag("QT_GSTREAMER_ASYNC_VIDEO_RENDER", false);
+}
+
 
 QVideoSurfaceGstDelegate::QVideoSurfaceGstDelegate(
     QAbstractVideoSurface *surface)
@@ -67,6 +73,16 @@ QVideoSurfaceGstDelegate::QVideoSurfaceGstDelegate(
     , m_lastPrerolledBuffer(0)
     , m_bytesPerLine(0)
     , m_startCanceled(false)
+    , m_asyncRender(useAsyncRender())
+    , m_renderQueued(false)
+    , m_sink(0)
+    , m_renderedFrames(0)
+    , m_droppedFrames(0)
+    , m_lateFrames(0)
+    , m_reportedLateFrames(0)
+    , m_lastLateStartTime(-1)
+    , m_lastLateEndTime(-1)
+    , m_lastLateness(0)
 {
     if (m_surface) {
         foreach (QObject *instance, bufferPoolLoader()->instances(QGstBufferPoolPluginKey)) {
@@ -87,7 +103,7 @@ QVideoSurfaceGstDelegate::~QVideoSurfaceGstDelegate()
 
 QList<QVideoFrame::PixelFormat> QVideoSurfaceGstDelegate::supportedPixelFormats(QAbstractVideoBuffer::HandleType handleType) const
 {
-    QMutexLocker locker(const_cast<QMutex *>(&m_mutex));
+    QMutexLocker locker(&m_mutex);
 
     if (!m_surface)
         return QList<QVideoFrame::PixelFormat>();
@@ -101,11 +117,12 @@ QList<QVideoFrame::PixelFormat> QVideoSurfaceGstDelegate::supportedPixelFormats(
 
 QVideoSurfaceFormat QVideoSurfaceGstDelegate::surfaceFormat() const
 {
-    QMutexLocker locker(const_cast<QMutex *>(&m_mutex));
+    QMutexLocker locker(&m_mutex);
     return m_format;
 }
 
-bool QVideoSurfaceGstDelegate::start(const QVideoSurfaceFormat &format, int bytesPerLine)
+bool QVideoSurfaceGstDelegate::start(const QVideoSurfaceFormat &format, int bytesPerLine,
+                                     const QGstVideoBuffer::PlaneLayout &planeLayout)
 {
     if (!m_surface)
         return false;
@@ -114,6 +131,8 @@ bool QVideoSurfaceGstDelegate::start(const QVideoSurfaceFormat &format, int byte
 
     m_format = format;
     m_bytesPerLine = bytesPerLine;
+    m_planeLayout = planeLayout;
+    m_pendingFrame = QVideoFrame();
 
     if (QThread::currentThread() == thread()) {
         m_started = !m_surface.isNull() ? m_surface->start(m_format) : false;
@@ -151,6 +170,8 @@ void QVideoSurfaceGstDelegate::stop()
 
     QMutexLocker locker(&m_mutex);
 
+    m_pendingFrame = QVideoFrame();
+
     if (QThread::currentThread() == thread()) {
         if (!m_surface.isNull())
             m_surface->stop();
@@ -188,13 +209,19 @@ GstFlowReturn QVideoSurfaceGstDelegate::render(GstBuffer *buffer)
 
     QMutexLocker locker(&m_mutex);
 
+    QosReport qos[2];
+    int qosCount = 0;
+
     QAbstractVideoBuffer *videoBuffer = 0;
 
     if (m_pool)
         videoBuffer = m_pool->prepareVideoBuffer(buffer, m_bytesPerLine);
 
-    if (!videoBuffer)
-        videoBuffer = new QGstVideoBuffer(buffer, m_bytesPerLine);
+    if (!videoBuffer) {
+        QGstVideoBuffer *gstBuffer = new QGstVideoBuffer(buffer, m_bytesPerLine);
+        gstBuffer->setPlaneLayout(m_planeLayout);
+        videoBuffer = gstBuffer;
+    }
 
     m_frame = QVideoFrame(
             videoBuffer,
@@ -208,13 +235,38 @@ GstFlowReturn QVideoSurfaceGstDelegate::render(GstBuffer *buffer)
     if (QThread::currentThread() == thread()) {
         if (!m_surface.isNull())
             m_surface->present(m_frame);
+    } else if (m_asyncRender) {
+        if (m_pendingFrame.isValid()) {
+            // The GUI thread did not get to the previous frame in time
+            ++m_droppedFrames;
+            qos[qosCount++] = qosReport(m_pendingFrame.startTime(), m_pendingFrame.endTime(), 0, false);
+        }
+        if (m_lateFrames != m_reportedLateFrames) {
+            m_reportedLateFrames = m_lateFrames;
+            qos[qosCount++] = qosReport(m_lastLateStartTime, m_lastLateEndTime, m_lastLateness, true);
+        }
+
+        m_pendingFrame = m_frame;
+        m_pendingSince.start();
+        if (!m_renderQueued) {
+            m_renderQueued = true;
+            QMetaObject::invokeMethod(this, "queuedRender", Qt::QueuedConnection);
+        }
     } else {
         QMetaObject::invokeMethod(this, "queuedRender", Qt::QueuedConnection);
         m_renderCondition.wait(&m_mutex, 300);
     }
 
     m_frame = QVideoFrame();
-    return m_renderReturn;
+    const GstFlowReturn result = m_renderReturn;
+    locker.unlock();
+
+    // Posting a message or pushing an event upstream runs into other
+    // elements and the bus, which must not happen with our lock held.
+    for (int i = 0; i < qosCount; ++i)
+        postQos(qos[i]);
+
+    return result;
 }
 
 void QVideoSurfaceGstDelegate::setLastPrerolledBuffer(GstBuffer *prerolledBuffer)
@@ -254,31 +306,126 @@ void QVideoSurfaceGstDelegate::queuedStop()
 
 void QVideoSurfaceGstDelegate::queuedRender()
 {
+    if (m_asyncRender) {
+        QVideoFrame frame;
+        {
+            QMutexLocker locker(&m_mutex);
+            m_renderQueued = false;
+            frame = m_pendingFrame;
+            m_pendingFrame = QVideoFrame();
+
+            if (frame.isValid()) {
+                // Late if the frame waited for longer than it is shown
+                const qint64 waited = m_pendingSince.nsecsElapsed() / 1000;
+                const qint64 duration = frame.endTime() - frame.startTime();
+                if (frame.startTime() >= 0 && duration > 0 && waited > duration) {
+                    ++m_lateFrames;
+                    m_lastLateStartTime = frame.startTime();
+                    m_lastLateEndTime = frame.endTime();
+                    m_lastLateness = waited - duration;
+                }
+            }
+        }
+
+        // Present without holding the lock, the streaming thread must never
+        // wait for the GUI.
+        if (frame.isValid()) {
+            presentFrame(frame);
+            QMutexLocker locker(&m_mutex);
+            ++m_renderedFrames;
+        }
+        return;
+    }
+
     QMutexLocker locker(&m_mutex);
 
+    m_renderReturn = presentFrame(m_frame);
+
+    m_renderCondition.wakeAll();
+}
+
+GstFlowReturn QVideoSurfaceGstDelegate::presentFrame(const QVideoFrame &frame)
+{
     if (m_surface.isNull()) {
         qWarning() << "Rendering video frame to deleted surface, skip the frame";
-        m_renderReturn = GST_FLOW_OK;
-    } else if (m_surface->present(m_frame)) {
-        m_renderReturn = GST_FLOW_OK;
-    } else {
+    } else if (!m_surface->present(frame)) {
         switch (m_surface->error()) {
         case QAbstractVideoSurface::NoError:
-            m_renderReturn = GST_FLOW_OK;
             break;
         case QAbstractVideoSurface::StoppedError:
             //It's likely we are in process of changing video output
             //and the surface is already stopped, ignore the frame
-            m_renderReturn = GST_FLOW_OK;
             break;
         default:
             qWarning() << "Failed to render video frame:" << m_surface->error();
-            m_renderReturn = GST_FLOW_OK;
             break;
         }
     }
 
-    m_renderCondition.wakeAll();
+    return GST_FLOW_OK;
+}
+
+// Must be called with m_mutex locked
+QVideoSurfaceGstDelegate::QosReport QVideoSurfaceGstDelegate::qosReport(qint64 startTime, qint64 endTime,
+                                                                      qint64 jitter, bool late) const
+{
+    QosReport report;
+    report.startTime = startTime;
+    report.endTime = endTime;
+    report.jitter = jitter;
+    report.late = late;
+    report.renderedFrames = m_renderedFrames;
+    report.droppedFrames = m_droppedFrames;
+    return report;
+}
+
+// Must be called without m_mutex locked
+void QVideoSurfaceGstDelegate::postQos(const QosReport &report)
+{
+    if (!m_sink)
+        return;
+
+    const qint64 startTime = report.startTime;
+    const qint64 endTime = report.endTime;
+    const qint64 jitter = report.jitter;
+
+    // Qt uses microseconds, GStreamer nanoseconds
+    const GstClockTime timestamp = startTime >= 0 ? GstClockTime(startTime) * 1000 : GST_CLOCK_TIME_NONE;
+    const GstClockTime duration = startTime >= 0 && endTime > startTime
+            ? GstClockTime(endTime - startTime) * 1000 : GST_CLOCK_TIME_NONE;
+
+#if GST_CHECK_VERSION(0,10,29)
+    GstMessage *message = gst_message_new_qos(GST_OBJECT(m_sink), FALSE,
+                                              GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE,
+                                              timestamp, duration);
+    gst_message_set_qos_values(message, jitter * 1000, 1.0, 1000000);
+    gst_message_set_qos_stats(message, GST_FORMAT_BUFFERS, report.renderedFrames, report.droppedFrames);
+    gst_element_post_message(m_sink, message);
+#else
+    Q_UNUSED(duration);
+#endif
+
+    // Let upstream skip ahead when presentation falls behind
+    if (report.late && timestamp != GST_CLOCK_TIME_NONE)
+        gst_pad_push_event(GST_BASE_SINK_PAD(m_sink), gst_event_new_qos(1.0, jitter * 1000, timestamp));
+}
+
+quint64 QVideoSurfaceGstDelegate::renderedFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_renderedFrames;
+}
+
+quint64 QVideoSurfaceGstDelegate::droppedFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_droppedFrames;
+}
+
+quint64 QVideoSurfaceGstDelegate::lateFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lateFrames;
 }
 
 void QVideoSurfaceGstDelegate::updateSupportedFormats()
@@ -404,6 +551,7 @@ QVideoSurfaceGstSink *QVideoSurfaceGstSink::createSink(QAbstractVideoSurface *su
             g_object_new(QVideoSurfaceGstSink::get_type(), 0));
 
     sink->delegate = new QVideoSurfaceGstDelegate(surface);
+    sink->delegate->setSink(GST_ELEMENT(sink));
 
     g_signal_connect(G_OBJECT(sink), "notify::show-preroll-frame", G_CALLBACK(handleShowPrerollChange), sink);
 
@@ -627,7 +775,7 @@ gboolean QVideoSurfaceGstSink::set_caps(GstBaseSink *base, GstCaps *caps)
         qDebug() << "bytesPerLine:" << bytesPerLine;
 #endif
 
-        if (sink->delegate->start(format, bytesPerLine))
+        if (sink->delegate->start(format, bytesPerLine, QGstVideoBuffer::planeLayoutForCaps(caps)))
             return TRUE;
         else
             qWarning() << "Failed to start video surface";
@@ -802,7 +950,8 @@ GstFlowReturn QVideoSurfaceGstSink::buffer_alloc(
 
         QVideoSurfaceFormat format = formatForCaps(intersection, &bytesPerLine, handleType);
 
-        if (!sink->delegate->start(format, bytesPerLine)) {
+        if (!sink->delegate->start(format, bytesPerLine,
+                                   QGstVideoBuffer::planeLayoutForCaps(intersection))) {
             qWarning() << "failed to start video surface";
             return GST_FLOW_NOT_NEGOTIATED;
         }
@@ -100,6 +100,11 @@ public:
         // for that version.
         qmlRegisterType<QSoundEffect>(uri, 5, 3, "SoundEffect");
 
+        // 5.4 types
+        qmlRegisterType<QDeclarativeVideoOutput, 3>(uri, 5, 4, "VideoOutput");
+        qmlRegisterUncreatableType<QDeclarativeVideoOutputStatistics>(uri, 5, 4, "VideoOutputStatistics",
+                                trUtf8("VideoOutputStatistics is provided by VideoOutput"));
+
         qmlRegisterType<QDeclarativeMediaMetaData>();
     }
 
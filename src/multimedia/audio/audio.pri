@@ -19,7 +19,8 @@ PRIVATE_HEADERS += \
            audio/qaudiodevicefactory_p.h \
            audio/qwavedecoder_p.h \
            audio/qsamplecache_p.h \
-           audio/qaudiohelpers_p.h
+           audio/qaudiohelpers_p.h \
+           audio/qaudioclock_p.h
 
 SOURCES += \
            audio/qaudio.cpp \
@@ -37,7 +38,12 @@ SOURCES += \
            audio/qaudiobuffer.cpp \
            audio/qaudioprobe.cpp \
            audio/qaudiodecoder.cpp \
-           audio/qaudiohelpers.cpp
+           audio/qaudiohelpers.cpp \
+           audio/qaudioclock_p.cpp
+
+SSE2_SOURCES += audio/qaudiohelpers_sse2.cpp
+AVX2_SOURCES += audio/qaudiohelpers_avx2.cpp
+NEON_SOURCES += audio/qaudiohelpers_neon.cpp
 
 unix:!mac {
     config_pulseaudio {
@@ -51,10 +57,14 @@ unix:!mac {
     } else {
         DEFINES += QT_MULTIMEDIA_QAUDIO
         PRIVATE_HEADERS += audio/qsoundeffect_qaudio_p.h
+        PRIVATE_HEADERS += audio/qsoundeffectmixer_p.h
         SOURCES += audio/qsoundeffect_qaudio_p.cpp
+        SOURCES += audio/qsoundeffectmixer_p.cpp
     }
 } else {
     DEFINES += QT_MULTIMEDIA_QAUDIO
     PRIVATE_HEADERS += audio/qsoundeffect_qaudio_p.h
+    PRIVATE_HEADERS += audio/qsoundeffectmixer_p.h
     SOURCES += audio/qsoundeffect_qaudio_p.cpp
+    SOURCES += audio/qsoundeffectmixer_p.cpp
 }
@@ -91,6 +91,81 @@ Q_CONSTRUCTOR_FUNCTION(qRegisterAudioMetaTypes)
     \value AudioInput    audio input device
 */
 
+/*!
+    \typedef QAudio::RenderCallback
+    \since 5.4
+
+    A function that produces audio for QAudioOutput::start(QAudio::RenderCallback, void *).
+    It is called as \c{callback(data, frameCount, userData)} and must fill
+    \a data with exactly \a frameCount frames in the output's format.
+
+    The function is called on the audio thread of the backend. It must not
+    block, and it must not call into the QAudioOutput it was passed to.
+*/
+
+/*!
+    \typedef QAudio::CaptureCallback
+    \since 5.4
+
+    A function that consumes audio for QAudioInput::start(QAudio::CaptureCallback, void *).
+    It is called as \c{callback(data, frameCount, userData)} with \a frameCount
+    frames of captured audio in the input's format. The data is only valid
+    for the duration of the call.
+
+    The function is called on the audio thread of the backend. It must not
+    block, and it must not call into the QAudioInput it was passed to.
+*/
+
+/*!
+    \class QAudio::Timestamp
+    \inmodule QtMultimedia
+    \ingroup multimedia_audio
+    \since 5.4
+
+    \brief The QAudio::Timestamp class relates a position in an audio stream
+    to the system clock.
+
+    A timestamp is taken from the audio hardware where the backend supports
+    it, see QAudioOutput::timestamp() and QAudioInput::timestamp(). Unlike
+    processedUSecs() it follows the clock of the device rather than the
+    amount of data that has been handed over.
+
+    \sa QAudioOutput::clockDrift(), QAudioInput::clockDrift()
+*/
+
+/*!
+    \fn QAudio::Timestamp::Timestamp()
+
+    Constructs an invalid timestamp.
+*/
+
+/*!
+    \fn bool QAudio::Timestamp::isValid() const
+
+    Returns true if the timestamp was taken from a running stream.
+*/
+
+/*!
+    \variable QAudio::Timestamp::framePosition
+
+    The number of frames the device had played or captured at
+    \l systemTime, counted from the start of the stream.
+*/
+
+/*!
+    \variable QAudio::Timestamp::systemTime
+
+    The time at which \l framePosition was reached, in microseconds on the
+    monotonic clock that QElapsedTimer uses.
+*/
+
+/*!
+    \variable QAudio::Timestamp::latency
+
+    The time in microseconds it takes a frame written now to be played, or
+    the age of the next frame that will be read, at \l systemTime.
+*/
+
 #ifndef QT_NO_DEBUG_STREAM
 QDebug operator<<(QDebug dbg, QAudio::Error error)
 {
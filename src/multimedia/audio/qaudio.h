@@ -59,8 +59,24 @@ namespace QAudio
     enum Error { NoError, OpenError, IOError, UnderrunError, FatalError };
     enum State { ActiveState, SuspendedState, StoppedState, IdleState };
     enum Mode { AudioInput, AudioOutput };
+
+    typedef void (*RenderCallback)(char *data, int frameCount, void *userData);
+    typedef void (*CaptureCallback)(const char *data, int frameCount, void *userData);
+
+    struct Timestamp
+    {
+        Timestamp() : framePosition(-1), systemTime(-1), latency(0) { }
+
+        bool isValid() const { return framePosition >= 0; }
+
+        qint64 framePosition;
+        qint64 systemTime;
+        qint64 latency;
+    };
 }
 
+Q_DECLARE_TYPEINFO(QAudio::Timestamp, Q_MOVABLE_TYPE);
+
 #ifndef QT_NO_DEBUG_STREAM
 Q_MULTIMEDIA_EXPORT QDebug operator<<(QDebug dbg, QAudio::Error error);
 Q_MULTIMEDIA_EXPORT QDebug operator<<(QDebug dbg, QAudio::State state);
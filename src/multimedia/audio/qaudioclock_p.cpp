@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudioclock_p.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmath.h>
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+#include <time.h>
+#define QAUDIOCLOCK_USE_CLOCK_GETTIME
+#endif
+
+QT_BEGIN_NAMESPACE
+
+// Samples closer together than this add little but noise to the fit
+static const qint64 MinSampleInterval = 100000;
+// With MinSampleInterval this keeps the last 6.4 seconds
+static const int MaxSamples = 64;
+// Below this span the scheduling jitter of the timestamps dominates
+static const qint64 MinSpan = 1000000;
+static const int MinSamples = 8;
+// Positions further off than this from what the nominal rate predicts
+// mean the stream was paused, underran or was restarted
+static const int DiscontinuityMs = 20;
+
+namespace QAudioClockInternal
+{
+
+#ifdef QAUDIOCLOCK_USE_CLOCK_GETTIME
+static qint64 toUSecs(const timespec &ts)
+{
+    return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
+
+qint64 monotonicTime()
+{
+#ifdef QAUDIOCLOCK_USE_CLOCK_GETTIME
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return toUSecs(ts);
+#else
+    QElapsedTimer timer;
+    timer.start();
+    return timer.msecsSinceReference() * 1000;
+#endif
+}
+
+qint64 monotonicFromRealtime(qint64 realtimeUSecs)
+{
+#ifdef QAUDIOCLOCK_USE_CLOCK_GETTIME
+    timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    return realtimeUSecs - toUSecs(realtime) + monotonicTime();
+#else
+    return realtimeUSecs - QDateTime::currentMSecsSinceEpoch() * 1000 + monotonicTime();
+#endif
+}
+
+}
+
+QAudioClockDriftEstimator::QAudioClockDriftEstimator()
+    : m_sampleRate(0)
+    , m_haveLast(false)
+{
+    m_points.reserve(MaxSamples);
+}
+
+void QAudioClockDriftEstimator::reset(int sampleRate)
+{
+    m_sampleRate = sampleRate;
+    m_points.clear();
+    m_haveLast = false;
+}
+
+void QAudioClockDriftEstimator::addSample(const QAudio::Timestamp &timestamp)
+{
+    if (!timestamp.isValid() || m_sampleRate <= 0)
+        return;
+
+    const Point point = { timestamp.framePosition, timestamp.systemTime };
+
+    if (m_haveLast) {
+        const qint64 elapsed = point.systemTime - m_last.systemTime;
+        const qint64 frames = point.framePosition - m_last.framePosition;
+
+        // Backends may report the same timing information more than once
+        if (elapsed == 0 && frames == 0)
+            return;
+
+        const qint64 expected = elapsed * m_sampleRate / 1000000;
+        const qint64 tolerance = qint64(m_sampleRate) * DiscontinuityMs / 1000;
+        if (elapsed < 0 || frames < 0 || qAbs(frames - expected) > tolerance)
+            m_points.clear();
+    }
+
+    m_last = point;
+    m_haveLast = true;
+
+    if (!m_points.isEmpty() && point.systemTime - m_points.last().systemTime < MinSampleInterval)
+        return;
+
+    if (m_points.size() == MaxSamples)
+        m_points.remove(0);
+    m_points.append(point);
+}
+
+// Returns how many frames the device runs through per nominal frame of
+// system time: above 1.0 the device clock is fast, below 1.0 it is slow.
+// Returns 1.0 until enough of the stream has been seen to tell.
+qreal QAudioClockDriftEstimator::drift() const
+{
+    const int count = m_points.size();
+    if (count < MinSamples || m_points.last().systemTime - m_points.first().systemTime < MinSpan)
+        return 1.0;
+
+    // Least squares fit of position over time. Work relative to the first
+    // point so that the squares stay well inside the precision of a double.
+    const Point &origin = m_points.first();
+    qreal meanTime = 0;
+    qreal meanFrames = 0;
+    for (int i = 0; i < count; ++i) {
+        meanTime += m_points.at(i).systemTime - origin.systemTime;
+        meanFrames += m_points.at(i).framePosition - origin.framePosition;
+    }
+    meanTime /= count;
+    meanFrames /= count;
+
+    qreal covariance = 0;
+    qreal variance = 0;
+    for (int i = 0; i < count; ++i) {
+        const qreal time = m_points.at(i).systemTime - origin.systemTime - meanTime;
+        const qreal frames = m_points.at(i).framePosition - origin.framePosition - meanFrames;
+        covariance += time * frames;
+        variance += time * time;
+    }
+    if (qFuzzyIsNull(variance))
+        return 1.0;
+
+    const qreal framesPerUSec = covariance / variance;
+    return framesPerUSec * 1000000 / m_sampleRate;
+}
+
+QT_END_NAMESPACE
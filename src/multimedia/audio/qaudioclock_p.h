@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QAUDIOCLOCK_P_H
+#define QAUDIOCLOCK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qaudio.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QAudioClockInternal
+{
+// Microseconds on the monotonic clock QElapsedTimer uses
+Q_MULTIMEDIA_EXPORT qint64 monotonicTime();
+
+// Maps a wall clock time in microseconds, as reported by gettimeofday(),
+// onto monotonicTime(). Only meant for times close to now.
+Q_MULTIMEDIA_EXPORT qint64 monotonicFromRealtime(qint64 realtimeUSecs);
+}
+
+// Measures how fast an audio device really runs compared to the system
+// clock, from the timestamps a backend takes while a stream is running.
+// Not thread safe; backends guard it with the lock that protects their
+// timestamp.
+class Q_MULTIMEDIA_EXPORT QAudioClockDriftEstimator
+{
+public:
+    QAudioClockDriftEstimator();
+
+    void reset(int sampleRate);
+    void addSample(const QAudio::Timestamp &timestamp);
+
+    qreal drift() const;
+    int sampleCount() const { return m_points.size(); }
+
+private:
+    struct Point
+    {
+        qint64 framePosition;
+        qint64 systemTime;
+    };
+
+    int m_sampleRate;
+    QVector<Point> m_points;
+    Point m_last;
+    bool m_haveLast;
+};
+
+QT_END_NAMESPACE
+
+#endif // QAUDIOCLOCK_P_H
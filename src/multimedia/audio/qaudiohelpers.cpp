@@ -42,6 +42,7 @@
 #include "qaudiohelpers_p.h"
 
 #include <QDebug>
+#include <private/qsimd_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -53,7 +54,7 @@ template<class T> void adjustSamples(qreal factor, const void *src, void *dst, i
     const T *pSrc = (const T *)src;
     T *pDst = (T*)dst;
     for ( int i = 0; i < samples; i++ )
-        pDst[i] = pSrc[i] * factor;
+        pDst[i] = saturateSample<T>(pSrc[i] * factor);
 }
 
 // Unsigned samples are biased around 0x80/0x8000 :/
@@ -82,11 +83,11 @@ template<class T> void adjustUnsignedSamples(qreal factor, const void *src, void
     const T *pSrc = (const T *)src;
     T *pDst = (T*)dst;
     for ( int i = 0; i < samples; i++ ) {
-        pDst[i] = signedVersion<T>::offset + ((typename signedVersion<T>::TS)(pSrc[i] - signedVersion<T>::offset) * factor);
+        pDst[i] = signedVersion<T>::offset + saturateSample<typename signedVersion<T>::TS>((typename signedVersion<T>::TS)(pSrc[i] - signedVersion<T>::offset) * factor);
     }
 }
 
-void qMultiplySamples(qreal factor, const QAudioFormat &format, const void* src, void* dest, int len)
+void qMultiplySamplesGeneric(qreal factor, const QAudioFormat &format, const void* src, void* dest, int len)
 {
     int samplesCount = len / (format.sampleSize()/8);
 
@@ -112,6 +113,124 @@ void qMultiplySamples(qreal factor, const QAudioFormat &format, const void* src,
             QAudioHelperInternal::adjustSamples<float>(factor,src,dest,samplesCount);
     }
 }
+
+#if defined(QT_COMPILER_SUPPORTS_SSE2)
+void qt_multiplySamples_s8_sse2(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_s16_sse2(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_s32_sse2(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_float_sse2(qreal factor, const void *src, void *dest, int samples, bool biased);
+#endif
+
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+void qt_multiplySamples_s8_avx2(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_s16_avx2(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_s32_avx2(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_float_avx2(qreal factor, const void *src, void *dest, int samples, bool biased);
+#endif
+
+#if defined(QT_COMPILER_SUPPORTS_NEON)
+void qt_multiplySamples_s8_neon(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_s16_neon(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_s32_neon(qreal factor, const void *src, void *dest, int samples, bool biased);
+void qt_multiplySamples_float_neon(qreal factor, const void *src, void *dest, int samples, bool biased);
+#endif
+
+static MultiplySamplesFunc selectKernel(int sampleSize, QAudioFormat::SampleType sampleType)
+{
+    if (sampleType == QAudioFormat::Unknown)
+        return 0;
+    if (sampleType == QAudioFormat::Float && sampleSize != 32)
+        return 0;
+
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+    if (qCpuHasFeature(AVX2)) {
+        switch (sampleSize) {
+        case 8: return qt_multiplySamples_s8_avx2;
+        case 16: return qt_multiplySamples_s16_avx2;
+        case 32: return sampleType == QAudioFormat::Float ? qt_multiplySamples_float_avx2
+                                                          : qt_multiplySamples_s32_avx2;
+        }
+        return 0;
+    }
+#endif
+#if defined(QT_COMPILER_SUPPORTS_SSE2)
+    if (qCpuHasFeature(SSE2)) {
+        switch (sampleSize) {
+        case 8: return qt_multiplySamples_s8_sse2;
+        case 16: return qt_multiplySamples_s16_sse2;
+        case 32: return sampleType == QAudioFormat::Float ? qt_multiplySamples_float_sse2
+                                                          : qt_multiplySamples_s32_sse2;
+        }
+        return 0;
+    }
+#endif
+#if defined(QT_COMPILER_SUPPORTS_NEON)
+    if (qCpuHasFeature(NEON)) {
+        switch (sampleSize) {
+        case 8: return qt_multiplySamples_s8_neon;
+        case 16: return qt_multiplySamples_s16_neon;
+        case 32: return sampleType == QAudioFormat::Float ? qt_multiplySamples_float_neon
+                                                          : qt_multiplySamples_s32_neon;
+        }
+        return 0;
+    }
+#endif
+    Q_UNUSED(sampleSize);
+    return 0;
+}
+
+static void fillSilence(const QAudioFormat &format, void *dest, int len)
+{
+    if (format.sampleType() != QAudioFormat::UnSignedInt) {
+        memset(dest, 0, len);
+        return;
+    }
+
+    switch (format.sampleSize()) {
+    case 8:
+        memset(dest, 0x80, len);
+        break;
+    case 16: {
+        quint16 *pDst = (quint16 *)dest;
+        for (int i = 0; i < len / 2; ++i)
+            pDst[i] = 0x8000;
+        break;
+    }
+    default: {
+        quint32 *pDst = (quint32 *)dest;
+        for (int i = 0; i < len / 4; ++i)
+            pDst[i] = 0x80000000;
+        break;
+    }
+    }
+}
+
+void qMultiplySamples(qreal factor, const QAudioFormat &format, const void* src, void* dest, int len)
+{
+    if (len <= 0 || format.sampleSize() < 8)
+        return;
+
+    // Full volume in place is by far the most common case; don't touch the data at all.
+    if (factor == 1.0) {
+        if (src != dest)
+            memmove(dest, src, len);
+        return;
+    }
+
+    if (factor == 0.0 && format.sampleType() != QAudioFormat::Unknown) {
+        fillSilence(format, dest, len);
+        return;
+    }
+
+    MultiplySamplesFunc kernel = selectKernel(format.sampleSize(), format.sampleType());
+    if (!kernel) {
+        qMultiplySamplesGeneric(factor, format, src, dest, len);
+        return;
+    }
+
+    kernel(factor, src, dest, len / (format.sampleSize()/8),
+           format.sampleType() == QAudioFormat::UnSignedInt);
+}
 }
 
 QT_END_NAMESPACE
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudiohelpers_p.h"
+
+#include <private/qsimd_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+
+QT_BEGIN_NAMESPACE
+
+namespace QAudioHelperInternal
+{
+
+static inline __m256i multiplyInt32x8(__m256i v, __m256 factor, __m256 min, __m256 max)
+{
+    __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(v), factor);
+    f = _mm256_min_ps(_mm256_max_ps(f, min), max);
+    return _mm256_cvttps_epi32(f);
+}
+
+static inline __m128i packs32x8(__m256i v)
+{
+    return _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+void qt_multiplySamples_s8_avx2(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint8 *pSrc = (const qint8 *)src;
+    qint8 *pDst = (qint8 *)dest;
+    const qint8 bias = biased ? qint8(0x80) : 0;
+
+    const __m256 vfactor = _mm256_set1_ps(float(factor));
+    const __m256 vmin = _mm256_set1_ps(-128.0f);
+    const __m256 vmax = _mm256_set1_ps(127.0f);
+    const __m128i vbias = _mm_set1_epi8(bias);
+
+    int i = 0;
+    for (; i < samples - 15; i += 16) {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(pSrc + i)), vbias);
+        const __m256i lo = multiplyInt32x8(_mm256_cvtepi8_epi32(v), vfactor, vmin, vmax);
+        const __m256i hi = multiplyInt32x8(_mm256_cvtepi8_epi32(_mm_srli_si128(v, 8)), vfactor, vmin, vmax);
+
+        const __m128i r = _mm_packs_epi16(packs32x8(lo), packs32x8(hi));
+        _mm_storeu_si128((__m128i *)(pDst + i), _mm_xor_si128(r, vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint8(saturateSample<qint8>(qint8(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_s16_avx2(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint16 *pSrc = (const qint16 *)src;
+    qint16 *pDst = (qint16 *)dest;
+    const qint16 bias = biased ? qint16(0x8000) : 0;
+
+    const __m256 vfactor = _mm256_set1_ps(float(factor));
+    const __m256 vmin = _mm256_set1_ps(-32768.0f);
+    const __m256 vmax = _mm256_set1_ps(32767.0f);
+    const __m256i vbias = _mm256_set1_epi16(bias);
+
+    int i = 0;
+    for (; i < samples - 15; i += 16) {
+        const __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(pSrc + i)), vbias);
+        const __m256i lo = multiplyInt32x8(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)), vfactor, vmin, vmax);
+        const __m256i hi = multiplyInt32x8(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1)), vfactor, vmin, vmax);
+
+        // packs works per 128 bit lane, restore the sample order afterwards
+        const __m256i r = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i *)(pDst + i), _mm256_xor_si256(r, vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint16(saturateSample<qint16>(qint16(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_s32_avx2(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint32 *pSrc = (const qint32 *)src;
+    qint32 *pDst = (qint32 *)dest;
+    const qint32 bias = biased ? qint32(0x80000000) : 0;
+
+    const __m256d vfactor = _mm256_set1_pd(factor);
+    const __m256d vmin = _mm256_set1_pd(-2147483648.0);
+    const __m256d vmax = _mm256_set1_pd(2147483647.0);
+    const __m128i vbias = _mm_set1_epi32(bias);
+
+    int i = 0;
+    for (; i < samples - 3; i += 4) {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(pSrc + i)), vbias);
+        __m256d d = _mm256_mul_pd(_mm256_cvtepi32_pd(v), vfactor);
+        d = _mm256_min_pd(_mm256_max_pd(d, vmin), vmax);
+        _mm_storeu_si128((__m128i *)(pDst + i), _mm_xor_si128(_mm256_cvttpd_epi32(d), vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint32(saturateSample<qint32>(qint32(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_float_avx2(qreal factor, const void *src, void *dest, int samples, bool)
+{
+    const float *pSrc = (const float *)src;
+    float *pDst = (float *)dest;
+    const __m256 vfactor = _mm256_set1_ps(float(factor));
+
+    int i = 0;
+    for (; i < samples - 15; i += 16) {
+        const __m256 a = _mm256_loadu_ps(pSrc + i);
+        const __m256 b = _mm256_loadu_ps(pSrc + i + 8);
+        _mm256_storeu_ps(pDst + i, _mm256_mul_ps(a, vfactor));
+        _mm256_storeu_ps(pDst + i + 8, _mm256_mul_ps(b, vfactor));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = pSrc[i] * factor;
+}
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_COMPILER_SUPPORTS_AVX2
@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudiohelpers_p.h"
+
+#include <private/qsimd_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_NEON
+
+#include <arm_neon.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QAudioHelperInternal
+{
+
+// vcvtq_s32_f32 truncates and saturates, and the vqmovn narrowing is
+// saturating as well, so no explicit clamping is needed here.
+
+static inline int16x8_t multiplyInt16x8(int16x8_t v, float32_t factor)
+{
+    const float32x4_t lo = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), factor);
+    const float32x4_t hi = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), factor);
+    return vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi)));
+}
+
+void qt_multiplySamples_s8_neon(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint8 *pSrc = (const qint8 *)src;
+    qint8 *pDst = (qint8 *)dest;
+    const qint8 bias = biased ? qint8(0x80) : 0;
+    const int8x16_t vbias = vdupq_n_s8(bias);
+    const float32_t f = float(factor);
+
+    int i = 0;
+    for (; i < samples - 15; i += 16) {
+        const int8x16_t v = veorq_s8(vld1q_s8(pSrc + i), vbias);
+        const int16x8_t lo = multiplyInt16x8(vmovl_s8(vget_low_s8(v)), f);
+        const int16x8_t hi = multiplyInt16x8(vmovl_s8(vget_high_s8(v)), f);
+        vst1q_s8(pDst + i, veorq_s8(vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi)), vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint8(saturateSample<qint8>(qint8(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_s16_neon(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint16 *pSrc = (const qint16 *)src;
+    qint16 *pDst = (qint16 *)dest;
+    const qint16 bias = biased ? qint16(0x8000) : 0;
+    const int16x8_t vbias = vdupq_n_s16(bias);
+    const float32_t f = float(factor);
+
+    int i = 0;
+    for (; i < samples - 7; i += 8) {
+        const int16x8_t v = veorq_s16(vld1q_s16(pSrc + i), vbias);
+        vst1q_s16(pDst + i, veorq_s16(multiplyInt16x8(v, f), vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint16(saturateSample<qint16>(qint16(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_s32_neon(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint32 *pSrc = (const qint32 *)src;
+    qint32 *pDst = (qint32 *)dest;
+    const qint32 bias = biased ? qint32(0x80000000) : 0;
+
+    int i = 0;
+
+    // Single precision floats lose bits on 32 bit samples and there is no
+    // double precision NEON, so attenuation is done in Q31 fixed point instead.
+    if (factor >= 0.0 && factor < 1.0) {
+        const int32x4_t vfactor = vdupq_n_s32(qint32(factor * 2147483648.0));
+        const int32x4_t vbias = vdupq_n_s32(bias);
+        for (; i < samples - 3; i += 4) {
+            const int32x4_t v = veorq_s32(vld1q_s32(pSrc + i), vbias);
+            vst1q_s32(pDst + i, veorq_s32(vqdmulhq_s32(v, vfactor), vbias));
+        }
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint32(saturateSample<qint32>(qint32(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_float_neon(qreal factor, const void *src, void *dest, int samples, bool)
+{
+    const float *pSrc = (const float *)src;
+    float *pDst = (float *)dest;
+    const float32_t f = float(factor);
+
+    int i = 0;
+    for (; i < samples - 7; i += 8) {
+        const float32x4_t a = vld1q_f32(pSrc + i);
+        const float32x4_t b = vld1q_f32(pSrc + i + 4);
+        vst1q_f32(pDst + i, vmulq_n_f32(a, f));
+        vst1q_f32(pDst + i + 4, vmulq_n_f32(b, f));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = pSrc[i] * factor;
+}
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_COMPILER_SUPPORTS_NEON
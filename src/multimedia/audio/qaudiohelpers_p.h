@@ -55,11 +55,35 @@
 
 #include <qaudioformat.h>
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 namespace QAudioHelperInternal
 {
 Q_MULTIMEDIA_EXPORT void qMultiplySamples(qreal factor, const QAudioFormat& format, const void *src, void* dest, int len);
+
+// Plain C++ implementation of qMultiplySamples(). It is used whenever no
+// vectorized kernel is available and is the reference the kernels are tested against.
+Q_MULTIMEDIA_EXPORT void qMultiplySamplesGeneric(qreal factor, const QAudioFormat& format, const void *src, void* dest, int len);
+
+// Vectorized kernels work on signed samples; unsigned samples are passed
+// with \a biased set and are flipped around 0x80/0x8000/0x80000000 on the fly.
+typedef void (*MultiplySamplesFunc)(qreal factor, const void *src, void *dest, int samples, bool biased);
+
+template<class T> inline T saturateSample(qreal value)
+{
+    if (value >= qreal(std::numeric_limits<T>::max()))
+        return std::numeric_limits<T>::max();
+    if (value <= qreal(std::numeric_limits<T>::min()))
+        return std::numeric_limits<T>::min();
+    return T(value);
+}
+
+template<> inline float saturateSample<float>(qreal value)
+{
+    return float(value);
+}
 }
 
 QT_END_NAMESPACE
@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qaudiohelpers_p.h"
+
+#include <private/qsimd_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+
+QT_BEGIN_NAMESPACE
+
+namespace QAudioHelperInternal
+{
+
+// All kernels widen to float (or double for 32 bit samples), clamp to the
+// range of the sample type and truncate, which matches adjustSamples().
+
+void qt_multiplySamples_s8_sse2(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint8 *pSrc = (const qint8 *)src;
+    qint8 *pDst = (qint8 *)dest;
+    const qint8 bias = biased ? qint8(0x80) : 0;
+
+    const __m128 vfactor = _mm_set1_ps(float(factor));
+    const __m128 vmin = _mm_set1_ps(-128.0f);
+    const __m128 vmax = _mm_set1_ps(127.0f);
+    const __m128i vbias = _mm_set1_epi8(bias);
+
+    int i = 0;
+    for (; i < samples - 15; i += 16) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(pSrc + i)), vbias);
+        const __m128i lo16 = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+        const __m128i hi16 = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+
+        __m128i w[4];
+        w[0] = _mm_srai_epi32(_mm_unpacklo_epi16(lo16, lo16), 16);
+        w[1] = _mm_srai_epi32(_mm_unpackhi_epi16(lo16, lo16), 16);
+        w[2] = _mm_srai_epi32(_mm_unpacklo_epi16(hi16, hi16), 16);
+        w[3] = _mm_srai_epi32(_mm_unpackhi_epi16(hi16, hi16), 16);
+        for (int j = 0; j < 4; ++j) {
+            __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(w[j]), vfactor);
+            f = _mm_min_ps(_mm_max_ps(f, vmin), vmax);
+            w[j] = _mm_cvttps_epi32(f);
+        }
+
+        v = _mm_packs_epi16(_mm_packs_epi32(w[0], w[1]), _mm_packs_epi32(w[2], w[3]));
+        _mm_storeu_si128((__m128i *)(pDst + i), _mm_xor_si128(v, vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint8(saturateSample<qint8>(qint8(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_s16_sse2(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint16 *pSrc = (const qint16 *)src;
+    qint16 *pDst = (qint16 *)dest;
+    const qint16 bias = biased ? qint16(0x8000) : 0;
+
+    const __m128 vfactor = _mm_set1_ps(float(factor));
+    const __m128 vmin = _mm_set1_ps(-32768.0f);
+    const __m128 vmax = _mm_set1_ps(32767.0f);
+    const __m128i vbias = _mm_set1_epi16(bias);
+
+    int i = 0;
+    for (; i < samples - 7; i += 8) {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(pSrc + i)), vbias);
+        __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+        __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+        lo = _mm_min_ps(_mm_max_ps(_mm_mul_ps(lo, vfactor), vmin), vmax);
+        hi = _mm_min_ps(_mm_max_ps(_mm_mul_ps(hi, vfactor), vmin), vmax);
+
+        const __m128i r = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+        _mm_storeu_si128((__m128i *)(pDst + i), _mm_xor_si128(r, vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint16(saturateSample<qint16>(qint16(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_s32_sse2(qreal factor, const void *src, void *dest, int samples, bool biased)
+{
+    const qint32 *pSrc = (const qint32 *)src;
+    qint32 *pDst = (qint32 *)dest;
+    const qint32 bias = biased ? qint32(0x80000000) : 0;
+
+    const __m128d vfactor = _mm_set1_pd(factor);
+    const __m128d vmin = _mm_set1_pd(-2147483648.0);
+    const __m128d vmax = _mm_set1_pd(2147483647.0);
+    const __m128i vbias = _mm_set1_epi32(bias);
+
+    int i = 0;
+    for (; i < samples - 3; i += 4) {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(pSrc + i)), vbias);
+        __m128d lo = _mm_mul_pd(_mm_cvtepi32_pd(v), vfactor);
+        __m128d hi = _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(v, 8)), vfactor);
+        lo = _mm_min_pd(_mm_max_pd(lo, vmin), vmax);
+        hi = _mm_min_pd(_mm_max_pd(hi, vmin), vmax);
+
+        const __m128i r = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+        _mm_storeu_si128((__m128i *)(pDst + i), _mm_xor_si128(r, vbias));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = qint32(saturateSample<qint32>(qint32(pSrc[i] ^ bias) * factor) ^ bias);
+}
+
+void qt_multiplySamples_float_sse2(qreal factor, const void *src, void *dest, int samples, bool)
+{
+    const float *pSrc = (const float *)src;
+    float *pDst = (float *)dest;
+    const __m128 vfactor = _mm_set1_ps(float(factor));
+
+    int i = 0;
+    for (; i < samples - 7; i += 8) {
+        const __m128 a = _mm_loadu_ps(pSrc + i);
+        const __m128 b = _mm_loadu_ps(pSrc + i + 4);
+        _mm_storeu_ps(pDst + i, _mm_mul_ps(a, vfactor));
+        _mm_storeu_ps(pDst + i + 4, _mm_mul_ps(b, vfactor));
+    }
+
+    for (; i < samples; ++i)
+        pDst[i] = pSrc[i] * factor;
+}
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_COMPILER_SUPPORTS_SSE2
@@ -49,6 +49,12 @@
 
 QT_BEGIN_NAMESPACE
 
+// Backend features added after 5.0 are behind an interface, see qaudiosystem.h
+static inline QAudioInputExtensionInterface *extension(QAbstractAudioInput *backend)
+{
+    return qobject_cast<QAudioInputExtensionInterface *>(backend);
+}
+
 /*!
     \class QAudioInput
     \brief The QAudioInput class provides an interface for receiving audio data from an audio input device.
@@ -193,6 +199,54 @@ QIODevice* QAudioInput::start()
     return d->start();
 }
 
+/*!
+    Starts the audio input, calling \a callback with \a userData on the
+    audio thread whenever the system's audio input has captured data.
+
+    Captured audio is handed over directly from the device, without going
+    through a QIODevice or the event loop. This allows for much shorter
+    latencies; see setLatencyTarget(). The callback must not block.
+
+    Returns true and sets state() to QAudio::ActiveState if the input was
+    started. If the platform does not support capture callbacks, returns false
+    without changing the state; use start(QIODevice *) instead. If the device
+    could not be opened, returns false and error() returns QAudio::OpenError.
+
+    \since 5.4
+    \sa QAudio::CaptureCallback
+*/
+bool QAudioInput::start(QAudio::CaptureCallback callback, void *userData)
+{
+    if (!callback)
+        return false;
+    QAudioInputExtensionInterface *ext = extension(d);
+    return ext && ext->startCapturing(callback, userData);
+}
+
+/*!
+    Opens the connection to the system's audio input ahead of time, without
+    starting to capture.
+
+    Setting up an audio stream can take a noticeable amount of time on some
+    platforms. Calling prepare() while the input is stopped lets that happen
+    in the background, so that a following start() captures from the first
+    period on. The state() stays QAudio::StoppedState.
+
+    Changing the buffer size or latency target of a prepared input discards
+    the prepared stream. Calling stop() releases it.
+
+    Not all platforms support preparing a stream. In this case, the function
+    call will be ignored and start() opens the stream as usual.
+
+    \since 5.4
+    \sa start()
+*/
+void QAudioInput::prepare()
+{
+    if (QAudioInputExtensionInterface *ext = extension(d))
+        ext->prepare();
+}
+
 /*!
     Returns the QAudioFormat being used.
 */
@@ -306,6 +360,41 @@ int QAudioInput::periodSize() const
     return d->periodSize();
 }
 
+/*!
+    Sets the latency the audio stream should aim for to \a usecs microseconds.
+
+    This is the time between audio data being captured and it being
+    available to read. Lower values trade a higher risk of overruns and a
+    higher CPU load for a quicker response. A value of 0 lets the platform
+    choose.
+
+    Like setBufferSize(), this takes effect the next time the stream is
+    started. If both are set, the latency target takes precedence.
+
+    Not all platforms support a latency target. In this case, the function
+    call will be ignored.
+
+    \since 5.4
+    \sa latencyTarget(), setBufferSize()
+*/
+void QAudioInput::setLatencyTarget(qint64 usecs)
+{
+    if (QAudioInputExtensionInterface *ext = extension(d))
+        ext->setLatencyTarget(usecs);
+}
+
+/*!
+    Returns the latency target in microseconds set with setLatencyTarget(),
+    or 0 if the platform default is used.
+
+    \since 5.4
+*/
+qint64 QAudioInput::latencyTarget() const
+{
+    QAudioInputExtensionInterface *ext = extension(d);
+    return ext ? ext->latencyTarget() : 0;
+}
+
 /*!
     Sets the interval for notify() signal to be emitted.
     This is based on the \a ms of audio data processed
@@ -374,6 +463,44 @@ qint64 QAudioInput::elapsedUSecs() const
     return d->elapsedUSecs();
 }
 
+/*!
+    Returns the most recent timestamp the backend took from the audio device
+    while capturing. It tells how many frames the device had captured at a
+    given time on the monotonic system clock, and how old the next frame
+    that will be read is, which makes it the right clock for matching
+    captured audio with video frames.
+
+    The timestamp is refreshed about once per period while the input is
+    active. Returns an invalid timestamp if the input is stopped or the
+    backend cannot read the device clock.
+
+    \since 5.4
+    \sa clockDrift(), processedUSecs()
+*/
+QAudio::Timestamp QAudioInput::timestamp() const
+{
+    QAudioInputExtensionInterface *ext = extension(d);
+    return ext ? ext->timestamp() : QAudio::Timestamp();
+}
+
+/*!
+    Returns how fast the audio device captures compared to the system clock,
+    as estimated from the timestamps taken over the last few seconds. A
+    value of 0.9999 means the device delivers 100 frames per million fewer
+    than its nominal sample rate would.
+
+    Returns 1.0 until enough of the stream has been captured to tell, and
+    whenever the backend cannot read the device clock.
+
+    \since 5.4
+    \sa timestamp()
+*/
+qreal QAudioInput::clockDrift() const
+{
+    QAudioInputExtensionInterface *ext = extension(d);
+    return ext ? ext->clockDrift() : 1.0;
+}
+
 /*!
     Returns the error state.
 */
@@ -72,6 +72,8 @@ public:
 
     void start(QIODevice *device);
     QIODevice* start();
+    bool start(QAudio::CaptureCallback callback, void *userData);
+    void prepare();
 
     void stop();
     void reset();
@@ -81,6 +83,9 @@ public:
     void setBufferSize(int bytes);
     int bufferSize() const;
 
+    void setLatencyTarget(qint64 usecs);
+    qint64 latencyTarget() const;
+
     int bytesReady() const;
     int periodSize() const;
 
@@ -93,6 +98,9 @@ public:
     qint64 processedUSecs() const;
     qint64 elapsedUSecs() const;
 
+    QAudio::Timestamp timestamp() const;
+    qreal clockDrift() const;
+
     QAudio::Error error() const;
     QAudio::State state() const;
 
@@ -50,6 +50,12 @@
 
 QT_BEGIN_NAMESPACE
 
+// Backend features added after 5.0 are behind an interface, see qaudiosystem.h
+static inline QAudioOutputExtensionInterface *extension(QAbstractAudioOutput *backend)
+{
+    return qobject_cast<QAudioOutputExtensionInterface *>(backend);
+}
+
 /*!
     \class QAudioOutput
     \brief The QAudioOutput class provides an interface for sending audio data to an audio output device.
@@ -172,6 +178,11 @@ QAudioFormat QAudioOutput::format() const
     If a problem occurs during this process, error() returns QAudio::OpenError,
     state() returns QAudio::StoppedState and the stateChanged() signal is emitted.
 
+    \note Some backends can be configured to read a random access \a device
+    from a dedicated audio thread. Such a device must not be read, written or
+    seeked from any other thread while the output is active. Sequential
+    devices are always read from the thread the QAudioOutput lives in.
+
     \sa QIODevice
 */
 void QAudioOutput::start(QIODevice* device)
@@ -201,6 +212,56 @@ QIODevice* QAudioOutput::start()
     return d->start();
 }
 
+/*!
+    Starts the audio output, calling \a callback with \a userData on the
+    audio thread whenever the system's audio output needs more data.
+
+    Audio is handed to the device directly from the callback, without going
+    through a QIODevice or the event loop. This allows for much shorter
+    latencies; see setLatencyTarget(). The callback must always produce the
+    requested number of frames, writing silence if it has nothing to play,
+    and must not block.
+
+    Returns true and sets state() to QAudio::ActiveState if the output was
+    started. If the platform does not support render callbacks, returns false
+    without changing the state; use start(QIODevice *) instead. If the device
+    could not be opened, returns false and error() returns QAudio::OpenError.
+
+    \since 5.4
+    \sa QAudio::RenderCallback
+*/
+bool QAudioOutput::start(QAudio::RenderCallback callback, void *userData)
+{
+    if (!callback)
+        return false;
+    QAudioOutputExtensionInterface *ext = extension(d);
+    return ext && ext->startRendering(callback, userData);
+}
+
+/*!
+    Opens the connection to the system's audio output ahead of time, without
+    starting playback.
+
+    Setting up an audio stream can take a noticeable amount of time on some
+    platforms. Calling prepare() while the output is stopped lets that happen
+    in the background, so that a following start() produces sound as soon as
+    possible. The state() stays QAudio::StoppedState.
+
+    Changing the format, buffer size or category of a prepared output
+    discards the prepared stream. Calling stop() releases it.
+
+    Not all platforms support preparing a stream. In this case, the function
+    call will be ignored and start() opens the stream as usual.
+
+    \since 5.4
+    \sa start()
+*/
+void QAudioOutput::prepare()
+{
+    if (QAudioOutputExtensionInterface *ext = extension(d))
+        ext->prepare();
+}
+
 /*!
     Stops the audio output, detaching from the system resource.
 
@@ -295,6 +356,40 @@ int QAudioOutput::bufferSize() const
     return d->bufferSize();
 }
 
+/*!
+    Sets the latency the audio stream should aim for to \a usecs microseconds.
+
+    This is the time between audio data being written and it being heard.
+    Lower values trade a higher risk of underruns and a higher CPU load for
+    a quicker response. A value of 0 lets the platform choose.
+
+    Like setBufferSize(), this takes effect the next time the stream is
+    started. If both are set, the latency target takes precedence.
+
+    Not all platforms support a latency target. In this case, the function
+    call will be ignored.
+
+    \since 5.4
+    \sa latencyTarget(), setBufferSize()
+*/
+void QAudioOutput::setLatencyTarget(qint64 usecs)
+{
+    if (QAudioOutputExtensionInterface *ext = extension(d))
+        ext->setLatencyTarget(usecs);
+}
+
+/*!
+    Returns the latency target in microseconds set with setLatencyTarget(),
+    or 0 if the platform default is used.
+
+    \since 5.4
+*/
+qint64 QAudioOutput::latencyTarget() const
+{
+    QAudioOutputExtensionInterface *ext = extension(d);
+    return ext ? ext->latencyTarget() : 0;
+}
+
 /*!
     Sets the interval for notify() signal to be emitted.
     This is based on the \a ms of audio data processed,
@@ -334,6 +429,45 @@ qint64 QAudioOutput::elapsedUSecs() const
     return d->elapsedUSecs();
 }
 
+/*!
+    Returns the most recent timestamp the backend took from the audio device
+    while playing. It tells which frame the device was playing at a given
+    time on the monotonic system clock, and how long it takes for data written
+    now to be heard, which makes it the right clock for synchronizing video
+    with the audio.
+
+    The timestamp is refreshed about once per period while the output is
+    active; extrapolate from it using the sample rate and clockDrift().
+    Returns an invalid timestamp if the output is stopped or the backend
+    cannot read the device clock.
+
+    \since 5.4
+    \sa clockDrift(), processedUSecs()
+*/
+QAudio::Timestamp QAudioOutput::timestamp() const
+{
+    QAudioOutputExtensionInterface *ext = extension(d);
+    return ext ? ext->timestamp() : QAudio::Timestamp();
+}
+
+/*!
+    Returns how fast the audio device plays compared to the system clock,
+    as estimated from the timestamps taken over the last few seconds. A
+    value of 1.0001 means the device plays 100 frames per million more than
+    its nominal sample rate would.
+
+    Returns 1.0 until enough of the stream has been played to tell, and
+    whenever the backend cannot read the device clock.
+
+    \since 5.4
+    \sa timestamp()
+*/
+qreal QAudioOutput::clockDrift() const
+{
+    QAudioOutputExtensionInterface *ext = extension(d);
+    return ext ? ext->clockDrift() : 1.0;
+}
+
 /*!
     Returns the error state.
 */
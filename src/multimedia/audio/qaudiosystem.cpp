@@ -375,6 +375,109 @@ QT_BEGIN_NAMESPACE
     the interval set by setNotifyInterval(x).
 */
 
+/*!
+    \class QAudioOutputExtensionInterface
+    \brief The QAudioOutputExtensionInterface class holds the optional features of an audio output backend.
+    \inmodule QtMultimedia
+    \internal
+    \since 5.4
+
+    These were added after QAbstractAudioOutput was published, so they are
+    not part of its virtual table. A QAbstractAudioOutput that supports any of
+    them also derives from this interface and names it in Q_INTERFACES();
+    QAudioOutput finds it with qobject_cast(). For backends that don't,
+    QAudioOutput behaves as the default implementations do.
+*/
+
+QAudioOutputExtensionInterface::~QAudioOutputExtensionInterface()
+{
+}
+
+/*!
+    \fn virtual void QAudioOutputExtensionInterface::prepare()
+    Opens the stream ahead of a start() without starting playback.
+    The default implementation does nothing.
+*/
+
+/*!
+    \fn virtual bool QAudioOutputExtensionInterface::startRendering(QAudio::RenderCallback callback, void *userData)
+    Starts the output, calling \a callback with \a userData from the audio
+    thread whenever the device needs data. Returns false if the output could
+    not be started. The default implementation returns false.
+*/
+
+/*!
+    \fn virtual void QAudioOutputExtensionInterface::setLatencyTarget(qint64 usecs)
+    Sets the latency the stream should aim for to \a usecs microseconds,
+    0 meaning the platform default. The default implementation does nothing.
+*/
+
+/*!
+    \fn virtual qint64 QAudioOutputExtensionInterface::latencyTarget() const
+    Returns the latency target in microseconds. The default implementation returns 0.
+*/
+
+/*!
+    \fn virtual QAudio::Timestamp QAudioOutputExtensionInterface::timestamp() const
+    Returns the most recent timestamp taken from the device while playing.
+    The default implementation returns an invalid timestamp.
+*/
+
+/*!
+    \fn virtual qreal QAudioOutputExtensionInterface::clockDrift() const
+    Returns the rate of the device clock relative to the system clock.
+    The default implementation returns 1.0.
+*/
+
+/*!
+    \class QAudioInputExtensionInterface
+    \brief The QAudioInputExtensionInterface class holds the optional features of an audio input backend.
+    \inmodule QtMultimedia
+    \internal
+    \since 5.4
+
+    The input side counterpart of QAudioOutputExtensionInterface.
+*/
+
+QAudioInputExtensionInterface::~QAudioInputExtensionInterface()
+{
+}
+
+/*!
+    \fn virtual void QAudioInputExtensionInterface::prepare()
+    Opens the stream ahead of a start() without starting to capture.
+    The default implementation does nothing.
+*/
+
+/*!
+    \fn virtual bool QAudioInputExtensionInterface::startCapturing(QAudio::CaptureCallback callback, void *userData)
+    Starts the input, calling \a callback with \a userData from the audio
+    thread whenever captured data is available. Returns false if the input
+    could not be started. The default implementation returns false.
+*/
+
+/*!
+    \fn virtual void QAudioInputExtensionInterface::setLatencyTarget(qint64 usecs)
+    Sets the latency the stream should aim for to \a usecs microseconds,
+    0 meaning the platform default. The default implementation does nothing.
+*/
+
+/*!
+    \fn virtual qint64 QAudioInputExtensionInterface::latencyTarget() const
+    Returns the latency target in microseconds. The default implementation returns 0.
+*/
+
+/*!
+    \fn virtual QAudio::Timestamp QAudioInputExtensionInterface::timestamp() const
+    Returns the most recent timestamp taken from the device while capturing.
+    The default implementation returns an invalid timestamp.
+*/
+
+/*!
+    \fn virtual qreal QAudioInputExtensionInterface::clockDrift() const
+    Returns the rate of the device clock relative to the system clock.
+    The default implementation returns 1.0.
+*/
 
 QT_END_NAMESPACE
 
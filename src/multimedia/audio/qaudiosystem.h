@@ -136,6 +136,39 @@ Q_SIGNALS:
     void notify();
 };
 
+// Features added after 5.0 are kept out of the vtables above, so that
+// existing backends keep working. A backend that has any of them derives
+// from the matching interface as well and lists it in Q_INTERFACES.
+struct Q_MULTIMEDIA_EXPORT QAudioOutputExtensionInterface
+{
+    virtual ~QAudioOutputExtensionInterface();
+    virtual void prepare() { }
+    virtual bool startRendering(QAudio::RenderCallback, void *) { return false; }
+    virtual void setLatencyTarget(qint64) { }
+    virtual qint64 latencyTarget() const { return 0; }
+    virtual QAudio::Timestamp timestamp() const { return QAudio::Timestamp(); }
+    virtual qreal clockDrift() const { return 1.0; }
+};
+
+#define QAudioOutputExtensionInterface_iid \
+    "org.qt-project.qt.audiooutputextension/5.4"
+Q_DECLARE_INTERFACE(QAudioOutputExtensionInterface, QAudioOutputExtensionInterface_iid)
+
+struct Q_MULTIMEDIA_EXPORT QAudioInputExtensionInterface
+{
+    virtual ~QAudioInputExtensionInterface();
+    virtual void prepare() { }
+    virtual bool startCapturing(QAudio::CaptureCallback, void *) { return false; }
+    virtual void setLatencyTarget(qint64) { }
+    virtual qint64 latencyTarget() const { return 0; }
+    virtual QAudio::Timestamp timestamp() const { return QAudio::Timestamp(); }
+    virtual qreal clockDrift() const { return 1.0; }
+};
+
+#define QAudioInputExtensionInterface_iid \
+    "org.qt-project.qt.audioinputextension/5.4"
+Q_DECLARE_INTERFACE(QAudioInputExtensionInterface, QAudioInputExtensionInterface_iid)
+
 QT_END_NAMESPACE
 
 #endif // QAUDIOSYSTEM_H
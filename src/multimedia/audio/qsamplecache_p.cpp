@@ -42,6 +42,9 @@
 #include "qsamplecache_p.h"
 #include "qwavedecoder_p.h"
 #include <QtNetwork>
+#include <QtCore/qendian.h>
+
+#include <limits>
 
 //#define QT_SAMPLECACHE_DEBUG
 
@@ -91,14 +94,152 @@ QT_BEGIN_NAMESPACE
            m_sample = 0;
        }
     \endcode
+
+    Released samples stay in the cache until the memory they use is needed
+    for other samples; the least recently used ones are unloaded first. The
+    budget is set with setCapacity(). With a capacity of zero or less
+    samples are unloaded as soon as they are released.
+
+    Samples which must never be unloaded, for example the sounds of a game
+    level, can be pinned with setPinned(). Pinned samples count towards the
+    usage but are not unloaded, whether they are referenced or not.
+
+    hitCount(), missCount() and evictionCount() tell how well the capacity
+    fits the application.
+
+    Local and resource files are read on a pool of loader threads, one per
+    core, in one go. Other URLs are streamed through the network access
+    manager. preload() requests a batch of samples and emits
+    preloadFinished() once all of them are loaded or failed to load. With
+    a capacity the loaded samples are then released like any other, and
+    stay cached until their memory is needed. Without a capacity they
+    would be unloaded right away, so the cache holds on to them until they
+    are requested, the next preload() is made, releasePreloadedSamples()
+    is called or a capacity is set.
 */
 
+// Shared between a sample and the loader thread reading its file, so that
+// the loader can tell whether the sample is still around when it is done.
+class QSampleLoadJob : public QSharedData
+{
+public:
+    QSampleLoadJob(QSample *s, const QString &file)
+        : sample(s)
+        , fileName(file)
+        , ok(false)
+    {
+    }
+
+    QMutex mutex;
+    QSample *sample; // Cleared when the sample is deleted, guarded by mutex
+    QString fileName;
+    QByteArray data;
+    QAudioFormat format;
+    bool ok;
+};
+
+// Parses the RIFF headers itself and reads the data chunk with a single
+// read(). Follows the same rules as QWaveDecoder; anything unexpected is
+// left to it.
+static bool readWaveFile(const QString &fileName, QByteArray *data, QAudioFormat *format)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    char riff[12];
+    if (file.read(riff, sizeof(riff)) != sizeof(riff))
+        return false;
+
+    // RIFF = little endian RIFF, RIFX = big endian RIFF
+    if ((qstrncmp(riff, "RIFF", 4) != 0 && qstrncmp(riff, "RIFX", 4) != 0)
+            || qstrncmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    const bool bigEndian = qstrncmp(riff, "RIFX", 4) == 0;
+
+    bool haveFormat = false;
+    forever {
+        uchar chunk[8];
+        if (file.read(reinterpret_cast<char *>(chunk), sizeof(chunk)) != sizeof(chunk))
+            return false;
+
+        const quint32 size = bigEndian ? qFromBigEndian<quint32>(chunk + 4)
+                                       : qFromLittleEndian<quint32>(chunk + 4);
+
+        if (!haveFormat && qstrncmp(reinterpret_cast<const char *>(chunk), "fmt ", 4) == 0) {
+            uchar wave[16];
+            if (size < sizeof(wave) || file.read(reinterpret_cast<char *>(wave), sizeof(wave)) != sizeof(wave))
+                return false;
+
+            const quint16 audioFormat = bigEndian ? qFromBigEndian<quint16>(wave) : qFromLittleEndian<quint16>(wave);
+            if (audioFormat != 0 && audioFormat != 1)
+                return false;
+
+            const int bps = bigEndian ? qFromBigEndian<quint16>(wave + 14) : qFromLittleEndian<quint16>(wave + 14);
+            format->setCodec(QLatin1String("audio/pcm"));
+            format->setSampleType(bps == 8 ? QAudioFormat::UnSignedInt : QAudioFormat::SignedInt);
+            format->setByteOrder(bigEndian ? QAudioFormat::BigEndian : QAudioFormat::LittleEndian);
+            format->setSampleRate(bigEndian ? qFromBigEndian<quint32>(wave + 4) : qFromLittleEndian<quint32>(wave + 4));
+            format->setSampleSize(bps);
+            format->setChannelCount(bigEndian ? qFromBigEndian<quint16>(wave + 2) : qFromLittleEndian<quint16>(wave + 2));
+
+            if (!file.seek(file.pos() + size - sizeof(wave)))
+                return false;
+            haveFormat = true;
+        } else if (haveFormat && qstrncmp(reinterpret_cast<const char *>(chunk), "data", 4) == 0) {
+            if (size > quint32(std::numeric_limits<int>::max()))
+                return false;
+            data->resize(size);
+            return file.read(data->data(), size) == qint64(size);
+        } else if (!file.seek(file.pos() + size)) {
+            return false;
+        }
+    }
+}
+
+class QSampleFileLoader : public QRunnable
+{
+public:
+    QSampleFileLoader(QSampleLoadJob *job)
+        : m_job(job)
+    {
+    }
+
+    void run()
+    {
+        m_job->ok = readWaveFile(m_job->fileName, &m_job->data, &m_job->format);
+
+        QMutexLocker locker(&m_job->mutex);
+        if (m_job->sample)
+            QMetaObject::invokeMethod(m_job->sample, "fileLoaded", Qt::QueuedConnection);
+    }
+
+private:
+    QExplicitlySharedDataPointer<QSampleLoadJob> m_job;
+};
+
+static QString localFileName(const QUrl &url)
+{
+    if (url.isLocalFile())
+        return url.toLocalFile();
+    if (url.scheme() == QLatin1String("qrc"))
+        return QLatin1Char(':') + url.path();
+    return QString();
+}
+
 QSampleCache::QSampleCache(QObject *parent)
     : QObject(parent)
     , m_networkAccessManager(0)
     , m_mutex(QMutex::Recursive)
     , m_capacity(0)
     , m_usage(0)
+    , m_lruFirst(0)
+    , m_lruLast(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+    , m_preloading(false)
     , m_loadingRefCount(0)
 {
     m_loadingThread.setObjectName(QLatin1String("QSampleCache::LoadingThread"));
@@ -129,7 +270,9 @@ QSampleCache::~QSampleCache()
     foreach (QSample* sample, m_staleSamples)
         delete sample; // deleting a sample does affect the m_staleSamples list, but foreach copies it
 
-    m_networkAccessManager->deleteLater();
+    // Only exists if anything was loaded from the network
+    if (m_networkAccessManager)
+        m_networkAccessManager->deleteLater();
 }
 
 void QSampleCache::loadingRelease()
@@ -175,15 +318,120 @@ QSample* QSampleCache::requestSample(const QUrl& url)
         sample->moveToThread(&m_loadingThread);
     } else {
         sample = *it;
+        if (sample->m_inLru)
+            removeFromLru(sample);
     }
 
-    sample->addRef();
+    // The first request after a preload takes over the reference the
+    // preload left behind
+    if (!m_preloadedSamples.remove(sample))
+        sample->addRef();
     locker.unlock();
 
-    sample->loadIfNecessary();
+    const bool loading = sample->loadIfNecessary();
+
+    locker.relock();
+    if (loading)
+        ++m_misses;
+    else
+        ++m_hits;
+
     return sample;
 }
 
+// Called in application thread
+void QSampleCache::preload(const QList<QUrl> &urls)
+{
+    m_preloading = true;
+
+    // Samples still held from the last preload are released once this one
+    // has its own references, so a sample in both isn't unloaded in between
+    QSet<QSample*> previous;
+    {
+        QMutexLocker locker(&m_mutex);
+        previous.swap(m_preloadedSamples);
+    }
+
+    foreach (const QUrl &url, urls) {
+        QSample *sample = requestSample(url);
+        m_preloadSamples.append(sample);
+        if (m_preloadPending.contains(sample))
+            continue;
+
+        connect(sample, SIGNAL(ready()), this, SLOT(preloadSampleFinished()), Qt::QueuedConnection);
+        connect(sample, SIGNAL(error()), this, SLOT(preloadSampleFinished()), Qt::QueuedConnection);
+        m_preloadPending.insert(sample);
+
+        const QSample::State state = sample->state();
+        if (state == QSample::Ready || state == QSample::Error) {
+            disconnect(sample, 0, this, 0);
+            m_preloadPending.remove(sample);
+        }
+    }
+
+    foreach (QSample *sample, previous)
+        sample->release();
+
+    // Always finish asynchronously, even if everything was cached already
+    if (m_preloadPending.isEmpty())
+        QMetaObject::invokeMethod(this, "finishPreload", Qt::QueuedConnection);
+}
+
+// Called in application thread
+void QSampleCache::releasePreloadedSamples()
+{
+    QSet<QSample*> samples;
+    {
+        QMutexLocker locker(&m_mutex);
+        samples.swap(m_preloadedSamples);
+    }
+
+    // Samples are locked before the cache, see QSample::release()
+    foreach (QSample *sample, samples)
+        sample->release();
+}
+
+// Called in application thread
+void QSampleCache::preloadSampleFinished()
+{
+    // The sample may have finished before preload() connected to it; it is
+    // only guaranteed to be alive while it is pending.
+    QSample *sample = static_cast<QSample *>(sender());
+    if (!m_preloadPending.remove(sample))
+        return;
+
+    disconnect(sample, 0, this, 0);
+    if (m_preloadPending.isEmpty())
+        finishPreload();
+}
+
+// Called in application thread
+void QSampleCache::finishPreload()
+{
+    if (!m_preloading || !m_preloadPending.isEmpty())
+        return;
+
+    m_preloading = false;
+
+    // With a capacity the loaded samples simply end up in the LRU list.
+    // Without one they would be unloaded right away, so one reference to
+    // each is kept until they are requested or released.
+    QList<QSample*> samples;
+    samples.swap(m_preloadSamples);
+    foreach (QSample *sample, samples) {
+        const bool loaded = sample->state() == QSample::Ready;
+        QMutexLocker locker(&m_mutex);
+        if (loaded && m_capacity <= 0 && !m_preloadedSamples.contains(sample)) {
+            m_preloadedSamples.insert(sample);
+            continue;
+        }
+        locker.unlock();
+        sample->release();
+    }
+
+    emit preloadFinished();
+}
+
 void QSampleCache::setCapacity(qint64 capacity)
 {
     QMutexLocker locker(&m_mutex);
@@ -193,28 +441,143 @@ void QSampleCache::setCapacity(qint64 capacity)
     qDebug() << "QSampleCache: capacity changes from " << m_capacity << "to " << capacity;
 #endif
     if (m_capacity > 0 && capacity <= 0) { //memory management strategy changed
-        for (QMap<QUrl, QSample*>::iterator it = m_samples.begin(); it != m_samples.end();) {
-            QSample* sample = *it;
-            if (sample->m_ref == 0) {
-                unloadSample(sample);
-                it = m_samples.erase(it);
-            } else
-                it++;
-        }
+        while (m_lruFirst)
+            evictSample(m_lruFirst);
     }
 
     m_capacity = capacity;
     refresh(0);
+
+    // Preloaded samples were only held because nothing else would keep them
+    if (m_capacity > 0 && !m_preloadedSamples.isEmpty()) {
+        locker.unlock();
+        releasePreloadedSamples();
+    }
+}
+
+qint64 QSampleCache::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+qint64 QSampleCache::usage() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_usage;
+}
+
+void QSampleCache::setPinned(const QUrl &url, bool pinned)
+{
+    QMutexLocker locker(&m_mutex);
+    if (pinned == m_pinnedUrls.contains(url))
+        return;
+
+    // The reference count only changes with our mutex held, so it can be
+    // read here without taking the sample's lock.
+    QSample *sample = m_samples.value(url);
+    if (pinned) {
+        m_pinnedUrls.insert(url);
+        if (sample && sample->m_inLru)
+            removeFromLru(sample);
+    } else {
+        m_pinnedUrls.remove(url);
+        if (sample && sample->m_ref == 0) {
+            if (m_capacity > 0) {
+                appendToLru(sample);
+                refresh(0);
+            } else {
+                m_samples.remove(url);
+                unloadSample(sample);
+            }
+        }
+    }
+}
+
+bool QSampleCache::isPinned(const QUrl &url) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pinnedUrls.contains(url);
+}
+
+int QSampleCache::hitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+int QSampleCache::missCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+int QSampleCache::evictionCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_evictions;
+}
+
+void QSampleCache::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
 }
 
 // Called locked
 void QSampleCache::unloadSample(QSample *sample)
 {
+    if (sample->m_inLru)
+        removeFromLru(sample);
     m_usage -= sample->m_soundData.size();
     m_staleSamples.insert(sample);
     sample->deleteLater();
 }
 
+// Called locked
+void QSampleCache::evictSample(QSample *sample)
+{
+#ifdef QT_SAMPLECACHE_DEBUG
+    qDebug() << "QSampleCache: evict [" << sample->m_url << "]";
+#endif
+    m_samples.remove(sample->m_url);
+    unloadSample(sample);
+    ++m_evictions;
+}
+
+// Called locked
+void QSampleCache::appendToLru(QSample *sample)
+{
+    Q_ASSERT(!sample->m_inLru);
+    sample->m_lruPrevious = m_lruLast;
+    sample->m_lruNext = 0;
+    if (m_lruLast)
+        m_lruLast->m_lruNext = sample;
+    else
+        m_lruFirst = sample;
+    m_lruLast = sample;
+    sample->m_inLru = true;
+}
+
+// Called locked
+void QSampleCache::removeFromLru(QSample *sample)
+{
+    Q_ASSERT(sample->m_inLru);
+    if (sample->m_lruPrevious)
+        sample->m_lruPrevious->m_lruNext = sample->m_lruNext;
+    else
+        m_lruFirst = sample->m_lruNext;
+    if (sample->m_lruNext)
+        sample->m_lruNext->m_lruPrevious = sample->m_lruPrevious;
+    else
+        m_lruLast = sample->m_lruPrevious;
+    sample->m_lruPrevious = 0;
+    sample->m_lruNext = 0;
+    sample->m_inLru = false;
+}
+
 // Called in both threads
 void QSampleCache::refresh(qint64 usageChange)
 {
@@ -227,18 +590,12 @@ void QSampleCache::refresh(qint64 usageChange)
     qint64 recoveredSize = 0;
 #endif
 
-    //free unused samples to keep usage under capacity limit.
-    for (QMap<QUrl, QSample*>::iterator it = m_samples.begin(); it != m_samples.end();) {
-        QSample* sample = *it;
-        if (sample->m_ref > 0) {
-            ++it;
-            continue;
-        }
+    //free the least recently used samples to keep usage under capacity limit.
+    while (m_lruFirst) {
 #ifdef QT_SAMPLECACHE_DEBUG
-        recoveredSize += sample->m_soundData.size();
+        recoveredSize += m_lruFirst->m_soundData.size();
 #endif
-        unloadSample(sample);
-        it = m_samples.erase(it);
+        evictSample(m_lruFirst);
         if (m_usage <= m_capacity)
             return;
     }
@@ -267,6 +624,12 @@ QSample::~QSample()
     // Remove ourselves from our parent
     m_parent->removeUnreferencedSample(this);
 
+    // Let a loader thread still reading our file know that we are gone
+    if (m_loadJob) {
+        QMutexLocker jobLocker(&m_loadJob->mutex);
+        m_loadJob->sample = 0;
+    }
+
     QMutexLocker locker(&m_mutex);
 #ifdef QT_SAMPLECACHE_DEBUG
     qDebug() << "~QSample" << this << ": deleted [" << m_url << "]" << QThread::currentThread();
@@ -275,14 +638,17 @@ QSample::~QSample()
 }
 
 // Called in application thread
-void QSample::loadIfNecessary()
+// Returns true if the sample has to be (re)loaded.
+bool QSample::loadIfNecessary()
 {
     QMutexLocker locker(&m_mutex);
     if (m_state == QSample::Error || m_state == QSample::Creating) {
         m_state = QSample::Loading;
         QMetaObject::invokeMethod(this, "load", Qt::QueuedConnection);
+        return true;
     } else {
         qobject_cast<QSampleCache*>(m_parent)->loadingRelease();
+        return false;
     }
 }
 
@@ -290,8 +656,16 @@ void QSample::loadIfNecessary()
 bool QSampleCache::notifyUnreferencedSample(QSample* sample)
 {
     QMutexLocker locker(&m_mutex);
-    if (m_capacity > 0)
+    if (m_pinnedUrls.contains(sample->m_url))
         return false;
+
+    if (m_capacity > 0) {
+        // Keep it around until its memory is needed
+        appendToLru(sample);
+        refresh(0);
+        return false;
+    }
+
     m_samples.remove(sample->m_url);
     unloadSample(sample);
     return true;
@@ -301,6 +675,8 @@ bool QSampleCache::notifyUnreferencedSample(QSample* sample)
 void QSample::release()
 {
     QMutexLocker locker(&m_mutex);
+    // Samples are locked before the cache everywhere, see decoderReady()
+    QMutexLocker cacheLocker(&m_parent->m_mutex);
 #ifdef QT_SAMPLECACHE_DEBUG
     qDebug() << "Sample:: release" << this << QThread::currentThread() << m_ref;
 #endif
@@ -322,7 +698,7 @@ void QSample::cleanup()
     m_stream = 0;
 }
 
-// Called in application thread
+// Called in application thread, with the cache's mutex held
 void QSample::addRef()
 {
     m_ref++;
@@ -357,6 +733,7 @@ void QSample::decoderReady()
 #endif
     m_parent->refresh(m_waveDecoder->size());
 
+    m_audioFormat = m_waveDecoder->audioFormat();
     m_soundData.resize(m_waveDecoder->size());
     m_sampleReadLength = 0;
     qint64 read = m_waveDecoder->read(m_soundData.data(), m_waveDecoder->size());
@@ -381,6 +758,19 @@ void QSample::load()
 #ifdef QT_SAMPLECACHE_DEBUG
     qDebug() << "QSample: load [" << m_url << "]";
 #endif
+    const QString fileName = localFileName(m_url);
+    if (!fileName.isEmpty()) {
+        m_loadJob = new QSampleLoadJob(this, fileName);
+        m_parent->m_loaderPool.start(new QSampleFileLoader(m_loadJob.data()));
+        return;
+    }
+
+    loadStream();
+}
+
+// Called in loading thread
+void QSample::loadStream()
+{
     m_stream = m_parent->networkAccessManager().get(QNetworkRequest(m_url));
     connect(m_stream, SIGNAL(error(QNetworkReply::NetworkError)), SLOT(decoderError()));
     m_waveDecoder = new QWaveDecoder(m_stream);
@@ -389,6 +779,32 @@ void QSample::load()
     connect(m_waveDecoder, SIGNAL(readyRead()), SLOT(readSample()));
 }
 
+// Called in loading thread once a loader thread has read our file
+void QSample::fileLoaded()
+{
+    Q_ASSERT(QThread::currentThread()->objectName() == QLatin1String("QSampleCache::LoadingThread"));
+    QMutexLocker m(&m_mutex);
+
+    QExplicitlySharedDataPointer<QSampleLoadJob> job(m_loadJob);
+    m_loadJob.reset();
+
+    if (!job->ok) {
+        // Not something we could read directly, let the decoder deal with it
+#ifdef QT_SAMPLECACHE_DEBUG
+        qDebug() << "QSample: falling back to decoder for [" << m_url << "]";
+#endif
+        m.unlock();
+        loadStream();
+        return;
+    }
+
+    m_parent->refresh(job->data.size());
+
+    m_soundData = job->data;
+    m_audioFormat = job->format;
+    onReady();
+}
+
 // Called in loading thread
 void QSample::decoderError()
 {
@@ -410,7 +826,6 @@ void QSample::onReady()
 #ifdef QT_SAMPLECACHE_DEBUG
     qDebug() << "QSample: load ready";
 #endif
-    m_audioFormat = m_waveDecoder->audioFormat();
     cleanup();
     m_state = QSample::Ready;
     qobject_cast<QSampleCache*>(m_parent)->loadingRelease();
@@ -426,6 +841,9 @@ QSample::QSample(const QUrl& url, QSampleCache *parent)
     , m_sampleReadLength(0)
     , m_state(Creating)
     , m_ref(0)
+    , m_lruPrevious(0)
+    , m_lruNext(0)
+    , m_inLru(false)
 {
 }
 
@@ -59,6 +59,8 @@
 #include <QtCore/qmutex.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qset.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qthreadpool.h>
 #include <qaudioformat.h>
 
 
@@ -67,6 +69,7 @@ QT_BEGIN_NAMESPACE
 class QIODevice;
 class QNetworkAccessManager;
 class QSampleCache;
+class QSampleLoadJob;
 class QWaveDecoder;
 
 // Lives in application thread
@@ -102,12 +105,14 @@ private Q_SLOTS:
     void decoderError();
     void readSample();
     void decoderReady();
+    void fileLoaded();
 
 private:
+    void loadStream();
     void onReady();
     void cleanup();
     void addRef();
-    void loadIfNecessary();
+    bool loadIfNecessary();
     QSample();
     ~QSample();
 
@@ -120,7 +125,13 @@ private:
     QUrl         m_url;
     qint64       m_sampleReadLength;
     State        m_state;
-    int          m_ref;
+    int          m_ref;  // Guarded by the cache's mutex
+    QExplicitlySharedDataPointer<QSampleLoadJob> m_loadJob;
+
+    // Position in the cache's list of unreferenced samples, guarded by the cache's mutex
+    QSample      *m_lruPrevious;
+    QSample      *m_lruNext;
+    bool         m_inLru;
 };
 
 class Q_MULTIMEDIA_EXPORT QSampleCache : public QObject
@@ -133,28 +144,67 @@ public:
     ~QSampleCache();
 
     QSample* requestSample(const QUrl& url);
+    void preload(const QList<QUrl>& urls);
+    void releasePreloadedSamples();
     void setCapacity(qint64 capacity);
+    qint64 capacity() const;
+    qint64 usage() const;
+
+    void setPinned(const QUrl& url, bool pinned);
+    bool isPinned(const QUrl& url) const;
 
     bool isLoading() const;
     bool isCached(const QUrl& url) const;
 
+    int hitCount() const;
+    int missCount() const;
+    int evictionCount() const;
+    void resetStatistics();
+
 Q_SIGNALS:
     void isLoadingChanged();
+    void preloadFinished();
+
+private Q_SLOTS:
+    void preloadSampleFinished();
+    void finishPreload();
 
 private:
     QMap<QUrl, QSample*> m_samples;
     QSet<QSample*> m_staleSamples;
+    QSet<QUrl> m_pinnedUrls;
     QNetworkAccessManager *m_networkAccessManager;
     mutable QMutex m_mutex;
     qint64 m_capacity;
     qint64 m_usage;
     QThread m_loadingThread;
+    QThreadPool m_loaderPool;
+
+    // Unreferenced samples, least recently used first
+    QSample *m_lruFirst;
+    QSample *m_lruLast;
+
+    int m_hits;
+    int m_misses;
+    int m_evictions;
+
+    // Samples referenced on behalf of preload(), used in application thread only
+    QList<QSample*> m_preloadSamples;
+    QSet<QSample*> m_preloadPending;
+    bool m_preloading;
+
+    // Loaded by the last preload() without a capacity and not requested
+    // since, each holding one reference, guarded by m_mutex
+    QSet<QSample*> m_preloadedSamples;
 
     QNetworkAccessManager& networkAccessManager();
     void refresh(qint64 usageChange);
     bool notifyUnreferencedSample(QSample* sample);
     void removeUnreferencedSample(QSample* sample);
     void unloadSample(QSample* sample);
+    void evictSample(QSample* sample);
+    void appendToLru(QSample* sample);
+    void removeFromLru(QSample* sample);
 
     void loadingRelease();
     int m_loadingRefCount;
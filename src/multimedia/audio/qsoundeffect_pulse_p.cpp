@@ -54,6 +54,7 @@
 #include <qaudioformat.h>
 #include <QtNetwork>
 #include <QTime>
+#include <private/qmultimediaenvironment_p.h>
 
 #include "qsoundeffect_pulse_p.h"
 
@@ -101,7 +102,7 @@ class PulseDaemon : public QObject
 {
     Q_OBJECT
 public:
-    PulseDaemon(): m_prepared(false)
+    PulseDaemon(): m_prepared(false), m_reconnectInterval(MinReconnectIntervalMs)
     {
         prepare();
     }
@@ -129,9 +130,14 @@ public:
         return m_context;
     }
 
+    inline pa_volume_t calcVolume(int soundEffectVolume) const
+    {
+        return m_vol * soundEffectVolume / 100;
+    }
+
     inline pa_cvolume * calcVolume(pa_cvolume *dest, int soundEffectVolume)
     {
-        pa_volume_t v = m_vol * soundEffectVolume / 100;
+        pa_volume_t v = calcVolume(soundEffectVolume);
         for (int i = 0; i < dest->channels; ++i)
             dest->values[i] = v;
         return dest;
@@ -151,12 +157,20 @@ Q_SIGNALS:
     void volumeChanged();
 
 private Q_SLOTS:
+    void onContextReady()
+    {
+        m_reconnectInterval = MinReconnectIntervalMs;
+        emit contextReady();
+    }
+
     void onContextFailed()
     {
         release();
 
-        // Try to reconnect later
-        QTimer::singleShot(30000, this, SLOT(prepare()));
+        // Try to reconnect later. A restarting server is usually back within
+        // a second, one that is gone for good shouldn't be polled too often.
+        QTimer::singleShot(m_reconnectInterval, this, SLOT(prepare()));
+        m_reconnectInterval = qMin(2 * m_reconnectInterval, int(MaxReconnectIntervalMs));
 
         emit contextFailed();
     }
@@ -201,6 +215,7 @@ private Q_SLOTS:
             pa_threaded_mainloop_free(m_mainLoop);
             m_mainLoop = 0;
             m_context = 0;
+            onContextFailed();
             return;
         }
         unlock();
@@ -242,7 +257,7 @@ private:
                 pa_ext_stream_restore_set_subscribe_cb(c, &stream_restore_monitor_callback, self);
                 pa_ext_stream_restore_subscribe(c, 1, 0, self);
     #endif
-                QMetaObject::invokeMethod(self, "contextReady", Qt::QueuedConnection);
+                QMetaObject::invokeMethod(self, "onContextReady", Qt::QueuedConnection);
                 break;
             case PA_CONTEXT_FAILED:
                 QMetaObject::invokeMethod(self, "onContextFailed", Qt::QueuedConnection);
@@ -281,9 +296,12 @@ private:
     }
 #endif
 
+    enum { MinReconnectIntervalMs = 1000, MaxReconnectIntervalMs = 30000 };
+
     pa_volume_t m_vol;
 
     bool m_prepared;
+    int m_reconnectInterval;
     pa_context *m_context;
     pa_threaded_mainloop *m_mainLoop;
     pa_mainloop_api *m_mainLoopApi;
@@ -292,7 +310,22 @@ private:
 }
 
 Q_GLOBAL_STATIC(PulseDaemon, pulseDaemon)
-Q_GLOBAL_STATIC(QSampleCache, sampleCache)
+
+namespace
+{
+// Keeps released samples around, so that sound effects created again for
+// the same source, like a new SoundEffect per button press, do not reload it.
+class SoundEffectSampleCache : public QSampleCache
+{
+public:
+    SoundEffectSampleCache()
+    {
+        setCapacity(4 * 1024 * 1024);
+    }
+};
+}
+
+Q_GLOBAL_STATIC(SoundEffectSampleCache, sampleCache)
 
 namespace
 {
@@ -309,8 +342,214 @@ public:
         pulseDaemon()->unlock();
     }
 };
+
+static bool useServerSampleCache()
+{
+    return qt_multimedia_envFlag("QT_PULSEAUDIO_SAMPLE_CACHE", false);
 }
 
+// Keeps one copy of every sample in the server's sample cache, shared by all
+// effects playing the same source. Must be used with the daemon locked.
+class PulseSampleCache : public QObject
+{
+    Q_OBJECT
+public:
+    enum State { Idle, Uploading, Ready, Failed };
+
+    PulseSampleCache()
+        : m_nextName(0)
+        , m_subscribedContext(0)
+    {
+        connect(pulseDaemon(), SIGNAL(contextFailed()), SLOT(contextFailed()));
+    }
+
+    void acquire(const QUrl &url)
+    {
+        Entry &entry = m_entries[url];
+        if (entry.refCount++ == 0) {
+            entry.name = QString(QLatin1String("QtPulseSample-%1-%2")).arg(::getpid()).arg(++m_nextName).toUtf8();
+            entry.state = Idle;
+        }
+    }
+
+    void release(const QUrl &url)
+    {
+        QHash<QUrl, Entry>::iterator it = m_entries.find(url);
+        if (it == m_entries.end() || --it->refCount > 0)
+            return;
+        // An upload in progress is removed once it completes, see uploadDone()
+        if (it->state == Ready)
+            removeSample(it->name);
+        m_entries.erase(it);
+    }
+
+    State upload(const QUrl &url, const QByteArray &data, const pa_sample_spec &spec)
+    {
+        QHash<QUrl, Entry>::iterator it = m_entries.find(url);
+        Q_ASSERT(it != m_entries.end());
+        if (it->state != Idle)
+            return it->state;
+
+        pa_context *context = pulseDaemon()->context();
+        subscribe(context);
+
+        pa_stream *stream = pa_stream_new(context, it->name.constData(), &spec, 0);
+        if (stream == 0) {
+            qWarning("QSoundEffect(pulseaudio): Failed to create upload stream");
+            it->state = Failed;
+            return Failed;
+        }
+
+        UploadJob *job = new UploadJob;
+        job->cache = this;
+        job->url = url;
+        job->name = it->name;
+        job->data = data;
+        job->failed = false;
+        pa_stream_set_state_callback(stream, upload_state_callback, job);
+        if (pa_stream_connect_upload(stream, data.size()) < 0) {
+            qWarning("QSoundEffect(pulseaudio): Failed to upload sample, error = %s",
+                     pa_strerror(pa_context_errno(context)));
+            pa_stream_set_state_callback(stream, 0, 0);
+            pa_stream_unref(stream);
+            delete job;
+            it->state = Failed;
+            return Failed;
+        }
+
+        it->state = Uploading;
+        return Uploading;
+    }
+
+    bool isReady(const QUrl &url) const
+    {
+        return m_entries.value(url).state == Ready;
+    }
+
+    QByteArray sampleName(const QUrl &url) const
+    {
+        return m_entries.value(url).name;
+    }
+
+Q_SIGNALS:
+    void uploadFinished(const QUrl &url, bool success);
+    void sinkInputRemoved(int index);
+
+private Q_SLOTS:
+    void uploadDone(const QUrl &url, const QByteArray &name, bool success)
+    {
+        QHash<QUrl, Entry>::iterator it = m_entries.find(url);
+        if (it == m_entries.end() || it->name != name) {
+            // Released while uploading
+            if (success) {
+                PulseDaemonLocker locker;
+                removeSample(name);
+            }
+            return;
+        }
+
+        it->state = success ? Ready : Failed;
+        emit uploadFinished(url, success);
+    }
+
+    void contextFailed()
+    {
+        // The server may have gone away with its cache, upload again once
+        // a new context is up. Sample names are reused so a surviving copy
+        // is simply replaced.
+        for (QHash<QUrl, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+            it->state = Idle;
+        m_subscribedContext = 0;
+    }
+
+private:
+    struct Entry
+    {
+        Entry() : refCount(0), state(Idle) {}
+
+        QByteArray name;
+        int refCount;
+        State state;
+    };
+
+    struct UploadJob
+    {
+        PulseSampleCache *cache;
+        QUrl url;
+        QByteArray name;
+        QByteArray data;
+        bool failed;
+    };
+
+    void removeSample(const QByteArray &name)
+    {
+        pa_context *context = pulseDaemon()->context();
+        if (!context)
+            return;
+        pa_operation *o = pa_context_remove_sample(context, name.constData(), 0, 0);
+        if (o)
+            pa_operation_unref(o);
+    }
+
+    // Playing a cached sample has no completion callback, the end of
+    // playback shows up as the removal of its sink input.
+    void subscribe(pa_context *context)
+    {
+        if (context == m_subscribedContext)
+            return;
+        m_subscribedContext = context;
+        pa_context_set_subscribe_callback(context, subscribe_callback, this);
+        pa_operation *o = pa_context_subscribe(context, PA_SUBSCRIPTION_MASK_SINK_INPUT, 0, 0);
+        if (o)
+            pa_operation_unref(o);
+    }
+
+    static void upload_state_callback(pa_stream *s, void *userdata)
+    {
+        UploadJob *job = reinterpret_cast<UploadJob*>(userdata);
+        switch (pa_stream_get_state(s)) {
+        case PA_STREAM_READY:
+            // Without a free callback the data is copied right away
+            if (pa_stream_write(s, job->data.constData(), job->data.size(), 0, 0, PA_SEEK_RELATIVE) != 0
+                    || pa_stream_finish_upload(s) != 0) {
+                qWarning("QSoundEffect(pulseaudio): Failed to upload sample, error = %s",
+                         pa_strerror(pa_context_errno(pa_stream_get_context(s))));
+                job->failed = true;
+                pa_stream_disconnect(s);
+            }
+            break;
+        case PA_STREAM_TERMINATED:
+        case PA_STREAM_FAILED:
+            QMetaObject::invokeMethod(job->cache, "uploadDone", Qt::QueuedConnection,
+                                      Q_ARG(QUrl, job->url), Q_ARG(QByteArray, job->name),
+                                      Q_ARG(bool, !job->failed && pa_stream_get_state(s) == PA_STREAM_TERMINATED));
+            pa_stream_set_state_callback(s, 0, 0);
+            pa_stream_unref(s);
+            delete job;
+            break;
+        default:
+            break;
+        }
+    }
+
+    static void subscribe_callback(pa_context *c, pa_subscription_event_type_t t, uint32_t index, void *userdata)
+    {
+        Q_UNUSED(c);
+        if ((t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) != PA_SUBSCRIPTION_EVENT_SINK_INPUT
+                || (t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) != PA_SUBSCRIPTION_EVENT_REMOVE)
+            return;
+        PulseSampleCache *self = reinterpret_cast<PulseSampleCache*>(userdata);
+        QMetaObject::invokeMethod(self, "sinkInputRemoved", Qt::QueuedConnection, Q_ARG(int, int(index)));
+    }
+
+    QHash<QUrl, Entry> m_entries;
+    int m_nextName;
+    pa_context *m_subscribedContext;
+};
+}
+
+Q_GLOBAL_STATIC(PulseSampleCache, pulseSampleCache)
+
 class QSoundEffectRef
 {
 public:
@@ -372,6 +611,13 @@ private:
     QSoundEffectPrivate *m_target;
 };
 
+// Ties the reply of pa_context_play_sample() to the play() that asked for it
+struct QSoundEffectPlayRequest
+{
+    QSoundEffectRef *ref;
+    int serial;
+};
+
 QSoundEffectPrivate::QSoundEffectPrivate(QObject* parent):
     QObject(parent),
     m_pulseStream(0),
@@ -388,10 +634,18 @@ QSoundEffectPrivate::QSoundEffectPrivate(QObject* parent):
     m_runningCount(0),
     m_reloadCategory(false),
     m_sample(0),
-    m_position(0)
+    m_position(0),
+    m_useSampleCache(useServerSampleCache()),
+    m_streamPlayback(false),
+    m_playSerial(0)
 {
     m_ref = new QSoundEffectRef(this);
     pa_sample_spec_init(&m_pulseSpec);
+
+    if (m_useSampleCache) {
+        connect(pulseSampleCache(), SIGNAL(uploadFinished(QUrl,bool)), SLOT(cachedSampleUploaded(QUrl,bool)));
+        connect(pulseSampleCache(), SIGNAL(sinkInputRemoved(int)), SLOT(cachedSampleFinished(int)));
+    }
 }
 
 void QSoundEffectPrivate::release()
@@ -401,6 +655,12 @@ void QSoundEffectPrivate::release()
 #endif
     m_ref->notifyDeleted();
     unloadPulseStream();
+    if (m_useSampleCache) {
+        PulseDaemonLocker locker;
+        killCachedSample();
+        if (!m_cachedSource.isEmpty())
+            pulseSampleCache()->release(m_cachedSource);
+    }
     if (m_sample) {
         m_sample->release();
         m_sample = 0;
@@ -472,6 +732,10 @@ void QSoundEffectPrivate::setSource(const QUrl &url)
     m_sampleReady = false;
 
     PulseDaemonLocker locker;
+    if (!m_cachedSource.isEmpty()) {
+        pulseSampleCache()->release(m_cachedSource);
+        m_cachedSource.clear();
+    }
     setLoopsRemaining(0);
     if (m_pulseStream && !pa_stream_is_corked(m_pulseStream)) {
         pa_stream_set_write_callback(m_pulseStream, 0, 0);
@@ -539,8 +803,10 @@ void QSoundEffectPrivate::updateVolume()
     PulseDaemonLocker locker;
     pa_cvolume volume;
     volume.channels = m_pulseSpec.channels;
+    // Cached samples are muted through their volume, see playCachedSample()
+    const qreal effectVolume = m_useSampleCache && m_muted ? 0 : m_volume;
     if (pulseDaemon()->context())
-        pa_operation_unref(pa_context_set_sink_input_volume(pulseDaemon()->context(), m_sinkInputId, pulseDaemon()->calcVolume(&volume, qRound(m_volume * 100)), setvolume_callback, m_ref->getRef()));
+        pa_operation_unref(pa_context_set_sink_input_volume(pulseDaemon()->context(), m_sinkInputId, pulseDaemon()->calcVolume(&volume, qRound(effectVolume * 100)), setvolume_callback, m_ref->getRef()));
     Q_ASSERT(pa_cvolume_valid(&volume));
 #ifdef QT_PA_DEBUG
     qDebug() << this << "updateVolume =" << pa_cvolume_max(&volume);
@@ -563,6 +829,10 @@ void QSoundEffectPrivate::updateMuted()
 {
     if (m_sinkInputId < 0)
         return;
+    if (m_useSampleCache) {
+        updateVolume();
+        return;
+    }
     PulseDaemonLocker locker;
     if (pulseDaemon()->context())
         pa_operation_unref(pa_context_set_sink_input_mute(pulseDaemon()->context(), m_sinkInputId, m_muted, setmuted_callback, m_ref->getRef()));
@@ -633,6 +903,30 @@ void QSoundEffectPrivate::play()
         return;
 
     PulseDaemonLocker locker;
+    if (m_useSampleCache) {
+        if (m_playing && !m_streamPlayback) { //restart playing from the beginning
+            ++m_playSerial;
+            killCachedSample();
+        }
+
+        // Every trigger of a cached sample is a new sink input, so loops
+        // would have a gap between them. Loops are written into a stream
+        // instead, where each one follows the previous without a break.
+        m_streamPlayback = m_loopCount != 1;
+        if (!m_streamPlayback) {
+            setPlaying(true);
+            setLoopsRemaining(m_loopCount);
+            if (m_status == QSoundEffect::Ready && pulseSampleCache()->isReady(m_source))
+                playCachedSample();
+            else
+                m_playQueued = true;
+            return;
+        }
+
+        if (!m_pulseStream && m_sampleReady && pulseDaemon()->context())
+            createPulseStream();
+    }
+
     if (!m_pulseStream || m_status != QSoundEffect::Ready || m_stopping || m_emptying) {
 #ifdef QT_PA_DEBUG
         qDebug() << this << "play deferred";
@@ -701,7 +995,16 @@ void QSoundEffectPrivate::sampleReady()
         m_name = QString(QLatin1String("QtPulseSample-%1-%2")).arg(::getpid()).arg(quintptr(this)).toUtf8();
 
     PulseDaemonLocker locker;
-    if (m_pulseStream) {
+    if (m_useSampleCache) {
+        if (!pulseDaemon()->context() || pa_context_get_state(pulseDaemon()->context()) != PA_CONTEXT_READY) {
+            connect(pulseDaemon(), SIGNAL(contextReady()), SLOT(contextReady()));
+            return;
+        }
+        uploadCachedSample();
+        // A looping play() came in while the sample was still loading
+        if (m_streamPlayback && m_playQueued && !m_pulseStream)
+            createPulseStream();
+    } else if (m_pulseStream) {
 #ifdef QT_PA_DEBUG
         qDebug() << this << "reuse existing pulsestream";
 #endif
@@ -770,8 +1073,11 @@ void QSoundEffectPrivate::unloadPulseStream()
         pa_stream_set_underflow_callback(m_pulseStream, 0, 0);
         pa_stream_disconnect(m_pulseStream);
         pa_stream_unref(m_pulseStream);
-        disconnect(pulseDaemon(), SIGNAL(volumeChanged()), this, SLOT(updateVolume()));
-        disconnect(pulseDaemon(), SIGNAL(contextFailed()), this, SLOT(contextFailed()));
+        // Cached samples keep following the daemon without a stream
+        if (!m_useSampleCache) {
+            disconnect(pulseDaemon(), SIGNAL(volumeChanged()), this, SLOT(updateVolume()));
+            disconnect(pulseDaemon(), SIGNAL(contextFailed()), this, SLOT(contextFailed()));
+        }
         m_pulseStream = 0;
         m_reloadCategory = false; // category will be reloaded when we connect anyway
     }
@@ -883,6 +1189,12 @@ void QSoundEffectPrivate::stop()
         return;
     setPlaying(false);
     PulseDaemonLocker locker;
+    if (m_useSampleCache && !m_streamPlayback) {
+        ++m_playSerial;
+        killCachedSample();
+        setLoopsRemaining(0);
+        return;
+    }
     m_stopping = true;
     if (m_pulseStream) {
         emptyStream();
@@ -935,8 +1247,8 @@ void QSoundEffectPrivate::createPulseStream()
     pa_stream *stream = pa_stream_new_with_proplist(pulseDaemon()->context(), m_name.constData(), &m_pulseSpec, 0, propList);
     pa_proplist_free(propList);
 
-    connect(pulseDaemon(), SIGNAL(volumeChanged()), this, SLOT(updateVolume()));
-    connect(pulseDaemon(), SIGNAL(contextFailed()), this, SLOT(contextFailed()));
+    connect(pulseDaemon(), SIGNAL(volumeChanged()), this, SLOT(updateVolume()), Qt::UniqueConnection);
+    connect(pulseDaemon(), SIGNAL(contextFailed()), this, SLOT(contextFailed()), Qt::UniqueConnection);
 
     if (stream == 0) {
         qWarning("QSoundEffect(pulseaudio): Failed to create stream");
@@ -975,15 +1287,168 @@ void QSoundEffectPrivate::contextReady()
 {
     disconnect(pulseDaemon(), SIGNAL(contextReady()), this, SLOT(contextReady()));
     PulseDaemonLocker locker;
-    createPulseStream();
+    if (m_useSampleCache) {
+        uploadCachedSample();
+        if (m_streamPlayback && m_playQueued && !m_pulseStream)
+            createPulseStream();
+    } else {
+        createPulseStream();
+    }
 }
 
 void QSoundEffectPrivate::contextFailed()
 {
+    if (m_useSampleCache) {
+        // The sink input went away with the context
+        m_sinkInputId = -1;
+        stop();
+    }
     unloadPulseStream();
     connect(pulseDaemon(), SIGNAL(contextReady()), this, SLOT(contextReady()));
 }
 
+void QSoundEffectPrivate::uploadCachedSample()
+{
+    if (!m_sample || !m_sampleReady)
+        return;
+
+    if (m_cachedSource != m_source) {
+        m_cachedSource = m_source;
+        pulseSampleCache()->acquire(m_source);
+        connect(pulseDaemon(), SIGNAL(volumeChanged()), this, SLOT(updateVolume()), Qt::UniqueConnection);
+        connect(pulseDaemon(), SIGNAL(contextFailed()), this, SLOT(contextFailed()), Qt::UniqueConnection);
+    }
+
+    switch (pulseSampleCache()->upload(m_source, m_sample->data(), m_pulseSpec)) {
+    case PulseSampleCache::Ready:
+        cachedSampleUploaded(m_source, true);
+        break;
+    case PulseSampleCache::Failed:
+        cachedSampleUploaded(m_source, false);
+        break;
+    default:
+        // Another effect started the upload or we did, wait for uploadFinished()
+        break;
+    }
+}
+
+void QSoundEffectPrivate::cachedSampleUploaded(const QUrl &url, bool success)
+{
+    if (url != m_cachedSource || url != m_source)
+        return;
+#ifdef QT_PA_DEBUG
+    qDebug() << this << "cachedSampleUploaded" << success;
+#endif
+    if (!success) {
+        setLoopsRemaining(0);
+        setPlaying(false);
+        setStatus(QSoundEffect::Error);
+        return;
+    }
+
+    setStatus(QSoundEffect::Ready);
+    if (m_playQueued && !m_streamPlayback) {
+        PulseDaemonLocker locker;
+        m_playQueued = false;
+        playCachedSample();
+    }
+}
+
+void QSoundEffectPrivate::playCachedSample()
+{
+#ifdef QT_PA_DEBUG
+    qDebug() << this << "playCachedSample";
+#endif
+    pa_context *context = pulseDaemon()->context();
+    if (!context || !pulseSampleCache()->isReady(m_source)) {
+        m_playQueued = true;
+        return;
+    }
+
+    pa_proplist *propList = pa_proplist_new();
+    if (!m_category.isNull())
+        pa_proplist_sets(propList, PA_PROP_MEDIA_ROLE, m_category.toLatin1().constData());
+
+    // Muting is folded into the volume, a sink input created through the
+    // sample cache starts unmuted.
+    const pa_volume_t volume = m_muted ? PA_VOLUME_MUTED : pulseDaemon()->calcVolume(qRound(m_volume * 100));
+
+    QSoundEffectPlayRequest *request = new QSoundEffectPlayRequest;
+    request->ref = m_ref->getRef();
+    request->serial = m_playSerial;
+    pa_operation *o = pa_context_play_sample_with_proplist(context, pulseSampleCache()->sampleName(m_source).constData(),
+                                                           0, volume, propList, play_sample_callback, request);
+    pa_proplist_free(propList);
+
+    if (o) {
+        pa_operation_unref(o);
+    } else {
+        qWarning("QSoundEffect(pulseaudio): Failed to play sample, error = %s", pa_strerror(pa_context_errno(context)));
+        request->ref->release();
+        delete request;
+        setLoopsRemaining(0);
+        setPlaying(false);
+    }
+}
+
+void QSoundEffectPrivate::killCachedSample()
+{
+    if (m_sinkInputId < 0)
+        return;
+
+    if (pulseDaemon()->context()) {
+        pa_operation *o = pa_context_kill_sink_input(pulseDaemon()->context(), m_sinkInputId, 0, 0);
+        if (o)
+            pa_operation_unref(o);
+    }
+    m_sinkInputId = -1;
+}
+
+void QSoundEffectPrivate::cachedSampleStarted(int sinkInputId, int serial)
+{
+#ifdef QT_PA_DEBUG
+    qDebug() << this << "cachedSampleStarted" << sinkInputId << serial;
+#endif
+    PulseDaemonLocker locker;
+    if (serial != m_playSerial || !m_playing) {
+        // Stopped or restarted while the request was in flight
+        if (sinkInputId >= 0 && pulseDaemon()->context()) {
+            pa_operation *o = pa_context_kill_sink_input(pulseDaemon()->context(), sinkInputId, 0, 0);
+            if (o)
+                pa_operation_unref(o);
+        }
+        return;
+    }
+
+    if (sinkInputId < 0) {
+        qWarning("QSoundEffect(pulseaudio): Failed to play sample");
+        stop();
+        return;
+    }
+
+    m_sinkInputId = sinkInputId;
+}
+
+void QSoundEffectPrivate::cachedSampleFinished(int sinkInputId)
+{
+    if (sinkInputId != m_sinkInputId)
+        return;
+#ifdef QT_PA_DEBUG
+    qDebug() << this << "cachedSampleFinished" << sinkInputId;
+#endif
+    m_sinkInputId = -1;
+
+    if (m_runningCount > 0)
+        setLoopsRemaining(m_runningCount - 1);
+
+    if (m_runningCount != 0) {
+        PulseDaemonLocker locker;
+        playCachedSample();
+    } else {
+        setPlaying(false);
+    }
+}
+
 void QSoundEffectPrivate::stream_write_callback(pa_stream *s, size_t length, void *userdata)
 {
     Q_UNUSED(length);
@@ -1124,6 +1589,24 @@ void QSoundEffectPrivate::setmuted_callback(pa_context *c, int success, void *us
     }
 }
 
+void QSoundEffectPrivate::play_sample_callback(pa_context *c, uint32_t idx, void *userdata)
+{
+    Q_UNUSED(c);
+    QSoundEffectPlayRequest *request = reinterpret_cast<QSoundEffectPlayRequest*>(userdata);
+    QSoundEffectPrivate *self = request->ref->soundEffect();
+    request->ref->release();
+    const int serial = request->serial;
+    delete request;
+    if (!self)
+        return;
+#ifdef QT_PA_DEBUG
+    qDebug() << self << "play_sample_callback" << idx;
+#endif
+    const int sinkInputId = idx == PA_INVALID_INDEX ? -1 : int(idx);
+    QMetaObject::invokeMethod(self, "cachedSampleStarted", Qt::QueuedConnection,
+                              Q_ARG(int, sinkInputId), Q_ARG(int, serial));
+}
+
 void QSoundEffectPrivate::stream_underrun_callback(pa_stream *s, void *userdata)
 {
     Q_UNUSED(s);
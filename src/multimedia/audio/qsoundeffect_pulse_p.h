@@ -118,10 +118,17 @@ private Q_SLOTS:
     void emptyComplete(void *stream);
     void updateVolume();
     void updateMuted();
+    void cachedSampleUploaded(const QUrl &url, bool success);
+    void cachedSampleStarted(int sinkInputId, int serial);
+    void cachedSampleFinished(int sinkInputId);
 
 private:
     void playSample();
 
+    void uploadCachedSample();
+    void playCachedSample();
+    void killCachedSample();
+
     void emptyStream();
     void createPulseStream();
     void unloadPulseStream();
@@ -140,6 +147,7 @@ private:
     static void stream_reset_buffer_callback(pa_stream *s, int success, void *userdata);
     static void setvolume_callback(pa_context *c, int success, void *userdata);
     static void setmuted_callback(pa_context *c, int success, void *userdata);
+    static void play_sample_callback(pa_context *c, uint32_t idx, void *userdata);
 
     pa_stream *m_pulseStream;
     int        m_sinkInputId;
@@ -164,6 +172,12 @@ private:
     QSample *m_sample;
     int m_position;
     QSoundEffectRef *m_ref;
+
+    // Server side sample cache mode, see QT_PULSEAUDIO_SAMPLE_CACHE
+    bool m_useSampleCache;
+    bool m_streamPlayback; // a looping play() in sample cache mode, see play()
+    QUrl m_cachedSource;
+    int m_playSerial;
 };
 
 QT_END_NAMESPACE
@@ -53,18 +53,32 @@
 #include "qsoundeffect_qaudio_p.h"
 
 #include <QtCore/qcoreapplication.h>
-#include <QtCore/qiodevice.h>
 
 //#include <QDebug>
 //#define QT_QAUDIO_DEBUG 1
 
 QT_BEGIN_NAMESPACE
 
-Q_GLOBAL_STATIC(QSampleCache, sampleCache)
+namespace
+{
+// Keeps released samples around, so that sound effects created again for
+// the same source, like a new SoundEffect per button press, do not reload it.
+class SoundEffectSampleCache : public QSampleCache
+{
+public:
+    SoundEffectSampleCache()
+    {
+        setCapacity(4 * 1024 * 1024);
+    }
+};
+}
+
+Q_GLOBAL_STATIC(SoundEffectSampleCache, sampleCache)
 
 QSoundEffectPrivate::QSoundEffectPrivate(QObject* parent):
     QObject(parent),
-    d(new PrivateSoundSource(this))
+    d(new PrivateSoundSource(this)),
+    m_category(QLatin1String("game"))
 {
 }
 
@@ -75,11 +89,10 @@ QSoundEffectPrivate::~QSoundEffectPrivate()
 void QSoundEffectPrivate::release()
 {
     stop();
-    if (d->m_audioOutput) {
-        d->m_audioOutput->stop();
-        d->m_audioOutput->deleteLater();
+    if (d->m_mixer)
+        d->m_mixer->unregisterObserver(d->m_voiceId);
+    if (d->m_sample)
         d->m_sample->release();
-    }
     delete d;
     this->deleteLater();
 }
@@ -169,15 +182,15 @@ void QSoundEffectPrivate::setLoopCount(int loopCount)
     if (loopCount == 0)
         loopCount = 1;
     d->m_loopCount = loopCount;
-    if (d->m_playing)
+    if (d->m_playing) {
         setLoopsRemaining(loopCount);
+        if (d->m_mixer)
+            d->m_mixer->setLoopsRemaining(d->m_voiceId, loopCount);
+    }
 }
 
 qreal QSoundEffectPrivate::volume() const
 {
-    if (d->m_audioOutput && !d->m_muted)
-        return d->m_audioOutput->volume();
-
     return d->m_volume;
 }
 
@@ -185,8 +198,8 @@ void QSoundEffectPrivate::setVolume(qreal volume)
 {
     d->m_volume = volume;
 
-    if (d->m_audioOutput && !d->m_muted)
-        d->m_audioOutput->setVolume(volume);
+    if (d->m_mixer && !d->m_muted)
+        d->m_mixer->setVolume(d->m_voiceId, volume);
 
     emit volumeChanged();
 }
@@ -198,12 +211,11 @@ bool QSoundEffectPrivate::isMuted() const
 
 void QSoundEffectPrivate::setMuted(bool muted)
 {
-    if (muted && d->m_audioOutput)
-        d->m_audioOutput->setVolume(0);
-    else if (!muted && d->m_audioOutput && d->m_muted)
-        d->m_audioOutput->setVolume(d->m_volume);
-
     d->m_muted = muted;
+
+    if (d->m_mixer)
+        d->m_mixer->setVolume(d->m_voiceId, d->effectiveVolume());
+
     emit mutedChanged();
 }
 
@@ -225,7 +237,6 @@ QSoundEffect::Status QSoundEffectPrivate::status() const
 
 void QSoundEffectPrivate::play()
 {
-    d->m_offset = 0;
     setLoopsRemaining(d->m_loopCount);
 #ifdef QT_QAUDIO_DEBUG
     qDebug() << this << "play";
@@ -235,8 +246,8 @@ void QSoundEffectPrivate::play()
         return;
     }
     setPlaying(true);
-    if (d->m_audioOutput && d->m_audioOutput->state() == QAudio::StoppedState && d->m_sampleReady)
-        d->m_audioOutput->start(d);
+    if (d->m_mixer && d->m_sampleReady)
+        d->m_serial = d->m_mixer->play(d->m_voiceId, d->m_sample->data(), d->effectiveVolume(), d->m_runningCount);
 }
 
 void QSoundEffectPrivate::stop()
@@ -246,12 +257,12 @@ void QSoundEffectPrivate::stop()
 #ifdef QT_QAUDIO_DEBUG
     qDebug() << "stop()";
 #endif
-    d->m_offset = 0;
+    d->m_serial = 0;
 
     setPlaying(false);
 
-    if (d->m_audioOutput)
-        d->m_audioOutput->stop();
+    if (d->m_mixer)
+        d->m_mixer->stop(d->m_voiceId);
 }
 
 void QSoundEffectPrivate::setStatus(QSoundEffect::Status status)
@@ -290,16 +301,16 @@ void QSoundEffectPrivate::setLoopsRemaining(int loopsRemaining)
     emit loopsRemainingChanged();
 }
 
-/* Categories are ignored */
+/* Categories are ignored, all effects of a format play through one shared output */
 QString QSoundEffectPrivate::category() const
 {
-    return d->m_category;
+    return m_category;
 }
 
 void QSoundEffectPrivate::setCategory(const QString &category)
 {
-    if (d->m_category != category && !d->m_playing) {
-        d->m_category = category;
+    if (m_category != category && !d->m_playing) {
+        m_category = category;
         emit categoryChanged();
     }
 }
@@ -309,16 +320,15 @@ PrivateSoundSource::PrivateSoundSource(QSoundEffectPrivate* s):
     m_runningCount(0),
     m_playing(false),
     m_status(QSoundEffect::Null),
-    m_audioOutput(0),
+    m_mixer(0),
+    m_voiceId(0),
+    m_serial(0),
     m_sample(0),
     m_muted(false),
     m_volume(1.0),
-    m_sampleReady(false),
-    m_offset(0)
+    m_sampleReady(false)
 {
     soundeffect = s;
-    m_category = QLatin1String("game");
-    open(QIODevice::ReadOnly);
 }
 
 void PrivateSoundSource::sampleReady()
@@ -331,19 +341,25 @@ void PrivateSoundSource::sampleReady()
 #endif
     disconnect(m_sample, SIGNAL(error()), this, SLOT(decoderError()));
     disconnect(m_sample, SIGNAL(ready()), this, SLOT(sampleReady()));
-    if (!m_audioOutput) {
-        m_audioOutput = new QAudioOutput(m_sample->format());
-        connect(m_audioOutput,SIGNAL(stateChanged(QAudio::State)), this, SLOT(stateChanged(QAudio::State)));
-        if (!m_muted)
-            m_audioOutput->setVolume(m_volume);
-        else
-            m_audioOutput->setVolume(0);
+    // All effects with the same format share one output stream
+    QSoundEffectMixer *mixer = QSoundEffectMixer::instance(m_sample->format());
+    if (!mixer) {
+        qWarning("QSoundEffect(qaudio): Unsupported sample format");
+        m_playing = false;
+        soundeffect->setStatus(QSoundEffect::Error);
+        return;
+    }
+    if (mixer != m_mixer) {
+        if (m_mixer)
+            m_mixer->unregisterObserver(m_voiceId);
+        m_mixer = mixer;
+        m_voiceId = m_mixer->registerObserver(this);
     }
     m_sampleReady = true;
     soundeffect->setStatus(QSoundEffect::Ready);
 
     if (m_playing)
-        m_audioOutput->start(this);
+        m_serial = m_mixer->play(m_voiceId, m_sample->data(), effectiveVolume(), m_runningCount);
 }
 
 void PrivateSoundSource::decoderError()
@@ -355,92 +371,25 @@ void PrivateSoundSource::decoderError()
     soundeffect->setStatus(QSoundEffect::Error);
 }
 
-void PrivateSoundSource::stateChanged(QAudio::State state)
+void PrivateSoundSource::voiceLooped(int serial, int loopsRemaining)
 {
-#ifdef QT_QAUDIO_DEBUG
-    qDebug() << this << "stateChanged " << state;
-#endif
-    if (state == QAudio::IdleState && m_runningCount == 0)
-        emit soundeffect->stop();
+    // Ignore voices from before the last play() or stop()
+    if (serial != m_serial)
+        return;
+
+    soundeffect->setLoopsRemaining(loopsRemaining);
 }
 
-qint64 PrivateSoundSource::readData( char* data, qint64 len)
+void PrivateSoundSource::voiceFinished(int serial)
 {
-    if ((m_runningCount > 0  || m_runningCount == QSoundEffect::Infinite) && m_playing) {
-
-        if (m_sample->state() != QSample::Ready)
-            return 0;
-
-        qint64 bytesWritten = 0;
-
-        const int   periodSize = m_audioOutput->periodSize();
-        const int   sampleSize = m_sample->data().size();
-        const char* sampleData = m_sample->data().constData();
-
-        // Some systems can have large buffers we only need a max of three
-        int    periodsFree = qMin(3, (int)(m_audioOutput->bytesFree()/periodSize));
-        int    dataOffset = 0;
-
-#ifdef QT_QAUDIO_DEBUG
-        qDebug() << "bytesFree=" << m_audioOutput->bytesFree() << ", can fit " << periodsFree << " periodSize() chunks";
-#endif
-
-        while ((periodsFree > 0) && (bytesWritten + periodSize <= len)) {
+    if (serial != m_serial)
+        return;
 
-            if (sampleSize - m_offset >= periodSize) {
-                // We can fit a whole period of data
-                memcpy(data + dataOffset, sampleData + m_offset, periodSize);
-                m_offset += periodSize;
-                dataOffset += periodSize;
-                bytesWritten += periodSize;
-#ifdef QT_QAUDIO_DEBUG
-                qDebug() << "WHOLE PERIOD: bytesWritten=" << bytesWritten << ", offset=" << m_offset
-                         << ", filesize=" << sampleSize;
-#endif
-            } else {
-                // We are at end of sound, first write what is left of current sound
-                memcpy(data + dataOffset, sampleData + m_offset, sampleSize - m_offset);
-                bytesWritten += sampleSize - m_offset;
-                int wrapLen = periodSize - (sampleSize - m_offset);
 #ifdef QT_QAUDIO_DEBUG
-                qDebug() << "END OF SOUND: bytesWritten=" << bytesWritten << ", offset=" << m_offset
-                         << ", part1=" << (sampleSize-m_offset);
+    qDebug() << this << "voiceFinished " << serial;
 #endif
-                dataOffset += (sampleSize - m_offset);
-                m_offset = 0;
-
-                if (m_runningCount > 0 && m_runningCount != QSoundEffect::Infinite)
-                    soundeffect->setLoopsRemaining(m_runningCount-1);
-
-                if (m_runningCount > 0 || m_runningCount == QSoundEffect::Infinite) {
-                    // There are still more loops of this sound to play, append the start of sound to make up full period
-                    memcpy(data + dataOffset, sampleData + m_offset, wrapLen);
-                    m_offset += wrapLen;
-                    dataOffset += wrapLen;
-                    bytesWritten += wrapLen;
-#ifdef QT_QAUDIO_DEBUG
-                    qDebug() << "APPEND START FOR FULL PERIOD: bytesWritten=" << bytesWritten << ", offset=" << m_offset
-                             << ", part2=" << wrapLen;
-                    qDebug() << "part1 + part2 should be a period " << periodSize;
-#endif
-                }
-            }
-            if (m_runningCount == 0)
-                break;
-
-            periodsFree--;
-        }
-        return bytesWritten;
-    }
-
-    return 0;
-}
-
-qint64 PrivateSoundSource::writeData(const char* data, qint64 len)
-{
-    Q_UNUSED(data)
-    Q_UNUSED(len)
-    return 0;
+    m_serial = 0;
+    soundeffect->stop();
 }
 
 QT_END_NAMESPACE
@@ -55,15 +55,15 @@
 
 #include <QtCore/qobject.h>
 #include <QtCore/qurl.h>
-#include "qaudiooutput.h"
 #include "qsamplecache_p.h"
 #include "qsoundeffect.h"
+#include "qsoundeffectmixer_p.h"
 
 QT_BEGIN_NAMESPACE
 
 class QSoundEffectPrivate;
 
-class PrivateSoundSource : public QIODevice
+class PrivateSoundSource : public QObject, public QSoundEffectVoiceObserver
 {
     friend class QSoundEffectPrivate;
     Q_OBJECT
@@ -71,13 +71,15 @@ public:
     PrivateSoundSource(QSoundEffectPrivate* s);
     ~PrivateSoundSource() {}
 
-    qint64 readData( char* data, qint64 len);
-    qint64 writeData(const char* data, qint64 len);
+    void voiceLooped(int serial, int loopsRemaining);
+    void voiceFinished(int serial);
 
 private Q_SLOTS:
     void sampleReady();
     void decoderError();
-    void stateChanged(QAudio::State);
+
+private:
+    qreal effectiveVolume() const { return m_muted ? 0 : m_volume; }
 
 private:
     QUrl           m_url;
@@ -85,13 +87,13 @@ private:
     int            m_runningCount;
     bool           m_playing;
     QSoundEffect::Status  m_status;
-    QAudioOutput   *m_audioOutput;
+    QSoundEffectMixer *m_mixer;
+    int            m_voiceId;
+    int            m_serial;
     QSample        *m_sample;
     bool           m_muted;
     qreal          m_volume;
     bool           m_sampleReady;
-    qint64         m_offset;
-    QString        m_category;
 
     QSoundEffectPrivate *soundeffect;
 };
@@ -145,6 +147,7 @@ private:
     void setLoopsRemaining(int loopsRemaining);
 
     PrivateSoundSource* d;
+    QString m_category;
 };
 
 QT_END_NAMESPACE
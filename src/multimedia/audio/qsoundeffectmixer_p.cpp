@@ -0,0 +1,588 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// INTERNAL USE ONLY: Do NOT use for any other purpose.
+//
+
+#include "qsoundeffectmixer_p.h"
+#include "qsoundeffect.h"
+#include "qaudiooutput.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+
+// Stop the output stream when nothing has played for this long
+const int IdleTimeoutMs = 5000;
+const int CommandQueueSize = 256;
+// Used until the output knows its period size, which for an asynchronously
+// opened stream is only once it is running
+const qint64 FallbackChunkUSecs = 20000;
+
+typedef QList<QSoundEffectMixer *> QSoundEffectMixerList;
+Q_GLOBAL_STATIC(QSoundEffectMixerList, mixers)
+
+static void cleanupMixers()
+{
+    qDeleteAll(*mixers());
+    mixers()->clear();
+}
+
+namespace {
+
+// Samples are accumulated as floats in the sample type's own range, with
+// unsigned types moved around zero first.
+template<class T> struct MixTraits {};
+
+template<> struct MixTraits<quint8>
+{
+    static inline float toFloat(quint8 v) { return float(v) - 128.0f; }
+    static inline quint8 fromFloat(float v) { return quint8(qBound(-128.0f, v, 127.0f) + 128.0f); }
+};
+
+template<> struct MixTraits<qint8>
+{
+    static inline float toFloat(qint8 v) { return v; }
+    static inline qint8 fromFloat(float v) { return qint8(qBound(-128.0f, v, 127.0f)); }
+};
+
+template<> struct MixTraits<quint16>
+{
+    static inline float toFloat(quint16 v) { return float(v) - 32768.0f; }
+    static inline quint16 fromFloat(float v) { return quint16(qBound(-32768.0f, v, 32767.0f) + 32768.0f); }
+};
+
+template<> struct MixTraits<qint16>
+{
+    static inline float toFloat(qint16 v) { return v; }
+    static inline qint16 fromFloat(float v) { return qint16(qBound(-32768.0f, v, 32767.0f)); }
+};
+
+template<> struct MixTraits<quint32>
+{
+    static inline float toFloat(quint32 v) { return float(double(v) - 2147483648.0); }
+    static inline quint32 fromFloat(float v) { return quint32(qBound(-2147483648.0, double(v), 2147483647.0) + 2147483648.0); }
+};
+
+template<> struct MixTraits<qint32>
+{
+    static inline float toFloat(qint32 v) { return float(v); }
+    static inline qint32 fromFloat(float v) { return qint32(qBound(-2147483648.0, double(v), 2147483647.0)); }
+};
+
+template<> struct MixTraits<float>
+{
+    static inline float toFloat(float v) { return v; }
+    static inline float fromFloat(float v) { return v; }
+};
+
+template<class T> inline T swapSample(T v) { return qbswap(v); }
+template<> inline quint8 swapSample<quint8>(quint8 v) { return v; }
+template<> inline qint8 swapSample<qint8>(qint8 v) { return v; }
+template<> inline float swapSample<float>(float v)
+{
+    union { float f; quint32 i; } u;
+    u.f = v;
+    u.i = qbswap(u.i);
+    return u.f;
+}
+
+template<class T> void accumulateSamples(const char *src, float *mix, int count, float volume, bool swap)
+{
+    const T *pSrc = reinterpret_cast<const T *>(src);
+    if (swap) {
+        for (int i = 0; i < count; ++i)
+            mix[i] += MixTraits<T>::toFloat(swapSample(pSrc[i])) * volume;
+    } else {
+        for (int i = 0; i < count; ++i)
+            mix[i] += MixTraits<T>::toFloat(pSrc[i]) * volume;
+    }
+}
+
+template<class T> void storeSamples(const float *mix, char *dst, int count, bool swap)
+{
+    T *pDst = reinterpret_cast<T *>(dst);
+    if (swap) {
+        for (int i = 0; i < count; ++i)
+            pDst[i] = swapSample(MixTraits<T>::fromFloat(mix[i]));
+    } else {
+        for (int i = 0; i < count; ++i)
+            pDst[i] = MixTraits<T>::fromFloat(mix[i]);
+    }
+}
+
+void accumulate(const QAudioFormat &format, const char *src, float *mix, int count, float volume, bool swap)
+{
+    switch (format.sampleSize()) {
+    case 8:
+        if (format.sampleType() == QAudioFormat::SignedInt)
+            accumulateSamples<qint8>(src, mix, count, volume, swap);
+        else
+            accumulateSamples<quint8>(src, mix, count, volume, swap);
+        break;
+    case 16:
+        if (format.sampleType() == QAudioFormat::SignedInt)
+            accumulateSamples<qint16>(src, mix, count, volume, swap);
+        else
+            accumulateSamples<quint16>(src, mix, count, volume, swap);
+        break;
+    default:
+        if (format.sampleType() == QAudioFormat::SignedInt)
+            accumulateSamples<qint32>(src, mix, count, volume, swap);
+        else if (format.sampleType() == QAudioFormat::UnSignedInt)
+            accumulateSamples<quint32>(src, mix, count, volume, swap);
+        else
+            accumulateSamples<float>(src, mix, count, volume, swap);
+    }
+}
+
+void store(const QAudioFormat &format, const float *mix, char *dst, int count, bool swap)
+{
+    switch (format.sampleSize()) {
+    case 8:
+        if (format.sampleType() == QAudioFormat::SignedInt)
+            storeSamples<qint8>(mix, dst, count, swap);
+        else
+            storeSamples<quint8>(mix, dst, count, swap);
+        break;
+    case 16:
+        if (format.sampleType() == QAudioFormat::SignedInt)
+            storeSamples<qint16>(mix, dst, count, swap);
+        else
+            storeSamples<quint16>(mix, dst, count, swap);
+        break;
+    default:
+        if (format.sampleType() == QAudioFormat::SignedInt)
+            storeSamples<qint32>(mix, dst, count, swap);
+        else if (format.sampleType() == QAudioFormat::UnSignedInt)
+            storeSamples<quint32>(mix, dst, count, swap);
+        else
+            storeSamples<float>(mix, dst, count, swap);
+    }
+}
+
+inline bool needsSwap(const QAudioFormat &format)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return format.byteOrder() != QAudioFormat::LittleEndian;
+#else
+    return format.byteOrder() != QAudioFormat::BigEndian;
+#endif
+}
+
+}
+
+QSoundEffectMixer::QSoundEffectMixer(const QAudioFormat &format)
+    : m_format(format)
+    , m_output(0)
+    , m_nextId(1)
+    , m_nextSerial(1)
+    , m_commands(CommandQueueSize)
+    , m_commandRead(0)
+    , m_commandWrite(0)
+    , m_maxChunk(maxChunkFor(format, 0))
+    , m_voiceAge(0)
+{
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(IdleTimeoutMs);
+    connect(&m_idleTimer, SIGNAL(timeout()), this, SLOT(stopIfIdle()));
+
+    // Mix only what the output asks for, QIODevice's own read buffer would
+    // mix ahead and delay every command by its size.
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+QSoundEffectMixer::~QSoundEffectMixer()
+{
+    if (m_output) {
+        m_output->stop();
+        delete m_output;
+    }
+}
+
+bool QSoundEffectMixer::canMix(const QAudioFormat &format)
+{
+    if (!format.isValid() || format.codec() != QLatin1String("audio/pcm"))
+        return false;
+
+    switch (format.sampleSize()) {
+    case 8:
+    case 16:
+        return format.sampleType() == QAudioFormat::SignedInt
+                || format.sampleType() == QAudioFormat::UnSignedInt;
+    case 32:
+        return format.sampleType() != QAudioFormat::Unknown;
+    default:
+        return false;
+    }
+}
+
+QSoundEffectMixer *QSoundEffectMixer::instance(const QAudioFormat &format)
+{
+    if (!canMix(format))
+        return 0;
+
+    QSoundEffectMixerList *list = mixers();
+    foreach (QSoundEffectMixer *mixer, *list) {
+        if (mixer->format() == format)
+            return mixer;
+    }
+
+    if (list->isEmpty())
+        qAddPostRoutine(cleanupMixers);
+
+    QSoundEffectMixer *mixer = new QSoundEffectMixer(format);
+    list->append(mixer);
+    return mixer;
+}
+
+int QSoundEffectMixer::registerObserver(QSoundEffectVoiceObserver *observer)
+{
+    const int id = m_nextId++;
+    m_observers.insert(id, observer);
+    return id;
+}
+
+void QSoundEffectMixer::unregisterObserver(int id)
+{
+    stop(id);
+    m_observers.remove(id);
+}
+
+int QSoundEffectMixer::play(int id, const QByteArray &data, qreal volume, int loops)
+{
+    const int serial = m_nextSerial++;
+
+    Command command;
+    command.type = Command::Play;
+    command.id = id;
+    command.serial = serial;
+    command.volume = float(volume);
+    command.loops = loops;
+    command.data = data;
+    enqueue(command);
+
+    m_playingSerials.insert(id, serial);
+    m_idleTimer.stop();
+    startOutput();
+
+    return serial;
+}
+
+void QSoundEffectMixer::stop(int id)
+{
+    if (!m_playingSerials.remove(id))
+        return;
+
+    Command command;
+    command.type = Command::Stop;
+    command.id = id;
+    enqueue(command);
+
+    if (m_playingSerials.isEmpty())
+        m_idleTimer.start();
+}
+
+void QSoundEffectMixer::setVolume(int id, qreal volume)
+{
+    if (!m_playingSerials.contains(id))
+        return;
+
+    Command command;
+    command.type = Command::SetVolume;
+    command.id = id;
+    command.volume = float(volume);
+    enqueue(command);
+}
+
+void QSoundEffectMixer::setLoopsRemaining(int id, int loops)
+{
+    if (!m_playingSerials.contains(id))
+        return;
+
+    Command command;
+    command.type = Command::SetLoops;
+    command.id = id;
+    command.loops = loops;
+    enqueue(command);
+}
+
+void QSoundEffectMixer::enqueue(const Command &command)
+{
+    QMutexLocker locker(&m_producerMutex);
+
+    const int write = m_commandWrite.load();
+    const int next = (write + 1) % CommandQueueSize;
+    if (next == m_commandRead.loadAcquire()) {
+        // The mixing thread has not run for a long time; better to lose
+        // this than to block the caller.
+        qWarning("QSoundEffect(qaudio): command queue is full, dropping command");
+        if (command.type == Command::Play)
+            QMetaObject::invokeMethod(this, "notifyFinished", Qt::QueuedConnection,
+                                      Q_ARG(int, command.id), Q_ARG(int, command.serial));
+        return;
+    }
+
+    m_commands[write] = command;
+    m_commandWrite.storeRelease(next);
+}
+
+void QSoundEffectMixer::processCommands()
+{
+    int read = m_commandRead.load();
+    const int write = m_commandWrite.loadAcquire();
+
+    while (read != write) {
+        Command &command = m_commands[read];
+
+        Voice *voice = findVoice(command.id);
+        switch (command.type) {
+        case Command::Play:
+            if (!voice)
+                voice = allocateVoice();
+            voice->id = command.id;
+            voice->serial = command.serial;
+            voice->offset = 0;
+            voice->loops = command.loops;
+            voice->volume = command.volume;
+            voice->age = ++m_voiceAge;
+            voice->data.swap(command.data);
+            break;
+        case Command::Stop:
+            if (voice) {
+                voice->id = 0;
+                voice->data.clear();
+            }
+            break;
+        case Command::SetVolume:
+            if (voice)
+                voice->volume = command.volume;
+            break;
+        case Command::SetLoops:
+            if (voice)
+                voice->loops = command.loops;
+            break;
+        }
+
+        // Don't let the producer's next assignment free the sample data here
+        command.data.clear();
+        read = (read + 1) % CommandQueueSize;
+        m_commandRead.storeRelease(read);
+    }
+}
+
+QSoundEffectMixer::Voice *QSoundEffectMixer::findVoice(int id)
+{
+    for (int i = 0; i < MaxVoices; ++i) {
+        if (m_voices[i].id == id)
+            return &m_voices[i];
+    }
+    return 0;
+}
+
+QSoundEffectMixer::Voice *QSoundEffectMixer::allocateVoice()
+{
+    Voice *oldest = &m_voices[0];
+    for (int i = 0; i < MaxVoices; ++i) {
+        if (!m_voices[i].isActive())
+            return &m_voices[i];
+        if (m_voices[i].age < oldest->age)
+            oldest = &m_voices[i];
+    }
+
+    // All voices are busy, steal the one that has been playing the longest
+    finishVoice(oldest);
+    return oldest;
+}
+
+void QSoundEffectMixer::finishVoice(Voice *voice)
+{
+    QMetaObject::invokeMethod(this, "notifyFinished", Qt::QueuedConnection,
+                              Q_ARG(int, voice->id), Q_ARG(int, voice->serial));
+    voice->id = 0;
+    voice->data.clear();
+}
+
+void QSoundEffectMixer::mixVoice(Voice *voice, float *mix, int frames)
+{
+    const int frameBytes = m_format.bytesPerFrame();
+    const int channels = m_format.channelCount();
+    const int length = voice->data.size() - voice->data.size() % frameBytes;
+    const bool swap = needsSwap(m_format);
+
+    if (length == 0) {
+        finishVoice(voice);
+        return;
+    }
+
+    while (frames > 0) {
+        const int chunk = qMin(frames, (length - voice->offset) / frameBytes);
+        accumulate(m_format, voice->data.constData() + voice->offset, mix, chunk * channels, voice->volume, swap);
+        mix += chunk * channels;
+        frames -= chunk;
+        voice->offset += chunk * frameBytes;
+
+        if (voice->offset < length)
+            break;
+
+        voice->offset = 0;
+        if (voice->loops == QSoundEffect::Infinite)
+            continue;
+
+        --voice->loops;
+        QMetaObject::invokeMethod(this, "notifyLooped", Qt::QueuedConnection,
+                                  Q_ARG(int, voice->id), Q_ARG(int, voice->serial), Q_ARG(int, voice->loops));
+        if (voice->loops <= 0) {
+            finishVoice(voice);
+            break;
+        }
+    }
+}
+
+qint64 QSoundEffectMixer::readData(char *data, qint64 len)
+{
+    processCommands();
+
+    len = qMin<qint64>(len, m_maxChunk.load());
+
+    const int frameBytes = m_format.bytesPerFrame();
+    const int frames = len / frameBytes;
+    if (frames <= 0)
+        return 0;
+
+    const int samples = frames * m_format.channelCount();
+    if (m_mixBuffer.size() < samples)
+        m_mixBuffer.resize(samples);
+    float *mix = m_mixBuffer.data();
+    memset(mix, 0, samples * sizeof(float));
+
+    for (int i = 0; i < MaxVoices; ++i) {
+        if (m_voices[i].isActive())
+            mixVoice(&m_voices[i], mix, frames);
+    }
+
+    // Silence is written as well, so that the stream keeps running and the
+    // next effect starts within a period.
+    store(m_format, mix, data, samples, needsSwap(m_format));
+    return frames * frameBytes;
+}
+
+// The mix is generated on demand; there is nothing to seek in and no end
+bool QSoundEffectMixer::isSequential() const
+{
+    return true;
+}
+
+qint64 QSoundEffectMixer::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(len)
+    return 0;
+}
+
+void QSoundEffectMixer::notifyLooped(int id, int serial, int loopsRemaining)
+{
+    if (QSoundEffectVoiceObserver *observer = m_observers.value(id))
+        observer->voiceLooped(serial, loopsRemaining);
+}
+
+void QSoundEffectMixer::notifyFinished(int id, int serial)
+{
+    QHash<int, int>::iterator it = m_playingSerials.find(id);
+    if (it != m_playingSerials.end() && it.value() == serial) {
+        m_playingSerials.erase(it);
+        if (m_playingSerials.isEmpty())
+            m_idleTimer.start();
+    }
+
+    if (QSoundEffectVoiceObserver *observer = m_observers.value(id))
+        observer->voiceFinished(serial);
+}
+
+void QSoundEffectMixer::startOutput()
+{
+    if (!m_output) {
+        m_output = new QAudioOutput(m_format, this);
+        connect(m_output, SIGNAL(stateChanged(QAudio::State)),
+                this, SLOT(outputStateChanged(QAudio::State)));
+    }
+
+    if (m_output->state() == QAudio::StoppedState) {
+        m_maxChunk.store(maxChunkFor(m_format, 0));
+        m_output->start(this);
+        m_maxChunk.store(maxChunkFor(m_format, m_output->periodSize()));
+    }
+}
+
+void QSoundEffectMixer::outputStateChanged(QAudio::State state)
+{
+    if (state == QAudio::ActiveState || state == QAudio::IdleState)
+        m_maxChunk.store(maxChunkFor(m_format, m_output->periodSize()));
+}
+
+// Keep at most two periods ahead of the device, anything queued beyond
+// that only adds to the trigger latency.
+int QSoundEffectMixer::maxChunkFor(const QAudioFormat &format, int periodSize)
+{
+    if (periodSize > 0)
+        return 2 * periodSize;
+    return qMax(format.bytesPerFrame(), format.bytesForDuration(FallbackChunkUSecs));
+}
+
+void QSoundEffectMixer::stopIfIdle()
+{
+    if (m_playingSerials.isEmpty() && m_output)
+        m_output->stop();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qsoundeffectmixer_p.cpp"
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSOUNDEFFECTMIXER_P_H
+#define QSOUNDEFFECTMIXER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qiodevice.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qvector.h>
+#include <qaudio.h>
+#include <qaudioformat.h>
+
+QT_BEGIN_NAMESPACE
+
+class QAudioOutput;
+
+class QSoundEffectVoiceObserver
+{
+public:
+    virtual ~QSoundEffectVoiceObserver() {}
+
+    // Both are called in the application thread, with the serial returned by play()
+    virtual void voiceLooped(int serial, int loopsRemaining) = 0;
+    virtual void voiceFinished(int serial) = 0;
+};
+
+// Mixes all sound effects of one audio format into a single QAudioOutput.
+//
+// play(), stop() and friends are only queued from the application thread;
+// the voices themselves are owned by whichever thread the audio backend
+// calls readData() from, which never waits on the application thread.
+class Q_AUTOTEST_EXPORT QSoundEffectMixer : public QIODevice
+{
+    friend class tst_QSoundEffectMixer;
+    Q_OBJECT
+public:
+    enum { MaxVoices = 32 };
+
+    ~QSoundEffectMixer();
+
+    static bool canMix(const QAudioFormat &format);
+    static QSoundEffectMixer *instance(const QAudioFormat &format);
+
+    QAudioFormat format() const { return m_format; }
+
+    int registerObserver(QSoundEffectVoiceObserver *observer);
+    void unregisterObserver(int id);
+
+    int play(int id, const QByteArray &data, qreal volume, int loops);
+    void stop(int id);
+    void setVolume(int id, qreal volume);
+    void setLoopsRemaining(int id, int loops);
+
+    bool isSequential() const;
+
+protected:
+    qint64 readData(char *data, qint64 len);
+    qint64 writeData(const char *data, qint64 len);
+
+private Q_SLOTS:
+    void notifyLooped(int id, int serial, int loopsRemaining);
+    void notifyFinished(int id, int serial);
+    void stopIfIdle();
+    void outputStateChanged(QAudio::State state);
+
+private:
+    explicit QSoundEffectMixer(const QAudioFormat &format);
+
+    struct Command
+    {
+        enum Type { Play, Stop, SetVolume, SetLoops };
+
+        Command() : type(Stop), id(0), serial(0), volume(0), loops(0) {}
+
+        Type type;
+        int id;
+        int serial;
+        float volume;
+        int loops;
+        QByteArray data;
+    };
+
+    struct Voice
+    {
+        Voice() : id(0), serial(0), offset(0), loops(0), volume(0), age(0) {}
+
+        bool isActive() const { return id != 0; }
+
+        int id;
+        int serial;
+        int offset;
+        int loops;
+        float volume;
+        quint64 age;
+        QByteArray data;
+    };
+
+    void enqueue(const Command &command);
+    void processCommands();
+    Voice *findVoice(int id);
+    Voice *allocateVoice();
+    void finishVoice(Voice *voice);
+    void mixVoice(Voice *voice, float *mix, int frames);
+    void startOutput();
+    static int maxChunkFor(const QAudioFormat &format, int periodSize);
+
+    QAudioFormat m_format;
+    QAudioOutput *m_output;
+    QTimer m_idleTimer;
+
+    // Application thread
+    QHash<int, QSoundEffectVoiceObserver *> m_observers;
+    QHash<int, int> m_playingSerials;
+    int m_nextId;
+    int m_nextSerial;
+
+    // Single consumer ring of commands, producers are serialized by m_producerMutex
+    QVector<Command> m_commands;
+    QAtomicInt m_commandRead;
+    QAtomicInt m_commandWrite;
+    QMutex m_producerMutex;
+    QAtomicInt m_maxChunk;
+
+    // Mixing thread
+    Voice m_voices[MaxVoices];
+    QVector<float> m_mixBuffer;
+    quint64 m_voiceAge;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSOUNDEFFECTMIXER_P_H
@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGSTAUDIOBUFFER_P_H
+#define QGSTAUDIOBUFFER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qaudiobuffer_p.h>
+#include <qaudioformat.h>
+
+#include <gst/gst.h>
+
+QT_BEGIN_NAMESPACE
+
+// Hands the samples of a GstBuffer to QAudioBuffer without copying them.
+// The buffer stays referenced for as long as the QAudioBuffer is around.
+class QGstAudioBuffer : public QAbstractAudioBuffer
+{
+public:
+    QGstAudioBuffer(GstBuffer *buffer, const QAudioFormat &format, qint64 startTime = -1);
+    ~QGstAudioBuffer();
+
+    void release();
+
+    QAudioFormat format() const;
+    qint64 startTime() const;
+    int frameCount() const;
+
+    void *constData() const;
+
+    void *writableData();
+    QAbstractAudioBuffer *clone() const;
+
+private:
+    GstBuffer *m_buffer;
+    QAudioFormat m_format;
+    qint64 m_startTime;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -44,8 +44,8 @@
 
 #include <gst/gst.h>
 #include <qmediaaudioprobecontrol.h>
-#include <QtCore/qmutex.h>
 #include <qaudiobuffer.h>
+#include "qgstreamerprobequeue_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -58,12 +58,13 @@ public:
 
     void bufferProbed(GstBuffer* buffer);
 
+    quint64 droppedCount() const;
+
 private slots:
     void bufferProbed();
 
 private:
-    QAudioBuffer m_pendingBuffer;
-    QMutex m_bufferMutex;
+    QGstreamerProbeQueue<QAudioBuffer> m_queue;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,224 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGSTREAMERPROBEQUEUE_P_H
+#define QGSTREAMERPROBEQUEUE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qwaitcondition.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QGstreamerProbeQueueSettings
+{
+    enum Policy {
+        DropOldest,
+        DropNewest,
+        Block,      // Stall the streaming thread for up to blockTimeout ms, then drop the newest
+        Unbounded   // Never drop, grow beyond capacity as needed
+    };
+
+    QGstreamerProbeQueueSettings(Policy policy = DropOldest, int capacity = 1, int blockTimeout = 0)
+        : policy(policy), capacity(capacity), blockTimeout(blockTimeout) {}
+
+    // Reads "<drop-oldest|drop-newest|block|unbounded>[:<capacity>[:<timeout ms>]]"
+    // from the given environment variable, anything missing is taken from
+    // defaults.
+    static QGstreamerProbeQueueSettings fromEnvironment(const char *variable,
+                                                        const QGstreamerProbeQueueSettings &defaults);
+
+    Policy policy;
+    int capacity;
+    int blockTimeout;
+};
+
+// Bounded queue between a streaming thread (enqueue) and the thread the
+// probe control lives in (takeAll). enqueue() only asks for a wake-up when
+// the consumer has drained everything since the last one, so a burst of
+// buffers costs a single queued call.
+template <typename T>
+class QGstreamerProbeQueue
+{
+public:
+    explicit QGstreamerProbeQueue(const QGstreamerProbeQueueSettings &settings)
+        : m_head(0)
+        , m_count(0)
+        , m_wakeupPending(false)
+        , m_dropped(0)
+    {
+        setSettings(settings);
+    }
+
+    QGstreamerProbeQueueSettings settings() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_settings;
+    }
+
+    // Drops anything still queued
+    void setSettings(const QGstreamerProbeQueueSettings &settings)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_settings = settings;
+        m_settings.capacity = qMax(1, settings.capacity);
+        m_settings.blockTimeout = qMax(0, settings.blockTimeout);
+        m_items.clear();
+        m_items.resize(m_settings.capacity);
+        m_head = 0;
+        m_count = 0;
+        m_notFull.wakeAll();
+    }
+
+    // Returns true if the caller has to wake up the consumer
+    bool enqueue(const T &item)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_count == m_items.size()) {
+            switch (m_settings.policy) {
+            case QGstreamerProbeQueueSettings::DropOldest:
+                m_items[m_head] = T();
+                m_head = (m_head + 1) % m_items.size();
+                --m_count;
+                ++m_dropped;
+                break;
+            case QGstreamerProbeQueueSettings::DropNewest:
+                ++m_dropped;
+                return false;
+            case QGstreamerProbeQueueSettings::Block: {
+                QElapsedTimer timer;
+                timer.start();
+                qint64 remaining = m_settings.blockTimeout;
+                while (m_count == m_items.size() && remaining > 0) {
+                    m_notFull.wait(&m_mutex, remaining);
+                    remaining = m_settings.blockTimeout - timer.elapsed();
+                }
+                if (m_count == m_items.size()) {
+                    ++m_dropped;
+                    return false;
+                }
+                break;
+            }
+            case QGstreamerProbeQueueSettings::Unbounded:
+                grow();
+                break;
+            }
+        }
+
+        m_items[(m_head + m_count) % m_items.size()] = item;
+        ++m_count;
+
+        if (m_wakeupPending)
+            return false;
+        m_wakeupPending = true;
+        return true;
+    }
+
+    // Moves everything queued so far into items, in order
+    void takeAll(QVector<T> *items)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        m_wakeupPending = false;
+        items->reserve(items->size() + m_count);
+        for (; m_count > 0; --m_count) {
+            items->append(m_items[m_head]);
+            m_items[m_head] = T();
+            m_head = (m_head + 1) % m_items.size();
+        }
+        m_head = 0;
+        m_notFull.wakeAll();
+    }
+
+    // Also gives back whatever an unbounded queue grew to
+    void clear()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_items.clear();
+        m_items.resize(m_settings.capacity);
+        m_head = 0;
+        m_count = 0;
+        m_notFull.wakeAll();
+    }
+
+    quint64 droppedCount() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_dropped;
+    }
+
+private:
+    // Doubles the ring, unwrapping it so that the head is at 0 again
+    void grow()
+    {
+        QVector<T> items(m_items.size() * 2);
+        for (int i = 0; i < m_count; ++i)
+            items[i] = m_items[(m_head + i) % m_items.size()];
+        m_items.swap(items);
+        m_head = 0;
+    }
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_notFull;
+    QGstreamerProbeQueueSettings m_settings;
+    QVector<T> m_items;
+    int m_head;
+    int m_count;
+    bool m_wakeupPending;
+    quint64 m_dropped;
+};
+
+QT_END_NAMESPACE
+
+#endif
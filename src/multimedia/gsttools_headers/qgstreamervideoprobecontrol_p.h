@@ -44,8 +44,8 @@
 
 #include <gst/gst.h>
 #include <qmediavideoprobecontrol.h>
-#include <QtCore/qmutex.h>
 #include <qvideoframe.h>
+#include "qgstreamerprobequeue_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -60,14 +60,15 @@ public:
     void startFlushing();
     void stopFlushing();
 
+    quint64 droppedCount() const;
+
 private slots:
     void frameProbed();
 
 private:
     bool m_flushing;
     bool m_frameProbed; // true if at least one frame was probed
-    QVideoFrame m_pendingFrame;
-    QMutex m_frameMutex;
+    QGstreamerProbeQueue<QVideoFrame> m_queue;
 };
 
 QT_END_NAMESPACE
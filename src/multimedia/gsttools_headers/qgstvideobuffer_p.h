@@ -60,23 +60,39 @@
 
 QT_BEGIN_NAMESPACE
 
-class QGstVideoBuffer : public QAbstractVideoBuffer
+class QGstVideoBuffer : public QAbstractPlanarVideoBuffer
 {
 public:
+    // Where the planes of a planar format start and how they are strided,
+    // as laid out by GStreamer for the negotiated caps.
+    struct PlaneLayout
+    {
+        PlaneLayout() : planeCount(0), size(0) {}
+
+        int planeCount;
+        int bytesPerLine[4];
+        int offsets[4];
+        int size;
+    };
+
     QGstVideoBuffer(GstBuffer *buffer, int bytesPerLine);
     QGstVideoBuffer(GstBuffer *buffer, int bytesPerLine,
                     HandleType handleType, const QVariant &handle);
     ~QGstVideoBuffer();
 
+    static PlaneLayout planeLayoutForCaps(GstCaps *caps);
+    void setPlaneLayout(const PlaneLayout &layout) { m_planeLayout = layout; }
+
     MapMode mapMode() const;
 
-    uchar *map(MapMode mode, int *numBytes, int *bytesPerLine);
+    int mapPlanes(MapMode mode, int *numBytes, int bytesPerLine[4], uchar *data[4]);
     void unmap();
 
     QVariant handle() const { return m_handle; }
 private:
     GstBuffer *m_buffer;
     int m_bytesPerLine;
+    PlaneLayout m_planeLayout;
     MapMode m_mode;
     QVariant m_handle;
 };
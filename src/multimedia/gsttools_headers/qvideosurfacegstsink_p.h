@@ -55,6 +55,7 @@
 
 #include <gst/video/gstvideosink.h>
 
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qqueue.h>
@@ -65,6 +66,7 @@
 #include <qabstractvideobuffer.h>
 
 #include "qgstbufferpoolinterface_p.h"
+#include "qgstvideobuffer_p.h"
 
 QT_BEGIN_NAMESPACE
 class QAbstractVideoSurface;
@@ -81,7 +83,8 @@ public:
 
     QVideoSurfaceFormat surfaceFormat() const;
 
-    bool start(const QVideoSurfaceFormat &format, int bytesPerLine);
+    bool start(const QVideoSurfaceFormat &format, int bytesPerLine,
+               const QGstVideoBuffer::PlaneLayout &planeLayout = QGstVideoBuffer::PlaneLayout());
     void stop();
 
     bool isActive();
@@ -95,6 +98,14 @@ public:
     GstBuffer *lastPrerolledBuffer() const { return m_lastPrerolledBuffer; }
     void setLastPrerolledBuffer(GstBuffer *lastPrerolledBuffer); // set prerolledBuffer to 0 to discard prerolled buffer
 
+    // QoS messages and events are sent on behalf of this element
+    void setSink(GstElement *sink) { m_sink = sink; }
+
+    // Asynchronous presentation statistics, also reported in QoS messages
+    quint64 renderedFrames() const;
+    quint64 droppedFrames() const;
+    quint64 lateFrames() const;
+
 private slots:
     void queuedStart();
     void queuedStop();
@@ -103,6 +114,21 @@ private slots:
     void updateSupportedFormats();
 
 private:
+    // Collected under m_mutex, sent after it is released
+    struct QosReport
+    {
+        qint64 startTime;
+        qint64 endTime;
+        qint64 jitter;
+        bool late;
+        quint64 renderedFrames;
+        quint64 droppedFrames;
+    };
+
+    GstFlowReturn presentFrame(const QVideoFrame &frame);
+    QosReport qosReport(qint64 startTime, qint64 endTime, qint64 jitter, bool late) const;
+    void postQos(const QosReport &report);
+
     QPointer<QAbstractVideoSurface> m_surface;
     QList<QVideoFrame::PixelFormat> m_supportedPixelFormats;
     //pixel formats of buffers pool native type
@@ -110,7 +136,7 @@ private:
     QGstBufferPoolInterface *m_pool;
     QList<QGstBufferPoolInterface *> m_pools;
     QMutex m_poolMutex;
-    QMutex m_mutex;
+    mutable QMutex m_mutex;
     QWaitCondition m_setupCondition;
     QWaitCondition m_renderCondition;
     QVideoSurfaceFormat m_format;
@@ -119,8 +145,24 @@ private:
     // this pointer is not 0 when there is a prerolled buffer waiting to be displayed
     GstBuffer *m_lastPrerolledBuffer;
     int m_bytesPerLine;
+    QGstVideoBuffer::PlaneLayout m_planeLayout;
     bool m_started;
     bool m_startCanceled;
+
+    // Asynchronous presentation: render() leaves the newest frame here and
+    // returns, the GUI thread presents it on its next turn.
+    bool m_asyncRender;
+    bool m_renderQueued;
+    QVideoFrame m_pendingFrame;
+    QElapsedTimer m_pendingSince;
+    GstElement *m_sink;
+    quint64 m_renderedFrames;
+    quint64 m_droppedFrames;
+    quint64 m_lateFrames;
+    quint64 m_reportedLateFrames;
+    qint64 m_lastLateStartTime;
+    qint64 m_lastLateEndTime;
+    qint64 m_lastLateness;
 };
 
 class QVideoSurfaceGstSink
@@ -1,6 +1,8 @@
 TARGET = QtMultimedia
 QT = core-private network gui-private
 
+CONFIG += simd
+
 MODULE_PLUGIN_TYPES = \
     mediaservice \
     audio \
@@ -22,7 +24,8 @@ PRIVATE_HEADERS += \
     qmediaresourcepolicyplugin_p.h \
     qmediaresourcepolicy_p.h \
     qmediaresourceset_p.h \
-    qmediastoragelocation_p.h
+    qmediastoragelocation_p.h \
+    qmultimediaenvironment_p.h
 
 PUBLIC_HEADERS += \
     qmediabindableinterface.h \
@@ -49,7 +52,8 @@ SOURCES += \
     qmediaresourcepolicy_p.cpp \
     qmediaresourceset_p.cpp \
     qmediastoragelocation.cpp \
-    qmultimedia.cpp
+    qmultimedia.cpp \
+    qmultimediaenvironment.cpp
 
 include(audio/audio.pri)
 include(camera/camera.pri)
@@ -254,6 +254,7 @@ public:
     QPlaylistFileParserPrivate()
         : m_source(0)
         , m_scanIndex(0)
+        , m_bytesParsed(0)
         , m_utf8(false)
         , m_lineIndex(-1)
         , m_type(QPlaylistFileParser::UNKNOWN)
@@ -269,6 +270,7 @@ public:
     QNetworkReply  *m_source;
     QByteArray      m_buffer;
     int             m_scanIndex;
+    qint64          m_bytesParsed;
     QUrl            m_root;
     bool            m_utf8;
     int             m_lineIndex;
@@ -339,7 +341,9 @@ void QPlaylistFileParserPrivate::_q_handleData()
     while (m_source->bytesAvailable()) {
         int expectedBytes = qMin(READ_LIMIT, int(qMin(m_source->bytesAvailable(),
                                                       qint64(LINE_LIMIT - m_buffer.size()))));
-        m_buffer.push_back(m_source->read(expectedBytes));
+        const QByteArray data = m_source->read(expectedBytes);
+        m_buffer.push_back(data);
+        m_bytesParsed += data.size();
         int processedBytes = 0;
         while (m_scanIndex < m_buffer.length()) {
             char s = m_buffer[m_scanIndex];
@@ -383,7 +387,16 @@ void QPlaylistFileParserPrivate::_q_handleData()
         m_scanIndex = 0;
     }
 
-    if (m_source->isFinished()) {
+    if (!m_source)
+        return;
+
+    // Everything that arrived so far has been parsed, let listeners act on
+    // the items of this chunk together.
+    bool ok = false;
+    qint64 bytesTotal = m_source->header(QNetworkRequest::ContentLengthHeader).toLongLong(&ok);
+    emit q->loadProgress(m_bytesParsed, ok ? bytesTotal : qint64(-1));
+
+    if (m_source && m_source->isFinished()) {
         _q_handleParserFinished();
     }
 }
@@ -510,6 +523,7 @@ void QPlaylistFileParser::stop()
 
     d->m_buffer.clear();
     d->m_scanIndex = 0;
+    d->m_bytesParsed = 0;
     d->m_lineIndex = -1;
     if (d->m_source) {
         disconnect(d->m_source, SIGNAL(readyRead()), this, SLOT(_q_handleData()));
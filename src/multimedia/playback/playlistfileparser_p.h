@@ -89,6 +89,7 @@ public:
 
 Q_SIGNALS:
     void newItem(const QVariant& content);
+    void loadProgress(qint64 bytesParsed, qint64 bytesTotal);
     void finished();
     void error(QPlaylistFileParser::ParserError err, const QString& errorMsg);
 
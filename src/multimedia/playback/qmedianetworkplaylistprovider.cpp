@@ -53,11 +53,16 @@ class QMediaNetworkPlaylistProviderPrivate: public QMediaPlaylistProviderPrivate
 public:
     bool load(const QNetworkRequest &request);
 
+    void appendPendingItems();
+
     QPlaylistFileParser parser;
     QList<QMediaContent> resources;
+    QList<QMediaContent> pendingItems;
 
     void _q_handleParserError(QPlaylistFileParser::ParserError err, const QString &);
     void _q_handleNewItem(const QVariant& content);
+    void _q_handleLoadProgress(qint64 bytesParsed, qint64 bytesTotal);
+    void _q_handleParserFinished();
 
     QMediaNetworkPlaylistProvider *q_ptr;
 };
@@ -65,11 +70,31 @@ public:
 bool QMediaNetworkPlaylistProviderPrivate::load(const QNetworkRequest &request)
 {
     parser.stop();
+    appendPendingItems();
     parser.start(request, false);
 
     return true;
 }
 
+// Items are collected while the parser works through a chunk of the
+// playlist and are then appended with a single insertion, a large playlist
+// would otherwise cost a pair of signals per entry.
+void QMediaNetworkPlaylistProviderPrivate::appendPendingItems()
+{
+    Q_Q(QMediaNetworkPlaylistProvider);
+
+    if (pendingItems.isEmpty())
+        return;
+
+    const int pos = resources.count();
+    const int end = pos + pendingItems.count() - 1;
+
+    emit q->mediaAboutToBeInserted(pos, end);
+    resources.append(pendingItems);
+    pendingItems.clear();
+    emit q->mediaInserted(pos, end);
+}
+
 void QMediaNetworkPlaylistProviderPrivate::_q_handleParserError(QPlaylistFileParser::ParserError err, const QString &errorMessage)
 {
     Q_Q(QMediaNetworkPlaylistProvider);
@@ -91,14 +116,13 @@ void QMediaNetworkPlaylistProviderPrivate::_q_handleParserError(QPlaylistFilePar
     }
 
     parser.stop();
+    appendPendingItems();
 
     emit q->loadFailed(playlistError, errorMessage);
 }
 
 void QMediaNetworkPlaylistProviderPrivate::_q_handleNewItem(const QVariant& content)
 {
-    Q_Q(QMediaNetworkPlaylistProvider);
-
     QUrl url;
     if (content.type() == QVariant::Url) {
         url = content.toUrl();
@@ -108,7 +132,25 @@ void QMediaNetworkPlaylistProviderPrivate::_q_handleNewItem(const QVariant& cont
         return;
     }
 
-    q->addMedia(QMediaContent(url));
+    pendingItems.append(QMediaContent(url));
+}
+
+void QMediaNetworkPlaylistProviderPrivate::_q_handleLoadProgress(qint64 bytesParsed, qint64 bytesTotal)
+{
+    Q_Q(QMediaNetworkPlaylistProvider);
+
+    appendPendingItems();
+
+    emit q->loadProgress(bytesParsed, bytesTotal);
+}
+
+void QMediaNetworkPlaylistProviderPrivate::_q_handleParserFinished()
+{
+    Q_Q(QMediaNetworkPlaylistProvider);
+
+    appendPendingItems();
+
+    emit q->loaded();
 }
 
 QMediaNetworkPlaylistProvider::QMediaNetworkPlaylistProvider(QObject *parent)
@@ -117,7 +159,9 @@ QMediaNetworkPlaylistProvider::QMediaNetworkPlaylistProvider(QObject *parent)
     d_func()->q_ptr = this;
     connect(&d_func()->parser, SIGNAL(newItem(QVariant)),
             this, SLOT(_q_handleNewItem(QVariant)));
-    connect(&d_func()->parser, SIGNAL(finished()), this, SIGNAL(loaded()));
+    connect(&d_func()->parser, SIGNAL(loadProgress(qint64,qint64)),
+            this, SLOT(_q_handleLoadProgress(qint64,qint64)));
+    connect(&d_func()->parser, SIGNAL(finished()), this, SLOT(_q_handleParserFinished()));
     connect(&d_func()->parser, SIGNAL(error(QPlaylistFileParser::ParserError,QString)),
             this, SLOT(_q_handleParserError(QPlaylistFileParser::ParserError,QString)));
 }
@@ -150,6 +194,7 @@ QMediaContent QMediaNetworkPlaylistProvider::media(int pos) const
 bool QMediaNetworkPlaylistProvider::addMedia(const QMediaContent &content)
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
 
     int pos = d->resources.count();
 
@@ -163,6 +208,7 @@ bool QMediaNetworkPlaylistProvider::addMedia(const QMediaContent &content)
 bool QMediaNetworkPlaylistProvider::addMedia(const QList<QMediaContent> &items)
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
 
     if (items.isEmpty())
         return true;
@@ -181,6 +227,7 @@ bool QMediaNetworkPlaylistProvider::addMedia(const QList<QMediaContent> &items)
 bool QMediaNetworkPlaylistProvider::insertMedia(int pos, const QMediaContent &content)
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
 
     emit mediaAboutToBeInserted(pos, pos);
     d->resources.insert(pos, content);
@@ -192,6 +239,7 @@ bool QMediaNetworkPlaylistProvider::insertMedia(int pos, const QMediaContent &co
 bool QMediaNetworkPlaylistProvider::insertMedia(int pos, const QList<QMediaContent> &items)
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
 
     if (items.isEmpty())
         return true;
@@ -209,6 +257,7 @@ bool QMediaNetworkPlaylistProvider::insertMedia(int pos, const QList<QMediaConte
 bool QMediaNetworkPlaylistProvider::removeMedia(int fromPos, int toPos)
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
 
     Q_ASSERT(fromPos >= 0);
     Q_ASSERT(fromPos <= toPos);
@@ -224,6 +273,7 @@ bool QMediaNetworkPlaylistProvider::removeMedia(int fromPos, int toPos)
 bool QMediaNetworkPlaylistProvider::removeMedia(int pos)
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
 
     emit mediaAboutToBeRemoved(pos, pos);
     d->resources.removeAt(pos);
@@ -235,6 +285,7 @@ bool QMediaNetworkPlaylistProvider::removeMedia(int pos)
 bool QMediaNetworkPlaylistProvider::clear()
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
     if (!d->resources.isEmpty()) {
         int lastPos = mediaCount()-1;
         emit mediaAboutToBeRemoved(0, lastPos);
@@ -248,6 +299,7 @@ bool QMediaNetworkPlaylistProvider::clear()
 void QMediaNetworkPlaylistProvider::shuffle()
 {
     Q_D(QMediaNetworkPlaylistProvider);
+    d->appendPendingItems();
     if (!d->resources.isEmpty()) {
         QList<QMediaContent> resources;
 
@@ -89,6 +89,8 @@ private:
     Q_DECLARE_PRIVATE(QMediaNetworkPlaylistProvider)
     Q_PRIVATE_SLOT(d_func(), void _q_handleParserError(QPlaylistFileParser::ParserError err, const QString &))
     Q_PRIVATE_SLOT(d_func(), void _q_handleNewItem(const QVariant& content))
+    Q_PRIVATE_SLOT(d_func(), void _q_handleLoadProgress(qint64, qint64))
+    Q_PRIVATE_SLOT(d_func(), void _q_handleParserFinished())
 };
 
 QT_END_NAMESPACE
@@ -190,6 +190,8 @@ bool QMediaPlaylist::setMediaObject(QMediaObject *mediaObject)
             disconnect(playlist, SIGNAL(mediaRemoved(int,int)), this, SIGNAL(mediaRemoved(int,int)));
 
             disconnect(playlist, SIGNAL(loaded()), this, SIGNAL(loaded()));
+            disconnect(playlist, SIGNAL(loadProgress(qint64,qint64)),
+                       this, SIGNAL(loadProgress(qint64,qint64)));
 
             disconnect(d->control, SIGNAL(playbackModeChanged(QMediaPlaylist::PlaybackMode)),
                     this, SIGNAL(playbackModeChanged(QMediaPlaylist::PlaybackMode)));
@@ -214,6 +216,8 @@ bool QMediaPlaylist::setMediaObject(QMediaObject *mediaObject)
         connect(playlist, SIGNAL(mediaRemoved(int,int)), this, SIGNAL(mediaRemoved(int,int)));
 
         connect(playlist, SIGNAL(loaded()), this, SIGNAL(loaded()));
+        connect(playlist, SIGNAL(loadProgress(qint64,qint64)),
+                this, SIGNAL(loadProgress(qint64,qint64)));
 
         connect(d->control, SIGNAL(playbackModeChanged(QMediaPlaylist::PlaybackMode)),
                 this, SIGNAL(playbackModeChanged(QMediaPlaylist::PlaybackMode)));
@@ -415,8 +419,12 @@ bool QMediaPlaylist::clear()
 
 bool QMediaPlaylistPrivate::readItems(QMediaPlaylistReader *reader)
 {
+    QList<QMediaContent> items;
     while (!reader->atEnd())
-        playlist()->addMedia(reader->readItem());
+        items.append(reader->readItem());
+
+    // Insert everything at once rather than signalling every item.
+    playlist()->addMedia(items);
 
     return true;
 }
@@ -435,7 +443,8 @@ bool QMediaPlaylistPrivate::writeItems(QMediaPlaylistWriter *writer)
   Load playlist using network \a request. If \a format is specified, it is used,
   otherwise format is guessed from playlist name and data.
 
-  New items are appended to playlist.
+  New items are appended to playlist. While the playlist is parsed, loadProgress()
+  is emitted and the items parsed so far are inserted.
 
   QMediaPlaylist::loaded() signal is emitted if playlist was loaded successfully,
   otherwise the playlist emits loadFailed().
@@ -481,7 +490,8 @@ void QMediaPlaylist::load(const QNetworkRequest &request, const char *format)
   Load playlist from \a location. If \a format is specified, it is used,
   otherwise format is guessed from location name and data.
 
-  New items are appended to playlist.
+  New items are appended to playlist. While the playlist is parsed, loadProgress()
+  is emitted and the items parsed so far are inserted.
 
   QMediaPlaylist::loaded() signal is emitted if playlist was loaded successfully,
   otherwise the playlist emits loadFailed().
@@ -715,6 +725,19 @@ void QMediaPlaylist::setCurrentIndex(int playlistPosition)
     Signal emitted when playlist finished loading.
 */
 
+/*!
+    \fn QMediaPlaylist::loadProgress(qint64 bytesReceived, qint64 bytesTotal)
+
+    Signal emitted while a playlist is loaded from a network request or a
+    location.  \a bytesReceived bytes of the \a bytesTotal bytes long
+    playlist have been parsed, \a bytesTotal is -1 if the size is not known.
+
+    Items are inserted in batches as the playlist is parsed, so a single
+    mediaInserted() signal may cover many items.
+
+    \since 5.4
+*/
+
 /*!
     \fn QMediaPlaylist::loadFailed()
 
@@ -298,6 +298,14 @@ void QMediaPlaylistProvider::shuffle()
     Signals that a load() finished successfully.
 */
 
+/*!
+    \fn void QMediaPlaylistProvider::loadProgress(qint64 bytesReceived, qint64 bytesTotal)
+
+    Signals that a load() has processed \a bytesReceived bytes of a playlist
+    that is \a bytesTotal bytes long, or -1 if the size is not known.  Items
+    parsed from the data received so far have been inserted.
+*/
+
 /*!
     \fn void QMediaPlaylistProvider::loadFailed(QMediaPlaylist::Error error, const QString& errorMessage)
 
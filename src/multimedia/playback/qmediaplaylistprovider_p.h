@@ -106,6 +106,7 @@ Q_SIGNALS:
     void mediaChanged(int start, int end);
 
     void loaded();
+    void loadProgress(qint64 bytesReceived, qint64 bytesTotal);
     void loadFailed(QMediaPlaylist::Error, const QString& errorMessage);
 
 protected:
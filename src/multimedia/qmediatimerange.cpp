@@ -41,6 +41,8 @@
 
 #include <QtCore/qdebug.h>
 
+#include <algorithm>
+
 #include "qmediatimerange.h"
 
 QT_BEGIN_NAMESPACE
@@ -210,14 +212,15 @@ bool operator!=(const QMediaTimeInterval &a, const QMediaTimeInterval &b)
 class QMediaTimeRangePrivate : public QSharedData
 {
 public:
-
     QMediaTimeRangePrivate();
     QMediaTimeRangePrivate(const QMediaTimeRangePrivate &other);
     QMediaTimeRangePrivate(const QMediaTimeInterval &interval);
 
+    // Sorted by start time, disjoint and never adjacent.
     QList<QMediaTimeInterval> intervals;
 
     void addInterval(const QMediaTimeInterval &interval);
+    void addSortedIntervals(const QList<QMediaTimeInterval> &sorted);
     void removeInterval(const QMediaTimeInterval &interval);
 };
 
@@ -241,36 +244,79 @@ QMediaTimeRangePrivate::QMediaTimeRangePrivate(const QMediaTimeInterval &interva
         intervals << interval;
 }
 
+// Comparators for the binary searches over the sorted intervals.  Since the
+// intervals are disjoint both their start and their end times are ascending.
+static bool endsBeforeAdjacent(const QMediaTimeInterval &interval, qint64 time)
+{
+    return interval.end() < time - 1;
+}
+
+static bool startsAfterAdjacent(qint64 time, const QMediaTimeInterval &interval)
+{
+    return time < interval.start() - 1;
+}
+
+static bool endsBefore(const QMediaTimeInterval &interval, qint64 time)
+{
+    return interval.end() < time;
+}
+
+static bool startsAfter(qint64 time, const QMediaTimeInterval &interval)
+{
+    return time < interval.start();
+}
+
+static bool startsBefore(const QMediaTimeInterval &a, const QMediaTimeInterval &b)
+{
+    return a.start() < b.start();
+}
+
 void QMediaTimeRangePrivate::addInterval(const QMediaTimeInterval &interval)
 {
     // Handle normalized intervals only
     if(!interval.isNormal())
         return;
 
-    // Find a place to insert the interval
-    int i;
-    for (i = 0; i < intervals.count(); i++) {
-        // Insert before this element
-        if(interval.s < intervals[i].s) {
-            intervals.insert(i, interval);
-            break;
-        }
+    // The intervals in [first, last) overlap or touch the new one.
+    QList<QMediaTimeInterval>::iterator first =
+            std::lower_bound(intervals.begin(), intervals.end(), interval.s, endsBeforeAdjacent);
+    QList<QMediaTimeInterval>::iterator last =
+            std::upper_bound(first, intervals.end(), interval.e, startsAfterAdjacent);
+
+    if (first == last) {
+        intervals.insert(first, interval);
+        return;
     }
 
-    // Interval needs to be added to the end of the list
-    if (i == intervals.count())
-        intervals.append(interval);
+    // Merge them all into the first one
+    first->s = qMin(first->s, interval.s);
+    first->e = qMax((last - 1)->e, interval.e);
+    intervals.erase(first + 1, last);
+}
+
+// Merges intervals sorted by start time, which may overlap each other, with
+// the current ones in a single pass.
+void QMediaTimeRangePrivate::addSortedIntervals(const QList<QMediaTimeInterval> &sorted)
+{
+    if (sorted.isEmpty())
+        return;
+
+    QList<QMediaTimeInterval> merged;
+    merged.reserve(intervals.count() + sorted.count());
 
-    // Do we need to correct the element before us?
-    if(i > 0 && intervals[i - 1].e >= interval.s - 1)
-        i--;
+    QList<QMediaTimeInterval>::const_iterator a = intervals.constBegin();
+    QList<QMediaTimeInterval>::const_iterator b = sorted.constBegin();
+    while (a != intervals.constEnd() || b != sorted.constEnd()) {
+        const QMediaTimeInterval &next = (b == sorted.constEnd()
+                                          || (a != intervals.constEnd() && a->s <= b->s)) ? *a++ : *b++;
 
-    // Merge trailing ranges
-    while (i < intervals.count() - 1
-          && intervals[i].e >= intervals[i + 1].s - 1) {
-        intervals[i].e = qMax(intervals[i].e, intervals[i + 1].e);
-        intervals.removeAt(i + 1);
+        if (!merged.isEmpty() && merged.last().e >= next.s - 1)
+            merged.last().e = qMax(merged.last().e, next.e);
+        else
+            merged.append(next);
     }
+
+    intervals.swap(merged);
 }
 
 void QMediaTimeRangePrivate::removeInterval(const QMediaTimeInterval &interval)
@@ -279,33 +325,32 @@ void QMediaTimeRangePrivate::removeInterval(const QMediaTimeInterval &interval)
     if(!interval.isNormal())
         return;
 
-    for (int i = 0; i < intervals.count(); i++) {
-        QMediaTimeInterval r = intervals[i];
-
-        if (r.e < interval.s) {
-            // Before the removal interval
-            continue;
-        } else if (interval.e < r.s) {
-            // After the removal interval - stop here
-            break;
-        } else if (r.s < interval.s && interval.e < r.e) {
-            // Split case - a single range has a chunk removed
-            intervals[i].e = interval.s -1;
-            addInterval(QMediaTimeInterval(interval.e + 1, r.e));
-            break;
-        } else if (r.s < interval.s) {
-            // Trimming Tail Case
-            intervals[i].e = interval.s - 1;
-        } else if (interval.e < r.e) {
-            // Trimming Head Case - we can stop after this
-            intervals[i].s = interval.e + 1;
-            break;
-        } else {
-            // Complete coverage case
-            intervals.removeAt(i);
-            --i;
-        }
+    // The intervals in [first, last) overlap the removed one.
+    const int first = std::lower_bound(intervals.constBegin(), intervals.constEnd(),
+                                       interval.s, endsBefore) - intervals.constBegin();
+    const int last = std::upper_bound(intervals.constBegin() + first, intervals.constEnd(),
+                                      interval.e, startsAfter) - intervals.constBegin();
+
+    if (first == last)
+        return;
+
+    // What is left of the first and last of them
+    const QMediaTimeInterval head(intervals.at(first).s, interval.s - 1);
+    const QMediaTimeInterval tail(interval.e + 1, intervals.at(last - 1).e);
+
+    int i = first;
+    if (head.isNormal())
+        intervals[i++] = head;
+
+    if (tail.isNormal()) {
+        if (i < last)
+            intervals[i++] = tail;
+        else
+            intervals.insert(i++, tail); // Split case - a single range has a chunk removed
     }
+
+    if (i < last)
+        intervals.erase(intervals.begin() + i, intervals.begin() + last);
 }
 
 /*!
@@ -478,7 +523,9 @@ void QMediaTimeRange::addInterval(qint64 start, qint64 end)
     If the specified interval is adjacent to, or overlaps existing
     intervals within the time range, these intervals will be merged.
 
-    This operation takes linear time.
+    The position of the interval is found in logarithmic time, although
+    inserting it or merging it with its neighbours may still take linear time.
+    Use addIntervals() to add many intervals at once.
 
     \sa removeInterval()
 */
@@ -487,6 +534,33 @@ void QMediaTimeRange::addInterval(const QMediaTimeInterval &interval)
     d->addInterval(interval);
 }
 
+/*!
+    \fn QMediaTimeRange::addIntervals(const QList<QMediaTimeInterval> &intervals)
+    \since 5.4
+
+    Adds each of the \a intervals to the time range.
+
+    Equivalent to calling addInterval() for each interval in \a intervals,
+    but the intervals are sorted and merged in a single pass, which is
+    considerably faster when adding many intervals at once. The intervals do
+    not need to be sorted and may overlap each other.
+
+    \sa addInterval(), addTimeRange()
+*/
+void QMediaTimeRange::addIntervals(const QList<QMediaTimeInterval> &intervals)
+{
+    QList<QMediaTimeInterval> sorted;
+    sorted.reserve(intervals.count());
+    foreach (const QMediaTimeInterval &i, intervals) {
+        // Handle normalized intervals only
+        if (i.isNormal())
+            sorted.append(i);
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(), startsBefore);
+    d->addSortedIntervals(sorted);
+}
+
 /*!
     \fn QMediaTimeRange::addTimeRange(const QMediaTimeRange &range)
 
@@ -496,9 +570,8 @@ void QMediaTimeRange::addInterval(const QMediaTimeInterval &interval)
 */
 void QMediaTimeRange::addTimeRange(const QMediaTimeRange &range)
 {
-    foreach(const QMediaTimeInterval &i, range.intervals()) {
-        d->addInterval(i);
-    }
+    // The intervals of a range are already sorted
+    d->addSortedIntervals(range.d->intervals);
 }
 
 /*!
@@ -646,15 +719,11 @@ bool QMediaTimeRange::isContinuous() const
 */
 bool QMediaTimeRange::contains(qint64 time) const
 {
-    for (int i = 0; i < d->intervals.count(); i++) {
-        if (d->intervals[i].contains(time))
-            return true;
-
-        if (time < d->intervals[i].s)
-            break;
-    }
+    // The last interval starting at or before time is the only candidate
+    QList<QMediaTimeInterval>::const_iterator it =
+            std::upper_bound(d->intervals.constBegin(), d->intervals.constEnd(), time, startsAfter);
 
-    return false;
+    return it != d->intervals.constBegin() && (it - 1)->e >= time;
 }
 
 /*!
@@ -665,16 +734,7 @@ bool QMediaTimeRange::contains(qint64 time) const
 */
 bool operator==(const QMediaTimeRange &a, const QMediaTimeRange &b)
 {
-    if (a.intervals().count() != b.intervals().count())
-        return false;
-
-    for (int i = 0; i < a.intervals().count(); i++)
-    {
-        if(a.intervals()[i] != b.intervals()[i])
-            return false;
-    }
-
-    return true;
+    return a.intervals() == b.intervals();
 }
 
 /*!
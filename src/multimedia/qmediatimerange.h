@@ -102,6 +102,7 @@ public:
 
     void addInterval(qint64 start, qint64 end);
     void addInterval(const QMediaTimeInterval &interval);
+    void addIntervals(const QList<QMediaTimeInterval> &intervals);
     void addTimeRange(const QMediaTimeRange&);
 
     void removeInterval(qint64 start, qint64 end);
@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMULTIMEDIAENVIRONMENT_P_H
+#define QMULTIMEDIAENVIRONMENT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qtmultimediadefs.h>
+
+QT_BEGIN_NAMESPACE
+
+// Returns the value of the boolean environment variable \a name: unset or
+// empty gives \a defaultValue, "0" and "false" give false, anything else
+// gives true. The variable is read once; later calls return the same answer.
+//
+// Switches read through this:
+//   QT_ALSA_OUTPUT_THREAD           ALSA pull mode output is fed from a real time
+//                                   thread instead of a GUI thread timer (off)
+//   QT_ALSA_MMAP                    ALSA devices are opened with mmap access (off)
+//   QT_ALSA_PREWARM                 the ALSA plugin probes all devices on a pool
+//                                   thread when it is loaded (off)
+//   QT_PULSEAUDIO_SAMPLE_CACHE      QSoundEffect plays from the PulseAudio server's
+//                                   sample cache instead of a stream per effect (off)
+//   QT_GSTREAMER_ASYNC_VIDEO_RENDER the GStreamer video sink hands frames to the
+//                                   surface without waiting for them to be shown (off)
+//   QT_QUICK_VIDEO_PBO              QML video nodes upload through pixel buffer
+//                                   objects where the GL supports them (on for
+//                                   desktop GL, off for OpenGL ES unless set)
+Q_MULTIMEDIA_EXPORT bool qt_multimedia_envFlag(const char *name, bool defaultValue);
+
+QT_END_NAMESPACE
+
+#endif // QMULTIMEDIAENVIRONMENT_P_H
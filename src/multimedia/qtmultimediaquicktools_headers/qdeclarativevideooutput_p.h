@@ -50,6 +50,7 @@
 #include <QtMultimedia/qcamerainfo.h>
 
 #include <private/qtmultimediaquickdefs_p.h>
+#include <private/qdeclarativevideooutputstatistics_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -68,6 +69,7 @@ class Q_MULTIMEDIAQUICK_EXPORT QDeclarativeVideoOutput : public QQuickItem
     Q_PROPERTY(bool autoOrientation READ autoOrientation WRITE setAutoOrientation NOTIFY autoOrientationChanged REVISION 2)
     Q_PROPERTY(QRectF sourceRect READ sourceRect NOTIFY sourceRectChanged)
     Q_PROPERTY(QRectF contentRect READ contentRect NOTIFY contentRectChanged)
+    Q_PROPERTY(QDeclarativeVideoOutputStatistics *statistics READ statistics CONSTANT REVISION 3)
     Q_ENUMS(FillMode)
 
 public:
@@ -96,6 +98,8 @@ public:
     QRectF sourceRect() const;
     QRectF contentRect() const;
 
+    QDeclarativeVideoOutputStatistics *statistics() const { return m_statistics; }
+
     Q_INVOKABLE QPointF mapPointToItem(const QPointF &point) const;
     Q_INVOKABLE QRectF mapRectToItem(const QRectF &rectangle) const;
     Q_INVOKABLE QPointF mapNormalizedPointToItem(const QPointF &point) const;
@@ -150,6 +154,7 @@ private:
     int m_orientation;
     bool m_autoOrientation;
     QVideoOutputOrientationHandler *m_screenOrientationHandler;
+    QDeclarativeVideoOutputStatistics *m_statistics;
 
     QScopedPointer<QDeclarativeVideoBackend> m_backend;
 };
@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDECLARATIVEVIDEOOUTPUTSTATISTICS_P_H
+#define QDECLARATIVEVIDEOOUTPUTSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qobject.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qtimer.h>
+
+#include <private/qtmultimediaquickdefs_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_MULTIMEDIAQUICK_EXPORT QDeclarativeVideoOutputStatistics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int framesPresented READ framesPresented NOTIFY changed)
+    Q_PROPERTY(int framesDropped READ framesDropped NOTIFY changed)
+    Q_PROPERTY(int framesRendered READ framesRendered NOTIFY changed)
+    Q_PROPERTY(qreal averageUploadTime READ averageUploadTime NOTIFY changed)
+    Q_PROPERTY(qreal maximumUploadTime READ maximumUploadTime NOTIFY changed)
+    Q_PROPERTY(QList<int> uploadTimeHistogram READ uploadTimeHistogram NOTIFY changed)
+    Q_PROPERTY(qreal averageLatency READ averageLatency NOTIFY changed)
+    Q_PROPERTY(qreal maximumLatency READ maximumLatency NOTIFY changed)
+    Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY updateIntervalChanged)
+
+public:
+    enum { HistogramBuckets = 8 };
+
+    explicit QDeclarativeVideoOutputStatistics(QObject *parent = 0);
+    ~QDeclarativeVideoOutputStatistics();
+
+    int framesPresented() const;
+    int framesDropped() const;
+    int framesRendered() const;
+
+    qreal averageUploadTime() const;
+    qreal maximumUploadTime() const;
+    QList<int> uploadTimeHistogram() const;
+    static qint64 uploadTimeBucketLimit(int bucket);
+
+    qreal averageLatency() const;
+    qreal maximumLatency() const;
+
+    int updateInterval() const;
+    void setUpdateInterval(int interval);
+
+    Q_INVOKABLE void reset();
+
+    // Recording, safe to call from any thread.  Times are in microseconds.
+    qint64 timestamp() const { return m_clock.nsecsElapsed() / 1000; }
+    void framePresented(bool droppedPending);
+    void frameRendered(qint64 presentationTimestamp);
+    void frameUploaded(qint64 uploadTime);
+
+Q_SIGNALS:
+    void changed();
+    void updateIntervalChanged();
+
+private Q_SLOTS:
+    void _q_scheduleUpdate();
+    void _q_update();
+
+private:
+    void markDirty();
+
+    QElapsedTimer m_clock;
+    mutable QMutex m_mutex;
+    QTimer m_updateTimer;
+    bool m_dirty;
+
+    int m_framesPresented;
+    int m_framesDropped;
+    int m_framesRendered;
+
+    int m_uploads;
+    qint64 m_totalUploadTime;
+    qint64 m_maximumUploadTime;
+    int m_uploadTimeHistogram[HistogramBuckets];
+
+    qint64 m_totalLatency;
+    qint64 m_maximumLatency;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDECLARATIVEVIDEOOUTPUTSTATISTICS_P_H
@@ -53,6 +53,8 @@ QT_BEGIN_NAMESPACE
 
 const QLatin1String QSGVideoNodeFactoryPluginKey("sgvideonodes");
 
+class QDeclarativeVideoOutputStatistics;
+
 class Q_MULTIMEDIAQUICK_EXPORT QSGVideoNode : public QSGGeometryNode
 {
 public:
@@ -63,10 +65,15 @@ public:
 
     void setTexturedRectGeometry(const QRectF &boundingRect, const QRectF &textureRect, int orientation);
 
+    // Nodes that upload frames themselves report the time it took here.
+    QDeclarativeVideoOutputStatistics *statistics() const { return m_statistics; }
+    void setStatistics(QDeclarativeVideoOutputStatistics *statistics) { m_statistics = statistics; }
+
 private:
     QRectF m_rect;
     QRectF m_textureRect;
     int m_orientation;
+    QDeclarativeVideoOutputStatistics *m_statistics;
 };
 
 class Q_MULTIMEDIAQUICK_EXPORT QSGVideoNodeFactoryInterface
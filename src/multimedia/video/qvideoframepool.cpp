@@ -0,0 +1,350 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qvideoframepool_p.h"
+
+#include <qabstractvideobuffer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+
+QT_BEGIN_NAMESPACE
+
+// Cache line sized alignment keeps the start of every frame, and of every
+// scan line with a suitable stride, friendly to SIMD loads and stores.
+static const size_t frameAlignment = 64;
+
+class QPooledVideoBuffer;
+
+class QVideoFramePoolPrivate
+{
+public:
+    QVideoFramePoolPrivate(qint64 highWaterMark)
+        : ref(1)
+        , highWaterMark(highWaterMark)
+        , detached(false)
+    {
+    }
+
+    void recycle(QPooledVideoBuffer *buffer);
+    QList<QPooledVideoBuffer *> takeIdleBuffers();
+
+    // One reference is held by the pool and one by every buffer handed out,
+    // so buffers outliving the pool can still return safely.
+    QAtomicInt ref;
+    QMutex mutex;
+    qint64 highWaterMark;
+    bool detached;
+    QVideoFramePool::Statistics statistics;
+    // Least recently returned first.
+    QList<QPooledVideoBuffer *> idleBuffers;
+};
+
+class QPooledVideoBuffer : public QAbstractVideoBuffer
+{
+public:
+    QPooledVideoBuffer(QVideoFramePoolPrivate *pool, uchar *data, int bytes, const QSize &size,
+                       int bytesPerLine, QVideoFrame::PixelFormat format)
+        : QAbstractVideoBuffer(NoHandle)
+        , pool(pool)
+        , data(data)
+        , bytes(bytes)
+        , bytesPerLine(bytesPerLine)
+        , size(size)
+        , format(format)
+        , mode(NotMapped)
+    {
+    }
+
+    ~QPooledVideoBuffer()
+    {
+        qFreeAligned(data);
+    }
+
+    bool matches(int bytes, const QSize &size, int bytesPerLine,
+                 QVideoFrame::PixelFormat format) const
+    {
+        return this->bytes == bytes
+                && this->bytesPerLine == bytesPerLine
+                && this->size == size
+                && this->format == format;
+    }
+
+    void release()
+    {
+        pool->recycle(this);
+    }
+
+    MapMode mapMode() const
+    {
+        return mode;
+    }
+
+    uchar *map(MapMode mode, int *numBytes, int *bytesPerLine)
+    {
+        if (this->mode != NotMapped || mode == NotMapped)
+            return 0;
+
+        this->mode = mode;
+
+        if (numBytes)
+            *numBytes = bytes;
+        if (bytesPerLine)
+            *bytesPerLine = this->bytesPerLine;
+
+        return data;
+    }
+
+    void unmap()
+    {
+        mode = NotMapped;
+    }
+
+    QVideoFramePoolPrivate *pool;
+    uchar *data;
+    const int bytes;
+    const int bytesPerLine;
+    const QSize size;
+    const QVideoFrame::PixelFormat format;
+    MapMode mode;
+};
+
+/*
+    Called when the last frame referencing \a buffer goes away. The buffer
+    is kept for reuse unless that would take the pool over its high-water
+    mark, or the pool is gone.
+*/
+void QVideoFramePoolPrivate::recycle(QPooledVideoBuffer *buffer)
+{
+    bool keep = false;
+    {
+        QMutexLocker locker(&mutex);
+
+        if (!detached && statistics.bytesResident <= highWaterMark) {
+            buffer->mode = QAbstractVideoBuffer::NotMapped;
+            idleBuffers.append(buffer);
+            statistics.bytesIdle += buffer->bytes;
+            keep = true;
+        } else {
+            statistics.bytesResident -= buffer->bytes;
+        }
+    }
+
+    if (!keep)
+        delete buffer;
+
+    if (!ref.deref())
+        delete this;
+}
+
+QList<QPooledVideoBuffer *> QVideoFramePoolPrivate::takeIdleBuffers()
+{
+    QList<QPooledVideoBuffer *> buffers;
+    buffers.swap(idleBuffers);
+    statistics.bytesResident -= statistics.bytesIdle;
+    statistics.bytesIdle = 0;
+    return buffers;
+}
+
+/*!
+    \class QVideoFramePool
+    \internal
+
+    \brief The QVideoFramePool class recycles the system memory of video frames.
+
+    Backends producing frames in system memory at a high rate can allocate
+    them from a pool instead of using QVideoFrame(int, const QSize &, int,
+    QVideoFrame::PixelFormat), which allocates a new buffer for every frame.
+
+    The memory of a frame allocated from the pool is aligned to 64 bytes and
+    returns to the pool once the last QVideoFrame referencing it is
+    destroyed. It is handed out again for the next frame with the same size,
+    stride and pixel format. Idle buffers are freed whenever the memory held
+    by the pool, in use or not, would exceed its high-water mark.
+
+    Frames may be allocated and released from any thread. They may also
+    outlive the pool, their memory is then freed when they are destroyed.
+*/
+
+/*!
+    Constructs a pool which keeps at most \a highWaterMark bytes resident.
+*/
+QVideoFramePool::QVideoFramePool(qint64 highWaterMark)
+    : d(new QVideoFramePoolPrivate(highWaterMark))
+{
+}
+
+/*!
+    Destroys the pool and frees its idle buffers.
+*/
+QVideoFramePool::~QVideoFramePool()
+{
+    QList<QPooledVideoBuffer *> buffers;
+    {
+        QMutexLocker locker(&d->mutex);
+        d->detached = true;
+        buffers = d->takeIdleBuffers();
+    }
+    qDeleteAll(buffers);
+
+    if (!d->ref.deref())
+        delete d;
+}
+
+/*!
+    Returns the number of bytes above which the pool stops keeping buffers.
+*/
+qint64 QVideoFramePool::highWaterMark() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->highWaterMark;
+}
+
+/*!
+    Sets the high-water mark of the pool to \a bytes.
+
+    Lowering it does not free any memory right away, idle buffers are
+    evicted by the next allocation.
+*/
+void QVideoFramePool::setHighWaterMark(qint64 bytes)
+{
+    QMutexLocker locker(&d->mutex);
+    d->highWaterMark = bytes;
+}
+
+/*!
+    Returns a frame of the given pixel \a format and \a size in pixels whose
+    buffer holds \a bytes bytes with a stride of \a bytesPerLine.
+
+    The contents of the buffer are undefined. If the memory cannot be
+    allocated an invalid frame is returned.
+*/
+QVideoFrame QVideoFramePool::allocate(
+        int bytes, const QSize &size, int bytesPerLine, QVideoFrame::PixelFormat format)
+{
+    if (bytes <= 0)
+        return QVideoFrame();
+
+    QPooledVideoBuffer *buffer = 0;
+    QList<QPooledVideoBuffer *> evicted;
+    {
+        QMutexLocker locker(&d->mutex);
+
+        // Prefer the most recently returned buffer, it is the most likely
+        // to still be in the cache.
+        for (int i = d->idleBuffers.count() - 1; i >= 0; --i) {
+            if (d->idleBuffers.at(i)->matches(bytes, size, bytesPerLine, format)) {
+                buffer = d->idleBuffers.takeAt(i);
+                d->statistics.bytesIdle -= bytes;
+                ++d->statistics.hits;
+                break;
+            }
+        }
+
+        if (!buffer) {
+            ++d->statistics.misses;
+
+            while (!d->idleBuffers.isEmpty()
+                   && d->statistics.bytesResident + bytes > d->highWaterMark) {
+                QPooledVideoBuffer *idle = d->idleBuffers.takeFirst();
+                d->statistics.bytesIdle -= idle->bytes;
+                d->statistics.bytesResident -= idle->bytes;
+                ++d->statistics.evictions;
+                evicted.append(idle);
+            }
+            d->statistics.bytesResident += bytes;
+        }
+
+        d->ref.ref();
+    }
+
+    qDeleteAll(evicted);
+
+    if (!buffer) {
+        uchar *data = static_cast<uchar *>(qMallocAligned(bytes, frameAlignment));
+        if (!data) {
+            {
+                QMutexLocker locker(&d->mutex);
+                d->statistics.bytesResident -= bytes;
+            }
+            d->ref.deref();
+            return QVideoFrame();
+        }
+        buffer = new QPooledVideoBuffer(d, data, bytes, size, bytesPerLine, format);
+    }
+
+    return QVideoFrame(buffer, size, format);
+}
+
+/*!
+    Returns the allocation statistics of the pool.
+*/
+QVideoFramePool::Statistics QVideoFramePool::statistics() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->statistics;
+}
+
+/*!
+    Resets the hit, miss and eviction counters. The byte counts are left
+    untouched as they describe the current state of the pool.
+*/
+void QVideoFramePool::resetStatistics()
+{
+    QMutexLocker locker(&d->mutex);
+    d->statistics.hits = 0;
+    d->statistics.misses = 0;
+    d->statistics.evictions = 0;
+}
+
+/*!
+    Frees all idle buffers. Frames still in use are not affected.
+*/
+void QVideoFramePool::clear()
+{
+    QList<QPooledVideoBuffer *> buffers;
+    {
+        QMutexLocker locker(&d->mutex);
+        buffers = d->takeIdleBuffers();
+    }
+    qDeleteAll(buffers);
+}
+
+QT_END_NAMESPACE
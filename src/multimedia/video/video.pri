@@ -12,6 +12,7 @@ PRIVATE_HEADERS += \
     video/qabstractvideobuffer_p.h \
     video/qimagevideobuffer_p.h \
     video/qmemoryvideobuffer_p.h \
+    video/qvideoframepool_p.h \
     video/qvideooutputorientationhandler_p.h \
     video/qvideosurfaceoutput_p.h
 
@@ -21,6 +22,7 @@ SOURCES += \
     video/qimagevideobuffer.cpp \
     video/qmemoryvideobuffer.cpp \
     video/qvideoframe.cpp \
+    video/qvideoframepool.cpp \
     video/qvideooutputorientationhandler.cpp \
     video/qvideosurfaceformat.cpp \
     video/qvideosurfaceoutput.cpp \
@@ -11,9 +11,12 @@ QMAKE_DOCS = $$PWD/doc/qtmultimediawidgets.qdocconf
 
 load(qt_module)
 
+CONFIG += simd
+
 PRIVATE_HEADERS += \
     qvideowidget_p.h \
     qpaintervideosurface_p.h \
+    qvideoyuvconverter_p.h \
 
 PUBLIC_HEADERS += \
     qtmultimediawidgetdefs.h \
@@ -26,7 +29,12 @@ SOURCES += \
     qcameraviewfinder.cpp \
     qpaintervideosurface.cpp \
     qvideowidgetcontrol.cpp \
-    qvideowidget.cpp
+    qvideowidget.cpp \
+    qvideoyuvconverter.cpp
+
+SSE2_SOURCES += qvideoyuvconverter_sse2.cpp
+AVX2_SOURCES += qvideoyuvconverter_avx2.cpp
+NEON_SOURCES += qvideoyuvconverter_neon.cpp
 
 maemo6 {
     contains(QT_CONFIG, opengles2) {
@@ -40,6 +40,7 @@
 ****************************************************************************/
 
 #include "qpaintervideosurface_p.h"
+#include "qvideoyuvconverter_p.h"
 
 #include <qmath.h>
 
@@ -84,16 +85,28 @@ public:
     void updateColors(int brightness, int contrast, int hue, int saturation);
 
 private:
+    void drawImage(const QRectF &target, QPainter *painter, const QRectF &source,
+                   const QImage &image) const;
+
     QList<QVideoFrame::PixelFormat> m_imagePixelFormats;
+    QList<QVideoFrame::PixelFormat> m_yuvPixelFormats;
     QVideoFrame m_frame;
     QSize m_imageSize;
     QImage::Format m_imageFormat;
     QVideoSurfaceFormat::Direction m_scanLineDirection;
+    QVideoSurfaceFormat::YCbCrColorSpace m_colorSpace;
+    QVideoYuvConverter m_converter;
+    QImage m_convertedImage;
+    bool m_yuv;
+    bool m_conversionDirty;
 };
 
 QVideoSurfaceGenericPainter::QVideoSurfaceGenericPainter()
     : m_imageFormat(QImage::Format_Invalid)
     , m_scanLineDirection(QVideoSurfaceFormat::TopToBottom)
+    , m_colorSpace(QVideoSurfaceFormat::YCbCr_BT601)
+    , m_yuv(false)
+    , m_conversionDirty(true)
 {
     m_imagePixelFormats
         << QVideoFrame::Format_RGB32
@@ -102,6 +115,14 @@ QVideoSurfaceGenericPainter::QVideoSurfaceGenericPainter()
 #endif
         << QVideoFrame::Format_ARGB32
         << QVideoFrame::Format_RGB565;
+
+    m_yuvPixelFormats
+        << QVideoFrame::Format_YUV420P
+        << QVideoFrame::Format_YV12
+        << QVideoFrame::Format_NV12
+        << QVideoFrame::Format_NV21
+        << QVideoFrame::Format_UYVY
+        << QVideoFrame::Format_YUYV;
 }
 
 QList<QVideoFrame::PixelFormat> QVideoSurfaceGenericPainter::supportedPixelFormats(
@@ -109,8 +130,9 @@ QList<QVideoFrame::PixelFormat> QVideoSurfaceGenericPainter::supportedPixelForma
 {
     switch (handleType) {
     case QAbstractVideoBuffer::QPixmapHandle:
-    case QAbstractVideoBuffer::NoHandle:
         return m_imagePixelFormats;
+    case QAbstractVideoBuffer::NoHandle:
+        return m_imagePixelFormats + m_yuvPixelFormats;
     default:
         ;
     }
@@ -123,7 +145,8 @@ bool QVideoSurfaceGenericPainter::isFormatSupported(const QVideoSurfaceFormat &f
     case QAbstractVideoBuffer::QPixmapHandle:
         return true;
     case QAbstractVideoBuffer::NoHandle:
-        return m_imagePixelFormats.contains(format.pixelFormat())
+        return (m_imagePixelFormats.contains(format.pixelFormat())
+                || m_yuvPixelFormats.contains(format.pixelFormat()))
                && !format.frameSize().isEmpty();
     default:
         ;
@@ -137,6 +160,16 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::start(const QVideoSurf
     m_imageFormat = QVideoFrame::imageFormatFromPixelFormat(format.pixelFormat());
     m_imageSize = format.frameSize();
     m_scanLineDirection = format.scanLineDirection();
+    m_colorSpace = format.yCbCrColorSpace();
+    m_yuv = format.handleType() == QAbstractVideoBuffer::NoHandle
+            && QVideoYuvConverter::canConvert(format.pixelFormat());
+    m_conversionDirty = true;
+
+    if (m_yuv) {
+        // YUV frames are converted into m_convertedImage before painting.
+        m_imageFormat = QImage::Format_RGB32;
+        m_converter.setMatrix(QVideoYuvConverter::matrix(m_colorSpace));
+    }
 
     const QAbstractVideoBuffer::HandleType t = format.handleType();
     if (t == QAbstractVideoBuffer::NoHandle) {
@@ -156,11 +189,13 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::start(const QVideoSurf
 void QVideoSurfaceGenericPainter::stop()
 {
     m_frame = QVideoFrame();
+    m_convertedImage = QImage();
 }
 
 QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::setCurrentFrame(const QVideoFrame &frame)
 {
     m_frame = frame;
+    m_conversionDirty = true;
 
     return QAbstractVideoSurface::NoError;
 }
@@ -175,26 +210,29 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::paint(
 
     if (m_frame.handleType() == QAbstractVideoBuffer::QPixmapHandle) {
         painter->drawPixmap(target, m_frame.handle().value<QPixmap>(), source);
+    } else if (m_yuv && !m_conversionDirty) {
+        drawImage(target, painter, source, m_convertedImage);
     } else if (m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
-        QImage image(
-                m_frame.bits(),
-                m_imageSize.width(),
-                m_imageSize.height(),
-                m_frame.bytesPerLine(),
-                m_imageFormat);
-
-        if (m_scanLineDirection == QVideoSurfaceFormat::BottomToTop) {
-            const QTransform oldTransform = painter->transform();
-
-            painter->scale(1, -1);
-            painter->translate(0, -target.bottom());
-            painter->drawImage(
-                QRectF(target.x(), 0, target.width(), target.height()), image, source);
-            painter->setTransform(oldTransform);
+        QImage image;
+        if (!m_yuv) {
+            image = QImage(
+                    m_frame.bits(),
+                    m_imageSize.width(),
+                    m_imageSize.height(),
+                    m_frame.bytesPerLine(),
+                    m_imageFormat);
+        } else if (m_converter.convert(m_frame, &m_convertedImage)) {
+            // Repaints of the same frame, e.g. while the widget is resized,
+            // reuse the converted image.
+            image = m_convertedImage;
+            m_conversionDirty = false;
         } else {
-            painter->drawImage(target, image, source);
+            m_frame.unmap();
+            return QAbstractVideoSurface::IncorrectFormatError;
         }
 
+        drawImage(target, painter, source, image);
+
         m_frame.unmap();
     } else if (m_frame.isValid()) {
         return QAbstractVideoSurface::IncorrectFormatError;
@@ -204,8 +242,30 @@ QAbstractVideoSurface::Error QVideoSurfaceGenericPainter::paint(
     return QAbstractVideoSurface::NoError;
 }
 
-void QVideoSurfaceGenericPainter::updateColors(int, int, int, int)
+void QVideoSurfaceGenericPainter::updateColors(int brightness, int contrast, int hue, int saturation)
 {
+    if (!m_yuv)
+        return;
+
+    m_converter.setMatrix(
+            QVideoYuvConverter::matrix(m_colorSpace, brightness, contrast, hue, saturation));
+    m_conversionDirty = true;
+}
+
+void QVideoSurfaceGenericPainter::drawImage(
+        const QRectF &target, QPainter *painter, const QRectF &source, const QImage &image) const
+{
+    if (m_scanLineDirection == QVideoSurfaceFormat::BottomToTop) {
+        const QTransform oldTransform = painter->transform();
+
+        painter->scale(1, -1);
+        painter->translate(0, -target.bottom());
+        painter->drawImage(
+            QRectF(target.x(), 0, target.width(), target.height()), image, source);
+        painter->setTransform(oldTransform);
+    } else {
+        painter->drawImage(target, image, source);
+    }
 }
 
 #if !defined(QT_NO_OPENGL) && !defined(QT_OPENGL_ES_1_CL) && !defined(QT_OPENGL_ES_1)
@@ -418,85 +478,10 @@ QAbstractVideoSurface::Error QVideoSurfaceGLPainter::paint(
 
 void QVideoSurfaceGLPainter::updateColors(int brightness, int contrast, int hue, int saturation)
 {
-    const qreal b = brightness / 200.0;
-    const qreal c = contrast / 100.0 + 1.0;
-    const qreal h = hue / 100.0;
-    const qreal s = saturation / 100.0 + 1.0;
-
-    const qreal cosH = qCos(M_PI * h);
-    const qreal sinH = qSin(M_PI * h);
-
-    const qreal h11 =  0.787 * cosH - 0.213 * sinH + 0.213;
-    const qreal h21 = -0.213 * cosH + 0.143 * sinH + 0.213;
-    const qreal h31 = -0.213 * cosH - 0.787 * sinH + 0.213;
-
-    const qreal h12 = -0.715 * cosH - 0.715 * sinH + 0.715;
-    const qreal h22 =  0.285 * cosH + 0.140 * sinH + 0.715;
-    const qreal h32 = -0.715 * cosH + 0.715 * sinH + 0.715;
-
-    const qreal h13 = -0.072 * cosH + 0.928 * sinH + 0.072;
-    const qreal h23 = -0.072 * cosH - 0.283 * sinH + 0.072;
-    const qreal h33 =  0.928 * cosH + 0.072 * sinH + 0.072;
-
-    const qreal sr = (1.0 - s) * 0.3086;
-    const qreal sg = (1.0 - s) * 0.6094;
-    const qreal sb = (1.0 - s) * 0.0820;
-
-    const qreal sr_s = sr + s;
-    const qreal sg_s = sg + s;
-    const qreal sb_s = sr + s;
-
-    const float m4 = (s + sr + sg + sb) * (0.5 - 0.5 * c + b);
-
-    m_colorMatrix(0, 0) = c * (sr_s * h11 + sg * h21 + sb * h31);
-    m_colorMatrix(0, 1) = c * (sr_s * h12 + sg * h22 + sb * h32);
-    m_colorMatrix(0, 2) = c * (sr_s * h13 + sg * h23 + sb * h33);
-    m_colorMatrix(0, 3) = m4;
+    m_colorMatrix = QVideoYuvConverter::colorAdjustmentMatrix(brightness, contrast, hue, saturation);
 
-    m_colorMatrix(1, 0) = c * (sr * h11 + sg_s * h21 + sb * h31);
-    m_colorMatrix(1, 1) = c * (sr * h12 + sg_s * h22 + sb * h32);
-    m_colorMatrix(1, 2) = c * (sr * h13 + sg_s * h23 + sb * h33);
-    m_colorMatrix(1, 3) = m4;
-
-    m_colorMatrix(2, 0) = c * (sr * h11 + sg * h21 + sb_s * h31);
-    m_colorMatrix(2, 1) = c * (sr * h12 + sg * h22 + sb_s * h32);
-    m_colorMatrix(2, 2) = c * (sr * h13 + sg * h23 + sb_s * h33);
-    m_colorMatrix(2, 3) = m4;
-
-    m_colorMatrix(3, 0) = 0.0;
-    m_colorMatrix(3, 1) = 0.0;
-    m_colorMatrix(3, 2) = 0.0;
-    m_colorMatrix(3, 3) = 1.0;
-
-    if (m_yuv) {
-        QMatrix4x4 colorSpaceMatrix;
-
-        switch (m_colorSpace) {
-        case QVideoSurfaceFormat::YCbCr_JPEG:
-            colorSpaceMatrix = QMatrix4x4(
-                        1.0f,  0.000f,  1.402f, -0.701f,
-                        1.0f, -0.344f, -0.714f,  0.529f,
-                        1.0f,  1.772f,  0.000f, -0.886f,
-                        0.0f,  0.000f,  0.000f,  1.0000f);
-            break;
-        case QVideoSurfaceFormat::YCbCr_BT709:
-        case QVideoSurfaceFormat::YCbCr_xvYCC709:
-            colorSpaceMatrix = QMatrix4x4(
-                        1.164f,  0.000f,  1.793f, -0.5727f,
-                        1.164f, -0.534f, -0.213f,  0.3007f,
-                        1.164f,  2.115f,  0.000f, -1.1302f,
-                        0.0f,    0.000f,  0.000f,  1.0000f);
-            break;
-        default: //BT 601:
-            colorSpaceMatrix = QMatrix4x4(
-                        1.164f,  0.000f,  1.596f, -0.8708f,
-                        1.164f, -0.392f, -0.813f,  0.5296f,
-                        1.164f,  2.017f,  0.000f, -1.081f,
-                        0.0f,    0.000f,  0.000f,  1.0000f);
-        }
-
-        m_colorMatrix = m_colorMatrix * colorSpaceMatrix;
-    }
+    if (m_yuv)
+        m_colorMatrix = m_colorMatrix * QVideoYuvConverter::colorSpaceMatrix(m_colorSpace);
 }
 
 void QVideoSurfaceGLPainter::initRgbTextureInfo(
@@ -0,0 +1,343 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qvideoyuvconverter_p.h"
+
+#include <qmath.h>
+#include <private/qsimd_p.h>
+
+QT_BEGIN_NAMESPACE
+
+void qt_convertYuvRowGeneric(const uchar *y, const uchar *u, const uchar *v,
+                             quint32 *dst, int width, const QYuvToRgbMatrix &m)
+{
+    const int shift = QYuvToRgbMatrix::FractionBits;
+
+    for (int x = 0; x < width; ++x) {
+        const int Y = y[x];
+        const int U = u[x >> 1] - 128;
+        const int V = v[x >> 1] - 128;
+
+        const int r = (m.coefficients[0][0] * Y + m.coefficients[0][1] * U
+                       + m.coefficients[0][2] * V + m.offsets[0]) >> shift;
+        const int g = (m.coefficients[1][0] * Y + m.coefficients[1][1] * U
+                       + m.coefficients[1][2] * V + m.offsets[1]) >> shift;
+        const int b = (m.coefficients[2][0] * Y + m.coefficients[2][1] * U
+                       + m.coefficients[2][2] * V + m.offsets[2]) >> shift;
+
+        dst[x] = 0xff000000
+                | (qBound(0, r, 255) << 16)
+                | (qBound(0, g, 255) << 8)
+                | qBound(0, b, 255);
+    }
+}
+
+#if defined(QT_COMPILER_SUPPORTS_SSE2)
+void qt_convertYuvRow_sse2(const uchar *y, const uchar *u, const uchar *v,
+                           quint32 *dst, int width, const QYuvToRgbMatrix &m);
+#endif
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+void qt_convertYuvRow_avx2(const uchar *y, const uchar *u, const uchar *v,
+                           quint32 *dst, int width, const QYuvToRgbMatrix &m);
+#endif
+#if defined(QT_COMPILER_SUPPORTS_NEON) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+void qt_convertYuvRow_neon(const uchar *y, const uchar *u, const uchar *v,
+                           quint32 *dst, int width, const QYuvToRgbMatrix &m);
+#endif
+
+QYuvToRgbRowFunc qt_selectYuvRowKernel()
+{
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+    if (qCpuHasFeature(AVX2))
+        return qt_convertYuvRow_avx2;
+#endif
+#if defined(QT_COMPILER_SUPPORTS_SSE2)
+    if (qCpuHasFeature(SSE2))
+        return qt_convertYuvRow_sse2;
+#endif
+#if defined(QT_COMPILER_SUPPORTS_NEON) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (qCpuHasFeature(NEON))
+        return qt_convertYuvRow_neon;
+#endif
+    return qt_convertYuvRowGeneric;
+}
+
+QVideoYuvConverter::QVideoYuvConverter()
+    : m_matrix(matrix(QVideoSurfaceFormat::YCbCr_BT601))
+    , m_convertRow(qt_selectYuvRowKernel())
+{
+}
+
+bool QVideoYuvConverter::canConvert(QVideoFrame::PixelFormat format)
+{
+    switch (format) {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_YV12:
+    case QVideoFrame::Format_NV12:
+    case QVideoFrame::Format_NV21:
+    case QVideoFrame::Format_UYVY:
+    case QVideoFrame::Format_YUYV:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+    Returns the matrix applying the brightness, contrast, hue and saturation
+    adjustments to normalized RGB values.
+*/
+QMatrix4x4 QVideoYuvConverter::colorAdjustmentMatrix(
+        int brightness, int contrast, int hue, int saturation)
+{
+    const qreal b = brightness / 200.0;
+    const qreal c = contrast / 100.0 + 1.0;
+    const qreal h = hue / 100.0;
+    const qreal s = saturation / 100.0 + 1.0;
+
+    const qreal cosH = qCos(M_PI * h);
+    const qreal sinH = qSin(M_PI * h);
+
+    const qreal h11 =  0.787 * cosH - 0.213 * sinH + 0.213;
+    const qreal h21 = -0.213 * cosH + 0.143 * sinH + 0.213;
+    const qreal h31 = -0.213 * cosH - 0.787 * sinH + 0.213;
+
+    const qreal h12 = -0.715 * cosH - 0.715 * sinH + 0.715;
+    const qreal h22 =  0.285 * cosH + 0.140 * sinH + 0.715;
+    const qreal h32 = -0.715 * cosH + 0.715 * sinH + 0.715;
+
+    const qreal h13 = -0.072 * cosH + 0.928 * sinH + 0.072;
+    const qreal h23 = -0.072 * cosH - 0.283 * sinH + 0.072;
+    const qreal h33 =  0.928 * cosH + 0.072 * sinH + 0.072;
+
+    const qreal sr = (1.0 - s) * 0.3086;
+    const qreal sg = (1.0 - s) * 0.6094;
+    const qreal sb = (1.0 - s) * 0.0820;
+
+    const qreal sr_s = sr + s;
+    const qreal sg_s = sg + s;
+    const qreal sb_s = sr + s;
+
+    const float m4 = (s + sr + sg + sb) * (0.5 - 0.5 * c + b);
+
+    QMatrix4x4 colorMatrix;
+
+    colorMatrix(0, 0) = c * (sr_s * h11 + sg * h21 + sb * h31);
+    colorMatrix(0, 1) = c * (sr_s * h12 + sg * h22 + sb * h32);
+    colorMatrix(0, 2) = c * (sr_s * h13 + sg * h23 + sb * h33);
+    colorMatrix(0, 3) = m4;
+
+    colorMatrix(1, 0) = c * (sr * h11 + sg_s * h21 + sb * h31);
+    colorMatrix(1, 1) = c * (sr * h12 + sg_s * h22 + sb * h32);
+    colorMatrix(1, 2) = c * (sr * h13 + sg_s * h23 + sb * h33);
+    colorMatrix(1, 3) = m4;
+
+    colorMatrix(2, 0) = c * (sr * h11 + sg * h21 + sb_s * h31);
+    colorMatrix(2, 1) = c * (sr * h12 + sg * h22 + sb_s * h32);
+    colorMatrix(2, 2) = c * (sr * h13 + sg * h23 + sb_s * h33);
+    colorMatrix(2, 3) = m4;
+
+    colorMatrix(3, 0) = 0.0;
+    colorMatrix(3, 1) = 0.0;
+    colorMatrix(3, 2) = 0.0;
+    colorMatrix(3, 3) = 1.0;
+
+    return colorMatrix;
+}
+
+/*
+    Returns the matrix converting normalized (Y, Cb, Cr, 1) vectors in
+    \a colorSpace to normalized RGB.
+*/
+QMatrix4x4 QVideoYuvConverter::colorSpaceMatrix(QVideoSurfaceFormat::YCbCrColorSpace colorSpace)
+{
+    switch (colorSpace) {
+    case QVideoSurfaceFormat::YCbCr_JPEG:
+        return QMatrix4x4(
+                    1.0f,  0.000f,  1.402f, -0.701f,
+                    1.0f, -0.344f, -0.714f,  0.529f,
+                    1.0f,  1.772f,  0.000f, -0.886f,
+                    0.0f,  0.000f,  0.000f,  1.0000f);
+    case QVideoSurfaceFormat::YCbCr_BT709:
+    case QVideoSurfaceFormat::YCbCr_xvYCC709:
+        return QMatrix4x4(
+                    1.164f,  0.000f,  1.793f, -0.5727f,
+                    1.164f, -0.534f, -0.213f,  0.3007f,
+                    1.164f,  2.115f,  0.000f, -1.1302f,
+                    0.0f,    0.000f,  0.000f,  1.0000f);
+    default: //BT 601:
+        return QMatrix4x4(
+                    1.164f,  0.000f,  1.596f, -0.8708f,
+                    1.164f, -0.392f, -0.813f,  0.5296f,
+                    1.164f,  2.017f,  0.000f, -1.081f,
+                    0.0f,    0.000f,  0.000f,  1.0000f);
+    }
+}
+
+/*
+    Folds the color adjustments and the color space conversion into a
+    single fixed point matrix working on 8 bit samples.
+*/
+QYuvToRgbMatrix QVideoYuvConverter::matrix(
+        QVideoSurfaceFormat::YCbCrColorSpace colorSpace,
+        int brightness, int contrast, int hue, int saturation)
+{
+    const QMatrix4x4 m = colorAdjustmentMatrix(brightness, contrast, hue, saturation)
+            * colorSpaceMatrix(colorSpace);
+    const qreal scale = 1 << QYuvToRgbMatrix::FractionBits;
+
+    QYuvToRgbMatrix result;
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            result.coefficients[row][column] = qint16(qRound(qBound<qreal>(
+                    -32768, m(row, column) * scale, 32767)));
+        }
+        // The kernels see Cb and Cr centered around zero, move the bias
+        // they remove into the constant term.
+        const qreal offset = 255 * m(row, 3) + 128 * (m(row, 1) + m(row, 2));
+        result.offsets[row] = qRound(offset * scale) + (1 << (QYuvToRgbMatrix::FractionBits - 1));
+    }
+    return result;
+}
+
+/*
+    Converts the mapped \a mappedFrame into \a image, which is reallocated
+    only if it does not already have the frame size and the RGB32 format.
+*/
+bool QVideoYuvConverter::convert(const QVideoFrame &mappedFrame, QImage *image)
+{
+    const uchar *bits = mappedFrame.bits();
+    const int width = mappedFrame.width();
+    const int height = mappedFrame.height();
+    const int bytesPerLine = mappedFrame.bytesPerLine();
+
+    if (!bits || width <= 0 || height <= 0 || !canConvert(mappedFrame.pixelFormat()))
+        return false;
+
+    if (image->size() != mappedFrame.size() || image->format() != QImage::Format_RGB32)
+        *image = QImage(width, height, QImage::Format_RGB32);
+    if (image->isNull())
+        return false;
+
+    const int chromaWidth = (width + 1) / 2;
+
+    switch (mappedFrame.pixelFormat()) {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_YV12: {
+        if (mappedFrame.planeCount() < 3)
+            return false;
+
+        // YV12 stores the Cr plane first.
+        const bool yv12 = mappedFrame.pixelFormat() == QVideoFrame::Format_YV12;
+        const uchar *u = mappedFrame.bits(yv12 ? 2 : 1);
+        const uchar *v = mappedFrame.bits(yv12 ? 1 : 2);
+        const int uBytesPerLine = mappedFrame.bytesPerLine(yv12 ? 2 : 1);
+        const int vBytesPerLine = mappedFrame.bytesPerLine(yv12 ? 1 : 2);
+
+        for (int row = 0; row < height; ++row) {
+            m_convertRow(bits + row * bytesPerLine,
+                         u + (row / 2) * uBytesPerLine,
+                         v + (row / 2) * vBytesPerLine,
+                         reinterpret_cast<quint32 *>(image->scanLine(row)), width, m_matrix);
+        }
+        break;
+    }
+    case QVideoFrame::Format_NV12:
+    case QVideoFrame::Format_NV21: {
+        if (mappedFrame.planeCount() < 2)
+            return false;
+
+        const uchar *uv = mappedFrame.bits(1);
+        const int uvBytesPerLine = mappedFrame.bytesPerLine(1);
+        const int first = mappedFrame.pixelFormat() == QVideoFrame::Format_NV12 ? 0 : 1;
+
+        m_u.resize(chromaWidth);
+        m_v.resize(chromaWidth);
+        uchar *u = m_u.data();
+        uchar *v = m_v.data();
+
+        for (int row = 0; row < height; ++row) {
+            if ((row & 1) == 0) {
+                const uchar *src = uv + (row / 2) * uvBytesPerLine;
+                for (int x = 0; x < chromaWidth; ++x) {
+                    u[x] = src[2 * x + first];
+                    v[x] = src[2 * x + 1 - first];
+                }
+            }
+            m_convertRow(bits + row * bytesPerLine, u, v,
+                         reinterpret_cast<quint32 *>(image->scanLine(row)), width, m_matrix);
+        }
+        break;
+    }
+    case QVideoFrame::Format_UYVY:
+    case QVideoFrame::Format_YUYV: {
+        const bool uyvy = mappedFrame.pixelFormat() == QVideoFrame::Format_UYVY;
+        const int yIndex = uyvy ? 1 : 0;
+        const int uIndex = uyvy ? 0 : 1;
+
+        m_y.resize(2 * chromaWidth);
+        m_u.resize(chromaWidth);
+        m_v.resize(chromaWidth);
+        uchar *y = m_y.data();
+        uchar *u = m_u.data();
+        uchar *v = m_v.data();
+
+        for (int row = 0; row < height; ++row) {
+            const uchar *src = bits + row * bytesPerLine;
+            for (int x = 0; x < chromaWidth; ++x, src += 4) {
+                y[2 * x] = src[yIndex];
+                y[2 * x + 1] = src[yIndex + 2];
+                u[x] = src[uIndex];
+                v[x] = src[uIndex + 2];
+            }
+            m_convertRow(y, u, v,
+                         reinterpret_cast<quint32 *>(image->scanLine(row)), width, m_matrix);
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qvideoyuvconverter_p.h"
+
+#include <private/qsimd_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+
+QT_BEGIN_NAMESPACE
+
+static inline __m128i convertChannel_avx2(__m256i yuLo, __m256i yuHi, __m256i vLo, __m256i vHi,
+                                          const QYuvToRgbMatrix &m, int channel)
+{
+    const __m256i cyu = _mm256_set1_epi32((int(m.coefficients[channel][1]) << 16)
+                                          | quint16(m.coefficients[channel][0]));
+    const __m256i cv = _mm256_set1_epi32(quint16(m.coefficients[channel][2]));
+    const __m256i offset = _mm256_set1_epi32(m.offsets[channel]);
+
+    __m256i lo = _mm256_add_epi32(_mm256_madd_epi16(yuLo, cyu), _mm256_madd_epi16(vLo, cv));
+    __m256i hi = _mm256_add_epi32(_mm256_madd_epi16(yuHi, cyu), _mm256_madd_epi16(vHi, cv));
+    lo = _mm256_srai_epi32(_mm256_add_epi32(lo, offset), QYuvToRgbMatrix::FractionBits);
+    hi = _mm256_srai_epi32(_mm256_add_epi32(hi, offset), QYuvToRgbMatrix::FractionBits);
+
+    // The unpacks above and this pack work per 128 bit lane, so they cancel
+    // out and the words end up in pixel order again.
+    const __m256i words = _mm256_packs_epi32(lo, hi);
+    return _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+}
+
+void qt_convertYuvRow_avx2(const uchar *y, const uchar *u, const uchar *v,
+                           quint32 *dst, int width, const QYuvToRgbMatrix &m)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi16(128);
+    const __m128i alpha = _mm_set1_epi8(char(0xff));
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m256i Y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(y + x)));
+
+        const __m128i u8 = _mm_loadl_epi64((const __m128i *)(u + x / 2));
+        const __m128i v8 = _mm_loadl_epi64((const __m128i *)(v + x / 2));
+        const __m256i U = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u8, u8)), bias);
+        const __m256i V = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v8, v8)), bias);
+
+        const __m256i yuLo = _mm256_unpacklo_epi16(Y, U);
+        const __m256i yuHi = _mm256_unpackhi_epi16(Y, U);
+        const __m256i vLo = _mm256_unpacklo_epi16(V, zero);
+        const __m256i vHi = _mm256_unpackhi_epi16(V, zero);
+
+        const __m128i r = convertChannel_avx2(yuLo, yuHi, vLo, vHi, m, 0);
+        const __m128i g = convertChannel_avx2(yuLo, yuHi, vLo, vHi, m, 1);
+        const __m128i b = convertChannel_avx2(yuLo, yuHi, vLo, vHi, m, 2);
+
+        const __m128i bgLo = _mm_unpacklo_epi8(b, g);
+        const __m128i bgHi = _mm_unpackhi_epi8(b, g);
+        const __m128i raLo = _mm_unpacklo_epi8(r, alpha);
+        const __m128i raHi = _mm_unpackhi_epi8(r, alpha);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_unpacklo_epi16(bgLo, raLo));
+        _mm_storeu_si128((__m128i *)(dst + x + 4), _mm_unpackhi_epi16(bgLo, raLo));
+        _mm_storeu_si128((__m128i *)(dst + x + 8), _mm_unpacklo_epi16(bgHi, raHi));
+        _mm_storeu_si128((__m128i *)(dst + x + 12), _mm_unpackhi_epi16(bgHi, raHi));
+    }
+
+    if (x < width)
+        qt_convertYuvRowGeneric(y + x, u + x / 2, v + x / 2, dst + x, width - x, m);
+}
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qvideoyuvconverter_p.h"
+
+#include <private/qsimd_p.h>
+
+#include <string.h>
+
+#if defined(QT_COMPILER_SUPPORTS_NEON) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+
+QT_BEGIN_NAMESPACE
+
+static inline uint8x8_t convertChannel_neon(int16x8_t Y, int16x8_t U, int16x8_t V,
+                                            const QYuvToRgbMatrix &m, int channel)
+{
+    const int32x4_t offset = vdupq_n_s32(m.offsets[channel]);
+
+    int32x4_t lo = vmull_n_s16(vget_low_s16(Y), m.coefficients[channel][0]);
+    lo = vmlal_n_s16(lo, vget_low_s16(U), m.coefficients[channel][1]);
+    lo = vmlal_n_s16(lo, vget_low_s16(V), m.coefficients[channel][2]);
+    lo = vshrq_n_s32(vaddq_s32(lo, offset), QYuvToRgbMatrix::FractionBits);
+
+    int32x4_t hi = vmull_n_s16(vget_high_s16(Y), m.coefficients[channel][0]);
+    hi = vmlal_n_s16(hi, vget_high_s16(U), m.coefficients[channel][1]);
+    hi = vmlal_n_s16(hi, vget_high_s16(V), m.coefficients[channel][2]);
+    hi = vshrq_n_s32(vaddq_s32(hi, offset), QYuvToRgbMatrix::FractionBits);
+
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+}
+
+static inline int16x8_t loadChroma_neon(const uchar *c)
+{
+    // Only four samples are valid here, duplicate each of them for the two
+    // pixels sharing it.
+    quint32 samples;
+    memcpy(&samples, c, sizeof(samples));
+    const uint8x8_t c8 = vreinterpret_u8_u32(vdup_n_u32(samples));
+    const uint8x8_t doubled = vzip_u8(c8, c8).val[0];
+    return vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(doubled)), vdupq_n_s16(128));
+}
+
+void qt_convertYuvRow_neon(const uchar *y, const uchar *u, const uchar *v,
+                           quint32 *dst, int width, const QYuvToRgbMatrix &m)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const int16x8_t Y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + x)));
+        const int16x8_t U = loadChroma_neon(u + x / 2);
+        const int16x8_t V = loadChroma_neon(v + x / 2);
+
+        uint8x8x4_t pixels;
+        pixels.val[0] = convertChannel_neon(Y, U, V, m, 2);
+        pixels.val[1] = convertChannel_neon(Y, U, V, m, 1);
+        pixels.val[2] = convertChannel_neon(Y, U, V, m, 0);
+        pixels.val[3] = vdup_n_u8(0xff);
+        vst4_u8((uchar *)(dst + x), pixels);
+    }
+
+    if (x < width)
+        qt_convertYuvRowGeneric(y + x, u + x / 2, v + x / 2, dst + x, width - x, m);
+}
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QVIDEOYUVCONVERTER_P_H
+#define QVIDEOYUVCONVERTER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <qtmultimediawidgetdefs.h>
+#include <QtCore/qvector.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qmatrix4x4.h>
+#include <qvideoframe.h>
+#include <qvideosurfaceformat.h>
+
+QT_BEGIN_NAMESPACE
+
+// Fixed point YCbCr to RGB matrix. Rows produce R, G and B, columns are
+// applied to Y, Cb - 128 and Cr - 128. The offsets already include the
+// rounding bias for the final shift by FractionBits.
+struct QYuvToRgbMatrix
+{
+    enum { FractionBits = 11 };
+
+    qint16 coefficients[3][3];
+    qint32 offsets[3];
+};
+
+// Converts one row of planar data to RGB32. The chroma rows are half the
+// width of the luma row, chroma sample x / 2 is used for pixel x.
+typedef void (*QYuvToRgbRowFunc)(const uchar *y, const uchar *u, const uchar *v,
+                                 quint32 *dst, int width, const QYuvToRgbMatrix &matrix);
+
+// Plain C++ implementation; it handles the tails the vectorized kernels
+// leave over and is the reference they are tested against.
+Q_MULTIMEDIAWIDGETS_EXPORT void qt_convertYuvRowGeneric(
+        const uchar *y, const uchar *u, const uchar *v,
+        quint32 *dst, int width, const QYuvToRgbMatrix &matrix);
+
+Q_MULTIMEDIAWIDGETS_EXPORT QYuvToRgbRowFunc qt_selectYuvRowKernel();
+
+class Q_MULTIMEDIAWIDGETS_EXPORT QVideoYuvConverter
+{
+public:
+    QVideoYuvConverter();
+
+    static bool canConvert(QVideoFrame::PixelFormat format);
+
+    static QMatrix4x4 colorAdjustmentMatrix(int brightness, int contrast, int hue, int saturation);
+    static QMatrix4x4 colorSpaceMatrix(QVideoSurfaceFormat::YCbCrColorSpace colorSpace);
+    static QYuvToRgbMatrix matrix(
+            QVideoSurfaceFormat::YCbCrColorSpace colorSpace,
+            int brightness = 0, int contrast = 0, int hue = 0, int saturation = 0);
+
+    void setMatrix(const QYuvToRgbMatrix &matrix) { m_matrix = matrix; }
+    QYuvToRgbMatrix matrix() const { return m_matrix; }
+
+    bool convert(const QVideoFrame &mappedFrame, QImage *image);
+
+private:
+    QYuvToRgbMatrix m_matrix;
+    QYuvToRgbRowFunc m_convertRow;
+    QVector<uchar> m_y;
+    QVector<uchar> m_u;
+    QVector<uchar> m_v;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qvideoyuvconverter_p.h"
+
+#include <private/qsimd_p.h>
+
+#include <string.h>
+
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+
+QT_BEGIN_NAMESPACE
+
+static inline __m128i convertChannel_sse2(__m128i yuLo, __m128i yuHi, __m128i vLo, __m128i vHi,
+                                          const QYuvToRgbMatrix &m, int channel)
+{
+    // pmaddwd multiplies the (Y, Cb) pairs and the (Cr, 0) pairs and adds
+    // each pair up, leaving one 32 bit sum per pixel.
+    const __m128i cyu = _mm_set1_epi32((int(m.coefficients[channel][1]) << 16)
+                                       | quint16(m.coefficients[channel][0]));
+    const __m128i cv = _mm_set1_epi32(quint16(m.coefficients[channel][2]));
+    const __m128i offset = _mm_set1_epi32(m.offsets[channel]);
+
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(yuLo, cyu), _mm_madd_epi16(vLo, cv));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(yuHi, cyu), _mm_madd_epi16(vHi, cv));
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, offset), QYuvToRgbMatrix::FractionBits);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, offset), QYuvToRgbMatrix::FractionBits);
+
+    const __m128i words = _mm_packs_epi32(lo, hi);
+    return _mm_packus_epi16(words, words);
+}
+
+void qt_convertYuvRow_sse2(const uchar *y, const uchar *u, const uchar *v,
+                           quint32 *dst, int width, const QYuvToRgbMatrix &m)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i alpha = _mm_set1_epi8(char(0xff));
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m128i Y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(y + x)), zero);
+
+        int chroma;
+        memcpy(&chroma, u + x / 2, sizeof(int));
+        __m128i U = _mm_cvtsi32_si128(chroma);
+        memcpy(&chroma, v + x / 2, sizeof(int));
+        __m128i V = _mm_cvtsi32_si128(chroma);
+
+        // Duplicate every chroma sample for the two pixels sharing it.
+        U = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(U, U), zero), bias);
+        V = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(V, V), zero), bias);
+
+        const __m128i yuLo = _mm_unpacklo_epi16(Y, U);
+        const __m128i yuHi = _mm_unpackhi_epi16(Y, U);
+        const __m128i vLo = _mm_unpacklo_epi16(V, zero);
+        const __m128i vHi = _mm_unpackhi_epi16(V, zero);
+
+        const __m128i r = convertChannel_sse2(yuLo, yuHi, vLo, vHi, m, 0);
+        const __m128i g = convertChannel_sse2(yuLo, yuHi, vLo, vHi, m, 1);
+        const __m128i b = convertChannel_sse2(yuLo, yuHi, vLo, vHi, m, 2);
+
+        const __m128i bg = _mm_unpacklo_epi8(b, g);
+        const __m128i ra = _mm_unpacklo_epi8(r, alpha);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128((__m128i *)(dst + x + 4), _mm_unpackhi_epi16(bg, ra));
+    }
+
+    if (x < width)
+        qt_convertYuvRowGeneric(y + x, u + x / 2, v + x / 2, dst + x, width - x, m);
+}
+
+QT_END_NAMESPACE
+
+#endif
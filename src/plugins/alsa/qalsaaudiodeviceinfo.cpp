@@ -52,23 +52,325 @@
 
 #include "qalsaaudiodeviceinfo.h"
 
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+
 #include <alsa/version.h>
 
 QT_BEGIN_NAMESPACE
 
-QAlsaAudioDeviceInfo::QAlsaAudioDeviceInfo(QByteArray dev, QAudio::Mode mode)
+// What a device can do, probed once with snd_pcm_hw_params_test_*() so that
+// format queries don't have to open the device every time.
+struct QAlsaDeviceCapabilities
+{
+    QAlsaDeviceCapabilities()
+        : valid(false), continuousRates(false), minRate(0), maxRate(0) {}
+
+    bool valid;
+    bool continuousRates;
+    unsigned int minRate;
+    unsigned int maxRate;
+    QList<unsigned int> rates;
+    QList<unsigned int> channels;
+    QList<snd_pcm_format_t> formats;
+};
+
+struct QAlsaCapabilityCache
+{
+    QAlsaCapabilityCache() : generation(0) {}
+
+    void clear()
+    {
+        capabilities.clear();
+        combinations.clear();
+        devices.clear();
+        ++generation;
+    }
+
+    QMutex mutex;
+    // Devices are probed without the mutex held; a probe result is only
+    // stored if no card came or went while it ran.
+    int generation;
+    QByteArray cards;
+    QHash<QString, QAlsaDeviceCapabilities> capabilities;
+    // The per-axis capabilities can't tell whether the hardware takes a
+    // given rate, channel count and sample format together, so whole
+    // formats are checked on demand and remembered here.
+    QHash<QString, bool> combinations;
+    QHash<int, QList<QByteArray> > devices;
+};
+
+Q_GLOBAL_STATIC(QAlsaCapabilityCache, capabilityCache)
+
+const unsigned int PROBE_SAMPLE_RATES[] =
+    { 8000, 11025, 16000, 22050, 32000, 44100, 48000, 88200, 96000, 176400, 192000 };
+
+const unsigned int MAX_PROBE_CHANNELS = 32;
+
+const snd_pcm_format_t PROBE_FORMATS[] = {
+    SND_PCM_FORMAT_S8, SND_PCM_FORMAT_U8,
+    SND_PCM_FORMAT_S16_LE, SND_PCM_FORMAT_S16_BE, SND_PCM_FORMAT_U16_LE, SND_PCM_FORMAT_U16_BE,
+    SND_PCM_FORMAT_S24_LE, SND_PCM_FORMAT_S24_BE, SND_PCM_FORMAT_U24_LE, SND_PCM_FORMAT_U24_BE,
+    SND_PCM_FORMAT_S32_LE, SND_PCM_FORMAT_S32_BE, SND_PCM_FORMAT_U32_LE, SND_PCM_FORMAT_U32_BE,
+    SND_PCM_FORMAT_FLOAT_LE, SND_PCM_FORMAT_FLOAT_BE, SND_PCM_FORMAT_FLOAT64_LE, SND_PCM_FORMAT_FLOAT64_BE
+};
+
+// The set of card indices is cheap to get (no device is opened) and changes
+// whenever a card is plugged or unplugged, which is when the cache goes stale.
+// Must be called with the cache mutex held.
+static void checkCardsLocked(QAlsaCapabilityCache *cache)
+{
+    QByteArray cards;
+    int card = -1;
+    while (snd_card_next(&card) == 0 && card >= 0)
+        cards.append(char(card));
+
+    if (cards != cache->cards) {
+        cache->clear();
+        cache->cards = cards;
+    }
+}
+
+static snd_pcm_format_t pcmFormatFor(const QAudioFormat &format)
+{
+    snd_pcm_format_t pcmFormat = SND_PCM_FORMAT_UNKNOWN;
+    switch (format.sampleSize()) {
+    case 8:
+        if (format.sampleType() == QAudioFormat::SignedInt)
+            pcmFormat = SND_PCM_FORMAT_S8;
+        else if (format.sampleType() == QAudioFormat::UnSignedInt)
+            pcmFormat = SND_PCM_FORMAT_U8;
+        break;
+    case 16:
+        if (format.sampleType() == QAudioFormat::SignedInt) {
+            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
+                      ? SND_PCM_FORMAT_S16_LE : SND_PCM_FORMAT_S16_BE;
+        } else if (format.sampleType() == QAudioFormat::UnSignedInt) {
+            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
+                      ? SND_PCM_FORMAT_U16_LE : SND_PCM_FORMAT_U16_BE;
+        }
+        break;
+    case 32:
+        if (format.sampleType() == QAudioFormat::SignedInt) {
+            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
+                      ? SND_PCM_FORMAT_S32_LE : SND_PCM_FORMAT_S32_BE;
+        } else if (format.sampleType() == QAudioFormat::UnSignedInt) {
+            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
+                      ? SND_PCM_FORMAT_U32_LE : SND_PCM_FORMAT_U32_BE;
+        } else if (format.sampleType() == QAudioFormat::Float) {
+            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
+                      ? SND_PCM_FORMAT_FLOAT_LE : SND_PCM_FORMAT_FLOAT_BE;
+        }
+    }
+    return pcmFormat;
+}
+
+static QString resolveDeviceName(const QString &device, QAudio::Mode mode)
+{
+    QString dev = device;
+
+#if(SND_LIB_MAJOR == 1 && SND_LIB_MINOR == 0 && SND_LIB_SUBMINOR >= 14)
+    if (dev.compare(QLatin1String("default")) == 0) {
+        QList<QByteArray> devices = QAlsaAudioDeviceInfo::availableDevices(mode);
+        if (!devices.isEmpty())
+            dev = QLatin1String(devices.first().constData());
+    }
+#else
+    Q_UNUSED(mode);
+    if (dev.compare(QLatin1String("default")) == 0) {
+        dev = QLatin1String("hw:0,0");
+    } else {
+        int idx = 0;
+        char *name;
+
+        QString shortName = device.mid(device.indexOf(QLatin1String("="),0)+1);
+
+        while(snd_card_get_name(idx,&name) == 0) {
+            if(shortName.compare(QLatin1String(name)) == 0)
+                break;
+            idx++;
+        }
+        dev = QString(QLatin1String("hw:%1,0")).arg(idx);
+    }
+#endif
+
+    return dev;
+}
+
+// Returns false only if the device could not be opened at all.
+static bool probeCapabilities(const QString &dev, QAudio::Mode mode, QAlsaDeviceCapabilities *caps, int *openError)
 {
-    handle = 0;
+    snd_pcm_t *pcmHandle;
+    snd_pcm_hw_params_t *params;
+
+    snd_pcm_stream_t stream = mode == QAudio::AudioOutput
+                            ? SND_PCM_STREAM_PLAYBACK : SND_PCM_STREAM_CAPTURE;
+
+    // Don't wait for a device that is in use, it just can't be probed right now
+    *openError = snd_pcm_open(&pcmHandle, dev.toLocal8Bit().constData(), stream, SND_PCM_NONBLOCK);
+    if (*openError < 0)
+        return false;
+
+    snd_pcm_hw_params_alloca(&params);
+    if (snd_pcm_hw_params_any(pcmHandle, params) < 0) {
+        snd_pcm_close(pcmHandle);
+        return true;
+    }
+
+    int dir = 0;
+    snd_pcm_hw_params_get_rate_min(params, &caps->minRate, &dir);
+    snd_pcm_hw_params_get_rate_max(params, &caps->maxRate, &dir);
+
+    // Plug devices resample and accept anything in range; an odd rate tells them apart
+    caps->continuousRates = caps->maxRate > caps->minRate
+            && snd_pcm_hw_params_test_rate(pcmHandle, params, caps->minRate + 1, 0) == 0;
+    for (size_t i = 0; i < sizeof(PROBE_SAMPLE_RATES) / sizeof(PROBE_SAMPLE_RATES[0]); ++i) {
+        if (snd_pcm_hw_params_test_rate(pcmHandle, params, PROBE_SAMPLE_RATES[i], 0) == 0)
+            caps->rates.append(PROBE_SAMPLE_RATES[i]);
+    }
+
+    unsigned int minChannels = 0;
+    unsigned int maxChannels = 0;
+    snd_pcm_hw_params_get_channels_min(params, &minChannels);
+    snd_pcm_hw_params_get_channels_max(params, &maxChannels);
+    for (unsigned int c = qMax(1u, minChannels); c <= qMin(maxChannels, MAX_PROBE_CHANNELS); ++c) {
+        if (snd_pcm_hw_params_test_channels(pcmHandle, params, c) == 0)
+            caps->channels.append(c);
+    }
+
+    for (size_t i = 0; i < sizeof(PROBE_FORMATS) / sizeof(PROBE_FORMATS[0]); ++i) {
+        if (snd_pcm_hw_params_test_format(pcmHandle, params, PROBE_FORMATS[i]) == 0)
+            caps->formats.append(PROBE_FORMATS[i]);
+    }
+
+    snd_pcm_close(pcmHandle);
+
+    caps->valid = !caps->rates.isEmpty() || caps->continuousRates;
+    caps->valid = caps->valid && !caps->channels.isEmpty() && !caps->formats.isEmpty();
+    return true;
+}
+
+static QAlsaDeviceCapabilities deviceCapabilities(const QString &device, QAudio::Mode mode)
+{
+    // Resolve "default" before taking the lock, availableDevices() needs it too
+    const QString dev = resolveDeviceName(device, mode);
+    const QString key = QString::number(int(mode)) + QLatin1Char(':') + dev;
+
+    QAlsaCapabilityCache *cache = capabilityCache();
+    QMutexLocker locker(&cache->mutex);
+    checkCardsLocked(cache);
+
+    QHash<QString, QAlsaDeviceCapabilities>::const_iterator it = cache->capabilities.constFind(key);
+    if (it != cache->capabilities.constEnd())
+        return it.value();
+
+    // Opening a device can take a while, don't keep other lookups waiting.
+    // Two threads may end up probing the same device, which is harmless.
+    const int generation = cache->generation;
+    locker.unlock();
+
+    QAlsaDeviceCapabilities caps;
+    int openError = 0;
+    if (!probeCapabilities(dev, mode, &caps, &openError)) {
+        // A busy device may well become available later, don't remember that
+        if (openError == -EBUSY || openError == -EAGAIN)
+            return caps;
+    }
+
+    locker.relock();
+    if (cache->generation == generation)
+        cache->capabilities.insert(key, caps);
+    return caps;
+}
+
+// Returns false only if the device could not be opened at all.
+static bool probeCombination(const QString &dev, QAudio::Mode mode, snd_pcm_format_t format,
+                             int channels, int rate, bool *supported, int *openError)
+{
+    snd_pcm_t *pcmHandle;
+    snd_pcm_hw_params_t *params;
+
+    snd_pcm_stream_t stream = mode == QAudio::AudioOutput
+                            ? SND_PCM_STREAM_PLAYBACK : SND_PCM_STREAM_CAPTURE;
 
+    *openError = snd_pcm_open(&pcmHandle, dev.toLocal8Bit().constData(), stream, SND_PCM_NONBLOCK);
+    if (*openError < 0)
+        return false;
+
+    // Restrict one configuration space step by step, each step only
+    // succeeds if it is compatible with the ones before
+    snd_pcm_hw_params_alloca(&params);
+    int err = snd_pcm_hw_params_any(pcmHandle, params);
+    if (err >= 0)
+        err = snd_pcm_hw_params_set_format(pcmHandle, params, format);
+    if (err >= 0 && channels != -1)
+        err = snd_pcm_hw_params_set_channels(pcmHandle, params, channels);
+    if (err >= 0 && rate != -1)
+        err = snd_pcm_hw_params_test_rate(pcmHandle, params, rate, 0);
+
+    snd_pcm_close(pcmHandle);
+
+    *supported = err >= 0;
+    return true;
+}
+
+static bool combinationSupported(const QString &device, QAudio::Mode mode, snd_pcm_format_t format,
+                                 int channels, int rate)
+{
+    const QString dev = resolveDeviceName(device, mode);
+    const QString key = QString::fromLatin1("%1:%2:%3:%4:%5")
+            .arg(int(mode)).arg(dev).arg(int(format)).arg(channels).arg(rate);
+
+    QAlsaCapabilityCache *cache = capabilityCache();
+    QMutexLocker locker(&cache->mutex);
+    checkCardsLocked(cache);
+
+    QHash<QString, bool>::const_iterator it = cache->combinations.constFind(key);
+    if (it != cache->combinations.constEnd())
+        return it.value();
+
+    const int generation = cache->generation;
+    locker.unlock();
+
+    bool supported = false;
+    int openError = 0;
+    if (!probeCombination(dev, mode, format, channels, rate, &supported, &openError)) {
+        // Every single value is known to work; without being able to open
+        // the device right now that is the best answer there is. It is a
+        // guess though, so ask again next time instead of remembering it.
+        if (openError == -EBUSY || openError == -EAGAIN)
+            return true;
+    }
+
+    locker.relock();
+    if (cache->generation == generation)
+        cache->combinations.insert(key, supported);
+    return supported;
+}
+
+class QAlsaCapabilityPrewarmer : public QRunnable
+{
+public:
+    void run()
+    {
+        const QAudio::Mode modes[] = { QAudio::AudioOutput, QAudio::AudioInput };
+        for (int i = 0; i < 2; ++i) {
+            foreach (const QByteArray &device, QAlsaAudioDeviceInfo::availableDevices(modes[i]))
+                deviceCapabilities(QLatin1String(device), modes[i]);
+        }
+    }
+};
+
+QAlsaAudioDeviceInfo::QAlsaAudioDeviceInfo(QByteArray dev, QAudio::Mode mode)
+{
     device = QLatin1String(dev);
     this->mode = mode;
-
-    checkSurround();
 }
 
 QAlsaAudioDeviceInfo::~QAlsaAudioDeviceInfo()
 {
-    close();
 }
 
 bool QAlsaAudioDeviceInfo::isFormatSupported(const QAudioFormat& format) const
@@ -142,163 +444,37 @@ QList<QAudioFormat::SampleType> QAlsaAudioDeviceInfo::supportedSampleTypes()
     return typez;
 }
 
-bool QAlsaAudioDeviceInfo::open()
-{
-    int err = 0;
-    QString dev = device;
-    QList<QByteArray> devices = availableDevices(mode);
-
-    if(dev.compare(QLatin1String("default")) == 0) {
-#if(SND_LIB_MAJOR == 1 && SND_LIB_MINOR == 0 && SND_LIB_SUBMINOR >= 14)
-        if (devices.size() > 0)
-            dev = QLatin1String(devices.first().constData());
-        else
-            return false;
-#else
-        dev = QLatin1String("hw:0,0");
-#endif
-    } else {
-#if(SND_LIB_MAJOR == 1 && SND_LIB_MINOR == 0 && SND_LIB_SUBMINOR >= 14)
-        dev = device;
-#else
-        int idx = 0;
-        char *name;
-
-        QString shortName = device.mid(device.indexOf(QLatin1String("="),0)+1);
-
-        while (snd_card_get_name(idx,&name) == 0) {
-            if(dev.contains(QLatin1String(name)))
-                break;
-            idx++;
-        }
-        dev = QString(QLatin1String("hw:%1,0")).arg(idx);
-#endif
-    }
-    if(mode == QAudio::AudioOutput) {
-        err=snd_pcm_open( &handle,dev.toLocal8Bit().constData(),SND_PCM_STREAM_PLAYBACK,0);
-    } else {
-        err=snd_pcm_open( &handle,dev.toLocal8Bit().constData(),SND_PCM_STREAM_CAPTURE,0);
-    }
-    if(err < 0) {
-        handle = 0;
-        return false;
-    }
-    return true;
-}
-
-void QAlsaAudioDeviceInfo::close()
-{
-    if(handle)
-        snd_pcm_close(handle);
-    handle = 0;
-}
-
 bool QAlsaAudioDeviceInfo::testSettings(const QAudioFormat& format) const
 {
-    // Set nearest to closest settings that do work.
-    // See if what is in settings will work (return value).
-    int err = -1;
-    snd_pcm_t* pcmHandle;
-    snd_pcm_hw_params_t *params;
-    QString dev;
-
-#if(SND_LIB_MAJOR == 1 && SND_LIB_MINOR == 0 && SND_LIB_SUBMINOR >= 14)
-    dev = device;
-    if (dev.compare(QLatin1String("default")) == 0) {
-        QList<QByteArray> devices = availableDevices(QAudio::AudioOutput);
-        if (!devices.isEmpty())
-            dev = QLatin1String(devices.first().constData());
-    }
-#else
-    if (dev.compare(QLatin1String("default")) == 0) {
-        dev = QLatin1String("hw:0,0");
-    } else {
-        int idx = 0;
-        char *name;
-
-        QString shortName = device.mid(device.indexOf(QLatin1String("="),0)+1);
-
-        while(snd_card_get_name(idx,&name) == 0) {
-            if(shortName.compare(QLatin1String(name)) == 0)
-                break;
-            idx++;
-        }
-        dev = QString(QLatin1String("hw:%1,0")).arg(idx);
-    }
-#endif
+    // For now, just accept only audio/pcm codec
+    if (!format.codec().startsWith(QLatin1String("audio/pcm")))
+        return false;
 
-    snd_pcm_stream_t stream = mode == QAudio::AudioOutput
-                            ? SND_PCM_STREAM_PLAYBACK : SND_PCM_STREAM_CAPTURE;
+    const snd_pcm_format_t pcmFormat = pcmFormatFor(format);
+    if (pcmFormat == SND_PCM_FORMAT_UNKNOWN)
+        return false;
 
-    if (snd_pcm_open(&pcmHandle, dev.toLocal8Bit().constData(), stream, 0) < 0)
+    const QAlsaDeviceCapabilities caps = deviceCapabilities(device, mode);
+    if (!caps.valid)
         return false;
 
-    snd_pcm_nonblock(pcmHandle, 0);
-    snd_pcm_hw_params_alloca(&params);
-    snd_pcm_hw_params_any(pcmHandle, params);
+    if (!caps.formats.contains(pcmFormat))
+        return false;
 
-    // set the values!
-    snd_pcm_hw_params_set_channels(pcmHandle, params, format.channelCount());
-    snd_pcm_hw_params_set_rate(pcmHandle, params, format.sampleRate(), 0);
+    if (format.channelCount() != -1 && !caps.channels.contains((unsigned int)format.channelCount()))
+        return false;
 
-    snd_pcm_format_t pcmFormat = SND_PCM_FORMAT_UNKNOWN;
-    switch (format.sampleSize()) {
-    case 8:
-        if (format.sampleType() == QAudioFormat::SignedInt)
-            pcmFormat = SND_PCM_FORMAT_S8;
-        else if (format.sampleType() == QAudioFormat::UnSignedInt)
-            pcmFormat = SND_PCM_FORMAT_U8;
-        break;
-    case 16:
-        if (format.sampleType() == QAudioFormat::SignedInt) {
-            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
-                      ? SND_PCM_FORMAT_S16_LE : SND_PCM_FORMAT_S16_BE;
-        } else if (format.sampleType() == QAudioFormat::UnSignedInt) {
-            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
-                      ? SND_PCM_FORMAT_U16_LE : SND_PCM_FORMAT_U16_BE;
-        }
-        break;
-    case 32:
-        if (format.sampleType() == QAudioFormat::SignedInt) {
-            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
-                      ? SND_PCM_FORMAT_S32_LE : SND_PCM_FORMAT_S32_BE;
-        } else if (format.sampleType() == QAudioFormat::UnSignedInt) {
-            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
-                      ? SND_PCM_FORMAT_U32_LE : SND_PCM_FORMAT_U32_BE;
-        } else if (format.sampleType() == QAudioFormat::Float) {
-            pcmFormat = format.byteOrder() == QAudioFormat::LittleEndian
-                      ? SND_PCM_FORMAT_FLOAT_LE : SND_PCM_FORMAT_FLOAT_BE;
+    if (format.sampleRate() != -1) {
+        const unsigned int rate = format.sampleRate();
+        if (caps.continuousRates) {
+            if (rate < caps.minRate || rate > caps.maxRate)
+                return false;
+        } else if (!caps.rates.contains(rate)) {
+            return false;
         }
     }
 
-    if (pcmFormat != SND_PCM_FORMAT_UNKNOWN)
-        err = snd_pcm_hw_params_set_format(pcmHandle, params, pcmFormat);
-
-    // For now, just accept only audio/pcm codec
-    if (!format.codec().startsWith(QLatin1String("audio/pcm")))
-        err = -1;
-
-    if (err >= 0 && format.channelCount() != -1) {
-        err = snd_pcm_hw_params_test_channels(pcmHandle, params, format.channelCount());
-        if (err >= 0)
-            err = snd_pcm_hw_params_set_channels(pcmHandle, params, format.channelCount());
-    }
-
-    if (err >= 0 && format.sampleRate() != -1) {
-        err = snd_pcm_hw_params_test_rate(pcmHandle, params, format.sampleRate(), 0);
-        if (err >= 0)
-            err = snd_pcm_hw_params_set_rate(pcmHandle, params, format.sampleRate(), 0);
-    }
-
-    if (err >= 0 && pcmFormat != SND_PCM_FORMAT_UNKNOWN)
-        err = snd_pcm_hw_params_set_format(pcmHandle, params, pcmFormat);
-
-    if (err >= 0)
-        err = snd_pcm_hw_params(pcmHandle, params);
-
-    snd_pcm_close(pcmHandle);
-
-    return (err == 0);
+    return combinationSupported(device, mode, pcmFormat, format.channelCount(), format.sampleRate());
 }
 
 void QAlsaAudioDeviceInfo::updateLists()
@@ -311,34 +487,54 @@ void QAlsaAudioDeviceInfo::updateLists()
     typez.clear();
     codecz.clear();
 
-    if(!handle)
-        open();
-
-    if(!handle)
+    const QAlsaDeviceCapabilities caps = deviceCapabilities(device, mode);
+    if (!caps.valid)
         return;
 
-    for(int i=0; i<(int)MAX_SAMPLE_RATES; i++) {
-        //if(snd_pcm_hw_params_test_rate(handle, params, SAMPLE_RATES[i], dir) == 0)
-        sampleRatez.append(SAMPLE_RATES[i]);
+    for (size_t i = 0; i < sizeof(PROBE_SAMPLE_RATES) / sizeof(PROBE_SAMPLE_RATES[0]); ++i) {
+        const unsigned int rate = PROBE_SAMPLE_RATES[i];
+        if (caps.continuousRates ? (rate >= caps.minRate && rate <= caps.maxRate) : caps.rates.contains(rate))
+            sampleRatez.append(rate);
+    }
+    if (caps.continuousRates && sampleRatez.isEmpty()) {
+        sampleRatez.append(caps.minRate);
+        if (caps.maxRate != caps.minRate)
+            sampleRatez.append(caps.maxRate);
+    }
+
+    foreach (unsigned int channels, caps.channels)
+        channelz.append(channels);
+
+    // Everything that maps onto a sample format the device takes
+    const int sizes[] = { 8, 16, 32 };
+    const QAudioFormat::SampleType types[] = { QAudioFormat::SignedInt, QAudioFormat::UnSignedInt, QAudioFormat::Float };
+    const QAudioFormat::Endian byteOrders[] = { QAudioFormat::LittleEndian, QAudioFormat::BigEndian };
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            for (int k = 0; k < 2; ++k) {
+                QAudioFormat format;
+                format.setSampleSize(sizes[i]);
+                format.setSampleType(types[j]);
+                format.setByteOrder(byteOrders[k]);
+
+                const snd_pcm_format_t pcmFormat = pcmFormatFor(format);
+                if (pcmFormat == SND_PCM_FORMAT_UNKNOWN || !caps.formats.contains(pcmFormat))
+                    continue;
+
+                if (!sizez.contains(sizes[i]))
+                    sizez.append(sizes[i]);
+                if (!typez.contains(types[j]))
+                    typez.append(types[j]);
+                if (!byteOrderz.contains(byteOrders[k]))
+                    byteOrderz.append(byteOrders[k]);
+            }
+        }
     }
-    channelz.append(1);
-    channelz.append(2);
-    if (surround40) channelz.append(4);
-    if (surround51) channelz.append(6);
-    if (surround71) channelz.append(8);
-    sizez.append(8);
-    sizez.append(16);
-    sizez.append(32);
-    byteOrderz.append(QAudioFormat::LittleEndian);
-    byteOrderz.append(QAudioFormat::BigEndian);
-    typez.append(QAudioFormat::SignedInt);
-    typez.append(QAudioFormat::UnSignedInt);
-    typez.append(QAudioFormat::Float);
+
     codecz.append(QLatin1String("audio/pcm"));
-    close();
 }
 
-QList<QByteArray> QAlsaAudioDeviceInfo::availableDevices(QAudio::Mode mode)
+static QList<QByteArray> enumerateDevices(QAudio::Mode mode)
 {
     QList<QByteArray> devices;
     QByteArray filter;
@@ -400,6 +596,28 @@ QList<QByteArray> QAlsaAudioDeviceInfo::availableDevices(QAudio::Mode mode)
     return devices;
 }
 
+QList<QByteArray> QAlsaAudioDeviceInfo::availableDevices(QAudio::Mode mode)
+{
+    QAlsaCapabilityCache *cache = capabilityCache();
+    QMutexLocker locker(&cache->mutex);
+    checkCardsLocked(cache);
+
+    QHash<int, QList<QByteArray> >::const_iterator it = cache->devices.constFind(int(mode));
+    if (it != cache->devices.constEnd())
+        return it.value();
+
+    const QList<QByteArray> devices = enumerateDevices(mode);
+    cache->devices.insert(int(mode), devices);
+    return devices;
+}
+
+// Probes all devices on a pool thread, so that the first format
+// negotiation doesn't have to open them.
+void QAlsaAudioDeviceInfo::prewarmCapabilities()
+{
+    QThreadPool::globalInstance()->start(new QAlsaCapabilityPrewarmer);
+}
+
 QByteArray QAlsaAudioDeviceInfo::defaultInputDevice()
 {
     QList<QByteArray> devices = availableDevices(QAudio::AudioInput);
@@ -418,47 +636,4 @@ QByteArray QAlsaAudioDeviceInfo::defaultOutputDevice()
     return devices.first();
 }
 
-void QAlsaAudioDeviceInfo::checkSurround()
-{
-    surround40 = false;
-    surround51 = false;
-    surround71 = false;
-
-    void **hints;
-    char *name, *descr, *io;
-    int card = -1;
-
-    while (snd_card_next(&card) == 0 && card >= 0) {
-        if (snd_device_name_hint(card, "pcm", &hints) < 0)
-            continue;
-
-        void **n = hints;
-        while (*n != NULL) {
-            name = snd_device_name_get_hint(*n, "NAME");
-            descr = snd_device_name_get_hint(*n, "DESC");
-            io = snd_device_name_get_hint(*n, "IOID");
-            if((name != NULL) && (descr != NULL)) {
-                QString deviceName = QLatin1String(name);
-                if (mode == QAudio::AudioOutput) {
-                    if(deviceName.contains(QLatin1String("surround40")))
-                        surround40 = true;
-                    if(deviceName.contains(QLatin1String("surround51")))
-                        surround51 = true;
-                    if(deviceName.contains(QLatin1String("surround71")))
-                        surround71 = true;
-                }
-            }
-            if(name != NULL)
-                free(name);
-            if(descr != NULL)
-                free(descr);
-            if(io != NULL)
-                free(io);
-            ++n;
-        }
-
-        snd_device_name_free_hint(hints);
-    }
-}
-
 QT_END_NAMESPACE
@@ -68,10 +68,6 @@
 QT_BEGIN_NAMESPACE
 
 
-const unsigned int MAX_SAMPLE_RATES = 5;
-const unsigned int SAMPLE_RATES[] =
-    { 8000, 11025, 22050, 44100, 48000 };
-
 class QAlsaAudioDeviceInfo : public QAbstractAudioDeviceInfo
 {
     Q_OBJECT
@@ -93,16 +89,9 @@ public:
     static QByteArray defaultInputDevice();
     static QByteArray defaultOutputDevice();
     static QList<QByteArray> availableDevices(QAudio::Mode);
+    static void prewarmCapabilities();
 
 private:
-    bool open();
-    void close();
-
-    void checkSurround();
-    bool surround40;
-    bool surround51;
-    bool surround71;
-
     QString device;
     QAudio::Mode mode;
     QAudioFormat nearest;
@@ -112,8 +101,6 @@ private:
     QList<QAudioFormat::Endian> byteOrderz;
     QStringList codecz;
     QList<QAudioFormat::SampleType> typez;
-    snd_pcm_t* handle;
-    snd_pcm_hw_params_t *params;
 };
 
 QT_END_NAMESPACE
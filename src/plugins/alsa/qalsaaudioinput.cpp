@@ -52,11 +52,24 @@
 
 #include <QtCore/qcoreapplication.h>
 #include <QtMultimedia/private/qaudiohelpers_p.h>
+#include <QtMultimedia/private/qmultimediaenvironment_p.h>
 #include "qalsaaudioinput.h"
 #include "qalsaaudiodeviceinfo.h"
 
+#include <pthread.h>
+#include <sched.h>
+
 QT_BEGIN_NAMESPACE
 
+const unsigned int DefaultPeriodTimeUs = 20000;
+const unsigned int DefaultBufferTimeUs = 100000;
+const unsigned int LatencyTargetPeriods = 4;
+
+static bool mmapAccessRequested()
+{
+    return qt_multimedia_envFlag("QT_ALSA_MMAP", false);
+}
+
 //#define DEBUG_AUDIO 1
 
 QAlsaAudioInput::QAlsaAudioInput(const QByteArray &device)
@@ -67,8 +80,8 @@ QAlsaAudioInput::QAlsaAudioInput(const QByteArray &device)
     pcmformat = SND_PCM_FORMAT_S16;
     buffer_size = 0;
     period_size = 0;
-    buffer_time = 100000;
-    period_time = 20000;
+    buffer_time = DefaultBufferTimeUs;
+    period_time = DefaultPeriodTimeUs;
     totalTimeValue = 0;
     intervalTime = 1000;
     errorState = QAudio::NoError;
@@ -78,6 +91,12 @@ QAlsaAudioInput::QAlsaAudioInput(const QByteArray &device)
     resuming = false;
 
     m_volume = 1.0f;
+    m_latencyTarget = 0;
+    m_captureCallback = 0;
+    m_captureUserData = 0;
+    m_capturer = 0;
+    m_capturerGeneration = 0;
+    m_monotonicTimestamps = false;
 
     m_device = device;
 
@@ -95,6 +114,7 @@ QAlsaAudioInput::~QAlsaAudioInput()
 
 void QAlsaAudioInput::setVolume(qreal vol)
 {
+    QMutexLocker locker(&m_captureMutex);
     m_volume = vol;
 }
 
@@ -243,6 +263,33 @@ void QAlsaAudioInput::start(QIODevice* device)
     emit stateChanged(deviceState);
 }
 
+bool QAlsaAudioInput::startCapturing(QAudio::CaptureCallback callback, void *userData)
+{
+    if(deviceState != QAudio::StoppedState)
+        close();
+
+    if(!pullMode && audioSource)
+        delete audioSource;
+
+    // The capture thread calls back, there is no device to write to
+    pullMode = true;
+    audioSource = 0;
+    m_captureCallback = callback;
+    m_captureUserData = userData;
+
+    deviceState = QAudio::ActiveState;
+
+    if( !open() ) {
+        m_captureCallback = 0;
+        m_captureUserData = 0;
+        return false;
+    }
+
+    emit stateChanged(deviceState);
+
+    return true;
+}
+
 QIODevice* QAlsaAudioInput::start()
 {
     if(deviceState != QAudio::StoppedState)
@@ -312,10 +359,14 @@ bool QAlsaAudioInput::open()
     QList<QByteArray> devices = QAlsaAudioDeviceInfo::availableDevices(QAudio::AudioInput);
     if(dev.compare(QLatin1String("default")) == 0) {
 #if(SND_LIB_MAJOR == 1 && SND_LIB_MINOR == 0 && SND_LIB_SUBMINOR >= 14)
-        if (devices.size() > 0)
+        if (devices.size() > 0) {
             dev = QLatin1String(devices.first());
-        else
+        } else {
+            errorState = QAudio::OpenError;
+            deviceState = QAudio::StoppedState;
+            emit stateChanged(deviceState);
             return false;
+        }
 #else
         dev = QLatin1String("hw:0,0");
 #endif
@@ -351,6 +402,17 @@ bool QAlsaAudioInput::open()
     }
     snd_pcm_nonblock( handle, 0 );
 
+    // Start from the defaults on every open, the members only hold what
+    // the last open ended up with.
+    unsigned int periodTime = DefaultPeriodTimeUs;
+    unsigned int bufferTime = DefaultBufferTimeUs;
+
+    // The whole device buffer is the latency, split it into a few periods
+    if (m_latencyTarget > 0) {
+        bufferTime = (unsigned int)m_latencyTarget;
+        periodTime = qMax(1000u, bufferTime / LatencyTargetPeriods);
+    }
+
     // Step 2: Set the desired HW parameters.
     snd_pcm_hw_params_alloca( &hwparams );
 
@@ -371,7 +433,13 @@ bool QAlsaAudioInput::open()
         }
     }
     if ( !fatal ) {
+        access = mmapAccessRequested() ? SND_PCM_ACCESS_MMAP_INTERLEAVED : SND_PCM_ACCESS_RW_INTERLEAVED;
         err = snd_pcm_hw_params_set_access( handle, hwparams, access );
+        if ( err < 0 && access == SND_PCM_ACCESS_MMAP_INTERLEAVED ) {
+            // Not every device can be mapped (e.g. the pulse plugin), copy instead
+            access = SND_PCM_ACCESS_RW_INTERLEAVED;
+            err = snd_pcm_hw_params_set_access( handle, hwparams, access );
+        }
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioInput: snd_pcm_hw_params_set_access: err = %1").arg(err);
@@ -399,14 +467,14 @@ bool QAlsaAudioInput::open()
         }
     }
     if ( !fatal ) {
-        err = snd_pcm_hw_params_set_buffer_time_near(handle, hwparams, &buffer_time, &dir);
+        err = snd_pcm_hw_params_set_buffer_time_near(handle, hwparams, &bufferTime, &dir);
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioInput: snd_pcm_hw_params_set_buffer_time_near: err = %1").arg(err);
         }
     }
     if ( !fatal ) {
-        err = snd_pcm_hw_params_set_period_time_near(handle, hwparams, &period_time, &dir);
+        err = snd_pcm_hw_params_set_period_time_near(handle, hwparams, &periodTime, &dir);
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioInput: snd_pcm_hw_params_set_period_time_near: err = %1").arg(err);
@@ -447,6 +515,13 @@ bool QAlsaAudioInput::open()
     snd_pcm_sw_params_set_start_threshold(handle,swparams,period_frames);
     snd_pcm_sw_params_set_stop_threshold(handle,swparams,buffer_frames);
     snd_pcm_sw_params_set_avail_min(handle, swparams,period_frames);
+    // Have the driver timestamp hardware pointer updates, see updateTimestamp()
+    snd_pcm_sw_params_set_tstamp_mode(handle, swparams, SND_PCM_TSTAMP_ENABLE);
+    m_monotonicTimestamps = snd_pcm_hw_params_is_monotonic(hwparams);
+#if SND_LIB_VERSION >= 0x01001d
+    if (snd_pcm_sw_params_set_tstamp_type(handle, swparams, SND_PCM_TSTAMP_TYPE_MONOTONIC) == 0)
+        m_monotonicTimestamps = true;
+#endif
     snd_pcm_sw_params(handle, swparams);
 
     // Step 4: Prepare audio
@@ -457,16 +532,22 @@ bool QAlsaAudioInput::open()
     // Step 5: Setup timer
     bytesAvailable = checkBytesReady();
 
-    if(pullMode)
+    if(pullMode && audioSource)
         connect(audioSource,SIGNAL(readyRead()),this,SLOT(userFeed()));
 
-    // Step 6: Start audio processing
-    chunks = buffer_size/period_size;
-    timer->start(period_time*chunks/2000);
-
     errorState  = QAudio::NoError;
 
     totalTimeValue = 0;
+    m_timestamp = QAudio::Timestamp();
+    m_driftEstimator.reset(settings.sampleRate());
+
+    // Step 6: Start audio processing
+    if (m_captureCallback) {
+        startCapturer();
+    } else {
+        chunks = buffer_size/period_size;
+        timer->start(period_time*chunks/2000);
+    }
 
     return true;
 }
@@ -474,6 +555,13 @@ bool QAlsaAudioInput::open()
 void QAlsaAudioInput::close()
 {
     timer->stop();
+    stopCapturer();
+    m_captureCallback = 0;
+    m_captureUserData = 0;
+
+    m_captureMutex.lock();
+    m_timestamp = QAudio::Timestamp();
+    m_captureMutex.unlock();
 
     if ( handle ) {
         snd_pcm_drop( handle );
@@ -542,19 +630,27 @@ qint64 QAlsaAudioInput::read(char* data, qint64 len)
         int count=0;
         int err = 0;
         while(count < 5 && bytesToRead > 0) {
-            char buffer[bytesToRead];
             int chunks = bytesToRead / period_size;
             int frames = chunks * period_frames;
             if (frames > (int)buffer_frames)
                 frames = buffer_frames;
 
-            int readFrames = snd_pcm_readi(handle, buffer, frames);
-            bytesRead = snd_pcm_frames_to_bytes(handle, readFrames);
-            if (m_volume < 1.0f)
-                QAudioHelperInternal::qMultiplySamples(m_volume, settings, buffer, buffer, bytesRead);
+            int readFrames;
+            if (access == SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+                readFrames = readMappedFrames(frames);
+                bytesRead = snd_pcm_frames_to_bytes(handle, readFrames);
+            } else {
+                char buffer[bytesToRead];
+                readFrames = snd_pcm_readi(handle, buffer, frames);
+                bytesRead = snd_pcm_frames_to_bytes(handle, readFrames);
+                if (readFrames >= 0) {
+                    if (m_volume < 1.0f)
+                        QAudioHelperInternal::qMultiplySamples(m_volume, settings, buffer, buffer, bytesRead);
+                    ringBuffer.write(buffer, bytesRead);
+                }
+            }
 
             if (readFrames >= 0) {
-                ringBuffer.write(buffer, bytesRead);
 #ifdef DEBUG_AUDIO
                 qDebug() << QString::fromLatin1("read in bytes = %1 (frames=%2)").arg(bytesRead).arg(readFrames).toLatin1().constData();
 #endif
@@ -648,6 +744,39 @@ qint64 QAlsaAudioInput::read(char* data, qint64 len)
     return 0;
 }
 
+// Copies up to \a frames captured frames from the mapped device buffer
+// straight into the ring buffer. Nothing but the copy happens while an area
+// is open, so unlike handing the area to the sink, the device can't be closed
+// under it. Returns the number of frames read, or a negative error code.
+int QAlsaAudioInput::readMappedFrames(int frames)
+{
+    int framesRead = 0;
+    while (framesRead < frames) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t got = frames - framesRead;
+        int err = snd_pcm_mmap_begin(handle, &areas, &offset, &got);
+        if (err < 0)
+            return framesRead > 0 ? framesRead : err;
+        if (got == 0)
+            break;
+
+        // Interleaved access: every channel lives in the same area
+        char *src = (char *)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8;
+        const int bytes = snd_pcm_frames_to_bytes(handle, got);
+        if (m_volume < 1.0f)
+            QAudioHelperInternal::qMultiplySamples(m_volume, settings, src, src, bytes);
+        ringBuffer.write(src, bytes);
+
+        // The frames are copied either way; a failed commit means an overrun,
+        // which the next checkBytesReady() recovers from
+        framesRead += got;
+        if (snd_pcm_mmap_commit(handle, offset, got) < 0)
+            break;
+    }
+    return framesRead;
+}
+
 void QAlsaAudioInput::resume()
 {
     if(deviceState == QAudio::SuspendedState) {
@@ -666,8 +795,12 @@ void QAlsaAudioInput::resume()
         }
         resuming = true;
         deviceState = QAudio::ActiveState;
-        int chunks = buffer_size/period_size;
-        timer->start(period_time*chunks/2000);
+        if (m_captureCallback) {
+            startCapturer();
+        } else {
+            int chunks = buffer_size/period_size;
+            timer->start(period_time*chunks/2000);
+        }
         emit stateChanged(deviceState);
     }
 }
@@ -682,6 +815,16 @@ int QAlsaAudioInput::bufferSize() const
     return buffer_size;
 }
 
+void QAlsaAudioInput::setLatencyTarget(qint64 usecs)
+{
+    m_latencyTarget = qMax(qint64(0), usecs);
+}
+
+qint64 QAlsaAudioInput::latencyTarget() const
+{
+    return m_latencyTarget;
+}
+
 int QAlsaAudioInput::periodSize() const
 {
     return period_size;
@@ -689,6 +832,7 @@ int QAlsaAudioInput::periodSize() const
 
 void QAlsaAudioInput::setNotifyInterval(int ms)
 {
+    QMutexLocker locker(&m_captureMutex);
     intervalTime = qMax(0, ms);
 }
 
@@ -699,6 +843,7 @@ int QAlsaAudioInput::notifyInterval() const
 
 qint64 QAlsaAudioInput::processedUSecs() const
 {
+    QMutexLocker locker(&m_captureMutex);
     qint64 result = qint64(1000000) * totalTimeValue /
         (settings.channelCount()*(settings.sampleSize()/8)) /
         settings.sampleRate();
@@ -706,10 +851,54 @@ qint64 QAlsaAudioInput::processedUSecs() const
     return result;
 }
 
+QAudio::Timestamp QAlsaAudioInput::timestamp() const
+{
+    QMutexLocker locker(&m_captureMutex);
+    return m_timestamp;
+}
+
+qreal QAlsaAudioInput::clockDrift() const
+{
+    QMutexLocker locker(&m_captureMutex);
+    return m_driftEstimator.drift();
+}
+
+// Called from whichever thread reads from the device, right after reading,
+// so that the read total and the delay ALSA reports agree.
+void QAlsaAudioInput::updateTimestamp()
+{
+    snd_pcm_status_t *status;
+    snd_pcm_status_alloca(&status);
+    if (snd_pcm_status(handle, status) < 0)
+        return;
+
+    if (snd_pcm_status_get_state(status) != SND_PCM_STATE_RUNNING)
+        return;
+
+    // The time of the last hardware pointer update, which the delay refers to
+    snd_htimestamp_t htstamp;
+    snd_pcm_status_get_htstamp(status, &htstamp);
+    if (htstamp.tv_sec == 0 && htstamp.tv_nsec == 0)
+        return;
+
+    // For capture the delay is what the device has captured but nobody has read yet
+    const snd_pcm_sframes_t delay = snd_pcm_status_get_delay(status);
+    qint64 systemTime = qint64(htstamp.tv_sec) * 1000000 + htstamp.tv_nsec / 1000;
+    if (!m_monotonicTimestamps)
+        systemTime = QAudioClockInternal::monotonicFromRealtime(systemTime);
+
+    QMutexLocker locker(&m_captureMutex);
+    m_timestamp.framePosition = snd_pcm_bytes_to_frames(handle, totalTimeValue) + delay;
+    m_timestamp.systemTime = systemTime;
+    m_timestamp.latency = qint64(1000000) * delay / settings.sampleRate();
+    m_driftEstimator.addSample(m_timestamp);
+}
+
 void QAlsaAudioInput::suspend()
 {
     if(deviceState == QAudio::ActiveState||resuming) {
         timer->stop();
+        stopCapturer();
         deviceState = QAudio::SuspendedState;
         emit stateChanged(deviceState);
     }
@@ -755,6 +944,8 @@ bool QAlsaAudioInput::deviceReady()
         }
     }
 
+    updateTimestamp();
+
     if(intervalTime && (timeStamp.elapsed() + elapsedTimeOffset) > intervalTime) {
         emit notify();
         elapsedTimeOffset = timeStamp.elapsed() + elapsedTimeOffset - intervalTime;
@@ -785,6 +976,195 @@ void QAlsaAudioInput::drain()
         snd_pcm_drain(handle);
 }
 
+void QAlsaAudioInput::startCapturer()
+{
+    if (m_capturer || !handle)
+        return;
+
+    m_capturer = new QAlsaAudioInputCapturer(this, m_capturerGeneration);
+    connect(m_capturer, SIGNAL(stateChanged(int,QAudio::State,QAudio::Error)),
+            SLOT(capturerStateChanged(int,QAudio::State,QAudio::Error)), Qt::QueuedConnection);
+    connect(m_capturer, SIGNAL(notify(int)), SLOT(capturerNotify(int)), Qt::QueuedConnection);
+    m_capturer->start(QThread::TimeCriticalPriority);
+}
+
+void QAlsaAudioInput::stopCapturer()
+{
+    if (!m_capturer)
+        return;
+
+    m_capturer->requestStop();
+    m_capturer->wait();
+    delete m_capturer;
+    m_capturer = 0;
+
+    // Whatever the stopped capturer still has queued for us is stale
+    ++m_capturerGeneration;
+}
+
+void QAlsaAudioInput::capturerStateChanged(int generation, QAudio::State state, QAudio::Error error)
+{
+    if (!m_capturer || generation != m_capturerGeneration)
+        return;
+
+    if (state == QAudio::StoppedState)
+        close();
+
+    errorState = error;
+    if (errorState != QAudio::NoError)
+        emit errorChanged(errorState);
+
+    if (deviceState != state) {
+        deviceState = state;
+        emit stateChanged(deviceState);
+    }
+}
+
+void QAlsaAudioInput::capturerNotify(int generation)
+{
+    if (m_capturer && generation == m_capturerGeneration)
+        emit notify();
+}
+
+QAlsaAudioInputCapturer::QAlsaAudioInputCapturer(QAlsaAudioInput *input, int generation)
+    : m_input(input)
+    , m_generation(generation)
+    , m_quit(0)
+{
+}
+
+void QAlsaAudioInputCapturer::requestStop()
+{
+    m_quit.store(1);
+}
+
+void QAlsaAudioInputCapturer::raisePriority()
+{
+    // Best effort, as for the output feeder thread
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+}
+
+bool QAlsaAudioInputCapturer::recover(int err)
+{
+    if (err == -EPIPE)
+        emit stateChanged(m_generation, QAudio::ActiveState, QAudio::UnderrunError);
+
+    if (snd_pcm_recover(m_input->handle, err, 1) < 0) {
+        emit stateChanged(m_generation, QAudio::StoppedState, QAudio::FatalError);
+        return false;
+    }
+
+    // A recovered capture stream has to be restarted by hand
+    snd_pcm_start(m_input->handle);
+    return true;
+}
+
+void QAlsaAudioInputCapturer::run()
+{
+    raisePriority();
+
+    snd_pcm_t *handle = m_input->handle;
+    const snd_pcm_sframes_t periodFrames = m_input->period_frames;
+    const snd_pcm_sframes_t bufferFrames = m_input->buffer_frames;
+    const unsigned long periodMs = qMax(1u, m_input->period_time / 1000);
+    const bool mmap = m_input->access == SND_PCM_ACCESS_MMAP_INTERLEAVED;
+    QByteArray buffer;
+    if (!mmap)
+        buffer.resize(snd_pcm_frames_to_bytes(handle, bufferFrames));
+
+    if (snd_pcm_state(handle) == SND_PCM_STATE_PREPARED)
+        snd_pcm_start(handle);
+
+    QTime notifyTime;
+    notifyTime.start();
+    qint64 notifyOffset = 0;
+
+    while (!m_quit.load()) {
+        int err = snd_pcm_wait(handle, 2 * periodMs);
+        if (m_quit.load())
+            break;
+        if (err < 0 && !recover(err))
+            return;
+
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
+        if (avail < 0) {
+            if (!recover(avail))
+                return;
+            continue;
+        }
+        if (avail < periodFrames)
+            continue;
+
+        snd_pcm_sframes_t frames = qMin(avail, bufferFrames);
+        frames -= frames % periodFrames;
+
+        // Volume and notify interval can be changed from the GUI thread
+        m_input->m_captureMutex.lock();
+        const qreal volume = m_input->m_volume;
+        const int interval = m_input->intervalTime;
+        m_input->m_captureMutex.unlock();
+
+        snd_pcm_sframes_t captured = 0;
+        if (mmap) {
+            const snd_pcm_channel_area_t *areas;
+            snd_pcm_uframes_t offset;
+            snd_pcm_uframes_t got = frames;
+            err = snd_pcm_mmap_begin(handle, &areas, &offset, &got);
+            if (err < 0) {
+                if (!recover(err))
+                    return;
+                continue;
+            }
+            if (got == 0)
+                continue;
+
+            // Interleaved access: every channel lives in the same area
+            char *src = (char *)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8;
+            if (volume < 1.0f) {
+                QAudioHelperInternal::qMultiplySamples(volume, m_input->settings,
+                                                       src, src, snd_pcm_frames_to_bytes(handle, got));
+            }
+            m_input->m_captureCallback(src, int(got), m_input->m_captureUserData);
+
+            captured = snd_pcm_mmap_commit(handle, offset, got);
+            if (captured < 0) {
+                if (!recover(captured))
+                    return;
+                continue;
+            }
+        } else {
+            captured = snd_pcm_readi(handle, buffer.data(), frames);
+            if (captured < 0) {
+                if (!recover(captured))
+                    return;
+                continue;
+            }
+            if (captured == 0)
+                continue;
+
+            if (volume < 1.0f) {
+                QAudioHelperInternal::qMultiplySamples(volume, m_input->settings,
+                                                       buffer.constData(), buffer.data(),
+                                                       snd_pcm_frames_to_bytes(handle, captured));
+            }
+            m_input->m_captureCallback(buffer.constData(), int(captured), m_input->m_captureUserData);
+        }
+
+        m_input->m_captureMutex.lock();
+        m_input->totalTimeValue += snd_pcm_frames_to_bytes(handle, captured);
+        m_input->m_captureMutex.unlock();
+        m_input->updateTimestamp();
+
+        if (interval && (notifyTime.elapsed() + notifyOffset) > interval) {
+            emit notify(m_generation);
+            notifyOffset = notifyTime.elapsed() + notifyOffset - interval;
+            notifyTime.restart();
+        }
+    }
+}
+
 InputPrivate::InputPrivate(QAlsaAudioInput* audio)
 {
     audioDevice = qobject_cast<QAlsaAudioInput*>(audio);
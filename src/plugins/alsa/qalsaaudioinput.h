@@ -62,15 +62,20 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qdatetime.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qatomic.h>
 
 #include <QtMultimedia/qaudio.h>
 #include <QtMultimedia/qaudiodeviceinfo.h>
 #include <QtMultimedia/qaudiosystem.h>
+#include <QtMultimedia/private/qaudioclock_p.h>
 
 QT_BEGIN_NAMESPACE
 
 
 class InputPrivate;
+class QAlsaAudioInputCapturer;
 
 class RingBuffer
 {
@@ -95,9 +100,11 @@ private:
     QByteArray m_data;
 };
 
-class QAlsaAudioInput : public QAbstractAudioInput
+class QAlsaAudioInput : public QAbstractAudioInput, public QAudioInputExtensionInterface
 {
+    friend class QAlsaAudioInputCapturer;
     Q_OBJECT
+    Q_INTERFACES(QAudioInputExtensionInterface)
 public:
     QAlsaAudioInput(const QByteArray &device);
     ~QAlsaAudioInput();
@@ -106,6 +113,7 @@ public:
 
     void start(QIODevice* device);
     QIODevice* start();
+    bool startCapturing(QAudio::CaptureCallback callback, void *userData);
     void stop();
     void reset();
     void suspend();
@@ -114,10 +122,14 @@ public:
     int periodSize() const;
     void setBufferSize(int value);
     int bufferSize() const;
+    void setLatencyTarget(qint64 usecs);
+    qint64 latencyTarget() const;
     void setNotifyInterval(int milliSeconds);
     int notifyInterval() const;
     qint64 processedUSecs() const;
     qint64 elapsedUSecs() const;
+    QAudio::Timestamp timestamp() const;
+    qreal clockDrift() const;
     QAudio::Error error() const;
     QAudio::State state() const;
     void setFormat(const QAudioFormat& fmt);
@@ -135,14 +147,20 @@ public:
 private slots:
     void userFeed();
     bool deviceReady();
+    void capturerStateChanged(int generation, QAudio::State state, QAudio::Error error);
+    void capturerNotify(int generation);
 
 private:
     int checkBytesReady();
+    int readMappedFrames(int frames);
     int xrun_recovery(int err);
     int setFormat();
     bool open();
     void close();
     void drain();
+    void startCapturer();
+    void stopCapturer();
+    void updateTimestamp();
 
     QTimer* timer;
     QTime timeStamp;
@@ -161,9 +179,41 @@ private:
     snd_pcm_uframes_t period_frames;
     snd_pcm_access_t access;
     snd_pcm_format_t pcmformat;
-    snd_timestamp_t* timestamp;
     snd_pcm_hw_params_t *hwparams;
     qreal m_volume;
+    qint64 m_latencyTarget;
+    QAudio::CaptureCallback m_captureCallback;
+    void *m_captureUserData;
+    QAlsaAudioInputCapturer *m_capturer;
+    int m_capturerGeneration;
+    mutable QMutex m_captureMutex;
+    QAudio::Timestamp m_timestamp;
+    QAudioClockDriftEstimator m_driftEstimator;
+    bool m_monotonicTimestamps;
+};
+
+class QAlsaAudioInputCapturer : public QThread
+{
+    Q_OBJECT
+public:
+    QAlsaAudioInputCapturer(QAlsaAudioInput *input, int generation);
+
+    void requestStop();
+
+signals:
+    void stateChanged(int generation, QAudio::State state, QAudio::Error error);
+    void notify(int generation);
+
+protected:
+    void run();
+
+private:
+    void raisePriority();
+    bool recover(int err);
+
+    QAlsaAudioInput *m_input;
+    const int m_generation;
+    QAtomicInt m_quit;
 };
 
 class InputPrivate : public QIODevice
@@ -52,13 +52,41 @@
 
 #include <QtCore/qcoreapplication.h>
 #include <QtMultimedia/private/qaudiohelpers_p.h>
+#include <QtMultimedia/private/qmultimediaenvironment_p.h>
 #include "qalsaaudiooutput.h"
 #include "qalsaaudiodeviceinfo.h"
 
+#include <pthread.h>
+#include <sched.h>
+
 QT_BEGIN_NAMESPACE
 
 //#define DEBUG_AUDIO 1
 
+const unsigned int DefaultPeriodTimeUs = 20000;
+const unsigned int DefaultBufferTimeUs = 100000;
+const unsigned int FeederPeriodTimeUs = 5000;
+const unsigned int FeederBufferTimeUs = 20000;
+const unsigned int LatencyTargetPeriods = 4;
+
+static bool feederThreadRequested()
+{
+    return qt_multimedia_envFlag("QT_ALSA_OUTPUT_THREAD", false);
+}
+
+static inline snd_pcm_sframes_t writeFrames(snd_pcm_t *handle, snd_pcm_access_t access,
+                                             const void *data, snd_pcm_uframes_t frames)
+{
+    if (access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        return snd_pcm_mmap_writei(handle, data, frames);
+    return snd_pcm_writei(handle, data, frames);
+}
+
+static bool mmapAccessRequested()
+{
+    return qt_multimedia_envFlag("QT_ALSA_MMAP", false);
+}
+
 QAlsaAudioOutput::QAlsaAudioOutput(const QByteArray &device)
 {
     bytesAvailable = 0;
@@ -69,8 +97,8 @@ QAlsaAudioOutput::QAlsaAudioOutput(const QByteArray &device)
     period_frames = 0;
     buffer_size = 0;
     period_size = 0;
-    buffer_time = 100000;
-    period_time = 20000;
+    buffer_time = DefaultBufferTimeUs;
+    period_time = DefaultPeriodTimeUs;
     totalTimeValue = 0;
     intervalTime = 1000;
     audioBuffer = 0;
@@ -82,6 +110,12 @@ QAlsaAudioOutput::QAlsaAudioOutput(const QByteArray &device)
     opened = false;
 
     m_volume = 1.0f;
+    m_latencyTarget = 0;
+    m_renderCallback = 0;
+    m_renderUserData = 0;
+    m_feeder = 0;
+    m_feederGeneration = 0;
+    m_monotonicTimestamps = false;
 
     m_device = device;
 
@@ -99,6 +133,7 @@ QAlsaAudioOutput::~QAlsaAudioOutput()
 
 void QAlsaAudioOutput::setVolume(qreal vol)
 {
+    QMutexLocker locker(&m_feederMutex);
     m_volume = vol;
 }
 
@@ -240,6 +275,46 @@ void QAlsaAudioOutput::start(QIODevice* device)
     emit stateChanged(deviceState);
 }
 
+bool QAlsaAudioOutput::startRendering(QAudio::RenderCallback callback, void *userData)
+{
+    if(deviceState != QAudio::StoppedState)
+        deviceState = QAudio::StoppedState;
+
+    errorState = QAudio::NoError;
+
+    // Handle change of mode
+    if(audioSource && !pullMode) {
+        delete audioSource;
+        audioSource = 0;
+    }
+
+    close();
+
+    // The feeder thread calls back, see renderToDevice()
+    pullMode = true;
+    audioSource = 0;
+    m_renderCallback = callback;
+    m_renderUserData = userData;
+
+    deviceState = QAudio::ActiveState;
+
+    if (!open()) {
+        m_renderCallback = 0;
+        m_renderUserData = 0;
+        deviceState = QAudio::StoppedState;
+        if (errorState == QAudio::NoError) {
+            errorState = QAudio::OpenError;
+            emit errorChanged(errorState);
+        }
+        emit stateChanged(deviceState);
+        return false;
+    }
+
+    emit stateChanged(deviceState);
+
+    return true;
+}
+
 QIODevice* QAlsaAudioOutput::start()
 {
     if(deviceState != QAudio::StoppedState)
@@ -315,10 +390,14 @@ bool QAlsaAudioOutput::open()
     QList<QByteArray> devices = QAlsaAudioDeviceInfo::availableDevices(QAudio::AudioOutput);
     if(dev.compare(QLatin1String("default")) == 0) {
 #if(SND_LIB_MAJOR == 1 && SND_LIB_MINOR == 0 && SND_LIB_SUBMINOR >= 14)
-        if (devices.size() > 0)
+        if (devices.size() > 0) {
             dev = QLatin1String(devices.first());
-        else
+        } else {
+            errorState = QAudio::OpenError;
+            deviceState = QAudio::StoppedState;
+            emit errorChanged(errorState);
             return false;
+        }
 #else
         dev = QLatin1String("hw:0,0");
 #endif
@@ -354,6 +433,24 @@ bool QAlsaAudioOutput::open()
     }
     snd_pcm_nonblock( handle, 0 );
 
+    // What to ask the device for is worked out afresh on every open, the
+    // members only hold what the last open ended up with.
+    unsigned int periodTime = DefaultPeriodTimeUs;
+    unsigned int bufferTime = DefaultBufferTimeUs;
+
+    // The feeder thread does not depend on the event loop, so it can keep
+    // up with much shorter periods than the timer.
+    if (useFeederThread()) {
+        periodTime = FeederPeriodTimeUs;
+        bufferTime = FeederBufferTimeUs;
+    }
+
+    // The whole device buffer is the latency, split it into a few periods
+    if (m_latencyTarget > 0) {
+        bufferTime = (unsigned int)m_latencyTarget;
+        periodTime = qMax(1000u, bufferTime / LatencyTargetPeriods);
+    }
+
     // Step 2: Set the desired HW parameters.
     snd_pcm_hw_params_alloca( &hwparams );
 
@@ -374,7 +471,13 @@ bool QAlsaAudioOutput::open()
         }
     }
     if ( !fatal ) {
+        access = mmapAccessRequested() ? SND_PCM_ACCESS_MMAP_INTERLEAVED : SND_PCM_ACCESS_RW_INTERLEAVED;
         err = snd_pcm_hw_params_set_access( handle, hwparams, access );
+        if ( err < 0 && access == SND_PCM_ACCESS_MMAP_INTERLEAVED ) {
+            // Not every device can be mapped (e.g. the pulse plugin), copy instead
+            access = SND_PCM_ACCESS_RW_INTERLEAVED;
+            err = snd_pcm_hw_params_set_access( handle, hwparams, access );
+        }
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioOutput: snd_pcm_hw_params_set_access: err = %1").arg(err);
@@ -419,39 +522,39 @@ bool QAlsaAudioOutput::open()
             fatal = true;
             errMessage = QString::fromLatin1("QAudioOutput: buffer/period min and max: err = %1").arg(err);
         } else {
-            if (maxBufferTime < buffer_time || buffer_time < minBufferTime || maxPeriodTime < period_time || minPeriodTime > period_time) {
+            if (maxBufferTime < bufferTime || bufferTime < minBufferTime || maxPeriodTime < periodTime || minPeriodTime > periodTime) {
 #ifdef DEBUG_AUDIO
                 qDebug()<<"defaults out of range";
                 qDebug()<<"pmin="<<minPeriodTime<<", pmax="<<maxPeriodTime<<", bmin="<<minBufferTime<<", bmax="<<maxBufferTime;
 #endif
-                period_time = minPeriodTime;
-                if (period_time*4 <= maxBufferTime) {
+                periodTime = minPeriodTime;
+                if (periodTime*4 <= maxBufferTime) {
                     // Use 4 periods if possible
-                    buffer_time = period_time*4;
+                    bufferTime = periodTime*4;
                     chunks = 4;
-                } else if (period_time*2 <= maxBufferTime) {
+                } else if (periodTime*2 <= maxBufferTime) {
                     // Use 2 periods if possible
-                    buffer_time = period_time*2;
+                    bufferTime = periodTime*2;
                     chunks = 2;
                 } else {
                     qWarning()<<"QAudioOutput: alsa only supports single period!";
                     fatal = true;
                 }
 #ifdef DEBUG_AUDIO
-                qDebug()<<"used: buffer_time="<<buffer_time<<", period_time="<<period_time;
+                qDebug()<<"used: bufferTime="<<bufferTime<<", periodTime="<<periodTime;
 #endif
             }
         }
     }
     if ( !fatal ) {
-        err = snd_pcm_hw_params_set_buffer_time_near(handle, hwparams, &buffer_time, &dir);
+        err = snd_pcm_hw_params_set_buffer_time_near(handle, hwparams, &bufferTime, &dir);
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioOutput: snd_pcm_hw_params_set_buffer_time_near: err = %1").arg(err);
         }
     }
     if ( !fatal ) {
-        err = snd_pcm_hw_params_set_period_time_near(handle, hwparams, &period_time, &dir);
+        err = snd_pcm_hw_params_set_period_time_near(handle, hwparams, &periodTime, &dir);
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioOutput: snd_pcm_hw_params_set_period_time_near: err = %1").arg(err);
@@ -492,6 +595,13 @@ bool QAlsaAudioOutput::open()
     snd_pcm_sw_params_set_start_threshold(handle,swparams,period_frames);
     snd_pcm_sw_params_set_stop_threshold(handle,swparams,buffer_frames);
     snd_pcm_sw_params_set_avail_min(handle, swparams,period_frames);
+    // Have the driver timestamp hardware pointer updates, see updateTimestamp()
+    snd_pcm_sw_params_set_tstamp_mode(handle, swparams, SND_PCM_TSTAMP_ENABLE);
+    m_monotonicTimestamps = snd_pcm_hw_params_is_monotonic(hwparams);
+#if SND_LIB_VERSION >= 0x01001d
+    if (snd_pcm_sw_params_set_tstamp_type(handle, swparams, SND_PCM_TSTAMP_TYPE_MONOTONIC) == 0)
+        m_monotonicTimestamps = true;
+#endif
     snd_pcm_sw_params(handle, swparams);
 
     // Step 4: Prepare audio
@@ -503,22 +613,34 @@ bool QAlsaAudioOutput::open()
     // Step 5: Setup timer
     bytesAvailable = bytesFree();
 
-    // Step 6: Start audio processing
-    timer->start(period_time/1000);
-
     clockStamp.restart();
     timeStamp.restart();
     elapsedTimeOffset = 0;
     errorState  = QAudio::NoError;
     totalTimeValue = 0;
+    m_timestamp = QAudio::Timestamp();
+    m_driftEstimator.reset(settings.sampleRate());
     opened = true;
 
+    // Step 6: Start audio processing
+    if (useFeederThread())
+        startFeeder();
+    else
+        timer->start(period_time/1000);
+
     return true;
 }
 
 void QAlsaAudioOutput::close()
 {
     timer->stop();
+    stopFeeder();
+    m_renderCallback = 0;
+    m_renderUserData = 0;
+
+    m_feederMutex.lock();
+    m_timestamp = QAudio::Timestamp();
+    m_feederMutex.unlock();
 
     if ( handle ) {
         snd_pcm_drain( handle );
@@ -583,13 +705,15 @@ qint64 QAlsaAudioOutput::write( const char *data, qint64 len )
     if (m_volume < 1.0f) {
         char out[space];
         QAudioHelperInternal::qMultiplySamples(m_volume, settings, data, out, space);
-        err = snd_pcm_writei(handle, out, frames);
+        err = writeFrames(handle, access, out, frames);
     } else {
-        err = snd_pcm_writei(handle, data, frames);
+        err = writeFrames(handle, access, data, frames);
     }
 
     if(err > 0) {
+        m_feederMutex.lock();
         totalTimeValue += err;
+        m_feederMutex.unlock();
         resuming = false;
         errorState = QAudio::NoError;
         if (deviceState != QAudio::ActiveState) {
@@ -610,6 +734,134 @@ qint64 QAlsaAudioOutput::write( const char *data, qint64 len )
     return 0;
 }
 
+// Reads up to maxFrames from the source straight into the mapped device
+// buffer, saving the copy through audioBuffer. Returns what
+// QIODevice::read() returned; ALSA failures are reported through pcmError.
+// Feeder thread only: close() stops the feeder before it closes the handle,
+// so the mapped area stays valid for as long as the source is being read.
+qint64 QAlsaAudioOutput::mmapFromSource(snd_pcm_uframes_t maxFrames, int *pcmError)
+{
+    *pcmError = 0;
+    qint64 total = 0;
+
+    snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
+    if (avail < 0) {
+        *pcmError = avail;
+        return 0;
+    }
+    snd_pcm_uframes_t remaining = qMin<snd_pcm_uframes_t>(maxFrames, avail);
+
+    while (remaining > 0) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = remaining;
+
+        int err = snd_pcm_mmap_begin(handle, &areas, &offset, &frames);
+        if (err < 0) {
+            *pcmError = err;
+            break;
+        }
+        if (frames == 0)
+            break;
+
+        // Interleaved access: every channel lives in the same area
+        char *dst = (char *)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8;
+        const qint64 l = audioSource->read(dst, snd_pcm_frames_to_bytes(handle, frames));
+        if (l <= 0) {
+            snd_pcm_mmap_commit(handle, offset, 0);
+            return total > 0 ? total : l;
+        }
+
+        const snd_pcm_uframes_t got = snd_pcm_bytes_to_frames(handle, l);
+        const qint64 bytes = snd_pcm_frames_to_bytes(handle, got);
+        if (bytes != l)
+            audioSource->seek(audioSource->pos() - (l - bytes));
+        const qreal volume = feederVolume();
+        if (volume < 1.0f)
+            QAudioHelperInternal::qMultiplySamples(volume, settings, dst, dst, bytes);
+
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(handle, offset, got);
+        if (committed < 0 || snd_pcm_uframes_t(committed) != got) {
+            *pcmError = committed < 0 ? int(committed) : -EPIPE;
+            break;
+        }
+
+        total += bytes;
+        remaining -= got;
+        if (got < frames)
+            break;
+    }
+
+    // Committing does not trigger the start threshold like a write does
+    if (total > 0 && snd_pcm_state(handle) == SND_PCM_STATE_PREPARED)
+        snd_pcm_start(handle);
+
+    return total;
+}
+
+// Has the render callback produce the frames straight into the mapped device
+// buffer, or into audioBuffer if the device can't be mapped. Returns the
+// number of frames written; ALSA failures are reported through pcmError.
+snd_pcm_sframes_t QAlsaAudioOutput::renderToDevice(snd_pcm_uframes_t frames, int *pcmError)
+{
+    *pcmError = 0;
+
+    if (access != SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+        m_renderCallback(audioBuffer, int(frames), m_renderUserData);
+        const qreal volume = feederVolume();
+        if (volume < 1.0f) {
+            QAudioHelperInternal::qMultiplySamples(volume, settings, audioBuffer, audioBuffer,
+                                                   snd_pcm_frames_to_bytes(handle, frames));
+        }
+
+        snd_pcm_sframes_t written = snd_pcm_writei(handle, audioBuffer, frames);
+        if (written < 0) {
+            *pcmError = written;
+            return 0;
+        }
+        return written;
+    }
+
+    snd_pcm_sframes_t total = 0;
+    snd_pcm_uframes_t remaining = frames;
+
+    while (remaining > 0) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t got = remaining;
+
+        int err = snd_pcm_mmap_begin(handle, &areas, &offset, &got);
+        if (err < 0) {
+            *pcmError = err;
+            break;
+        }
+        if (got == 0)
+            break;
+
+        // Interleaved access: every channel lives in the same area
+        char *dst = (char *)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8;
+        m_renderCallback(dst, int(got), m_renderUserData);
+        const qreal volume = feederVolume();
+        if (volume < 1.0f)
+            QAudioHelperInternal::qMultiplySamples(volume, settings, dst, dst, snd_pcm_frames_to_bytes(handle, got));
+
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(handle, offset, got);
+        if (committed < 0 || snd_pcm_uframes_t(committed) != got) {
+            *pcmError = committed < 0 ? int(committed) : -EPIPE;
+            break;
+        }
+
+        total += got;
+        remaining -= got;
+    }
+
+    // Committing does not trigger the start threshold like a write does
+    if (total > 0 && snd_pcm_state(handle) == SND_PCM_STATE_PREPARED)
+        snd_pcm_start(handle);
+
+    return total;
+}
+
 int QAlsaAudioOutput::periodSize() const
 {
     return period_size;
@@ -626,8 +878,20 @@ int QAlsaAudioOutput::bufferSize() const
     return buffer_size;
 }
 
+void QAlsaAudioOutput::setLatencyTarget(qint64 usecs)
+{
+    if(deviceState == QAudio::StoppedState)
+        m_latencyTarget = qMax(qint64(0), usecs);
+}
+
+qint64 QAlsaAudioOutput::latencyTarget() const
+{
+    return m_latencyTarget;
+}
+
 void QAlsaAudioOutput::setNotifyInterval(int ms)
 {
+    QMutexLocker locker(&m_feederMutex);
     intervalTime = qMax(0, ms);
 }
 
@@ -638,9 +902,53 @@ int QAlsaAudioOutput::notifyInterval() const
 
 qint64 QAlsaAudioOutput::processedUSecs() const
 {
+    QMutexLocker locker(&m_feederMutex);
     return qint64(1000000) * totalTimeValue / settings.sampleRate();
 }
 
+QAudio::Timestamp QAlsaAudioOutput::timestamp() const
+{
+    QMutexLocker locker(&m_feederMutex);
+    return m_timestamp;
+}
+
+qreal QAlsaAudioOutput::clockDrift() const
+{
+    QMutexLocker locker(&m_feederMutex);
+    return m_driftEstimator.drift();
+}
+
+// Called from whichever thread writes to the device, right after writing,
+// so that the written total and the delay ALSA reports agree.
+void QAlsaAudioOutput::updateTimestamp()
+{
+    snd_pcm_status_t *status;
+    snd_pcm_status_alloca(&status);
+    if (snd_pcm_status(handle, status) < 0)
+        return;
+
+    const snd_pcm_state_t state = snd_pcm_status_get_state(status);
+    if (state != SND_PCM_STATE_RUNNING && state != SND_PCM_STATE_DRAINING)
+        return;
+
+    // The time of the last hardware pointer update, which the delay refers to
+    snd_htimestamp_t htstamp;
+    snd_pcm_status_get_htstamp(status, &htstamp);
+    if (htstamp.tv_sec == 0 && htstamp.tv_nsec == 0)
+        return;
+
+    const snd_pcm_sframes_t delay = snd_pcm_status_get_delay(status);
+    qint64 systemTime = qint64(htstamp.tv_sec) * 1000000 + htstamp.tv_nsec / 1000;
+    if (!m_monotonicTimestamps)
+        systemTime = QAudioClockInternal::monotonicFromRealtime(systemTime);
+
+    QMutexLocker locker(&m_feederMutex);
+    m_timestamp.framePosition = qMax<qint64>(0, totalTimeValue - delay);
+    m_timestamp.systemTime = systemTime;
+    m_timestamp.latency = qint64(1000000) * delay / settings.sampleRate();
+    m_driftEstimator.addSample(m_timestamp);
+}
+
 void QAlsaAudioOutput::resume()
 {
     if(deviceState == QAudio::SuspendedState) {
@@ -662,7 +970,10 @@ void QAlsaAudioOutput::resume()
         deviceState = QAudio::ActiveState;
 
         errorState = QAudio::NoError;
-        timer->start(period_time/1000);
+        if (useFeederThread())
+            startFeeder();
+        else
+            timer->start(period_time/1000);
         emit stateChanged(deviceState);
     }
 }
@@ -682,6 +993,7 @@ void QAlsaAudioOutput::suspend()
 {
     if(deviceState == QAudio::ActiveState || deviceState == QAudio::IdleState || resuming) {
         timer->stop();
+        stopFeeder();
         deviceState = QAudio::SuspendedState;
         errorState = QAudio::NoError;
         emit stateChanged(deviceState);
@@ -718,6 +1030,12 @@ bool QAlsaAudioOutput::deviceReady()
         int input = period_frames*chunks;
         if(input > (int)buffer_frames)
             input = buffer_frames;
+
+        // Always go through audioBuffer here, even with mmap access: the read
+        // may run the event loop and close the device, which must not happen
+        // while a mapped area is open. write() copies it in with
+        // snd_pcm_mmap_writei(). Only the feeder thread reads straight into
+        // the mapping, see mmapFromSource().
         l = audioSource->read(audioBuffer,snd_pcm_frames_to_bytes(handle, input));
 
         // reading can take a while and stream may have been stopped
@@ -769,6 +1087,8 @@ bool QAlsaAudioOutput::deviceReady()
     if(deviceState != QAudio::ActiveState)
         return true;
 
+    updateTimestamp();
+
     if(intervalTime && (timeStamp.elapsed() + elapsedTimeOffset) > intervalTime) {
         emit notify();
         elapsedTimeOffset = timeStamp.elapsed() + elapsedTimeOffset - intervalTime;
@@ -777,6 +1097,78 @@ bool QAlsaAudioOutput::deviceReady()
     return true;
 }
 
+bool QAlsaAudioOutput::useFeederThread() const
+{
+    // A render callback has to be called from the feeder thread
+    if (m_renderCallback)
+        return true;
+
+    // The feeder reads the source from its own thread and seeks back over
+    // whatever the device didn't take. Sequential devices (sockets, processes,
+    // network replies) can do neither, they stay on the timer.
+    if (!pullMode || !audioSource || audioSource->isSequential())
+        return false;
+
+    return feederThreadRequested();
+}
+
+// The volume can be changed from the GUI thread while the feeder is running
+qreal QAlsaAudioOutput::feederVolume() const
+{
+    QMutexLocker locker(&m_feederMutex);
+    return m_volume;
+}
+
+void QAlsaAudioOutput::startFeeder()
+{
+    if (m_feeder || !handle)
+        return;
+
+    m_feeder = new QAlsaAudioOutputFeeder(this, m_feederGeneration);
+    connect(m_feeder, SIGNAL(stateChanged(int,QAudio::State,QAudio::Error)),
+            SLOT(feederStateChanged(int,QAudio::State,QAudio::Error)), Qt::QueuedConnection);
+    connect(m_feeder, SIGNAL(notify(int)), SLOT(feederNotify(int)), Qt::QueuedConnection);
+    m_feeder->start(QThread::TimeCriticalPriority);
+}
+
+void QAlsaAudioOutput::stopFeeder()
+{
+    if (!m_feeder)
+        return;
+
+    m_feeder->requestStop();
+    m_feeder->wait();
+    delete m_feeder;
+    m_feeder = 0;
+
+    // Whatever the stopped feeder still has queued for us is stale
+    ++m_feederGeneration;
+}
+
+void QAlsaAudioOutput::feederStateChanged(int generation, QAudio::State state, QAudio::Error error)
+{
+    if (!m_feeder || generation != m_feederGeneration)
+        return;
+
+    if (state == QAudio::StoppedState)
+        close();
+
+    errorState = error;
+    if (errorState != QAudio::NoError)
+        emit errorChanged(errorState);
+
+    if (deviceState != state) {
+        deviceState = state;
+        emit stateChanged(deviceState);
+    }
+}
+
+void QAlsaAudioOutput::feederNotify(int generation)
+{
+    if (m_feeder && generation == m_feederGeneration)
+        emit notify();
+}
+
 qint64 QAlsaAudioOutput::elapsedUSecs() const
 {
     if (deviceState == QAudio::StoppedState)
@@ -793,6 +1185,152 @@ void QAlsaAudioOutput::reset()
     stop();
 }
 
+QAlsaAudioOutputFeeder::QAlsaAudioOutputFeeder(QAlsaAudioOutput *output, int generation)
+    : m_output(output)
+    , m_generation(generation)
+    , m_quit(0)
+{
+}
+
+void QAlsaAudioOutputFeeder::requestStop()
+{
+    m_quit.store(1);
+}
+
+void QAlsaAudioOutputFeeder::raisePriority()
+{
+    // Best effort: without CAP_SYS_NICE or an RLIMIT_RTPRIO allowance this
+    // fails and the thread keeps running at TimeCriticalPriority.
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+}
+
+bool QAlsaAudioOutputFeeder::recover(int err)
+{
+    if (err == -EPIPE)
+        emit stateChanged(m_generation, QAudio::ActiveState, QAudio::UnderrunError);
+
+    if (snd_pcm_recover(m_output->handle, err, 1) < 0) {
+        emit stateChanged(m_generation, QAudio::StoppedState, QAudio::FatalError);
+        return false;
+    }
+    return true;
+}
+
+void QAlsaAudioOutputFeeder::run()
+{
+    raisePriority();
+
+    snd_pcm_t *handle = m_output->handle;
+    QIODevice *source = m_output->audioSource;
+    char *buffer = m_output->audioBuffer;
+    const snd_pcm_sframes_t periodFrames = m_output->period_frames;
+    const snd_pcm_sframes_t bufferFrames = m_output->buffer_frames;
+    const unsigned long periodMs = qMax(1u, m_output->period_time / 1000);
+
+    bool idle = false;
+    QTime notifyTime;
+    notifyTime.start();
+    qint64 notifyOffset = 0;
+
+    while (!m_quit.load()) {
+        int err = snd_pcm_wait(handle, 2 * periodMs);
+        if (m_quit.load())
+            break;
+        if (err < 0 && !recover(err))
+            return;
+
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
+        if (avail < 0) {
+            if (!recover(avail))
+                return;
+            continue;
+        }
+        if (avail < periodFrames)
+            continue;
+
+        snd_pcm_sframes_t frames = qMin(avail, bufferFrames);
+        frames -= frames % periodFrames;
+
+        qint64 l = 0;
+        snd_pcm_sframes_t written = 0;
+        if (m_output->m_renderCallback) {
+            int pcmError = 0;
+            written = m_output->renderToDevice(frames, &pcmError);
+            if (pcmError < 0 && !recover(pcmError))
+                return;
+            // The callback never runs dry, but the device may have taken less
+            // than was rendered. Count only that; after a recovered error
+            // nothing may have been written and the next wait tries again.
+            if (written <= 0)
+                continue;
+            l = snd_pcm_frames_to_bytes(handle, written);
+        } else if (m_output->access == SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+            int pcmError = 0;
+            l = m_output->mmapFromSource(frames, &pcmError);
+            if (pcmError < 0 && !recover(pcmError))
+                return;
+            if (l > 0)
+                written = snd_pcm_bytes_to_frames(handle, l);
+        } else {
+            l = source->read(buffer, snd_pcm_frames_to_bytes(handle, frames));
+            if (l > 0) {
+                frames = snd_pcm_bytes_to_frames(handle, l);
+                const qreal volume = m_output->feederVolume();
+                if (volume < 1.0f) {
+                    QAudioHelperInternal::qMultiplySamples(volume, m_output->settings,
+                                                           buffer, buffer, snd_pcm_frames_to_bytes(handle, frames));
+                }
+
+                written = snd_pcm_writei(handle, buffer, frames);
+                if (written < 0) {
+                    if (!recover(written))
+                        return;
+                    written = 0;
+                }
+
+                const qint64 writtenBytes = snd_pcm_frames_to_bytes(handle, written);
+                if (writtenBytes != l)
+                    source->seek(source->pos() - (l - writtenBytes));
+            }
+        }
+
+        if (l < 0) {
+            emit stateChanged(m_generation, QAudio::StoppedState, QAudio::IOError);
+            return;
+        }
+        if (l == 0) {
+            if (!idle && avail > bufferFrames - periodFrames) {
+                idle = true;
+                emit stateChanged(m_generation, QAudio::IdleState, QAudio::UnderrunError);
+            }
+            // The device wants data but the source has none; don't spin on snd_pcm_wait()
+            msleep(periodMs);
+            continue;
+        }
+        if (written == 0)
+            continue;
+
+        m_output->m_feederMutex.lock();
+        m_output->totalTimeValue += written;
+        const int interval = m_output->intervalTime;
+        m_output->m_feederMutex.unlock();
+        m_output->updateTimestamp();
+
+        if (idle) {
+            idle = false;
+            emit stateChanged(m_generation, QAudio::ActiveState, QAudio::NoError);
+        }
+
+        if (interval && (notifyTime.elapsed() + notifyOffset) > interval) {
+            emit notify(m_generation);
+            notifyOffset = notifyTime.elapsed() + notifyOffset - interval;
+            notifyTime.restart();
+        }
+    }
+}
+
 OutputPrivate::OutputPrivate(QAlsaAudioOutput* audio)
 {
     audioDevice = qobject_cast<QAlsaAudioOutput*>(audio);
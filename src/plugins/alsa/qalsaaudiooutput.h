@@ -61,17 +61,25 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qdatetime.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qatomic.h>
 
 #include <QtMultimedia/qaudio.h>
 #include <QtMultimedia/qaudiodeviceinfo.h>
 #include <QtMultimedia/qaudiosystem.h>
+#include <QtMultimedia/private/qaudioclock_p.h>
 
 QT_BEGIN_NAMESPACE
 
-class QAlsaAudioOutput : public QAbstractAudioOutput
+class QAlsaAudioOutputFeeder;
+
+class QAlsaAudioOutput : public QAbstractAudioOutput, public QAudioOutputExtensionInterface
 {
     friend class OutputPrivate;
+    friend class QAlsaAudioOutputFeeder;
     Q_OBJECT
+    Q_INTERFACES(QAudioOutputExtensionInterface)
 public:
     QAlsaAudioOutput(const QByteArray &device);
     ~QAlsaAudioOutput();
@@ -80,6 +88,7 @@ public:
 
     void start(QIODevice* device);
     QIODevice* start();
+    bool startRendering(QAudio::RenderCallback callback, void *userData);
     void stop();
     void reset();
     void suspend();
@@ -88,10 +97,14 @@ public:
     int periodSize() const;
     void setBufferSize(int value);
     int bufferSize() const;
+    void setLatencyTarget(qint64 usecs);
+    qint64 latencyTarget() const;
     void setNotifyInterval(int milliSeconds);
     int notifyInterval() const;
     qint64 processedUSecs() const;
     qint64 elapsedUSecs() const;
+    QAudio::Timestamp timestamp() const;
+    qreal clockDrift() const;
     QAudio::Error error() const;
     QAudio::State state() const;
     void setFormat(const QAudioFormat& fmt);
@@ -99,7 +112,6 @@ public:
     void setVolume(qreal);
     qreal volume() const;
 
-
     QIODevice* audioSource;
     QAudioFormat settings;
     QAudio::Error errorState;
@@ -108,6 +120,8 @@ public:
 private slots:
     void userFeed();
     bool deviceReady();
+    void feederStateChanged(int generation, QAudio::State state, QAudio::Error error);
+    void feederNotify(int generation);
 
 signals:
     void processMore();
@@ -130,6 +144,15 @@ private:
     bool open();
     void close();
 
+    qint64 mmapFromSource(snd_pcm_uframes_t maxFrames, int *pcmError);
+    snd_pcm_sframes_t renderToDevice(snd_pcm_uframes_t frames, int *pcmError);
+    void updateTimestamp();
+
+    bool useFeederThread() const;
+    qreal feederVolume() const;
+    void startFeeder();
+    void stopFeeder();
+
     QTimer* timer;
     QByteArray m_device;
     int bytesAvailable;
@@ -140,9 +163,44 @@ private:
     snd_pcm_t* handle;
     snd_pcm_access_t access;
     snd_pcm_format_t pcmformat;
-    snd_timestamp_t* timestamp;
     snd_pcm_hw_params_t *hwparams;
     qreal m_volume;
+    qint64 m_latencyTarget;
+    QAudio::RenderCallback m_renderCallback;
+    void *m_renderUserData;
+    QAlsaAudioOutputFeeder *m_feeder;
+    int m_feederGeneration;
+    mutable QMutex m_feederMutex;
+    QAudio::Timestamp m_timestamp;
+    QAudioClockDriftEstimator m_driftEstimator;
+    bool m_monotonicTimestamps;
+};
+
+// Pull mode alternative to the timer: blocks in snd_pcm_wait() on its own
+// thread, reads from the source and writes to the device, and reports state
+// changes back to the owning QAlsaAudioOutput through queued signals.
+class QAlsaAudioOutputFeeder : public QThread
+{
+    Q_OBJECT
+public:
+    QAlsaAudioOutputFeeder(QAlsaAudioOutput *output, int generation);
+
+    void requestStop();
+
+signals:
+    void stateChanged(int generation, QAudio::State state, QAudio::Error error);
+    void notify(int generation);
+
+protected:
+    void run();
+
+private:
+    void raisePriority();
+    bool recover(int err);
+
+    QAlsaAudioOutput *m_output;
+    const int m_generation;
+    QAtomicInt m_quit;
 };
 
 class OutputPrivate : public QIODevice
@@ -44,11 +44,20 @@
 #include "qalsaaudioinput.h"
 #include "qalsaaudiooutput.h"
 
+#include <QtMultimedia/private/qmultimediaenvironment_p.h>
+
 QT_BEGIN_NAMESPACE
 
 QAlsaPlugin::QAlsaPlugin(QObject *parent)
     : QAudioSystemPlugin(parent)
 {
+    // Opening every device to find out what it supports is slow, get it
+    // done on a pool thread before the first format negotiation needs it.
+    // The probe opens devices non-blocking and gives up on busy ones, so
+    // it can't hold up playback. Opening devices nobody asked for isn't
+    // free either, so it is only done when QT_ALSA_PREWARM=1 is set.
+    if (qt_multimedia_envFlag("QT_ALSA_PREWARM", false))
+        QAlsaAudioDeviceInfo::prewarmCapabilities();
 }
 
 QList<QByteArray> QAlsaPlugin::availableDevices(QAudio::Mode mode) const
@@ -46,7 +46,6 @@
 #include <QtMultimedia/qabstractvideobuffer.h>
 #include <QtMultimedia/qvideosurfaceformat.h>
 #include <QtMultimedia/qcameraimagecapture.h>
-#include <private/qmemoryvideobuffer_p.h>
 
 #include "dscamerasession.h"
 #include "dsvideorenderer.h"
@@ -370,19 +369,22 @@ void DSCameraSession::onFrameAvailable(const char *frameData, long len)
 {
     // !!! Not called on the main thread
 
-    // Deep copy, the data might be modified or freed after the callback returns
-    QByteArray data(frameData, len);
-
-    m_presentMutex.lock();
-
     // (We should be getting only RGB32 data)
     int stride = m_previewSize.width() * 4;
 
+    // Deep copy, the data might be modified or freed after the callback returns.
+    // The pool hands back the memory of frames that have been presented already.
+    QVideoFrame frame = m_framePool.allocate(len, m_previewSize, stride, m_previewPixelFormat);
+    if (frame.map(QAbstractVideoBuffer::WriteOnly)) {
+        memcpy(frame.bits(), frameData, len);
+        frame.unmap();
+    }
+
+    m_presentMutex.lock();
+
     // In case the source produces frames faster than we can display them,
     // only keep the most recent one
-    m_currentFrame = QVideoFrame(new QMemoryVideoBuffer(data, stride),
-                                 m_previewSize,
-                                 m_previewPixelFormat);
+    m_currentFrame = frame;
 
     m_presentMutex.unlock();
 
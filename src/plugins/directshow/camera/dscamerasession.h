@@ -52,6 +52,7 @@
 #include <QtMultimedia/qabstractvideosurface.h>
 #include <QtMultimedia/qvideosurfaceformat.h>
 #include <private/qmediastoragelocation_p.h>
+#include <private/qvideoframepool_p.h>
 
 #include <tchar.h>
 #include <dshow.h>
@@ -143,6 +144,7 @@ private:
     ISampleGrabber *m_previewSampleGrabber;
     IBaseFilter *m_nullRendererFilter;
     QVideoFrame m_currentFrame;
+    QVideoFramePool m_framePool;
     bool m_previewStarted;
     QAbstractVideoSurface* m_surface;
     QVideoSurfaceFormat m_previewSurfaceFormat;
@@ -44,6 +44,7 @@
 #include <private/qgstreamerbushelper_p.h>
 
 #include <private/qgstutils_p.h>
+#include <private/qgstaudiobuffer_p.h>
 
 #include <gst/gstvalue.h>
 #include <gst/base/gstbasesrc.h>
@@ -458,10 +459,8 @@ QAudioBuffer QGstreamerAudioDecoderSession::read()
 
         QAudioFormat format = QGstUtils::audioFormatForBuffer(buffer);
         if (format.isValid()) {
-            // XXX At the moment we have to copy data from GstBuffer into QAudioBuffer.
-            // We could improve performance by implementing QAbstractAudioBuffer for GstBuffer.
             qint64 position = getPositionFromBuffer(buffer);
-            audioBuffer = QAudioBuffer(QByteArray((const char*)buffer->data, buffer->size), format, position);
+            audioBuffer = QAudioBuffer(new QGstAudioBuffer(buffer, format, position));
             position /= 1000; // convert to milliseconds
             if (position != m_position) {
                 m_position = position;
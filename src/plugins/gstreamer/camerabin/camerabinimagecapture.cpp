@@ -180,6 +180,7 @@ gboolean CameraBinImageCapture::uncompressedBufferProbe(GstPad *pad, GstBuffer *
             qDebug() << "imageAvailable(uncompressed):" << format;
 #endif
             QGstVideoBuffer *videoBuffer = new QGstVideoBuffer(buffer, bytesPerLine);
+            videoBuffer->setPlaneLayout(QGstVideoBuffer::planeLayoutForCaps(caps));
 
             QVideoFrame frame(videoBuffer,
                               format.frameSize(),
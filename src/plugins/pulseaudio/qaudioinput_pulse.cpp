@@ -56,16 +56,15 @@ const int PeriodTimeMs = 50;
 
 static void inputStreamReadCallback(pa_stream *stream, size_t length, void *userdata)
 {
-    Q_UNUSED(userdata);
     Q_UNUSED(length);
     Q_UNUSED(stream);
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
     pa_threaded_mainloop_signal(pulseEngine->mainloop(), 0);
+    static_cast<QPulseAudioInput*>(userdata)->streamReadCallback();
 }
 
 static void inputStreamStateCallback(pa_stream *stream, void *userdata)
 {
-    Q_UNUSED(userdata);
     pa_stream_state_t state = pa_stream_get_state(stream);
 #ifdef DEBUG_PULSE
     qDebug() << "Stream state: " << QPulseAudioInternal::stateToQString(state);
@@ -86,6 +85,8 @@ static void inputStreamStateCallback(pa_stream *stream, void *userdata)
             pa_sample_spec spec = QPulseAudioInternal::audioFormatToSampleSpec(audioInput->format());
             qDebug() << "*** bytes_to_usec: " << pa_bytes_to_usec(buffer_attr->fragsize, &spec);
 #endif
+            // open() doesn't wait for the server, finish the setup in the input's thread
+            QMetaObject::invokeMethod(static_cast<QPulseAudioInput*>(userdata), "onStreamReady", Qt::QueuedConnection);
             }
             break;
         case PA_STREAM_TERMINATED:
@@ -95,6 +96,7 @@ static void inputStreamStateCallback(pa_stream *stream, void *userdata)
             qWarning() << QString("Stream error: %1").arg(pa_strerror(pa_context_errno(pa_stream_get_context(stream))));
             QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
             pa_threaded_mainloop_signal(pulseEngine->mainloop(), 0);
+            QMetaObject::invokeMethod(static_cast<QPulseAudioInput*>(userdata), "onStreamFailed", Qt::QueuedConnection);
             break;
     }
 }
@@ -113,6 +115,12 @@ static void inputStreamOverflowCallback(pa_stream *stream, void *userdata)
     qWarning() << "Got a buffer overflow!";
 }
 
+static void inputStreamLatencyCallback(pa_stream *stream, void *userdata)
+{
+    Q_UNUSED(stream)
+    ((QPulseAudioInput*)userdata)->streamLatencyCallback();
+}
+
 static void inputStreamSuccessCallback(pa_stream *stream, int success, void *userdata)
 {
     Q_UNUSED(stream);
@@ -155,14 +163,20 @@ void QPulseAudioInput::inputVolumeCallback(pa_context *context, int success, voi
 QPulseAudioInput::QPulseAudioInput(const QByteArray &device)
     : m_totalTimeValue(0)
     , m_audioSource(0)
+    , m_captureCallback(0)
+    , m_captureUserData(0)
     , m_errorState(QAudio::NoError)
     , m_deviceState(QAudio::StoppedState)
     , m_volume(qreal(1.0f))
     , m_pullMode(true)
     , m_opened(false)
+    , m_streamReady(false)
+    , m_prepared(false)
+    , m_corked(false)
     , m_bytesAvailable(0)
     , m_bufferSize(0)
     , m_periodSize(0)
+    , m_latencyTarget(0)
     , m_intervalTime(1000)
     , m_periodTime(PeriodTimeMs)
     , m_stream(0)
@@ -210,8 +224,13 @@ QAudio::State QPulseAudioInput::state() const
 
 void QPulseAudioInput::setFormat(const QAudioFormat &format)
 {
-    if (m_deviceState == QAudio::StoppedState)
-        m_format = format;
+    if (m_deviceState != QAudio::StoppedState)
+        return;
+
+    if (m_prepared)
+        close();
+
+    m_format = format;
 }
 
 QAudioFormat QPulseAudioInput::format() const
@@ -229,7 +248,8 @@ void QPulseAudioInput::start(QIODevice *device)
         m_audioSource = 0;
     }
 
-    close();
+    if (!m_prepared)
+        close();
 
     if (!open())
         return;
@@ -238,6 +258,7 @@ void QPulseAudioInput::start(QIODevice *device)
     m_audioSource = device;
 
     setState(QAudio::ActiveState);
+    startStream();
 }
 
 QIODevice *QPulseAudioInput::start()
@@ -250,7 +271,8 @@ QIODevice *QPulseAudioInput::start()
         m_audioSource = 0;
     }
 
-    close();
+    if (!m_prepared)
+        close();
 
     if (!open())
         return Q_NULLPTR;
@@ -260,14 +282,137 @@ QIODevice *QPulseAudioInput::start()
     m_audioSource->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
 
     setState(QAudio::IdleState);
+    startStream();
 
     return m_audioSource;
 }
 
+bool QPulseAudioInput::startCapturing(QAudio::CaptureCallback callback, void *userData)
+{
+    setState(QAudio::StoppedState);
+    setError(QAudio::NoError);
+
+    if (!m_pullMode && m_audioSource) {
+        delete m_audioSource;
+        m_audioSource = 0;
+    }
+
+    if (!m_prepared)
+        close();
+
+    if (!open())
+        return false;
+
+    m_pullMode = true;
+    m_audioSource = 0;
+
+    // Read in the pulse thread, see streamReadCallback()
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    m_captureCallback = callback;
+    m_captureUserData = userData;
+    pulseEngine->unlock();
+
+    setState(QAudio::ActiveState);
+    startStream();
+
+    return true;
+}
+
+void QPulseAudioInput::prepare()
+{
+    if (m_deviceState != QAudio::StoppedState || m_opened)
+        return;
+
+    // Connect the stream corked, start() only has to uncork it
+    m_prepared = true;
+    if (!open())
+        m_prepared = false;
+}
+
+// Called once the input is in its started state, whether the stream was
+// prepared beforehand or has just been opened.
+void QPulseAudioInput::startStream()
+{
+    m_prepared = false;
+
+    m_clockStamp.restart();
+    m_timeStamp.restart();
+    m_elapsedTimeOffset = 0;
+    m_totalTimeValue = 0;
+
+    // Otherwise onStreamReady() takes over once the server has set up the stream
+    if (m_streamReady) {
+        QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+        pulseEngine->lock();
+        m_timestamp = QAudio::Timestamp();
+        m_driftEstimator.reset(m_spec.rate);
+        setCorked(false);
+        pulseEngine->unlock();
+
+        m_timer->start(m_periodTime);
+    }
+}
+
+// Must be called with the mainloop locked. Doesn't wait for the server,
+// it processes the cork in order with the stream's data.
+void QPulseAudioInput::setCorked(bool corked)
+{
+    if (!m_streamReady || m_corked == corked)
+        return;
+
+    m_corked = corked;
+
+    pa_operation *operation = pa_stream_cork(m_stream, corked ? 1 : 0, inputStreamSuccessCallback, 0);
+    if (operation)
+        pa_operation_unref(operation);
+}
+
+// Called in the pulse thread, with the mainloop locked, whenever there is
+// new data. Hands it straight to the capture callback if there is one.
+void QPulseAudioInput::streamReadCallback()
+{
+    if (!m_captureCallback)
+        return;
+
+    const size_t frameSize = pa_frame_size(&m_spec);
+
+    while (pa_stream_readable_size(m_stream) > 0) {
+        const void *audioBuffer = 0;
+        size_t readLength = 0;
+
+        if (pa_stream_peek(m_stream, &audioBuffer, &readLength) < 0 || readLength == 0)
+            break;
+
+        // Holes in the stream come without data, but still have to be dropped
+        if (audioBuffer) {
+            m_captureCallback(static_cast<const char *>(audioBuffer), int(readLength / frameSize), m_captureUserData);
+            m_totalTimeValue += readLength;
+        }
+
+        pa_stream_drop(m_stream);
+    }
+}
+
+// Called with the mainloop lock held whenever the server has sent
+// fresh timing information
+void QPulseAudioInput::streamLatencyCallback()
+{
+    const QAudio::Timestamp timestamp = QPulseAudioInternal::streamTimestamp(m_stream, PA_STREAM_RECORD);
+    if (!timestamp.isValid())
+        return;
+
+    m_timestamp = timestamp;
+    m_driftEstimator.addSample(timestamp);
+}
+
 void QPulseAudioInput::stop()
 {
-    if (m_deviceState == QAudio::StoppedState)
+    if (m_deviceState == QAudio::StoppedState) {
+        // Release a prepared stream
+        close();
         return;
+    }
 
     close();
 
@@ -297,6 +442,7 @@ bool QPulseAudioInput::open()
     }
 
     m_spec = spec;
+    m_streamReady = false;
 
 #ifdef DEBUG_PULSE
 //    QTime now(QTime::currentTime());
@@ -328,6 +474,10 @@ bool QPulseAudioInput::open()
 
     pa_stream_set_underflow_callback(m_stream, inputStreamUnderflowCallback, this);
     pa_stream_set_overflow_callback(m_stream, inputStreamOverflowCallback, this);
+    pa_stream_set_latency_update_callback(m_stream, inputStreamLatencyCallback, this);
+
+    m_timestamp = QAudio::Timestamp();
+    m_driftEstimator.reset(spec.rate);
 
     m_periodSize = pa_usec_to_bytes(PeriodTimeMs*1000, &spec);
 
@@ -337,9 +487,16 @@ bool QPulseAudioInput::open()
     buffer_attr.prebuf = (uint32_t) -1;
     buffer_attr.tlength = (uint32_t) -1;
     buffer_attr.minreq = (uint32_t) -1;
-    flags |= PA_STREAM_ADJUST_LATENCY;
+    flags |= PA_STREAM_ADJUST_LATENCY | PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
 
-    if (m_bufferSize > 0)
+    m_corked = m_prepared;
+    if (m_prepared)
+        flags |= PA_STREAM_START_CORKED;
+
+    // With ADJUST_LATENCY the fragment size is the capture latency
+    if (m_latencyTarget > 0)
+        buffer_attr.fragsize = (uint32_t) pa_usec_to_bytes(m_latencyTarget, &spec);
+    else if (m_bufferSize > 0)
         buffer_attr.fragsize = (uint32_t) m_bufferSize;
     else
         buffer_attr.fragsize = (uint32_t) m_periodSize;
@@ -354,30 +511,65 @@ bool QPulseAudioInput::open()
         return false;
     }
 
-    while (pa_stream_get_state(m_stream) != PA_STREAM_READY)
-        pa_threaded_mainloop_wait(pulseEngine->mainloop());
+    // Don't wait for the stream to become ready here, that takes a round trip
+    // to the server. onStreamReady() finishes the setup.
+    pulseEngine->unlock();
+
+    connect(pulseEngine, &QPulseAudioEngine::contextFailed, this, &QPulseAudioInput::onPulseContextFailed);
+
+    m_opened = true;
+
+    return true;
+}
+
+void QPulseAudioInput::onStreamReady()
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+
+    pulseEngine->lock();
+
+    // Ignore notifications about a stream that has been closed since
+    if (!m_opened || m_streamReady || !m_stream || pa_stream_get_state(m_stream) != PA_STREAM_READY) {
+        pulseEngine->unlock();
+        return;
+    }
 
     const pa_buffer_attr *actualBufferAttr = pa_stream_get_buffer_attr(m_stream);
     m_periodSize = actualBufferAttr->fragsize;
-    m_periodTime = pa_bytes_to_usec(m_periodSize, &spec) / 1000;
+    m_periodTime = qMax(1u, (unsigned int)(pa_bytes_to_usec(m_periodSize, &m_spec) / 1000));
     if (actualBufferAttr->tlength != (uint32_t)-1)
         m_bufferSize = actualBufferAttr->tlength;
 
     setPulseVolume();
 
+    m_streamReady = true;
+
+    // The input may have been started, suspended or resumed while connecting
+    const bool running = !m_prepared && m_deviceState != QAudio::SuspendedState;
+    setCorked(!running);
+
     pulseEngine->unlock();
 
-    connect(pulseEngine, &QPulseAudioEngine::contextFailed, this, &QPulseAudioInput::onPulseContextFailed);
+    if (running)
+        m_timer->start(m_periodTime);
+}
 
-    m_opened = true;
-    m_timer->start(m_periodTime);
+void QPulseAudioInput::onStreamFailed()
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
-    m_clockStamp.restart();
-    m_timeStamp.restart();
-    m_elapsedTimeOffset = 0;
-    m_totalTimeValue = 0;
+    pulseEngine->lock();
+    const bool failed = m_opened && m_stream && pa_stream_get_state(m_stream) == PA_STREAM_FAILED;
+    pulseEngine->unlock();
 
-    return true;
+    if (!failed)
+        return;
+
+    const bool wasReady = m_streamReady;
+    close();
+
+    setError(wasReady ? QAudio::FatalError : QAudio::OpenError);
+    setState(QAudio::StoppedState);
 }
 
 void QPulseAudioInput::close()
@@ -386,16 +578,23 @@ void QPulseAudioInput::close()
         return;
 
     m_timer->stop();
+    m_streamReady = false;
+    m_prepared = false;
 
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
     if (m_stream) {
         pulseEngine->lock();
 
+        m_captureCallback = 0;
+        m_captureUserData = 0;
+
         pa_stream_set_state_callback(m_stream, 0, 0);
         pa_stream_set_read_callback(m_stream, 0, 0);
         pa_stream_set_underflow_callback(m_stream, 0, 0);
         pa_stream_set_overflow_callback(m_stream, 0, 0);
+        pa_stream_set_latency_update_callback(m_stream, 0, 0);
+        m_timestamp = QAudio::Timestamp();
 
         pa_stream_disconnect(m_stream);
         pa_stream_unref(m_stream);
@@ -441,7 +640,7 @@ void QPulseAudioInput::setPulseVolume()
 
 int QPulseAudioInput::checkBytesReady()
 {
-    if (m_deviceState != QAudio::ActiveState && m_deviceState != QAudio::IdleState) {
+    if (!m_streamReady || (m_deviceState != QAudio::ActiveState && m_deviceState != QAudio::IdleState)) {
         m_bytesAvailable = 0;
     } else {
         m_bytesAvailable = pa_stream_readable_size(m_stream);
@@ -459,6 +658,10 @@ qint64 QPulseAudioInput::read(char *data, qint64 len)
 {
     m_bytesAvailable = checkBytesReady();
 
+    // Nothing to read until the server has set up the stream
+    if (!m_streamReady)
+        return 0;
+
     setError(QAudio::NoError);
     setState(QAudio::ActiveState);
 
@@ -553,11 +756,19 @@ qint64 QPulseAudioInput::read(char *data, qint64 len)
 void QPulseAudioInput::resume()
 {
     if (m_deviceState == QAudio::SuspendedState || m_deviceState == QAudio::IdleState) {
+        setState(QAudio::ActiveState);
+        setError(QAudio::NoError);
+
+        // Still connecting, onStreamReady() leaves the stream running
+        if (!m_streamReady)
+            return;
+
         QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
         pa_operation *operation;
 
         pulseEngine->lock();
 
+        m_corked = false;
         operation = pa_stream_cork(m_stream, 0, inputStreamSuccessCallback, 0);
         pulseEngine->wait(operation);
         pa_operation_unref(operation);
@@ -565,9 +776,6 @@ void QPulseAudioInput::resume()
         pulseEngine->unlock();
 
         m_timer->start(m_periodTime);
-
-        setState(QAudio::ActiveState);
-        setError(QAudio::NoError);
     }
 }
 
@@ -578,7 +786,8 @@ void QPulseAudioInput::setVolume(qreal vol)
         pulseEngine->lock();
         if (!qFuzzyCompare(m_volume, vol)) {
             m_volume = vol;
-            if (m_opened) {
+            // Otherwise onStreamReady() applies it
+            if (m_streamReady) {
                 setPulseVolume();
             }
         }
@@ -598,6 +807,9 @@ qreal QPulseAudioInput::volume() const
 
 void QPulseAudioInput::setBufferSize(int value)
 {
+    if (m_prepared)
+        close();
+
     m_bufferSize = value;
 }
 
@@ -606,6 +818,19 @@ int QPulseAudioInput::bufferSize() const
     return m_bufferSize;
 }
 
+void QPulseAudioInput::setLatencyTarget(qint64 usecs)
+{
+    if (m_prepared)
+        close();
+
+    m_latencyTarget = qMax(qint64(0), usecs);
+}
+
+qint64 QPulseAudioInput::latencyTarget() const
+{
+    return m_latencyTarget;
+}
+
 int QPulseAudioInput::periodSize() const
 {
     return m_periodSize;
@@ -623,12 +848,38 @@ int QPulseAudioInput::notifyInterval() const
 
 qint64 QPulseAudioInput::processedUSecs() const
 {
+    // A capture callback adds to the total from the pulse thread
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    const qint64 totalBytes = m_totalTimeValue;
+    pulseEngine->unlock();
+
     pa_sample_spec spec = QPulseAudioInternal::audioFormatToSampleSpec(m_format);
-    qint64 result = pa_bytes_to_usec(m_totalTimeValue, &spec);
+    qint64 result = pa_bytes_to_usec(totalBytes, &spec);
 
     return result;
 }
 
+QAudio::Timestamp QPulseAudioInput::timestamp() const
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    const QAudio::Timestamp timestamp = m_timestamp;
+    pulseEngine->unlock();
+
+    return timestamp;
+}
+
+qreal QPulseAudioInput::clockDrift() const
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    const qreal drift = m_driftEstimator.drift();
+    pulseEngine->unlock();
+
+    return drift;
+}
+
 void QPulseAudioInput::suspend()
 {
     if (m_deviceState == QAudio::ActiveState) {
@@ -637,11 +888,15 @@ void QPulseAudioInput::suspend()
 
         m_timer->stop();
 
+        if (!m_streamReady)
+            return;
+
         QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
         pa_operation *operation;
 
         pulseEngine->lock();
 
+        m_corked = true;
         operation = pa_stream_cork(m_stream, 1, inputStreamSuccessCallback, 0);
         pulseEngine->wait(operation);
         pa_operation_unref(operation);
@@ -663,7 +918,9 @@ void QPulseAudioInput::userFeed()
 
 bool QPulseAudioInput::deviceReady()
 {
-   if (m_pullMode) {
+   if (m_captureCallback) {
+        // Data is handed over in the pulse thread, see streamReadCallback()
+   } else if (m_pullMode) {
         // reads some audio data and writes it to QIODevice
         read(0,0);
     } else {
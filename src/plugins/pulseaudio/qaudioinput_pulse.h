@@ -63,15 +63,18 @@
 #include "qaudiodeviceinfo.h"
 #include "qaudiosystem.h"
 
+#include <QtMultimedia/private/qaudioclock_p.h>
+
 #include <pulse/pulseaudio.h>
 
 QT_BEGIN_NAMESPACE
 
 class InputPrivate;
 
-class QPulseAudioInput : public QAbstractAudioInput
+class QPulseAudioInput : public QAbstractAudioInput, public QAudioInputExtensionInterface
 {
     Q_OBJECT
+    Q_INTERFACES(QAudioInputExtensionInterface)
 
 public:
     QPulseAudioInput(const QByteArray &device);
@@ -81,6 +84,8 @@ public:
 
     void start(QIODevice *device);
     QIODevice *start();
+    bool startCapturing(QAudio::CaptureCallback callback, void *userData);
+    void prepare();
     void stop();
     void reset();
     void suspend();
@@ -89,10 +94,14 @@ public:
     int periodSize() const;
     void setBufferSize(int value);
     int bufferSize() const;
+    void setLatencyTarget(qint64 usecs);
+    qint64 latencyTarget() const;
     void setNotifyInterval(int milliSeconds);
     int notifyInterval() const;
     qint64 processedUSecs() const;
     qint64 elapsedUSecs() const;
+    QAudio::Timestamp timestamp() const;
+    qreal clockDrift() const;
     QAudio::Error error() const;
     QAudio::State state() const;
     void setFormat(const QAudioFormat &format);
@@ -101,8 +110,13 @@ public:
     void setVolume(qreal volume);
     qreal volume() const;
 
+    void streamReadCallback();
+    void streamLatencyCallback();
+
     qint64 m_totalTimeValue;
     QIODevice *m_audioSource;
+    QAudio::CaptureCallback m_captureCallback;
+    void *m_captureUserData;
     QAudioFormat m_format;
     QAudio::Error m_errorState;
     QAudio::State m_deviceState;
@@ -112,6 +126,8 @@ public:
 private slots:
     void userFeed();
     bool deviceReady();
+    void onStreamReady();
+    void onStreamFailed();
     void onPulseContextFailed();
 
 private:
@@ -121,6 +137,8 @@ private:
     int checkBytesReady();
     bool open();
     void close();
+    void startStream();
+    void setCorked(bool corked);
     void setPulseVolume();
 
     static QMap<void *, QPulseAudioInput*> s_inputsMap;
@@ -130,9 +148,15 @@ private:
 
     bool m_pullMode;
     bool m_opened;
+    bool m_streamReady;
+    bool m_prepared;
+    bool m_corked;
     int m_bytesAvailable;
     int m_bufferSize;
     int m_periodSize;
+    qint64 m_latencyTarget;
+    QAudio::Timestamp m_timestamp;
+    QAudioClockDriftEstimator m_driftEstimator;
     int m_intervalTime;
     unsigned int m_periodTime;
     QTimer *m_timer;
@@ -53,8 +53,9 @@
 QT_BEGIN_NAMESPACE
 
 const int PeriodTimeMs = 20;
-const int LowLatencyPeriodTimeMs = 10;
 const int LowLatencyBufferSizeMs = 40;
+const int LatencyTargetPeriods = 4;
+const int PendingBufferPeriods = 5;
 
 #define LOW_LATENCY_CATEGORY_NAME "game"
 
@@ -62,29 +63,33 @@ static void  outputStreamWriteCallback(pa_stream *stream, size_t length, void *u
 {
     Q_UNUSED(stream);
     Q_UNUSED(length);
-    Q_UNUSED(userdata);
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
     pa_threaded_mainloop_signal(pulseEngine->mainloop(), 0);
+    ((QPulseAudioOutput*)userdata)->streamWriteCallback();
 }
 
 static void outputStreamStateCallback(pa_stream *stream, void *userdata)
 {
-    Q_UNUSED(userdata)
     pa_stream_state_t state = pa_stream_get_state(stream);
 #ifdef DEBUG_PULSE
     qDebug() << "Stream state: " << QPulseAudioInternal::stateToQString(state);
 #endif
     switch (state) {
         case PA_STREAM_CREATING:
-        case PA_STREAM_READY:
         case PA_STREAM_TERMINATED:
             break;
 
+        case PA_STREAM_READY:
+            // open() doesn't wait for the server, finish the setup in the output's thread
+            QMetaObject::invokeMethod((QPulseAudioOutput*)userdata, "onStreamReady", Qt::QueuedConnection);
+            break;
+
         case PA_STREAM_FAILED:
         default:
             qWarning() << QString("Stream error: %1").arg(pa_strerror(pa_context_errno(pa_stream_get_context(stream))));
             QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
             pa_threaded_mainloop_signal(pulseEngine->mainloop(), 0);
+            QMetaObject::invokeMethod((QPulseAudioOutput*)userdata, "onStreamFailed", Qt::QueuedConnection);
             break;
     }
 }
@@ -106,7 +111,7 @@ static void outputStreamOverflowCallback(pa_stream *stream, void *userdata)
 static void outputStreamLatencyCallback(pa_stream *stream, void *userdata)
 {
     Q_UNUSED(stream)
-    Q_UNUSED(userdata)
+    ((QPulseAudioOutput*)userdata)->streamLatencyCallback();
 
 #ifdef DEBUG_PULSE
     const pa_timing_info *info = pa_stream_get_timing_info(stream);
@@ -147,16 +152,24 @@ QPulseAudioOutput::QPulseAudioOutput(const QByteArray &device)
     , m_deviceState(QAudio::StoppedState)
     , m_pullMode(true)
     , m_opened(false)
+    , m_streamReady(false)
+    , m_prepared(false)
+    , m_corked(false)
+    , m_volumeChanged(false)
     , m_audioSource(0)
+    , m_renderCallback(0)
+    , m_renderUserData(0)
+    , m_rendering(false)
     , m_periodTime(0)
     , m_stream(0)
+    , m_streamGeneration(0)
     , m_notifyInterval(1000)
     , m_periodSize(0)
     , m_bufferSize(0)
     , m_maxBufferSize(0)
+    , m_latencyTarget(0)
     , m_totalTimeValue(0)
     , m_tickTimer(new QTimer(this))
-    , m_audioBuffer(0)
     , m_resuming(false)
     , m_volume(1.0)
 {
@@ -206,6 +219,64 @@ void QPulseAudioOutput::streamUnderflowCallback()
     }
 }
 
+// Called in the pulse thread whenever the server wants more data
+void QPulseAudioOutput::streamWriteCallback()
+{
+    // A render callback runs right here, without a trip through our thread
+    if (m_renderCallback) {
+        renderToStream();
+        return;
+    }
+
+    // The source must be read in our own thread, and one feed fills all
+    // the writable space, so queue only one at a time.
+    if (m_feedPending.testAndSetOrdered(0, 1))
+        QMetaObject::invokeMethod(this, "userFeed", Qt::QueuedConnection);
+}
+
+// Called with the mainloop lock held whenever the server has sent
+// fresh timing information, which AUTO_TIMING_UPDATE has it do regularly
+void QPulseAudioOutput::streamLatencyCallback()
+{
+    const QAudio::Timestamp timestamp = QPulseAudioInternal::streamTimestamp(m_stream, PA_STREAM_PLAYBACK);
+    if (!timestamp.isValid())
+        return;
+
+    m_timestamp = timestamp;
+    m_driftEstimator.addSample(timestamp);
+}
+
+// Must be called with the mainloop locked, which is always the case in the
+// pulse thread. Fills all writable space from the render callback.
+void QPulseAudioOutput::renderToStream()
+{
+    if (!m_rendering || !m_renderCallback)
+        return;
+
+    const size_t frameSize = pa_frame_size(&m_spec);
+
+    forever {
+        size_t writableSize = pa_stream_writable_size(m_stream);
+        if (writableSize == size_t(-1) || writableSize < frameSize)
+            break;
+
+        void *dest = 0;
+        size_t destSize = writableSize;
+        if (pa_stream_begin_write(m_stream, &dest, &destSize) < 0 || !dest)
+            break;
+
+        destSize -= destSize % frameSize;
+        if (destSize == 0) {
+            pa_stream_cancel_write(m_stream);
+            break;
+        }
+
+        m_renderCallback(static_cast<char *>(dest), int(destSize / frameSize), m_renderUserData);
+        pa_stream_write(m_stream, dest, destSize, 0, 0, PA_SEEK_RELATIVE);
+        m_totalTimeValue += destSize;
+    }
+}
+
 void QPulseAudioOutput::start(QIODevice *device)
 {
     setState(QAudio::StoppedState);
@@ -217,7 +288,8 @@ void QPulseAudioOutput::start(QIODevice *device)
         m_audioSource = 0;
     }
 
-    close();
+    if (!m_prepared)
+        close();
 
     if (!open())
         return;
@@ -226,6 +298,39 @@ void QPulseAudioOutput::start(QIODevice *device)
     m_audioSource = device;
 
     setState(QAudio::ActiveState);
+    startStream();
+}
+
+bool QPulseAudioOutput::startRendering(QAudio::RenderCallback callback, void *userData)
+{
+    setState(QAudio::StoppedState);
+    setError(QAudio::NoError);
+
+    if (m_audioSource && !m_pullMode) {
+        delete m_audioSource;
+        m_audioSource = 0;
+    }
+
+    if (!m_prepared)
+        close();
+
+    if (!open())
+        return false;
+
+    m_pullMode = true;
+    m_audioSource = 0;
+
+    // Read in the pulse thread, see streamWriteCallback()
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    m_renderCallback = callback;
+    m_renderUserData = userData;
+    pulseEngine->unlock();
+
+    setState(QAudio::ActiveState);
+    startStream();
+
+    return true;
 }
 
 QIODevice *QPulseAudioOutput::start()
@@ -239,7 +344,8 @@ QIODevice *QPulseAudioOutput::start()
         m_audioSource = 0;
     }
 
-    close();
+    if (!m_prepared)
+        close();
 
     if (!open())
         return Q_NULLPTR;
@@ -249,10 +355,106 @@ QIODevice *QPulseAudioOutput::start()
     m_pullMode = false;
 
     setState(QAudio::IdleState);
+    startStream();
 
     return m_audioSource;
 }
 
+void QPulseAudioOutput::prepare()
+{
+    if (m_deviceState != QAudio::StoppedState || m_opened)
+        return;
+
+    // Connect the stream corked, start() only has to uncork it
+    m_prepared = true;
+    if (!open())
+        m_prepared = false;
+}
+
+// Called once the output is in its started state, whether the stream was
+// prepared beforehand or has just been opened.
+void QPulseAudioOutput::startStream()
+{
+    m_prepared = false;
+    m_totalTimeValue = 0;
+
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    m_timestamp = QAudio::Timestamp();
+    m_driftEstimator.reset(m_format.sampleRate());
+    pulseEngine->unlock();
+
+    m_elapsedTimeOffset = 0;
+    m_timeStamp.restart();
+    m_clockStamp.restart();
+
+    // Otherwise onStreamReady() takes over once the server has set up the stream
+    if (m_streamReady) {
+        pulseEngine->lock();
+        setCorked(false);
+        pulseEngine->unlock();
+
+        startFeeding();
+    }
+}
+
+void QPulseAudioOutput::startFeeding()
+{
+    m_tickTimer->start(m_periodTime);
+
+    // The server may have asked for data before we were ready to render,
+    // it doesn't ask again until that has been written.
+    if (m_renderCallback) {
+        QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+        pulseEngine->lock();
+        m_rendering = true;
+        renderToStream();
+        pulseEngine->unlock();
+        return;
+    }
+
+    // Don't wait for the first tick or write request to fill the buffer
+    if (m_feedPending.testAndSetOrdered(0, 1))
+        QMetaObject::invokeMethod(this, "userFeed", Qt::QueuedConnection);
+}
+
+// Must be called with the mainloop locked. The server handles operations on
+// a stream in order, so there's no need to wait for this one to complete.
+void QPulseAudioOutput::setCorked(bool corked)
+{
+    if (!m_streamReady || m_corked == corked)
+        return;
+
+    m_corked = corked;
+
+    pa_operation *operation = pa_stream_cork(m_stream, corked ? 1 : 0, outputStreamSuccessCallback, NULL);
+    if (operation)
+        pa_operation_unref(operation);
+}
+
+// Must be called with the mainloop locked
+void QPulseAudioOutput::applyVolume()
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+
+    if (qFuzzyCompare(m_volume, 0.0)) {
+        pa_cvolume_mute(&m_chVolume, m_spec.channels);
+        m_volume = 0.0;
+    } else {
+        pa_volume_t paVolume = qFloor(m_volume * PA_VOLUME_NORM + 0.5);
+        pa_cvolume_set(&m_chVolume, m_spec.channels, paVolume);
+    }
+    pa_operation *op = pa_context_set_sink_input_volume(pulseEngine->context(),
+            pa_stream_get_index(m_stream),
+            &m_chVolume,
+            NULL,
+            NULL);
+    if (op == NULL)
+        qWarning()<<"QAudioOutput: Failed to set volume";
+    else
+        pa_operation_unref(op);
+}
+
 bool QPulseAudioOutput::open()
 {
     if (m_opened)
@@ -276,6 +478,20 @@ bool QPulseAudioOutput::open()
 
     m_spec = spec;
     m_totalTimeValue = 0;
+    m_streamReady = false;
+    m_volumeChanged = false;
+    m_pendingData.clear();
+
+    // An explicit latency target wins over the buffer size, the low latency
+    // category only picks a default for it
+    qint64 latencyTarget = m_latencyTarget;
+    if (latencyTarget <= 0 && m_bufferSize <= 0 && m_category == LOW_LATENCY_CATEGORY_NAME)
+        latencyTarget = LowLatencyBufferSizeMs * qint64(1000);
+
+    m_periodTime = PeriodTimeMs;
+    if (latencyTarget > 0)
+        m_periodTime = qBound(1, int(latencyTarget / 1000 / LatencyTargetPeriods), PeriodTimeMs);
+    m_periodSize = pa_usec_to_bytes(m_periodTime*1000, &m_spec);
 
     if (m_streamName.isNull())
         m_streamName = QString(QLatin1String("QtmPulseStream-%1-%2")).arg(::getpid()).arg(quintptr(this)).toUtf8();
@@ -289,8 +505,6 @@ bool QPulseAudioOutput::open()
 
     pulseEngine->lock();
 
-    qint64 bytesPerSecond = m_format.sampleRate() * m_format.channelCount() * m_format.sampleSize() / 8;
-
     pa_proplist *propList = pa_proplist_new();
     if (!m_category.isNull())
         pa_proplist_sets(propList, PA_PROP_MEDIA_ROLE, m_category.toLatin1().constData());
@@ -314,18 +528,27 @@ bool QPulseAudioOutput::open()
     }
     pa_cvolume_set(&m_chVolume, m_spec.channels, paVolume);
 
-    if (m_bufferSize <= 0 && m_category == LOW_LATENCY_CATEGORY_NAME) {
-        m_bufferSize = bytesPerSecond * LowLatencyBufferSizeMs / qint64(1000);
-    }
-
     pa_buffer_attr requestedBuffer;
     requestedBuffer.fragsize = (uint32_t)-1;
     requestedBuffer.maxlength = (uint32_t)-1;
     requestedBuffer.minreq = (uint32_t)-1;
     requestedBuffer.prebuf = (uint32_t)-1;
-    requestedBuffer.tlength = m_bufferSize;
+    requestedBuffer.tlength = (latencyTarget > 0) ? pa_usec_to_bytes(latencyTarget, &m_spec) : m_bufferSize;
+
+    // Let the server interpolate the playback position between timing
+    // updates, processedUSecs() asks it for what has actually been played.
+    int flags = PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
+
+    // With a latency target the server sizes the sink's own buffering to
+    // match, tlength is then the end-to-end latency rather than just ours.
+    if (latencyTarget > 0)
+        flags |= PA_STREAM_ADJUST_LATENCY;
+
+    m_corked = m_prepared;
+    if (m_prepared)
+        flags |= PA_STREAM_START_CORKED;
 
-    if (pa_stream_connect_playback(m_stream, m_device.data(), (m_bufferSize > 0) ? &requestedBuffer : NULL, (pa_stream_flags_t)0, &m_chVolume, NULL) < 0) {
+    if (pa_stream_connect_playback(m_stream, m_device.data(), (requestedBuffer.tlength > 0) ? &requestedBuffer : NULL, (pa_stream_flags_t)flags, &m_chVolume, NULL) < 0) {
         qWarning() << "pa_stream_connect_playback() failed!";
         pa_stream_unref(m_stream);
         m_stream = 0;
@@ -335,15 +558,32 @@ bool QPulseAudioOutput::open()
         return false;
     }
 
-    while (pa_stream_get_state(m_stream) != PA_STREAM_READY)
-        pa_threaded_mainloop_wait(pulseEngine->mainloop());
+    // Don't wait for the stream to become ready here, that takes a round trip
+    // to the server. onStreamReady() finishes the setup.
+    pulseEngine->unlock();
+
+    connect(pulseEngine, &QPulseAudioEngine::contextFailed, this, &QPulseAudioOutput::onPulseContextFailed);
+
+    m_opened = true;
+
+    return true;
+}
+
+void QPulseAudioOutput::onStreamReady()
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+
+    pulseEngine->lock();
+
+    // Ignore notifications about a stream that has been closed since
+    if (!m_opened || m_streamReady || !m_stream || pa_stream_get_state(m_stream) != PA_STREAM_READY) {
+        pulseEngine->unlock();
+        return;
+    }
 
     const pa_buffer_attr *buffer = pa_stream_get_buffer_attr(m_stream);
-    m_periodTime = (m_category == LOW_LATENCY_CATEGORY_NAME) ? LowLatencyPeriodTimeMs : PeriodTimeMs;
-    m_periodSize = pa_usec_to_bytes(m_periodTime*1000, &m_spec);
     m_bufferSize = buffer->tlength;
     m_maxBufferSize = buffer->maxlength;
-    m_audioBuffer = new char[m_maxBufferSize];
 #ifdef DEBUG_PULSE
     qDebug() << "Buffering info:";
     qDebug() << "\tMax length: " << buffer->maxlength;
@@ -353,19 +593,41 @@ bool QPulseAudioOutput::open()
     qDebug() << "\tFragment size: " << buffer->fragsize;
 #endif
 
+    m_streamReady = true;
+
+    if (m_volumeChanged) {
+        applyVolume();
+        m_volumeChanged = false;
+    }
+
+    // The output may have been started, suspended or resumed while connecting
+    const bool running = !m_prepared && m_deviceState != QAudio::SuspendedState;
+    setCorked(!running);
+
     pulseEngine->unlock();
 
-    connect(pulseEngine, &QPulseAudioEngine::contextFailed, this, &QPulseAudioOutput::onPulseContextFailed);
+    flushPendingData();
 
-    m_opened = true;
+    if (running)
+        startFeeding();
+}
 
-    m_tickTimer->start(m_periodTime);
+void QPulseAudioOutput::onStreamFailed()
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
-    m_elapsedTimeOffset = 0;
-    m_timeStamp.restart();
-    m_clockStamp.restart();
+    pulseEngine->lock();
+    const bool failed = m_opened && m_stream && pa_stream_get_state(m_stream) == PA_STREAM_FAILED;
+    pulseEngine->unlock();
 
-    return true;
+    if (!failed)
+        return;
+
+    const bool wasReady = m_streamReady;
+    close();
+
+    setError(wasReady ? QAudio::FatalError : QAudio::OpenError);
+    setState(QAudio::StoppedState);
 }
 
 void QPulseAudioOutput::close()
@@ -374,12 +636,20 @@ void QPulseAudioOutput::close()
         return;
 
     m_tickTimer->stop();
+    m_streamReady = false;
+    m_prepared = false;
+    m_pendingData.clear();
 
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
     if (m_stream) {
         pulseEngine->lock();
 
+        m_rendering = false;
+        m_renderCallback = 0;
+        m_renderUserData = 0;
+        m_timestamp = QAudio::Timestamp();
+
         pa_stream_set_state_callback(m_stream, 0, 0);
         pa_stream_set_write_callback(m_stream, 0, 0);
         pa_stream_set_underflow_callback(m_stream, 0, 0);
@@ -393,6 +663,7 @@ void QPulseAudioOutput::close()
         pa_stream_disconnect(m_stream);
         pa_stream_unref(m_stream);
         m_stream = NULL;
+        ++m_streamGeneration;
 
         pulseEngine->unlock();
     }
@@ -404,46 +675,29 @@ void QPulseAudioOutput::close()
         m_audioSource = 0;
     }
     m_opened = false;
-    if (m_audioBuffer) {
-        delete[] m_audioBuffer;
-        m_audioBuffer = 0;
-    }
 }
 
 void QPulseAudioOutput::userFeed()
 {
+    m_feedPending.store(0);
+
     if (m_deviceState == QAudio::StoppedState || m_deviceState == QAudio::SuspendedState)
         return;
 
+    if (!m_streamReady)
+        return;
+
     m_resuming = false;
 
-    if (m_pullMode) {
-        int writableSize = bytesFree();
-        int chunks = writableSize / m_periodSize;
-        if (chunks == 0)
+    if (m_renderCallback) {
+        // Fed from the pulse thread, which keeps going after an underflow
+        setError(QAudio::NoError);
+        setState(QAudio::ActiveState);
+    } else if (m_pullMode) {
+        if (!feedFromSource())
             return;
-
-        int input = m_periodSize; // always request 1 chunk of data from user
-        if (input > m_maxBufferSize)
-            input = m_maxBufferSize;
-
-        int audioBytesPulled = m_audioSource->read(m_audioBuffer, input);
-        Q_ASSERT(audioBytesPulled <= input);
-        if (audioBytesPulled > 0) {
-            if (audioBytesPulled > input) {
-                qWarning() << "QPulseAudioOutput::userFeed() - Invalid audio data size provided from user:"
-                           << audioBytesPulled << "should be less than" << input;
-                audioBytesPulled = input;
-            }
-            qint64 bytesWritten = write(m_audioBuffer, audioBytesPulled);
-            Q_ASSERT(bytesWritten == audioBytesPulled); //unfinished write should not happen since the data provided is less than writableSize
-            Q_UNUSED(bytesWritten);
-
-            if (chunks > 1) {
-                // PulseAudio needs more data. Ask for it immediately.
-                QMetaObject::invokeMethod(this, "userFeed", Qt::QueuedConnection);
-            }
-        }
+    } else {
+        flushPendingData();
     }
 
     if (m_deviceState != QAudio::ActiveState)
@@ -456,14 +710,122 @@ void QPulseAudioOutput::userFeed()
     }
 }
 
-qint64 QPulseAudioOutput::write(const char *data, qint64 len)
+// Reads from the source straight into the server's buffers until either all
+// writable space is filled or the source runs dry. Returns false if the
+// output was closed while reading.
+bool QPulseAudioOutput::feedFromSource()
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    // A stream opened while reading may well get the old one's address,
+    // only the generation tells them apart
+    const int generation = m_streamGeneration;
+    pa_stream *stream = m_stream;
+    qint64 bytesFed = 0;
+
+    forever {
+        pulseEngine->lock();
+
+        size_t writableSize = pa_stream_writable_size(stream);
+        void *dest = 0;
+        size_t destSize = writableSize;
+        if (writableSize == 0 || writableSize == size_t(-1)
+                || pa_stream_begin_write(stream, &dest, &destSize) < 0 || !dest || destSize == 0) {
+            pulseEngine->unlock();
+            break;
+        }
+
+        // The buffer stays ours until pa_stream_write() or pa_stream_cancel_write(),
+        // don't block the pulse thread while the source produces the data. The
+        // extra reference keeps the buffer alive should the source close us.
+        pa_stream_ref(stream);
+        pulseEngine->unlock();
+
+        qint64 audioBytesPulled = m_audioSource->read(static_cast<char *>(dest), destSize);
+
+        pulseEngine->lock();
+
+        // Reading may have ended up stopping or restarting us; the old
+        // stream is disconnected and its buffer goes with the last reference
+        if (!m_opened || m_streamGeneration != generation) {
+            pa_stream_unref(stream);
+            pulseEngine->unlock();
+            return false;
+        }
+
+        if (audioBytesPulled > qint64(destSize)) {
+            qWarning() << "QPulseAudioOutput::userFeed() - Invalid audio data size provided from user:"
+                       << audioBytesPulled << "should be less than" << destSize;
+            audioBytesPulled = destSize;
+        }
+
+        if (audioBytesPulled > 0)
+            pa_stream_write(stream, dest, audioBytesPulled, 0, 0, PA_SEEK_RELATIVE);
+        else
+            pa_stream_cancel_write(stream);
+        pa_stream_unref(stream);
+        pulseEngine->unlock();
+
+        if (audioBytesPulled <= 0)
+            break;
+
+        bytesFed += audioBytesPulled;
+        if (audioBytesPulled < qint64(destSize))
+            break;
+    }
+
+    if (bytesFed > 0) {
+        m_totalTimeValue += bytesFed;
+        setError(QAudio::NoError);
+        setState(QAudio::ActiveState);
+    }
+
+    return m_opened;
+}
+
+// The buffer for data written before the stream is ready, or while data
+// written back then is still waiting for space on the server.
+int QPulseAudioOutput::pendingBufferSize() const
+{
+    return m_bufferSize > 0 ? m_bufferSize : m_periodSize * PendingBufferPeriods;
+}
+
+void QPulseAudioOutput::flushPendingData()
 {
+    if (!m_streamReady || m_pendingData.isEmpty())
+        return;
+
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
     pulseEngine->lock();
-    len = qMin(len, static_cast<qint64>(pa_stream_writable_size(m_stream)));
-    pa_stream_write(m_stream, data, len, 0, 0, PA_SEEK_RELATIVE);
+    size_t writableSize = pa_stream_writable_size(m_stream);
+    int len = 0;
+    if (writableSize != size_t(-1)) {
+        len = int(qMin(static_cast<qint64>(m_pendingData.size()), static_cast<qint64>(writableSize)));
+        if (len > 0)
+            pa_stream_write(m_stream, m_pendingData.constData(), len, 0, 0, PA_SEEK_RELATIVE);
+    }
     pulseEngine->unlock();
+
+    m_pendingData.remove(0, len);
+}
+
+qint64 QPulseAudioOutput::write(const char *data, qint64 len)
+{
+    flushPendingData();
+
+    if (!m_streamReady || !m_pendingData.isEmpty()) {
+        len = qMin(len, static_cast<qint64>(pendingBufferSize() - m_pendingData.size()));
+        if (len <= 0)
+            return 0;
+        m_pendingData.append(data, len);
+    } else {
+        QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+
+        pulseEngine->lock();
+        len = qMin(len, static_cast<qint64>(pa_stream_writable_size(m_stream)));
+        pa_stream_write(m_stream, data, len, 0, 0, PA_SEEK_RELATIVE);
+        pulseEngine->unlock();
+    }
     m_totalTimeValue += len;
 
     setError(QAudio::NoError);
@@ -474,8 +836,11 @@ qint64 QPulseAudioOutput::write(const char *data, qint64 len)
 
 void QPulseAudioOutput::stop()
 {
-    if (m_deviceState == QAudio::StoppedState)
+    if (m_deviceState == QAudio::StoppedState) {
+        // Release a prepared stream
+        close();
         return;
+    }
 
     close();
 
@@ -488,6 +853,9 @@ int QPulseAudioOutput::bytesFree() const
     if (m_deviceState != QAudio::ActiveState && m_deviceState != QAudio::IdleState)
         return 0;
 
+    if (!m_streamReady || !m_pendingData.isEmpty())
+        return qMax(0, pendingBufferSize() - m_pendingData.size());
+
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
     pulseEngine->lock();
     int writableSize = pa_stream_writable_size(m_stream);
@@ -502,6 +870,9 @@ int QPulseAudioOutput::periodSize() const
 
 void QPulseAudioOutput::setBufferSize(int value)
 {
+    if (m_prepared)
+        close();
+
     m_bufferSize = value;
 }
 
@@ -510,6 +881,19 @@ int QPulseAudioOutput::bufferSize() const
     return m_bufferSize;
 }
 
+void QPulseAudioOutput::setLatencyTarget(qint64 usecs)
+{
+    if (m_prepared)
+        close();
+
+    m_latencyTarget = qMax(qint64(0), usecs);
+}
+
+qint64 QPulseAudioOutput::latencyTarget() const
+{
+    return m_latencyTarget;
+}
+
 void QPulseAudioOutput::setNotifyInterval(int ms)
 {
     m_notifyInterval = qMax(0, ms);
@@ -522,41 +906,83 @@ int QPulseAudioOutput::notifyInterval() const
 
 qint64 QPulseAudioOutput::processedUSecs() const
 {
-    qint64 result = qint64(1000000) * m_totalTimeValue /
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pa_usec_t streamTime = 0;
+    bool haveTime = false;
+
+    // A render callback adds to the total from the pulse thread
+    pulseEngine->lock();
+    const qint64 totalBytes = m_totalTimeValue;
+    if (m_streamReady)
+        haveTime = pa_stream_get_time(m_stream, &streamTime) == 0;
+    pulseEngine->unlock();
+
+    qint64 result = qint64(1000000) * totalBytes /
         (m_format.channelCount() * (m_format.sampleSize() / 8)) /
         m_format.sampleRate();
 
+    // Report what the server has played rather than what we've handed it,
+    // as long as it has timing information for the stream. The read index
+    // runs past the written data on underruns.
+    if (haveTime)
+        result = qMin(result, qint64(streamTime));
+
     return result;
 }
 
+QAudio::Timestamp QPulseAudioOutput::timestamp() const
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    const QAudio::Timestamp timestamp = m_timestamp;
+    pulseEngine->unlock();
+
+    return timestamp;
+}
+
+qreal QPulseAudioOutput::clockDrift() const
+{
+    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+    pulseEngine->lock();
+    const qreal drift = m_driftEstimator.drift();
+    pulseEngine->unlock();
+
+    return drift;
+}
+
 void QPulseAudioOutput::resume()
 {
     if (m_deviceState == QAudio::SuspendedState) {
         m_resuming = true;
 
+        setState(QAudio::ActiveState);
+        setError(QAudio::NoError);
+
+        // Still connecting, onStreamReady() leaves the stream running
+        if (!m_streamReady)
+            return;
+
         QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
 
         pulseEngine->lock();
 
-        pa_operation *operation = pa_stream_cork(m_stream, 0, outputStreamSuccessCallback, NULL);
-        pulseEngine->wait(operation);
-        pa_operation_unref(operation);
+        setCorked(false);
 
-        operation = pa_stream_trigger(m_stream, outputStreamSuccessCallback, NULL);
-        pulseEngine->wait(operation);
-        pa_operation_unref(operation);
+        pa_operation *operation = pa_stream_trigger(m_stream, outputStreamSuccessCallback, NULL);
+        if (operation)
+            pa_operation_unref(operation);
 
         pulseEngine->unlock();
 
-        m_tickTimer->start(m_periodTime);
-
-        setState(QAudio::ActiveState);
-        setError(QAudio::NoError);
+        startFeeding();
     }
 }
 
 void QPulseAudioOutput::setFormat(const QAudioFormat &format)
 {
+    if (m_prepared)
+        close();
+
     m_format = format;
 }
 
@@ -574,14 +1000,10 @@ void QPulseAudioOutput::suspend()
         m_tickTimer->stop();
 
         QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
-        pa_operation *operation;
 
         pulseEngine->lock();
-
-        operation = pa_stream_cork(m_stream, 1, outputStreamSuccessCallback, NULL);
-        pulseEngine->wait(operation);
-        pa_operation_unref(operation);
-
+        m_rendering = false;
+        setCorked(true);
         pulseEngine->unlock();
     }
 }
@@ -637,27 +1059,14 @@ void QPulseAudioOutput::setVolume(qreal vol)
     if (vol >= 0.0 && vol <= 1.0) {
         if (!qFuzzyCompare(m_volume, vol)) {
             m_volume = vol;
-            if (m_opened) {
+            if (m_streamReady) {
                 QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
                 pulseEngine->lock();
-                pa_volume_t paVolume;
-                if (qFuzzyCompare(vol, 0.0)) {
-                    pa_cvolume_mute(&m_chVolume, m_spec.channels);
-                    m_volume = 0.0;
-                } else {
-                    paVolume = qFloor(m_volume * PA_VOLUME_NORM + 0.5);
-                    pa_cvolume_set(&m_chVolume, m_spec.channels, paVolume);
-                }
-                pa_operation *op = pa_context_set_sink_input_volume(pulseEngine->context(),
-                        pa_stream_get_index(m_stream),
-                        &m_chVolume,
-                        NULL,
-                        NULL);
-                if (op == NULL)
-                    qWarning()<<"QAudioOutput: Failed to set volume";
-                else
-                    pa_operation_unref(op);
+                applyVolume();
                 pulseEngine->unlock();
+            } else if (m_opened) {
+                // The sink input doesn't exist until the stream is ready
+                m_volumeChanged = true;
             }
         }
     }
@@ -671,6 +1080,8 @@ qreal QPulseAudioOutput::volume() const
 void QPulseAudioOutput::setCategory(const QString &category)
 {
     if (m_category != category) {
+        if (m_prepared)
+            close();
         m_category = category;
     }
 }
@@ -53,6 +53,7 @@
 // We mean it.
 //
 
+#include <QtCore/qatomic.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qstring.h>
@@ -63,14 +64,17 @@
 #include "qaudiodeviceinfo.h"
 #include "qaudiosystem.h"
 
+#include <QtMultimedia/private/qaudioclock_p.h>
+
 #include <pulse/pulseaudio.h>
 
 QT_BEGIN_NAMESPACE
 
-class QPulseAudioOutput : public QAbstractAudioOutput
+class QPulseAudioOutput : public QAbstractAudioOutput, public QAudioOutputExtensionInterface
 {
     friend class OutputPrivate;
     Q_OBJECT
+    Q_INTERFACES(QAudioOutputExtensionInterface)
 
 public:
     QPulseAudioOutput(const QByteArray &device);
@@ -78,6 +82,7 @@ public:
 
     void start(QIODevice *device);
     QIODevice *start();
+    bool startRendering(QAudio::RenderCallback callback, void *userData);
     void stop();
     void reset();
     void suspend();
@@ -86,10 +91,14 @@ public:
     int periodSize() const;
     void setBufferSize(int value);
     int bufferSize() const;
+    void setLatencyTarget(qint64 usecs);
+    qint64 latencyTarget() const;
     void setNotifyInterval(int milliSeconds);
     int notifyInterval() const;
     qint64 processedUSecs() const;
     qint64 elapsedUSecs() const;
+    QAudio::Timestamp timestamp() const;
+    qreal clockDrift() const;
     QAudio::Error error() const;
     QAudio::State state() const;
     void setFormat(const QAudioFormat &format);
@@ -101,8 +110,12 @@ public:
     void setCategory(const QString &category);
     QString category() const;
 
+    void prepare();
+
 public:
     void streamUnderflowCallback();
+    void streamWriteCallback();
+    void streamLatencyCallback();
 
 private:
     void setState(QAudio::State state);
@@ -110,10 +123,20 @@ private:
 
     bool open();
     void close();
+    void startStream();
+    void startFeeding();
+    void setCorked(bool corked);
+    void applyVolume();
+    void renderToStream();
+    int pendingBufferSize() const;
+    void flushPendingData();
+    bool feedFromSource();
     qint64 write(const char *data, qint64 len);
 
 private Q_SLOTS:
     void userFeed();
+    void onStreamReady();
+    void onStreamFailed();
     void onPulseContextFailed();
 
 private:
@@ -124,18 +147,30 @@ private:
     QAudio::State m_deviceState;
     bool m_pullMode;
     bool m_opened;
+    bool m_streamReady;
+    bool m_prepared;
+    bool m_corked;
+    bool m_volumeChanged;
     QIODevice *m_audioSource;
+    QAudio::RenderCallback m_renderCallback;
+    void *m_renderUserData;
+    bool m_rendering;
     QTimer m_periodTimer;
     int m_periodTime;
     pa_stream *m_stream;
+    int m_streamGeneration;
     int m_notifyInterval;
     int m_periodSize;
     int m_bufferSize;
     int m_maxBufferSize;
+    qint64 m_latencyTarget;
     QTime m_clockStamp;
     qint64 m_totalTimeValue;
+    QAudio::Timestamp m_timestamp;
+    QAudioClockDriftEstimator m_driftEstimator;
+    QByteArray m_pendingData;
     QTimer *m_tickTimer;
-    char *m_audioBuffer;
+    QAtomicInt m_feedPending;
     QTime m_timeStamp;
     qint64 m_elapsedTimeOffset;
     bool m_resuming;
@@ -41,6 +41,8 @@
 
 #include "qpulsehelpers.h"
 
+#include <QtMultimedia/private/qaudioclock_p.h>
+
 QT_BEGIN_NAMESPACE
 
 namespace QPulseAudioInternal
@@ -215,6 +217,46 @@ QAudioFormat sampleSpecToAudioFormat(pa_sample_spec spec)
 
     return format;
 }
+
+// Must be called with the mainloop lock held
+QAudio::Timestamp streamTimestamp(pa_stream *stream, pa_stream_direction_t direction)
+{
+    QAudio::Timestamp timestamp;
+
+    const pa_timing_info *info = pa_stream_get_timing_info(stream);
+    if (!info)
+        return timestamp;
+
+    // The same arithmetic pa_stream_get_time() does, but in frames and
+    // without interpolating, so that the position matches info->timestamp
+    qint64 index;
+    qint64 offsetUSecs;
+    if (direction == PA_STREAM_PLAYBACK) {
+        if (info->read_index_corrupt || !info->playing)
+            return timestamp;
+        index = info->read_index;
+        offsetUSecs = qint64(info->transport_usec) - qint64(info->sink_usec);
+    } else {
+        if (info->write_index_corrupt)
+            return timestamp;
+        index = info->write_index;
+        offsetUSecs = qint64(info->source_usec) + qint64(info->transport_usec);
+    }
+
+    const pa_sample_spec *spec = pa_stream_get_sample_spec(stream);
+    const qint64 frames = index / qint64(pa_frame_size(spec)) + offsetUSecs * spec->rate / 1000000;
+
+    timestamp.framePosition = qMax(qint64(0), frames);
+    timestamp.systemTime = QAudioClockInternal::monotonicFromRealtime(
+                qint64(info->timestamp.tv_sec) * 1000000 + info->timestamp.tv_usec);
+
+    pa_usec_t latency = 0;
+    int negative = 0;
+    if (pa_stream_get_latency(stream, &latency, &negative) == 0 && !negative)
+        timestamp.latency = latency;
+
+    return timestamp;
+}
 }
 
 QT_END_NAMESPACE
@@ -53,6 +53,7 @@
 // We mean it.
 //
 
+#include "qaudio.h"
 #include "qaudiodeviceinfo.h"
 #include <qaudioformat.h>
 #include <pulse/pulseaudio.h>
@@ -66,6 +67,7 @@ QString stateToQString(pa_stream_state_t state);
 QString stateToQString(pa_context_state_t state);
 QString sampleFormatToQString(pa_sample_format format);
 QAudioFormat sampleSpecToAudioFormat(pa_sample_spec spec);
+QAudio::Timestamp streamTimestamp(pa_stream *stream, pa_stream_direction_t direction);
 }
 
 QT_END_NAMESPACE
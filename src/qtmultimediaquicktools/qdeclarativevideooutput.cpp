@@ -135,7 +135,8 @@ QDeclarativeVideoOutput::QDeclarativeVideoOutput(QQuickItem *parent) :
     m_geometryDirty(true),
     m_orientation(0),
     m_autoOrientation(false),
-    m_screenOrientationHandler(0)
+    m_screenOrientationHandler(0),
+    m_statistics(new QDeclarativeVideoOutputStatistics(this))
 {
     setFlag(ItemHasContents, true);
 }
@@ -506,6 +507,20 @@ void QDeclarativeVideoOutput::setAutoOrientation(bool autoOrientation)
     emit autoOrientationChanged();
 }
 
+/*!
+    \qmlproperty VideoOutputStatistics QtMultimedia::VideoOutput::statistics
+
+    This property holds frame timing statistics of the video output: how
+    many frames were delivered, dropped because they were replaced before
+    being rendered, how long texture uploads take and how long frames wait
+    to be rendered.
+
+    Statistics are only collected when the video is rendered by the scene
+    graph, not when it is shown in an overlay window.
+
+    \since QtMultimedia 5.4
+*/
+
 /*!
     \qmlproperty rectangle QtMultimedia::VideoOutput::contentRect
 
@@ -42,6 +42,7 @@
 
 #include "qdeclarativevideooutput_render_p.h"
 #include "qdeclarativevideooutput_p.h"
+#include "qdeclarativevideooutputstatistics_p.h"
 #include <QtMultimedia/qvideorenderercontrol.h>
 #include <QtMultimedia/qmediaservice.h>
 #include <private/qmediapluginloader_p.h>
@@ -57,7 +58,8 @@ Q_GLOBAL_STATIC_WITH_ARGS(QMediaPluginLoader, videoNodeFactoryLoader,
 QDeclarativeVideoRendererBackend::QDeclarativeVideoRendererBackend(QDeclarativeVideoOutput *parent)
     : QDeclarativeVideoBackend(parent),
       m_glContext(0),
-      m_frameChanged(false)
+      m_frameChanged(false),
+      m_framePresentationTime(0)
 {
     m_surface = new QSGVideoItemSurface(this);
     QObject::connect(m_surface, SIGNAL(surfaceFormatChanged(QVideoSurfaceFormat)),
@@ -71,6 +73,7 @@ QDeclarativeVideoRendererBackend::QDeclarativeVideoRendererBackend(QDeclarativeV
 
     // Append existing node factories as fallback if we have no plugins
     m_videoNodeFactories.append(&m_i420Factory);
+    m_videoNodeFactories.append(&m_nv12Factory);
     m_videoNodeFactories.append(&m_rgbFactory);
     m_videoNodeFactories.append(&m_textureFactory);
 }
@@ -232,8 +235,10 @@ QSGNode *QDeclarativeVideoRendererBackend::updatePaintNode(QSGNode *oldNode,
         if (!videoNode) {
             foreach (QSGVideoNodeFactoryInterface* factory, m_videoNodeFactories) {
                 videoNode = factory->createNode(m_surface->surfaceFormat());
-                if (videoNode)
+                if (videoNode) {
+                    videoNode->setStatistics(q->statistics());
                     break;
+                }
             }
         }
     }
@@ -248,6 +253,7 @@ QSGNode *QDeclarativeVideoRendererBackend::updatePaintNode(QSGNode *oldNode,
     videoNode->setTexturedRectGeometry(m_renderedRect, m_sourceTextureRect,
                                        qNormalizedOrientation(q->orientation()));
     if (m_frameChanged) {
+        q->statistics()->frameRendered(m_framePresentationTime);
         videoNode->setCurrentFrame(m_frame);
         //don't keep the frame for more than really necessary
         m_frameChanged = false;
@@ -285,6 +291,11 @@ QOpenGLContext *QDeclarativeVideoRendererBackend::glContext() const
 void QDeclarativeVideoRendererBackend::present(const QVideoFrame &frame)
 {
     m_frameMutex.lock();
+    if (frame.isValid()) {
+        QDeclarativeVideoOutputStatistics *statistics = q->statistics();
+        statistics->framePresented(m_frameChanged && m_frame.isValid());
+        m_framePresentationTime = statistics->timestamp();
+    }
     m_frame = frame;
     m_frameChanged = true;
     m_frameMutex.unlock();
@@ -45,6 +45,7 @@
 
 #include "qdeclarativevideooutput_backend_p.h"
 #include "qsgvideonode_i420.h"
+#include "qsgvideonode_nv12.h"
 #include "qsgvideonode_rgb.h"
 #include "qsgvideonode_texture.h"
 
@@ -85,7 +86,9 @@ private:
     QOpenGLContext *m_glContext;
     QVideoFrame m_frame;
     bool m_frameChanged;
+    qint64 m_framePresentationTime;
     QSGVideoNodeFactory_I420 m_i420Factory;
+    QSGVideoNodeFactory_NV12 m_nv12Factory;
     QSGVideoNodeFactory_RGB m_rgbFactory;
     QSGVideoNodeFactory_Texture m_textureFactory;
     QMutex m_frameMutex;
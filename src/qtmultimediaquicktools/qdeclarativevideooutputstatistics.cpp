@@ -0,0 +1,351 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qdeclarativevideooutputstatistics_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Upper limits of the upload time histogram buckets, in microseconds.  The
+// last bucket collects everything slower than a 30 fps frame.
+static const qint64 uploadTimeBucketLimits[QDeclarativeVideoOutputStatistics::HistogramBuckets] = {
+    500, 1000, 2000, 4000, 8000, 16000, 33000, Q_INT64_C(0x7fffffffffffffff)
+};
+
+/*!
+    \qmltype VideoOutputStatistics
+    \instantiates QDeclarativeVideoOutputStatistics
+    \brief Frame timing statistics of a VideoOutput.
+
+    \ingroup multimedia_qml
+    \ingroup multimedia_video_qml
+    \inqmlmodule QtMultimedia
+
+    This type is provided by the \l {QtMultimedia::VideoOutput::statistics}{statistics}
+    property of VideoOutput and cannot be created directly.
+
+    The counters are cheap to maintain and are always collected. To keep
+    bindings from being reevaluated for every video frame, change
+    notifications are only sent every \l updateInterval milliseconds.
+
+    \qml
+    import QtQuick 2.0
+    import QtMultimedia 5.4
+
+    VideoOutput {
+        id: videoOutput
+        source: player
+
+        Text {
+            text: videoOutput.statistics.framesDropped + " frames dropped, "
+                  + videoOutput.statistics.averageUploadTime.toFixed(2) + " ms per upload"
+        }
+    }
+    \endqml
+
+    \since QtMultimedia 5.4
+*/
+
+/*!
+    \internal
+    \class QDeclarativeVideoOutputStatistics
+    \brief The QDeclarativeVideoOutputStatistics class collects frame timing
+    statistics of a QDeclarativeVideoOutput.
+
+    The recording functions may be called from the thread delivering video
+    frames and from the render thread.
+*/
+
+QDeclarativeVideoOutputStatistics::QDeclarativeVideoOutputStatistics(QObject *parent)
+    : QObject(parent)
+    , m_dirty(false)
+{
+    m_clock.start();
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(1000);
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(_q_update()));
+
+    reset();
+}
+
+QDeclarativeVideoOutputStatistics::~QDeclarativeVideoOutputStatistics()
+{
+}
+
+/*!
+    \qmlproperty int QtMultimedia::VideoOutputStatistics::framesPresented
+
+    This property holds the number of frames delivered to the VideoOutput.
+*/
+int QDeclarativeVideoOutputStatistics::framesPresented() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_framesPresented;
+}
+
+/*!
+    \qmlproperty int QtMultimedia::VideoOutputStatistics::framesDropped
+
+    This property holds the number of frames that were replaced by a newer
+    frame before the scene graph got to render them.
+*/
+int QDeclarativeVideoOutputStatistics::framesDropped() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_framesDropped;
+}
+
+/*!
+    \qmlproperty int QtMultimedia::VideoOutputStatistics::framesRendered
+
+    This property holds the number of frames handed to the scene graph.
+*/
+int QDeclarativeVideoOutputStatistics::framesRendered() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_framesRendered;
+}
+
+/*!
+    \qmlproperty real QtMultimedia::VideoOutputStatistics::averageUploadTime
+
+    This property holds the average time in milliseconds spent uploading a
+    frame to textures on the render thread.
+
+    Only frames rendered by the built-in video nodes are measured.
+*/
+qreal QDeclarativeVideoOutputStatistics::averageUploadTime() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_uploads > 0 ? qreal(m_totalUploadTime) / m_uploads / 1000 : 0;
+}
+
+/*!
+    \qmlproperty real QtMultimedia::VideoOutputStatistics::maximumUploadTime
+
+    This property holds the longest time in milliseconds spent uploading a
+    single frame.
+*/
+qreal QDeclarativeVideoOutputStatistics::maximumUploadTime() const
+{
+    QMutexLocker locker(&m_mutex);
+    return qreal(m_maximumUploadTime) / 1000;
+}
+
+/*!
+    \qmlproperty list<int> QtMultimedia::VideoOutputStatistics::uploadTimeHistogram
+
+    This property holds the number of uploads that took at most 0.5, 1, 2, 4,
+    8, 16 and 33 milliseconds, followed by the number of uploads that took
+    longer than 33 milliseconds.
+*/
+QList<int> QDeclarativeVideoOutputStatistics::uploadTimeHistogram() const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<int> histogram;
+    for (int i = 0; i < HistogramBuckets; ++i)
+        histogram.append(m_uploadTimeHistogram[i]);
+    return histogram;
+}
+
+/*!
+    Returns the upper limit in microseconds of the upload times counted in
+    histogram \a bucket.
+*/
+qint64 QDeclarativeVideoOutputStatistics::uploadTimeBucketLimit(int bucket)
+{
+    return bucket >= 0 && bucket < HistogramBuckets ? uploadTimeBucketLimits[bucket] : 0;
+}
+
+/*!
+    \qmlproperty real QtMultimedia::VideoOutputStatistics::averageLatency
+
+    This property holds the average time in milliseconds from a frame being
+    delivered to the VideoOutput until it is handed to the scene graph.
+*/
+qreal QDeclarativeVideoOutputStatistics::averageLatency() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_framesRendered > 0 ? qreal(m_totalLatency) / m_framesRendered / 1000 : 0;
+}
+
+/*!
+    \qmlproperty real QtMultimedia::VideoOutputStatistics::maximumLatency
+
+    This property holds the longest time in milliseconds a frame waited to
+    be handed to the scene graph.
+*/
+qreal QDeclarativeVideoOutputStatistics::maximumLatency() const
+{
+    QMutexLocker locker(&m_mutex);
+    return qreal(m_maximumLatency) / 1000;
+}
+
+/*!
+    \qmlproperty int QtMultimedia::VideoOutputStatistics::updateInterval
+
+    This property holds the minimum interval in milliseconds between two
+    change notifications.
+
+    The default is 1000 milliseconds.
+*/
+int QDeclarativeVideoOutputStatistics::updateInterval() const
+{
+    return m_updateTimer.interval();
+}
+
+void QDeclarativeVideoOutputStatistics::setUpdateInterval(int interval)
+{
+    if (interval == m_updateTimer.interval())
+        return;
+
+    m_updateTimer.setInterval(qMax(0, interval));
+    emit updateIntervalChanged();
+}
+
+/*!
+    \qmlmethod QtMultimedia::VideoOutputStatistics::reset()
+
+    Sets all counters back to zero.
+*/
+void QDeclarativeVideoOutputStatistics::reset()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_framesPresented = 0;
+        m_framesDropped = 0;
+        m_framesRendered = 0;
+        m_uploads = 0;
+        m_totalUploadTime = 0;
+        m_maximumUploadTime = 0;
+        memset(m_uploadTimeHistogram, 0, sizeof(m_uploadTimeHistogram));
+        m_totalLatency = 0;
+        m_maximumLatency = 0;
+    }
+
+    markDirty();
+}
+
+/*!
+    Records that a frame was delivered.  \a droppedPending is true when it
+    replaced a frame that had not been rendered yet.
+*/
+void QDeclarativeVideoOutputStatistics::framePresented(bool droppedPending)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_framesPresented;
+        if (droppedPending)
+            ++m_framesDropped;
+    }
+
+    markDirty();
+}
+
+/*!
+    Records that the frame delivered at \a presentationTimestamp, as returned
+    by timestamp(), was handed to the scene graph.
+*/
+void QDeclarativeVideoOutputStatistics::frameRendered(qint64 presentationTimestamp)
+{
+    const qint64 latency = qMax(Q_INT64_C(0), timestamp() - presentationTimestamp);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_framesRendered;
+        m_totalLatency += latency;
+        m_maximumLatency = qMax(m_maximumLatency, latency);
+    }
+
+    markDirty();
+}
+
+/*!
+    Records that uploading a frame to textures took \a uploadTime microseconds.
+*/
+void QDeclarativeVideoOutputStatistics::frameUploaded(qint64 uploadTime)
+{
+    int bucket = 0;
+    while (uploadTime > uploadTimeBucketLimits[bucket])
+        ++bucket;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_uploads;
+        m_totalUploadTime += uploadTime;
+        m_maximumUploadTime = qMax(m_maximumUploadTime, uploadTime);
+        ++m_uploadTimeHistogram[bucket];
+    }
+
+    markDirty();
+}
+
+void QDeclarativeVideoOutputStatistics::markDirty()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_dirty)
+            return;
+        m_dirty = true;
+    }
+
+    // Only the first change after a notification has to reach the GUI
+    // thread, the others are folded into the pending update.
+    QMetaObject::invokeMethod(this, "_q_scheduleUpdate", Qt::QueuedConnection);
+}
+
+void QDeclarativeVideoOutputStatistics::_q_scheduleUpdate()
+{
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start();
+}
+
+void QDeclarativeVideoOutputStatistics::_q_update()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_dirty = false;
+    }
+
+    emit changed();
+}
+
+QT_END_NAMESPACE
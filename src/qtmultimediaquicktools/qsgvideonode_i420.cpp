@@ -39,6 +39,9 @@
 **
 ****************************************************************************/
 #include "qsgvideonode_i420.h"
+#include "qsgvideotextureuploader.h"
+#include <private/qdeclarativevideooutputstatistics_p.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qmutex.h>
 #include <QtQuick/qsgtexturematerial.h>
 #include <QtQuick/qsgmaterial.h>
@@ -148,7 +151,7 @@ protected:
 class QSGVideoMaterial_YUV420 : public QSGMaterial
 {
 public:
-    QSGVideoMaterial_YUV420(const QVideoSurfaceFormat &format);
+    QSGVideoMaterial_YUV420(const QVideoSurfaceFormat &format, QSGVideoNode *node);
     ~QSGVideoMaterial_YUV420();
 
     virtual QSGMaterialType *type() const {
@@ -162,13 +165,13 @@ public:
 
     virtual int compare(const QSGMaterial *other) const {
         const QSGVideoMaterial_YUV420 *m = static_cast<const QSGVideoMaterial_YUV420 *>(other);
-        int d = m_textureIds[0] - m->m_textureIds[0];
+        int d = m_textures[0].textureId() - m->m_textures[0].textureId();
         if (d)
             return d;
-        else if ((d = m_textureIds[1] - m->m_textureIds[1]) != 0)
+        else if ((d = m_textures[1].textureId() - m->m_textures[1].textureId()) != 0)
             return d;
         else
-            return m_textureIds[2] - m->m_textureIds[2];
+            return m_textures[2].textureId() - m->m_textures[2].textureId();
     }
 
     void updateBlending() {
@@ -181,13 +184,13 @@ public:
     }
 
     void bind();
-    void bindTexture(int id, int w, int h, const uchar *bits);
+    void uploadPlane(QSGVideoTextureUploader *texture, int plane, int height);
 
     QVideoSurfaceFormat m_format;
-    QSize m_textureSize;
+    QSGVideoNode *m_node;
 
     static const uint Num_Texture_IDs = 3;
-    GLuint m_textureIds[Num_Texture_IDs];
+    QSGVideoTextureUploader m_textures[Num_Texture_IDs];
 
     qreal m_opacity;
     GLfloat m_yWidth;
@@ -198,14 +201,13 @@ public:
     QMutex m_frameMutex;
 };
 
-QSGVideoMaterial_YUV420::QSGVideoMaterial_YUV420(const QVideoSurfaceFormat &format) :
+QSGVideoMaterial_YUV420::QSGVideoMaterial_YUV420(const QVideoSurfaceFormat &format, QSGVideoNode *node) :
     m_format(format),
+    m_node(node),
     m_opacity(1.0),
     m_yWidth(1.0),
     m_uvWidth(1.0)
 {
-    memset(m_textureIds, 0, sizeof(m_textureIds));
-
     switch (format.yCbCrColorSpace()) {
     case QVideoSurfaceFormat::YCbCr_JPEG:
         m_colorMatrix = QMatrix4x4(
@@ -235,8 +237,6 @@ QSGVideoMaterial_YUV420::QSGVideoMaterial_YUV420(const QVideoSurfaceFormat &form
 
 QSGVideoMaterial_YUV420::~QSGVideoMaterial_YUV420()
 {
-    if (!m_textureSize.isEmpty())
-        glDeleteTextures(Num_Texture_IDs, m_textureIds);
 }
 
 void QSGVideoMaterial_YUV420::bind()
@@ -246,76 +246,61 @@ void QSGVideoMaterial_YUV420::bind()
     QMutexLocker lock(&m_frameMutex);
     if (m_frame.isValid()) {
         if (m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
+            QElapsedTimer uploadTimer;
+            uploadTimer.start();
+
             int fw = m_frame.width();
             int fh = m_frame.height();
 
-            // Frame has changed size, recreate textures...
-            if (m_textureSize != m_frame.size()) {
-                if (!m_textureSize.isEmpty())
-                    glDeleteTextures(Num_Texture_IDs, m_textureIds);
-                glGenTextures(Num_Texture_IDs, m_textureIds);
-                m_textureSize = m_frame.size();
-            }
-
-            const uchar *bits = m_frame.bits();
-            int yStride = m_frame.bytesPerLine();
-            // The UV stride is usually half the Y stride and is 32-bit aligned.
-            // However it's not always the case, at least on Windows where the
-            // UV planes are sometimes not aligned.
-            // We calculate the stride using the UV byte count to always
-            // have a correct stride.
-            int uvStride = (m_frame.mappedBytes() - yStride * fh) / fh;
-            int offsetU = yStride * fh;
-            int offsetV = yStride * fh + uvStride * fh / 2;
-
-            m_yWidth = qreal(fw) / yStride;
-            m_uvWidth = qreal(fw) /  (2 * uvStride);
-
-            if (m_frame.pixelFormat() == QVideoFrame::Format_YV12)
-                qSwap(offsetU, offsetV);
+            const int y = 0;
+            const int u = m_frame.pixelFormat() == QVideoFrame::Format_YUV420P ? 1 : 2;
+            const int v = m_frame.pixelFormat() == QVideoFrame::Format_YUV420P ? 2 : 1;
+
+            m_yWidth = qreal(fw) / m_frame.bytesPerLine(y);
+            m_uvWidth = qreal(fw) / (2 * m_frame.bytesPerLine(u));
 
             GLint previousAlignment;
             glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
             glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
             functions->glActiveTexture(GL_TEXTURE1);
-            bindTexture(m_textureIds[1], uvStride, fh / 2, bits + offsetU);
+            uploadPlane(&m_textures[1], u, fh / 2);
             functions->glActiveTexture(GL_TEXTURE2);
-            bindTexture(m_textureIds[2], uvStride, fh / 2, bits + offsetV);
+            uploadPlane(&m_textures[2], v, fh / 2);
             functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
-            bindTexture(m_textureIds[0], yStride, fh, bits);
+            uploadPlane(&m_textures[0], y, fh);
 
             glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
 
             m_frame.unmap();
+
+            if (QDeclarativeVideoOutputStatistics *statistics = m_node->statistics())
+                statistics->frameUploaded(uploadTimer.nsecsElapsed() / 1000);
         }
 
         m_frame = QVideoFrame();
     } else {
         functions->glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, m_textureIds[1]);
+        m_textures[1].bind();
         functions->glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, m_textureIds[2]);
+        m_textures[2].bind();
         functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
-        glBindTexture(GL_TEXTURE_2D, m_textureIds[0]);
+        m_textures[0].bind();
     }
 }
 
-void QSGVideoMaterial_YUV420::bindTexture(int id, int w, int h, const uchar *bits)
+void QSGVideoMaterial_YUV420::uploadPlane(QSGVideoTextureUploader *texture, int plane, int height)
 {
-    glBindTexture(GL_TEXTURE_2D, id);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, w, h, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, bits);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    const int bytesPerLine = m_frame.bytesPerLine(plane);
+    texture->upload(GL_LUMINANCE, GL_UNSIGNED_BYTE, bytesPerLine, height, bytesPerLine,
+                    m_frame.bits(plane));
 }
 
 QSGVideoNode_I420::QSGVideoNode_I420(const QVideoSurfaceFormat &format) :
     m_format(format)
 {
     setFlag(QSGNode::OwnsMaterial);
-    m_material = new QSGVideoMaterial_YUV420(format);
+    m_material = new QSGVideoMaterial_YUV420(format, this);
     setMaterial(m_material);
 }
 
@@ -60,8 +60,6 @@ public:
     void setCurrentFrame(const QVideoFrame &frame);
 
 private:
-    void bindTexture(int id, int unit, int w, int h, const uchar *bits);
-
     QVideoSurfaceFormat m_format;
     QSGVideoMaterial_YUV420 *m_material;
 };
@@ -0,0 +1,364 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgvideonode_nv12.h"
+#include "qsgvideotextureuploader.h"
+#include <private/qdeclarativevideooutputstatistics_p.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtQuick/qsgmaterial.h>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOpenGLShaderProgram>
+
+QT_BEGIN_NAMESPACE
+
+QList<QVideoFrame::PixelFormat> QSGVideoNodeFactory_NV12::supportedPixelFormats(
+                                        QAbstractVideoBuffer::HandleType handleType) const
+{
+    QList<QVideoFrame::PixelFormat> formats;
+
+    if (handleType == QAbstractVideoBuffer::NoHandle)
+        formats << QVideoFrame::Format_NV12 << QVideoFrame::Format_NV21;
+
+    return formats;
+}
+
+QSGVideoNode *QSGVideoNodeFactory_NV12::createNode(const QVideoSurfaceFormat &format)
+{
+    if (supportedPixelFormats(format.handleType()).contains(format.pixelFormat()))
+        return new QSGVideoNode_NV12(format);
+
+    return 0;
+}
+
+
+class QSGVideoMaterialShader_NV12 : public QSGMaterialShader
+{
+public:
+    QSGVideoMaterialShader_NV12(QVideoFrame::PixelFormat pixelFormat)
+        : QSGMaterialShader(),
+          m_id_matrix(-1),
+          m_id_yWidth(-1),
+          m_id_uvWidth(-1),
+          m_id_yTexture(-1),
+          m_id_uvTexture(-1),
+          m_id_colorMatrix(-1),
+          m_id_opacity(-1),
+          m_pixelFormat(pixelFormat)
+    {
+    }
+
+    void updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial);
+
+    virtual char const *const *attributeNames() const {
+        static const char *names[] = {
+            "qt_VertexPosition",
+            "qt_VertexTexCoord",
+            0
+        };
+        return names;
+    }
+
+protected:
+
+    virtual const char *vertexShader() const {
+        const char *shader =
+        "uniform highp mat4 qt_Matrix;                      \n"
+        "uniform highp float yWidth;                        \n"
+        "uniform highp float uvWidth;                       \n"
+        "attribute highp vec4 qt_VertexPosition;            \n"
+        "attribute highp vec2 qt_VertexTexCoord;            \n"
+        "varying highp vec2 yTexCoord;                      \n"
+        "varying highp vec2 uvTexCoord;                     \n"
+        "void main() {                                      \n"
+        "    yTexCoord   = qt_VertexTexCoord * vec2(yWidth, 1);\n"
+        "    uvTexCoord  = qt_VertexTexCoord * vec2(uvWidth, 1);\n"
+        "    gl_Position = qt_Matrix * qt_VertexPosition;   \n"
+        "}";
+        return shader;
+    }
+
+    // The interleaved chroma plane is uploaded as a luminance/alpha texture,
+    // so the first byte of each pair ends up in .r and the second in .a.
+    virtual const char *fragmentShader() const {
+        static const char *nv12Shader =
+        "uniform sampler2D yTexture;"
+        "uniform sampler2D uvTexture;"
+        "uniform mediump mat4 colorMatrix;"
+        "uniform lowp float opacity;"
+        ""
+        "varying highp vec2 yTexCoord;"
+        "varying highp vec2 uvTexCoord;"
+        ""
+        "void main()"
+        "{"
+        "    mediump float Y = texture2D(yTexture, yTexCoord).r;"
+        "    mediump vec4 UV = texture2D(uvTexture, uvTexCoord);"
+        "    mediump vec4 color = vec4(Y, UV.r, UV.a, 1.);"
+        "    gl_FragColor = colorMatrix * color * opacity;"
+        "}";
+
+        static const char *nv21Shader =
+        "uniform sampler2D yTexture;"
+        "uniform sampler2D uvTexture;"
+        "uniform mediump mat4 colorMatrix;"
+        "uniform lowp float opacity;"
+        ""
+        "varying highp vec2 yTexCoord;"
+        "varying highp vec2 uvTexCoord;"
+        ""
+        "void main()"
+        "{"
+        "    mediump float Y = texture2D(yTexture, yTexCoord).r;"
+        "    mediump vec4 UV = texture2D(uvTexture, uvTexCoord);"
+        "    mediump vec4 color = vec4(Y, UV.a, UV.r, 1.);"
+        "    gl_FragColor = colorMatrix * color * opacity;"
+        "}";
+
+        return m_pixelFormat == QVideoFrame::Format_NV21 ? nv21Shader : nv12Shader;
+    }
+
+    virtual void initialize() {
+        m_id_matrix = program()->uniformLocation("qt_Matrix");
+        m_id_yWidth = program()->uniformLocation("yWidth");
+        m_id_uvWidth = program()->uniformLocation("uvWidth");
+        m_id_yTexture = program()->uniformLocation("yTexture");
+        m_id_uvTexture = program()->uniformLocation("uvTexture");
+        m_id_colorMatrix = program()->uniformLocation("colorMatrix");
+        m_id_opacity = program()->uniformLocation("opacity");
+    }
+
+    int m_id_matrix;
+    int m_id_yWidth;
+    int m_id_uvWidth;
+    int m_id_yTexture;
+    int m_id_uvTexture;
+    int m_id_colorMatrix;
+    int m_id_opacity;
+    QVideoFrame::PixelFormat m_pixelFormat;
+};
+
+
+class QSGVideoMaterial_NV12 : public QSGMaterial
+{
+public:
+    QSGVideoMaterial_NV12(const QVideoSurfaceFormat &format, QSGVideoNode *node);
+    ~QSGVideoMaterial_NV12();
+
+    virtual QSGMaterialType *type() const {
+        // The two formats use different shaders and so need different types.
+        static QSGMaterialType nv12Type;
+        static QSGMaterialType nv21Type;
+        return m_format.pixelFormat() == QVideoFrame::Format_NV21 ? &nv21Type : &nv12Type;
+    }
+
+    virtual QSGMaterialShader *createShader() const {
+        return new QSGVideoMaterialShader_NV12(m_format.pixelFormat());
+    }
+
+    virtual int compare(const QSGMaterial *other) const {
+        const QSGVideoMaterial_NV12 *m = static_cast<const QSGVideoMaterial_NV12 *>(other);
+        int d = m_textures[0].textureId() - m->m_textures[0].textureId();
+        if (d)
+            return d;
+        else
+            return m_textures[1].textureId() - m->m_textures[1].textureId();
+    }
+
+    void updateBlending() {
+        setFlag(Blending, qFuzzyCompare(m_opacity, qreal(1.0)) ? false : true);
+    }
+
+    void setCurrentFrame(const QVideoFrame &frame) {
+        QMutexLocker lock(&m_frameMutex);
+        m_frame = frame;
+    }
+
+    void bind();
+
+    QVideoSurfaceFormat m_format;
+    QSGVideoNode *m_node;
+
+    static const uint Num_Texture_IDs = 2;
+    QSGVideoTextureUploader m_textures[Num_Texture_IDs];
+
+    qreal m_opacity;
+    GLfloat m_yWidth;
+    GLfloat m_uvWidth;
+    QMatrix4x4 m_colorMatrix;
+
+    QVideoFrame m_frame;
+    QMutex m_frameMutex;
+};
+
+QSGVideoMaterial_NV12::QSGVideoMaterial_NV12(const QVideoSurfaceFormat &format, QSGVideoNode *node) :
+    m_format(format),
+    m_node(node),
+    m_opacity(1.0),
+    m_yWidth(1.0),
+    m_uvWidth(1.0)
+{
+    switch (format.yCbCrColorSpace()) {
+    case QVideoSurfaceFormat::YCbCr_JPEG:
+        m_colorMatrix = QMatrix4x4(
+                    1.0f,  0.000f,  1.402f, -0.701f,
+                    1.0f, -0.344f, -0.714f,  0.529f,
+                    1.0f,  1.772f,  0.000f, -0.886f,
+                    0.0f,  0.000f,  0.000f,  1.0000f);
+        break;
+    case QVideoSurfaceFormat::YCbCr_BT709:
+    case QVideoSurfaceFormat::YCbCr_xvYCC709:
+        m_colorMatrix = QMatrix4x4(
+                    1.164f,  0.000f,  1.793f, -0.5727f,
+                    1.164f, -0.534f, -0.213f,  0.3007f,
+                    1.164f,  2.115f,  0.000f, -1.1302f,
+                    0.0f,    0.000f,  0.000f,  1.0000f);
+        break;
+    default: //BT 601:
+        m_colorMatrix = QMatrix4x4(
+                    1.164f,  0.000f,  1.596f, -0.8708f,
+                    1.164f, -0.392f, -0.813f,  0.5296f,
+                    1.164f,  2.017f,  0.000f, -1.081f,
+                    0.0f,    0.000f,  0.000f,  1.0000f);
+    }
+
+    setFlag(Blending, false);
+}
+
+QSGVideoMaterial_NV12::~QSGVideoMaterial_NV12()
+{
+}
+
+void QSGVideoMaterial_NV12::bind()
+{
+    QOpenGLFunctions *functions = QOpenGLContext::currentContext()->functions();
+
+    QMutexLocker lock(&m_frameMutex);
+    if (m_frame.isValid()) {
+        if (m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
+            QElapsedTimer uploadTimer;
+            uploadTimer.start();
+
+            if (m_frame.planeCount() == 2) {
+                const int fw = m_frame.width();
+                const int fh = m_frame.height();
+                const int yStride = m_frame.bytesPerLine(0);
+                const int uvStride = m_frame.bytesPerLine(1);
+
+                m_yWidth = qreal(fw) / yStride;
+                // Each texel of the chroma texture holds a U and a V sample.
+                m_uvWidth = qreal(fw) / uvStride;
+
+                GLint previousAlignment;
+                glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+                functions->glActiveTexture(GL_TEXTURE1);
+                m_textures[1].upload(GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, uvStride / 2, fh / 2,
+                                     uvStride, m_frame.bits(1));
+                functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
+                m_textures[0].upload(GL_LUMINANCE, GL_UNSIGNED_BYTE, yStride, fh,
+                                     yStride, m_frame.bits(0));
+
+                glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+            }
+
+            m_frame.unmap();
+
+            if (QDeclarativeVideoOutputStatistics *statistics = m_node->statistics())
+                statistics->frameUploaded(uploadTimer.nsecsElapsed() / 1000);
+        }
+
+        m_frame = QVideoFrame();
+    } else {
+        functions->glActiveTexture(GL_TEXTURE1);
+        m_textures[1].bind();
+        functions->glActiveTexture(GL_TEXTURE0); // Finish with 0 as default texture unit
+        m_textures[0].bind();
+    }
+}
+
+QSGVideoNode_NV12::QSGVideoNode_NV12(const QVideoSurfaceFormat &format) :
+    m_format(format)
+{
+    setFlag(QSGNode::OwnsMaterial);
+    m_material = new QSGVideoMaterial_NV12(format, this);
+    setMaterial(m_material);
+}
+
+QSGVideoNode_NV12::~QSGVideoNode_NV12()
+{
+}
+
+void QSGVideoNode_NV12::setCurrentFrame(const QVideoFrame &frame)
+{
+    m_material->setCurrentFrame(frame);
+    markDirty(DirtyMaterial);
+}
+
+
+void QSGVideoMaterialShader_NV12::updateState(const RenderState &state,
+                                              QSGMaterial *newMaterial,
+                                              QSGMaterial *oldMaterial)
+{
+    Q_UNUSED(oldMaterial);
+
+    QSGVideoMaterial_NV12 *mat = static_cast<QSGVideoMaterial_NV12 *>(newMaterial);
+    program()->setUniformValue(m_id_yTexture, 0);
+    program()->setUniformValue(m_id_uvTexture, 1);
+
+    mat->bind();
+
+    program()->setUniformValue(m_id_colorMatrix, mat->m_colorMatrix);
+    program()->setUniformValue(m_id_yWidth, mat->m_yWidth);
+    program()->setUniformValue(m_id_uvWidth, mat->m_uvWidth);
+    if (state.isOpacityDirty()) {
+        mat->m_opacity = state.opacity();
+        mat->updateBlending();
+        program()->setUniformValue(m_id_opacity, GLfloat(mat->m_opacity));
+    }
+
+    if (state.isMatrixDirty())
+        program()->setUniformValue(m_id_matrix, state.combinedMatrix());
+}
+
+QT_END_NAMESPACE
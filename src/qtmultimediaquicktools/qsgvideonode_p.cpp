@@ -45,6 +45,7 @@ QT_BEGIN_NAMESPACE
 
 QSGVideoNode::QSGVideoNode()
     : m_orientation(-1)
+    , m_statistics(0)
 {
     setFlag(QSGNode::OwnsGeometry);
 }
@@ -39,6 +39,9 @@
 **
 ****************************************************************************/
 #include "qsgvideonode_rgb.h"
+#include "qsgvideotextureuploader.h"
+#include <private/qdeclarativevideooutputstatistics_p.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtQuick/qsgtexturematerial.h>
 #include <QtQuick/qsgmaterial.h>
 #include <QtCore/qmutex.h>
@@ -164,9 +167,9 @@ protected:
 class QSGVideoMaterial_RGB : public QSGMaterial
 {
 public:
-    QSGVideoMaterial_RGB(const QVideoSurfaceFormat &format) :
+    QSGVideoMaterial_RGB(const QVideoSurfaceFormat &format, QSGVideoNode *node) :
         m_format(format),
-        m_textureId(0),
+        m_node(node),
         m_opacity(1.0),
         m_width(1.0)
     {
@@ -175,8 +178,6 @@ public:
 
     ~QSGVideoMaterial_RGB()
     {
-        if (m_textureId)
-            glDeleteTextures(1, &m_textureId);
     }
 
     virtual QSGMaterialType *type() const {
@@ -190,7 +191,7 @@ public:
 
     virtual int compare(const QSGMaterial *other) const {
         const QSGVideoMaterial_RGB *m = static_cast<const QSGVideoMaterial_RGB *>(other);
-        return m_textureId - m->m_textureId;
+        return m_texture.textureId() - m->m_texture.textureId();
     }
 
     void updateBlending() {
@@ -209,7 +210,8 @@ public:
         QMutexLocker lock(&m_frameMutex);
         if (m_frame.isValid()) {
             if (m_frame.map(QAbstractVideoBuffer::ReadOnly)) {
-                QSize textureSize = m_frame.size();
+                QElapsedTimer uploadTimer;
+                uploadTimer.start();
 
                 int stride = m_frame.bytesPerLine();
                 switch (m_frame.pixelFormat()) {
@@ -221,17 +223,9 @@ public:
                 }
 
                 m_width = qreal(m_frame.width()) / stride;
-                textureSize.setWidth(stride);
 
-                if (m_textureSize != textureSize) {
-                    if (!m_textureSize.isEmpty())
-                        glDeleteTextures(1, &m_textureId);
-                    glGenTextures(1, &m_textureId);
-                    m_textureSize = textureSize;
-                }
-
-                GLint dataType = GL_UNSIGNED_BYTE;
-                GLint dataFormat = GL_RGBA;
+                GLenum dataType = GL_UNSIGNED_BYTE;
+                GLenum dataFormat = GL_RGBA;
 
                 if (m_frame.pixelFormat() == QVideoFrame::Format_RGB565) {
                     dataType = GL_UNSIGNED_SHORT_5_6_5;
@@ -243,32 +237,28 @@ public:
                 glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
                 functions->glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, m_textureId);
-                glTexImage2D(GL_TEXTURE_2D, 0, dataFormat,
-                             m_textureSize.width(), m_textureSize.height(),
-                             0, dataFormat, dataType, m_frame.bits());
+                m_texture.upload(dataFormat, dataType, stride, m_frame.height(),
+                                 m_frame.bytesPerLine(), m_frame.bits());
 
                 glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
 
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
                 m_frame.unmap();
+
+                if (QDeclarativeVideoOutputStatistics *statistics = m_node->statistics())
+                    statistics->frameUploaded(uploadTimer.nsecsElapsed() / 1000);
             }
             m_frame = QVideoFrame();
         } else {
             functions->glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, m_textureId);
+            m_texture.bind();
         }
     }
 
     QVideoFrame m_frame;
     QMutex m_frameMutex;
-    QSize m_textureSize;
     QVideoSurfaceFormat m_format;
-    GLuint m_textureId;
+    QSGVideoNode *m_node;
+    QSGVideoTextureUploader m_texture;
     qreal m_opacity;
     GLfloat m_width;
 };
@@ -278,7 +268,7 @@ QSGVideoNode_RGB::QSGVideoNode_RGB(const QVideoSurfaceFormat &format) :
     m_format(format)
 {
     setFlag(QSGNode::OwnsMaterial);
-    m_material = new QSGVideoMaterial_RGB(format);
+    m_material = new QSGVideoMaterial_RGB(format, this);
     setMaterial(m_material);
 }
 
@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgvideotextureuploader.h"
+#include <QtGui/QOpenGLBuffer>
+#include <QtGui/QOpenGLContext>
+#include <QtMultimedia/private/qmultimediaenvironment_p.h>
+
+QT_BEGIN_NAMESPACE
+
+static bool usePixelBufferObjects()
+{
+    return qt_multimedia_envFlag("QT_QUICK_VIDEO_PBO", true);
+}
+
+QSGVideoTextureUploader::QSGVideoTextureUploader()
+    : m_textureId(0)
+    , m_format(0)
+    , m_type(0)
+    , m_nextBuffer(0)
+    , m_usePixelBuffers(-1)
+{
+    memset(m_buffers, 0, sizeof(m_buffers));
+}
+
+QSGVideoTextureUploader::~QSGVideoTextureUploader()
+{
+    releaseBuffers();
+    if (m_textureId)
+        glDeleteTextures(1, &m_textureId);
+}
+
+bool QSGVideoTextureUploader::pixelBufferObjectsEnabled()
+{
+    if (!usePixelBufferObjects())
+        return false;
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context)
+        return false;
+
+    const QSurfaceFormat format = context->format();
+    if (context->isOpenGLES()) {
+        // Streaming through buffers is a loss on several mobile drivers that
+        // copy the buffer on the CPU anyway, so ES only uses them on request.
+        if (!qEnvironmentVariableIsSet("QT_QUICK_VIDEO_PBO"))
+            return false;
+        return format.majorVersion() >= 3 || context->hasExtension("GL_NV_pixel_buffer_object");
+    }
+
+    return format.version() >= qMakePair(2, 1) || context->hasExtension("GL_ARB_pixel_buffer_object");
+}
+
+void QSGVideoTextureUploader::upload(GLenum format, GLenum type, int width, int height,
+                                     int bytesPerLine, const uchar *bits)
+{
+    if (!m_textureId)
+        glGenTextures(1, &m_textureId);
+
+    glBindTexture(GL_TEXTURE_2D, m_textureId);
+
+    const QSize size(width, height);
+    if (m_size != size || m_format != format || m_type != type) {
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, type, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        m_size = size;
+        m_format = format;
+        m_type = type;
+
+        // The buffers were sized for the old frames.
+        releaseBuffers();
+    }
+
+    if (m_usePixelBuffers < 0)
+        m_usePixelBuffers = pixelBufferObjectsEnabled() ? 1 : 0;
+
+    if (m_usePixelBuffers) {
+        QOpenGLBuffer *&buffer = m_buffers[m_nextBuffer];
+        m_nextBuffer = (m_nextBuffer + 1) % RingSize;
+
+        if (!buffer) {
+            buffer = new QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer);
+            buffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+            if (!buffer->create()) {
+                qWarning("Failed to create a pixel buffer object, uploading video frames directly");
+                delete buffer;
+                buffer = 0;
+                m_usePixelBuffers = 0;
+            }
+        }
+
+        if (buffer && buffer->bind()) {
+            // Respecifying the whole buffer lets the driver hand out fresh storage
+            // instead of waiting for the transfer of a frame still in flight;
+            // the texture is then sourced from the buffer asynchronously.
+            buffer->allocate(bits, bytesPerLine * height);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, 0);
+            buffer->release();
+            return;
+        }
+    }
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, bits);
+}
+
+void QSGVideoTextureUploader::bind()
+{
+    glBindTexture(GL_TEXTURE_2D, m_textureId);
+}
+
+void QSGVideoTextureUploader::releaseBuffers()
+{
+    for (int i = 0; i < RingSize; ++i) {
+        delete m_buffers[i];
+        m_buffers[i] = 0;
+    }
+    m_nextBuffer = 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGVIDEOTEXTUREUPLOADER_H
+#define QSGVIDEOTEXTUREUPLOADER_H
+
+#include <QtCore/qsize.h>
+#include <QtGui/qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLBuffer;
+
+// Owns one texture of a video material and streams frame data into it.
+// Storage is only (re)allocated when the size or format changes, every
+// other frame is written with glTexSubImage2D.  Where pixel buffer objects
+// are used (desktop GL by default, see QT_QUICK_VIDEO_PBO) the frame is
+// first copied into the next buffer of a small ring, so the transfer to the
+// texture overlaps with drawing the previous frame instead of stalling the
+// render thread.
+class QSGVideoTextureUploader
+{
+public:
+    QSGVideoTextureUploader();
+    ~QSGVideoTextureUploader();
+
+    GLuint textureId() const { return m_textureId; }
+    QSize size() const { return m_size; }
+
+    // Must be called with the texture unit to upload into already active.
+    void upload(GLenum format, GLenum type, int width, int height, int bytesPerLine, const uchar *bits);
+    void bind();
+
+    static bool pixelBufferObjectsEnabled();
+
+private:
+    void releaseBuffers();
+
+    enum { RingSize = 2 };
+
+    GLuint m_textureId;
+    QSize m_size;
+    GLenum m_format;
+    GLenum m_type;
+    QOpenGLBuffer *m_buffers[RingSize];
+    int m_nextBuffer;
+    int m_usePixelBuffers;
+
+    Q_DISABLE_COPY(QSGVideoTextureUploader)
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGVIDEOTEXTUREUPLOADER_H
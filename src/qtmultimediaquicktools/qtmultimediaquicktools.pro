@@ -13,6 +13,7 @@ INCLUDEPATH += ../multimedia/qtmultimediaquicktools_headers/
 PRIVATE_HEADERS += \
     ../multimedia/qtmultimediaquicktools_headers/qdeclarativevideooutput_p.h \
     ../multimedia/qtmultimediaquicktools_headers/qdeclarativevideooutput_backend_p.h \
+    ../multimedia/qtmultimediaquicktools_headers/qdeclarativevideooutputstatistics_p.h \
     ../multimedia/qtmultimediaquicktools_headers/qsgvideonode_p.h \
     ../multimedia/qtmultimediaquicktools_headers/qtmultimediaquickdefs_p.h
 
@@ -21,14 +22,19 @@ SOURCES += \
     qdeclarativevideooutput.cpp \
     qdeclarativevideooutput_render.cpp \
     qdeclarativevideooutput_window.cpp \
+    qdeclarativevideooutputstatistics.cpp \
     qsgvideonode_i420.cpp \
+    qsgvideonode_nv12.cpp \
     qsgvideonode_rgb.cpp \
-    qsgvideonode_texture.cpp
+    qsgvideonode_texture.cpp \
+    qsgvideotextureuploader.cpp
 
 HEADERS += \
     $$PRIVATE_HEADERS \
     qdeclarativevideooutput_render_p.h \
     qdeclarativevideooutput_window_p.h \
     qsgvideonode_i420.h \
+    qsgvideonode_nv12.h \
     qsgvideonode_rgb.h \
-    qsgvideonode_texture.h
+    qsgvideonode_texture.h \
+    qsgvideotextureuploader.h
@@ -13,7 +13,14 @@ SUBDIRS += \
 qtHaveModule(quick) {
     SUBDIRS += \
         qdeclarativevideooutput \
-        qdeclarativevideooutput_window
+        qdeclarativevideooutput_window \
+        qsgvideonode
+}
+
+unix:!mac:contains(QT_CONFIG, pulseaudio) {
+    SUBDIRS += \
+        qpulseaudio \
+        qsoundeffect_samplecache
 }
 
 !qtHaveModule(widgets): SUBDIRS -= qcamerabackend
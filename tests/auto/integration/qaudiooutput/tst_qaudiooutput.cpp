@@ -87,6 +87,10 @@ private slots:
     void bufferSize_data();
     void bufferSize();
 
+    void latencyTarget();
+
+    void renderCallback();
+
     void notifyInterval_data();
     void notifyInterval();
 
@@ -379,6 +383,84 @@ void tst_QAudioOutput::bufferSize()
              QString("bufferSize: requested=%1, actual=%2").arg(bufferSize).arg(audioOutput.bufferSize()).toLocal8Bit().constData());
 }
 
+void tst_QAudioOutput::latencyTarget()
+{
+    QAudioOutput audioOutput(audioDevice.preferredFormat(), this);
+    QCOMPARE(audioOutput.latencyTarget(), qint64(0));
+
+    audioOutput.setLatencyTarget(20000);
+    QVERIFY2((audioOutput.error() == QAudio::NoError), "error() is not QAudio::NoError after setLatencyTarget");
+    if (audioOutput.latencyTarget() == 0)
+        QSKIP("Latency target is not supported by this backend");
+    QCOMPARE(audioOutput.latencyTarget(), qint64(20000));
+
+    audioOutput.setLatencyTarget(-1);
+    QCOMPARE(audioOutput.latencyTarget(), qint64(0));
+
+    if (audioFiles.isEmpty())
+        return;
+
+    // Play a file with a short latency target, it must still play to the end
+    QAudioOutput lowLatencyOutput(testFormats.at(0), this);
+    lowLatencyOutput.setLatencyTarget(20000);
+    lowLatencyOutput.setVolume(0.1f);
+
+    QFile *audioFile = audioFiles.at(0).data();
+    audioFile->close();
+    audioFile->open(QIODevice::ReadOnly);
+    audioFile->seek(WavHeader::headerLength());
+
+    lowLatencyOutput.start(audioFile);
+    QTRY_VERIFY2((lowLatencyOutput.state() == QAudio::ActiveState), "didn't transition to ActiveState after start()");
+    QVERIFY(lowLatencyOutput.periodSize() > 0);
+
+    QTest::qWait(3000); // 3 seconds should be plenty
+
+    QVERIFY2(audioFile->atEnd(), "didn't play to EOF");
+    QVERIFY2((lowLatencyOutput.processedUSecs() == 2000000),
+             QString("processedUSecs() doesn't equal file duration in us (%1)").arg(lowLatencyOutput.processedUSecs()).toLocal8Bit().constData());
+
+    lowLatencyOutput.stop();
+    audioFile->close();
+}
+
+struct RenderState
+{
+    int bytesPerFrame;
+    QAtomicInt frames;
+};
+
+static void silenceRenderCallback(char *data, int frameCount, void *userData)
+{
+    RenderState *state = static_cast<RenderState *>(userData);
+    memset(data, 0, frameCount * state->bytesPerFrame);
+    state->frames.fetchAndAddOrdered(frameCount);
+}
+
+void tst_QAudioOutput::renderCallback()
+{
+    QAudioOutput audioOutput(audioDevice.preferredFormat(), this);
+    QVERIFY(!audioOutput.start(QAudio::RenderCallback(0), 0));
+
+    RenderState state;
+    state.bytesPerFrame = audioOutput.format().bytesPerFrame();
+    state.frames.store(0);
+    if (!audioOutput.start(silenceRenderCallback, &state))
+        QSKIP("Render callbacks are not supported by this backend");
+
+    QTRY_VERIFY2((state.frames.load() > 0), "render callback was never called");
+    QVERIFY(audioOutput.state() == QAudio::ActiveState);
+    QTRY_VERIFY(audioOutput.processedUSecs() > 0);
+
+    audioOutput.stop();
+    QVERIFY(audioOutput.state() == QAudio::StoppedState);
+
+    // Nothing may call back once stop() has returned
+    const int stoppedAt = state.frames.load();
+    QTest::qWait(100);
+    QCOMPARE(state.frames.load(), stoppedAt);
+}
+
 void tst_QAudioOutput::notifyInterval_data()
 {
     QTest::addColumn<int>("interval");
@@ -1,6 +1,6 @@
 TARGET = tst_qdeclarativevideooutput
 
-QT += multimedia-private qml testlib quick
+QT += multimedia-private qtmultimediaquicktools-private qml testlib quick
 CONFIG += testcase
 
 SOURCES += \
@@ -47,6 +47,7 @@
 #include <QtQml/qqmlcomponent.h>
 
 #include "private/qdeclarativevideooutput_p.h"
+#include "private/qdeclarativevideooutputstatistics_p.h"
 
 #include <qabstractvideosurface.h>
 #include <qvideorenderercontrol.h>
@@ -122,6 +123,8 @@ private slots:
     void orientation();
     void surfaceSource();
     void sourceRect();
+    void statistics();
+    void statisticsRecording();
 
     void contentRect();
     void contentRect_data();
@@ -411,6 +414,73 @@ void tst_QDeclarativeVideoOutput::sourceRect()
     delete videoOutput;
 }
 
+void tst_QDeclarativeVideoOutput::statistics()
+{
+    QQmlComponent component(&m_engine);
+    component.setData(m_plainQML, QUrl());
+
+    QObject *videoOutput = component.create();
+    QVERIFY(videoOutput != 0);
+
+    QDeclarativeVideoOutputStatistics *statistics =
+            qobject_cast<QDeclarativeVideoOutput *>(videoOutput)->statistics();
+    QVERIFY(statistics != 0);
+    QCOMPARE(statistics->framesPresented(), 0);
+    QCOMPARE(statistics->framesDropped(), 0);
+
+    SurfaceHolder holder(this);
+    videoOutput->setProperty("source", QVariant::fromValue(static_cast<QObject*>(&holder)));
+
+    // Nothing renders the item, so the second frame replaces the first one.
+    holder.presentDummyFrame(QSize(200, 100));
+    holder.presentDummyFrame(QSize(200, 100));
+
+    QCOMPARE(statistics->framesPresented(), 2);
+    QCOMPARE(statistics->framesDropped(), 1);
+    QCOMPARE(statistics->framesRendered(), 0);
+
+    statistics->reset();
+    QCOMPARE(statistics->framesPresented(), 0);
+    QCOMPARE(statistics->framesDropped(), 0);
+
+    delete videoOutput;
+}
+
+void tst_QDeclarativeVideoOutput::statisticsRecording()
+{
+    QDeclarativeVideoOutputStatistics statistics;
+    statistics.setUpdateInterval(0);
+
+    QSignalSpy spy(&statistics, SIGNAL(changed()));
+
+    statistics.frameUploaded(300);
+    statistics.frameUploaded(1700);
+    statistics.frameUploaded(100000);
+
+    QCOMPARE(statistics.averageUploadTime(), qreal(34));
+    QCOMPARE(statistics.maximumUploadTime(), qreal(100));
+
+    QList<int> histogram = statistics.uploadTimeHistogram();
+    QCOMPARE(histogram.count(), int(QDeclarativeVideoOutputStatistics::HistogramBuckets));
+    QCOMPARE(histogram.at(0), 1);
+    QCOMPARE(histogram.at(2), 1);
+    QCOMPARE(histogram.last(), 1);
+
+    statistics.frameRendered(statistics.timestamp());
+    QCOMPARE(statistics.framesRendered(), 1);
+    QVERIFY(statistics.maximumLatency() >= 0);
+
+    // Changes are folded into a single notification.
+    QTRY_COMPARE(spy.count(), 1);
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 1);
+
+    statistics.reset();
+    QCOMPARE(statistics.uploadTimeHistogram().at(0), 0);
+    QCOMPARE(statistics.averageUploadTime(), qreal(0));
+    QTRY_COMPARE(spy.count(), 2);
+}
+
 void tst_QDeclarativeVideoOutput::mappingPoint()
 {
     QFETCH(QPointF, point);
@@ -0,0 +1,28 @@
+TARGET = tst_qpulseaudio
+
+QT += core multimedia-private testlib
+
+# Talks to the PulseAudio server of the session, more of a system test
+CONFIG += testcase link_pkgconfig
+PKGCONFIG += libpulse
+
+# The streams are internal to the plugin, so build them into the test.
+PULSE_PLUGIN = ../../../../src/plugins/pulseaudio
+INCLUDEPATH += $$PULSE_PLUGIN
+
+HEADERS += \
+        $$PULSE_PLUGIN/qaudiodeviceinfo_pulse.h \
+        $$PULSE_PLUGIN/qaudiooutput_pulse.h \
+        $$PULSE_PLUGIN/qaudioinput_pulse.h \
+        $$PULSE_PLUGIN/qpulseaudioengine.h \
+        $$PULSE_PLUGIN/qpulsehelpers.h
+
+SOURCES += \
+        tst_qpulseaudio.cpp \
+        $$PULSE_PLUGIN/qaudiodeviceinfo_pulse.cpp \
+        $$PULSE_PLUGIN/qaudiooutput_pulse.cpp \
+        $$PULSE_PLUGIN/qaudioinput_pulse.cpp \
+        $$PULSE_PLUGIN/qpulseaudioengine.cpp \
+        $$PULSE_PLUGIN/qpulsehelpers.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,287 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/plugins/pulseaudio
+
+#include <QtTest/QtTest>
+#include <QtCore/qbuffer.h>
+
+#include "qaudiooutput_pulse.h"
+#include "qaudioinput_pulse.h"
+#include "qpulseaudioengine.h"
+
+// Covers how the PulseAudio streams move between states while the server
+// sets them up asynchronously: prepared streams, failures reported after
+// open() has returned, and suspending before the stream is ready.
+class tst_QPulseAudio : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void outputPrepareStaysStopped();
+    void outputPrepareThenStart();
+    void outputPrepareThenStop();
+    void outputSuspendWhileConnecting();
+    void outputAsyncOpenFailure();
+    void outputPreparedOpenFailure();
+
+    void inputPrepareStaysStopped();
+    void inputPrepareThenStart();
+    void inputAsyncOpenFailure();
+
+private:
+    QAudioFormat m_format;
+    QByteArray m_sink;
+    QByteArray m_source;
+};
+
+static const char NoSuchDevice[] = "qt-tst-qpulseaudio-no-such-device";
+
+void tst_QPulseAudio::initTestCase()
+{
+    qRegisterMetaType<QAudio::State>();
+
+    QPulseAudioEngine *engine = QPulseAudioEngine::instance();
+    if (!engine->context() || pa_context_get_state(engine->context()) != PA_CONTEXT_READY)
+        QSKIP("No PulseAudio server available");
+
+    m_sink = engine->m_defaultSink;
+    m_source = engine->m_defaultSource;
+
+    m_format.setSampleRate(44100);
+    m_format.setChannelCount(2);
+    m_format.setSampleSize(16);
+    m_format.setSampleType(QAudioFormat::SignedInt);
+    m_format.setByteOrder(QAudioFormat::LittleEndian);
+    m_format.setCodec(QLatin1String("audio/pcm"));
+}
+
+void tst_QPulseAudio::outputPrepareStaysStopped()
+{
+    QPulseAudioOutput output(m_sink);
+    output.setFormat(m_format);
+    QSignalSpy stateSpy(&output, SIGNAL(stateChanged(QAudio::State)));
+
+    output.prepare();
+    QTest::qWait(200);
+
+    QCOMPARE(output.state(), QAudio::StoppedState);
+    QCOMPARE(output.error(), QAudio::NoError);
+    QCOMPARE(output.bytesFree(), 0);
+    QCOMPARE(stateSpy.count(), 0);
+}
+
+void tst_QPulseAudio::outputPrepareThenStart()
+{
+    QPulseAudioOutput output(m_sink);
+    output.setFormat(m_format);
+    QSignalSpy stateSpy(&output, SIGNAL(stateChanged(QAudio::State)));
+
+    output.prepare();
+    QTest::qWait(200);
+
+    // A quarter of a second of silence
+    QByteArray silence(m_format.bytesForDuration(250000), 0);
+    QBuffer buffer(&silence);
+    buffer.open(QIODevice::ReadOnly);
+
+    output.start(&buffer);
+    QCOMPARE(output.state(), QAudio::ActiveState);
+    QCOMPARE(stateSpy.count(), 1);
+
+    // Runs dry once everything has been played
+    QTRY_COMPARE_WITH_TIMEOUT(output.state(), QAudio::IdleState, 5000);
+    QCOMPARE(output.error(), QAudio::UnderrunError);
+    QVERIFY(buffer.atEnd());
+
+    output.stop();
+    QCOMPARE(output.state(), QAudio::StoppedState);
+}
+
+void tst_QPulseAudio::outputPrepareThenStop()
+{
+    QPulseAudioOutput output(m_sink);
+    output.setFormat(m_format);
+    QSignalSpy stateSpy(&output, SIGNAL(stateChanged(QAudio::State)));
+
+    output.prepare();
+    output.stop();
+    QTest::qWait(200);
+
+    QCOMPARE(output.state(), QAudio::StoppedState);
+    QCOMPARE(output.error(), QAudio::NoError);
+    QCOMPARE(stateSpy.count(), 0);
+
+    // Can be prepared again and started normally afterwards
+    output.prepare();
+    QIODevice *device = output.start();
+    QVERIFY(device);
+    QCOMPARE(output.state(), QAudio::IdleState);
+    output.stop();
+}
+
+void tst_QPulseAudio::outputSuspendWhileConnecting()
+{
+    QPulseAudioOutput output(m_sink);
+    output.setFormat(m_format);
+
+    QIODevice *device = output.start();
+    QVERIFY(device);
+    output.suspend();
+    QCOMPARE(output.state(), QAudio::SuspendedState);
+
+    // The stream becoming ready must not resume it
+    QTest::qWait(300);
+    QCOMPARE(output.state(), QAudio::SuspendedState);
+    QCOMPARE(output.error(), QAudio::NoError);
+
+    output.resume();
+    QVERIFY(output.state() != QAudio::SuspendedState);
+
+    const QByteArray silence(m_format.bytesForDuration(20000), 0);
+    QTRY_VERIFY(output.bytesFree() > 0);
+    QVERIFY(device->write(silence) > 0);
+    QCOMPARE(output.state(), QAudio::ActiveState);
+
+    output.stop();
+}
+
+void tst_QPulseAudio::outputAsyncOpenFailure()
+{
+    QPulseAudioOutput output(NoSuchDevice);
+    output.setFormat(m_format);
+    QSignalSpy stateSpy(&output, SIGNAL(stateChanged(QAudio::State)));
+
+    // Connecting to the server doesn't block, so start() succeeds first...
+    QIODevice *device = output.start();
+    QVERIFY(device);
+    QCOMPARE(output.state(), QAudio::IdleState);
+
+    // ...and the server's answer stops the output again
+    QTRY_COMPARE(output.state(), QAudio::StoppedState);
+    QCOMPARE(output.error(), QAudio::OpenError);
+    QCOMPARE(stateSpy.count(), 2);
+    QCOMPARE(qvariant_cast<QAudio::State>(stateSpy.last().at(0)), QAudio::StoppedState);
+
+    // Writes in the meantime don't go anywhere
+    QCOMPARE(output.bytesFree(), 0);
+}
+
+void tst_QPulseAudio::outputPreparedOpenFailure()
+{
+    QPulseAudioOutput output(NoSuchDevice);
+    output.setFormat(m_format);
+    QSignalSpy stateSpy(&output, SIGNAL(stateChanged(QAudio::State)));
+
+    output.prepare();
+    QTRY_COMPARE(output.error(), QAudio::OpenError);
+    QCOMPARE(output.state(), QAudio::StoppedState);
+    QCOMPARE(stateSpy.count(), 0);
+
+    // start() tries again rather than using the failed stream
+    QVERIFY(output.start());
+    QCOMPARE(output.error(), QAudio::NoError);
+    QTRY_COMPARE(output.error(), QAudio::OpenError);
+    QCOMPARE(output.state(), QAudio::StoppedState);
+}
+
+void tst_QPulseAudio::inputPrepareStaysStopped()
+{
+    QPulseAudioInput input(m_source);
+    input.setFormat(m_format);
+    QSignalSpy stateSpy(&input, SIGNAL(stateChanged(QAudio::State)));
+
+    input.prepare();
+    QTest::qWait(200);
+
+    QCOMPARE(input.state(), QAudio::StoppedState);
+    QCOMPARE(input.error(), QAudio::NoError);
+    QCOMPARE(input.processedUSecs(), qint64(0));
+    QCOMPARE(stateSpy.count(), 0);
+
+    input.stop();
+    QCOMPARE(stateSpy.count(), 0);
+}
+
+void tst_QPulseAudio::inputPrepareThenStart()
+{
+    QPulseAudioInput input(m_source);
+    input.setFormat(m_format);
+
+    input.prepare();
+    QTest::qWait(200);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    input.start(&buffer);
+    QCOMPARE(input.state(), QAudio::ActiveState);
+
+    QTRY_VERIFY_WITH_TIMEOUT(buffer.size() > 0, 5000);
+    QCOMPARE(input.error(), QAudio::NoError);
+
+    input.stop();
+    QCOMPARE(input.state(), QAudio::StoppedState);
+}
+
+void tst_QPulseAudio::inputAsyncOpenFailure()
+{
+    QPulseAudioInput input(NoSuchDevice);
+    input.setFormat(m_format);
+    QSignalSpy stateSpy(&input, SIGNAL(stateChanged(QAudio::State)));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    input.start(&buffer);
+    QCOMPARE(input.state(), QAudio::ActiveState);
+
+    QTRY_COMPARE(input.state(), QAudio::StoppedState);
+    QCOMPARE(input.error(), QAudio::OpenError);
+    QCOMPARE(stateSpy.count(), 2);
+    QCOMPARE(buffer.size(), qint64(0));
+}
+
+QTEST_MAIN(tst_QPulseAudio)
+
+#include "tst_qpulseaudio.moc"
@@ -0,0 +1,19 @@
+TARGET = tst_qsgvideonode
+
+QT += multimedia-private qtmultimediaquicktools-private testlib quick
+CONFIG += testcase
+
+# The NV12 node and the texture uploader are internal to the module, so
+# build them into the test.
+INCLUDEPATH += ../../../../src/qtmultimediaquicktools
+
+SOURCES += \
+        tst_qsgvideonode.cpp \
+        ../../../../src/qtmultimediaquicktools/qsgvideonode_nv12.cpp \
+        ../../../../src/qtmultimediaquicktools/qsgvideotextureuploader.cpp
+
+HEADERS += \
+        ../../../../src/qtmultimediaquicktools/qsgvideonode_nv12.h \
+        ../../../../src/qtmultimediaquicktools/qsgvideotextureuploader.h
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,306 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/qtmultimediaquicktools
+
+#include <QtTest/QtTest>
+
+#include <QtGui/qoffscreensurface.h>
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglfunctions.h>
+#include <QtQuick/qquickitem.h>
+#include <QtQuick/qquickwindow.h>
+
+#include <qvideoframe.h>
+#include <qvideosurfaceformat.h>
+
+#include "qsgvideonode_nv12.h"
+#include "qsgvideotextureuploader.h"
+
+QT_USE_NAMESPACE
+
+// Fills the whole item with one NV12 or NV21 frame.
+class NV12Item : public QQuickItem
+{
+public:
+    NV12Item(const QVideoFrame &frame)
+        : m_frame(frame)
+    {
+        setFlag(ItemHasContents, true);
+    }
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+    {
+        QSGVideoNode *node = static_cast<QSGVideoNode *>(oldNode);
+        if (!node) {
+            QSGVideoNodeFactory_NV12 factory;
+            node = factory.createNode(QVideoSurfaceFormat(m_frame.size(), m_frame.pixelFormat()));
+        }
+        node->setTexturedRectGeometry(boundingRect(), QRectF(0, 0, 1, 1), 0);
+        node->setCurrentFrame(m_frame);
+        return node;
+    }
+
+private:
+    QVideoFrame m_frame;
+};
+
+class tst_QSGVideoNode : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void uploaderReusesTexture();
+    void uploaderContents();
+    void uploaderResize();
+
+    void nv12SupportedFormats();
+    void nv12CreateNode();
+    void nv12Render_data();
+    void nv12Render();
+
+private:
+    QByteArray readTexture(const QSGVideoTextureUploader &uploader);
+
+    QOffscreenSurface *m_surface;
+    QOpenGLContext *m_context;
+};
+
+static QByteArray rgbaPattern(int width, int height, int seed)
+{
+    QByteArray data(width * height * 4, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char((i * 7 + seed) & 0xff);
+    return data;
+}
+
+// An NV12 frame with the same Y sample everywhere and the chroma pairs
+// (first, second) interleaved in the second plane.
+static QVideoFrame nv12Frame(QVideoFrame::PixelFormat pixelFormat, int width, int height,
+                             uchar y, uchar first, uchar second)
+{
+    QVideoFrame frame(width * height * 3 / 2, QSize(width, height), width, pixelFormat);
+    frame.map(QAbstractVideoBuffer::WriteOnly);
+    memset(frame.bits(0), y, width * height);
+    uchar *uv = frame.bits(1);
+    for (int i = 0; i < width * height / 2; i += 2) {
+        uv[i] = first;
+        uv[i + 1] = second;
+    }
+    frame.unmap();
+    return frame;
+}
+
+void tst_QSGVideoNode::initTestCase()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+
+    m_context = new QOpenGLContext;
+    if (!m_context->create() || !m_context->makeCurrent(m_surface))
+        QSKIP("No OpenGL context available");
+}
+
+void tst_QSGVideoNode::cleanupTestCase()
+{
+    if (m_context)
+        m_context->doneCurrent();
+    delete m_context;
+    delete m_surface;
+}
+
+QByteArray tst_QSGVideoNode::readTexture(const QSGVideoTextureUploader &uploader)
+{
+    QOpenGLFunctions *functions = m_context->functions();
+
+    GLuint fbo = 0;
+    functions->glGenFramebuffers(1, &fbo);
+    functions->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    functions->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                                      uploader.textureId(), 0);
+
+    QByteArray data(uploader.size().width() * uploader.size().height() * 4, Qt::Uninitialized);
+    if (functions->glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) {
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, uploader.size().width(), uploader.size().height(),
+                     GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+    } else {
+        data.clear();
+    }
+
+    functions->glBindFramebuffer(GL_FRAMEBUFFER, m_context->defaultFramebufferObject());
+    functions->glDeleteFramebuffers(1, &fbo);
+    return data;
+}
+
+void tst_QSGVideoNode::uploaderReusesTexture()
+{
+    QSGVideoTextureUploader uploader;
+    QCOMPARE(uploader.textureId(), GLuint(0));
+
+    const QByteArray data = rgbaPattern(16, 8, 0);
+    uploader.upload(GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, 16 * 4, reinterpret_cast<const uchar *>(data.constData()));
+    const GLuint id = uploader.textureId();
+    QVERIFY(id != 0);
+    QCOMPARE(uploader.size(), QSize(16, 8));
+
+    uploader.upload(GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, 16 * 4, reinterpret_cast<const uchar *>(data.constData()));
+    QCOMPARE(uploader.textureId(), id);
+    QCOMPARE(glGetError(), GLenum(GL_NO_ERROR));
+}
+
+void tst_QSGVideoNode::uploaderContents()
+{
+    QSGVideoTextureUploader uploader;
+
+    // More frames than the buffer ring holds, so every slot is reused.
+    for (int seed = 0; seed < 5; ++seed) {
+        const QByteArray data = rgbaPattern(16, 8, seed);
+        uploader.upload(GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, 16 * 4,
+                        reinterpret_cast<const uchar *>(data.constData()));
+
+        const QByteArray contents = readTexture(uploader);
+        if (contents.isEmpty())
+            QSKIP("RGBA textures cannot be read back through a framebuffer object");
+        QCOMPARE(contents, data);
+    }
+}
+
+void tst_QSGVideoNode::uploaderResize()
+{
+    QSGVideoTextureUploader uploader;
+
+    QByteArray data = rgbaPattern(16, 8, 1);
+    uploader.upload(GL_RGBA, GL_UNSIGNED_BYTE, 16, 8, 16 * 4, reinterpret_cast<const uchar *>(data.constData()));
+
+    data = rgbaPattern(8, 4, 2);
+    uploader.upload(GL_RGBA, GL_UNSIGNED_BYTE, 8, 4, 8 * 4, reinterpret_cast<const uchar *>(data.constData()));
+    QCOMPARE(uploader.size(), QSize(8, 4));
+
+    const QByteArray contents = readTexture(uploader);
+    if (contents.isEmpty())
+        QSKIP("RGBA textures cannot be read back through a framebuffer object");
+    QCOMPARE(contents, data);
+}
+
+void tst_QSGVideoNode::nv12SupportedFormats()
+{
+    QSGVideoNodeFactory_NV12 factory;
+
+    const QList<QVideoFrame::PixelFormat> formats = factory.supportedPixelFormats(QAbstractVideoBuffer::NoHandle);
+    QCOMPARE(formats.count(), 2);
+    QVERIFY(formats.contains(QVideoFrame::Format_NV12));
+    QVERIFY(formats.contains(QVideoFrame::Format_NV21));
+
+    QVERIFY(factory.supportedPixelFormats(QAbstractVideoBuffer::GLTextureHandle).isEmpty());
+}
+
+void tst_QSGVideoNode::nv12CreateNode()
+{
+    QSGVideoNodeFactory_NV12 factory;
+
+    QScopedPointer<QSGVideoNode> nv12(factory.createNode(QVideoSurfaceFormat(QSize(64, 64), QVideoFrame::Format_NV12)));
+    QVERIFY(nv12);
+    QCOMPARE(nv12->pixelFormat(), QVideoFrame::Format_NV12);
+
+    QScopedPointer<QSGVideoNode> nv21(factory.createNode(QVideoSurfaceFormat(QSize(64, 64), QVideoFrame::Format_NV21)));
+    QVERIFY(nv21);
+    QCOMPARE(nv21->pixelFormat(), QVideoFrame::Format_NV21);
+
+    // The two layouts need different shaders.
+    QVERIFY(nv12->material()->type() != nv21->material()->type());
+
+    QVERIFY(!factory.createNode(QVideoSurfaceFormat(QSize(64, 64), QVideoFrame::Format_YUV420P)));
+    QVERIFY(!factory.createNode(QVideoSurfaceFormat(QSize(64, 64), QVideoFrame::Format_NV12,
+                                                    QAbstractVideoBuffer::GLTextureHandle)));
+}
+
+void tst_QSGVideoNode::nv12Render_data()
+{
+    QTest::addColumn<int>("pixelFormat");
+    QTest::addColumn<bool>("blue");
+
+    // The chroma pair (255, 128) is strong blue read as CbCr and strong
+    // red read as CrCb.
+    QTest::newRow("nv12") << int(QVideoFrame::Format_NV12) << true;
+    QTest::newRow("nv21") << int(QVideoFrame::Format_NV21) << false;
+}
+
+void tst_QSGVideoNode::nv12Render()
+{
+    QFETCH(int, pixelFormat);
+    QFETCH(bool, blue);
+
+    m_context->doneCurrent();
+
+    QQuickWindow window;
+    window.resize(64, 64);
+    NV12Item *item = new NV12Item(nv12Frame(QVideoFrame::PixelFormat(pixelFormat), 64, 64, 128, 255, 128));
+    item->setParentItem(window.contentItem());
+    item->setSize(QSizeF(64, 64));
+
+    window.show();
+    if (!QTest::qWaitForWindowExposed(&window)) {
+        m_context->makeCurrent(m_surface);
+        QSKIP("Window was not exposed");
+    }
+
+    const QImage image = window.grabWindow();
+    m_context->makeCurrent(m_surface);
+    QVERIFY(!image.isNull());
+
+    const QRgb pixel = image.pixel(32, 32);
+    if (blue) {
+        QVERIFY(qBlue(pixel) > 240);
+        QVERIFY(qRed(pixel) < 160);
+    } else {
+        QVERIFY(qRed(pixel) > 240);
+        QVERIFY(qBlue(pixel) < 160);
+    }
+}
+
+QTEST_MAIN(tst_QSGVideoNode)
+
+#include "tst_qsgvideonode.moc"
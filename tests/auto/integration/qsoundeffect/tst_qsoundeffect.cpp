@@ -98,6 +98,11 @@ void tst_QSoundEffect::cleanup()
 
 void tst_QSoundEffect::initTestCase()
 {
+#ifdef TEST_PULSEAUDIO_SAMPLE_CACHE
+    // Has to be set before the first sound effect reads it
+    qputenv("QT_PULSEAUDIO_SAMPLE_CACHE", "1");
+#endif
+
     // Only perform tests if audio device exists
     QStringList mimeTypes = sound->supportedMimeTypes();
     if (mimeTypes.empty())
@@ -0,0 +1,16 @@
+TARGET = tst_qsoundeffect_samplecache
+
+QT += core multimedia-private testlib
+
+# The qsoundeffect tests again, with the pulseaudio backend playing from
+# the server's sample cache
+CONFIG += testcase
+
+DEFINES += TEST_PULSEAUDIO_SAMPLE_CACHE
+
+SOURCES += ../qsoundeffect/tst_qsoundeffect.cpp
+
+TESTDATA += ../qsoundeffect/test.wav ../qsoundeffect/test_tone.wav ../qsoundeffect/test_corrupted.wav
+
+linux-*:CONFIG += insignificant_test # QTBUG-26748
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
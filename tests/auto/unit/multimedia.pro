@@ -28,10 +28,17 @@ SUBDIRS += \
     qradiotuner \
     qvideoencodersettingscontrol \
     qvideoframe \
+    qvideoframepool \
     qvideosurfaceformat \
     qwavedecoder \
+    qaudiohelpers \
+    qaudioclock \
+    qgstreamerprobequeue \
+    qsoundeffectmixer \
     qaudiobuffer \
     qaudiodecoder \
     qaudioprobe \
     qvideoprobe \
     qsamplecache
+
+config_gstreamer: SUBDIRS += qvideosurfacegstsink
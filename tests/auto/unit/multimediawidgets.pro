@@ -11,6 +11,7 @@ contains (QT_CONFIG, private_tests) {
   SUBDIRS += \
     qgraphicsvideoitem \
     qpaintervideosurface \
-    qvideowidget
+    qvideowidget \
+    qvideoyuvconverter
 }
 
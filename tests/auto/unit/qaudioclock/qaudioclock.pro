@@ -0,0 +1,8 @@
+CONFIG += no_private_qt_headers_warning testcase
+TARGET = tst_qaudioclock
+
+QT += core multimedia-private testlib
+
+SOURCES += tst_qaudioclock.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <private/qaudioclock_p.h>
+
+static const int SampleRate = 48000;
+static const qint64 PeriodUSecs = 10000;
+
+class tst_QAudioClock : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void monotonicFromRealtime();
+    void notEnoughSamples();
+    void invalidSamples();
+    void drift_data();
+    void drift();
+    void discontinuity();
+    void reset();
+
+private:
+    void feed(QAudioClockDriftEstimator &estimator, qreal ratio, int periods);
+
+    qint64 m_systemTime;
+    qint64 m_framePosition;
+};
+
+// Feeds one timestamp per period from a device running at ratio times its
+// nominal rate, with a few hundred microseconds of scheduling jitter
+void tst_QAudioClock::feed(QAudioClockDriftEstimator &estimator, qreal ratio, int periods)
+{
+    const qint64 startTime = m_systemTime;
+    const qint64 startPosition = m_framePosition;
+
+    for (int i = 0; i < periods; ++i) {
+        m_systemTime = startTime + i * PeriodUSecs;
+        m_framePosition = startPosition + qint64(i * PeriodUSecs * SampleRate * ratio / 1000000);
+
+        QAudio::Timestamp timestamp;
+        timestamp.framePosition = m_framePosition;
+        timestamp.systemTime = m_systemTime + (i * 7919) % 201 - 100;
+        estimator.addSample(timestamp);
+    }
+}
+
+void tst_QAudioClock::monotonicFromRealtime()
+{
+    const qint64 now = QAudioClockInternal::monotonicTime();
+    const qint64 mapped = QAudioClockInternal::monotonicFromRealtime(QDateTime::currentMSecsSinceEpoch() * 1000);
+
+    QVERIFY(qAbs(mapped - now) < 100000);
+    QVERIFY(QAudioClockInternal::monotonicTime() >= now);
+}
+
+void tst_QAudioClock::notEnoughSamples()
+{
+    QAudioClockDriftEstimator estimator;
+    estimator.reset(SampleRate);
+    QCOMPARE(estimator.drift(), qreal(1.0));
+
+    // Less than a second of a fast device tells nothing yet
+    m_systemTime = 1000000;
+    m_framePosition = 0;
+    feed(estimator, 1.001, 50);
+    QVERIFY(estimator.sampleCount() > 0);
+    QCOMPARE(estimator.drift(), qreal(1.0));
+}
+
+void tst_QAudioClock::invalidSamples()
+{
+    QAudioClockDriftEstimator estimator;
+
+    // Without a sample rate nothing is collected
+    QAudio::Timestamp timestamp;
+    timestamp.framePosition = 0;
+    timestamp.systemTime = 0;
+    estimator.addSample(timestamp);
+    QCOMPARE(estimator.sampleCount(), 0);
+
+    estimator.reset(SampleRate);
+    estimator.addSample(QAudio::Timestamp());
+    QCOMPARE(estimator.sampleCount(), 0);
+
+    estimator.addSample(timestamp);
+    estimator.addSample(timestamp);
+    QCOMPARE(estimator.sampleCount(), 1);
+}
+
+void tst_QAudioClock::drift_data()
+{
+    QTest::addColumn<qreal>("ratio");
+
+    QTest::newRow("exact") << qreal(1.0);
+    QTest::newRow("100 ppm fast") << qreal(1.0001);
+    QTest::newRow("500 ppm slow") << qreal(0.9995);
+}
+
+void tst_QAudioClock::drift()
+{
+    QFETCH(qreal, ratio);
+
+    QAudioClockDriftEstimator estimator;
+    estimator.reset(SampleRate);
+
+    m_systemTime = 5000000;
+    m_framePosition = 0;
+    feed(estimator, ratio, 800);
+
+    QVERIFY2(qAbs(estimator.drift() - ratio) < 1e-5,
+             QByteArray::number(estimator.drift(), 'f', 7).constData());
+}
+
+void tst_QAudioClock::discontinuity()
+{
+    QAudioClockDriftEstimator estimator;
+    estimator.reset(SampleRate);
+
+    m_systemTime = 5000000;
+    m_framePosition = 0;
+    feed(estimator, 1.0, 300);
+
+    // Half a second without the position moving, as after an underrun;
+    // only what comes after it may count
+    m_systemTime += 500000;
+    feed(estimator, 1.0005, 300);
+
+    QVERIFY2(qAbs(estimator.drift() - 1.0005) < 1e-5,
+             QByteArray::number(estimator.drift(), 'f', 7).constData());
+}
+
+void tst_QAudioClock::reset()
+{
+    QAudioClockDriftEstimator estimator;
+    estimator.reset(SampleRate);
+
+    m_systemTime = 5000000;
+    m_framePosition = 0;
+    feed(estimator, 1.0005, 300);
+    QVERIFY(estimator.drift() > 1.0);
+
+    estimator.reset(SampleRate);
+    QCOMPARE(estimator.sampleCount(), 0);
+    QCOMPARE(estimator.drift(), qreal(1.0));
+}
+
+QTEST_MAIN(tst_QAudioClock)
+
+#include "tst_qaudioclock.moc"
@@ -0,0 +1,10 @@
+CONFIG += no_private_qt_headers_warning testcase
+TARGET = tst_qaudiohelpers
+
+QT += core multimedia-private testlib
+
+SOURCES += tst_qaudiohelpers.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
+
+include (../qmultimedia_common/pcmformat.pri)
@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <private/qaudiohelpers_p.h>
+#include "pcmformat.h"
+
+class tst_QAudioHelpers : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void multiplySamples_data();
+    void multiplySamples();
+    void multiplySamplesInPlace_data();
+    void multiplySamplesInPlace();
+    void saturation();
+    void silence();
+
+private:
+    void addFormatRows();
+};
+
+Q_DECLARE_METATYPE(QAudioFormat::SampleType)
+
+static QByteArray makeSamples(const QAudioFormat &format, int count)
+{
+    QByteArray data(count * format.sampleSize() / 8, Qt::Uninitialized);
+    if (format.sampleType() == QAudioFormat::Float) {
+        float *p = reinterpret_cast<float *>(data.data());
+        for (int i = 0; i < count; ++i)
+            p[i] = float(qrand() % 20001 - 10000) / 10000.0f;
+    } else {
+        for (int i = 0; i < data.size(); ++i)
+            data[i] = char(qrand());
+    }
+    return data;
+}
+
+// The vectorized kernels compute in single precision, so they may differ
+// from the reference implementation by one step of truncation.
+static bool fuzzyCompareSamples(const QAudioFormat &format, const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    const int count = a.size() / (format.sampleSize() / 8);
+    for (int i = 0; i < count; ++i) {
+        qreal x = 0;
+        qreal y = 0;
+        switch (format.sampleSize()) {
+        case 8:
+            x = format.sampleType() == QAudioFormat::SignedInt ? qreal(((const qint8 *)a.constData())[i])
+                                                               : qreal(((const quint8 *)a.constData())[i]);
+            y = format.sampleType() == QAudioFormat::SignedInt ? qreal(((const qint8 *)b.constData())[i])
+                                                               : qreal(((const quint8 *)b.constData())[i]);
+            break;
+        case 16:
+            x = format.sampleType() == QAudioFormat::SignedInt ? qreal(((const qint16 *)a.constData())[i])
+                                                               : qreal(((const quint16 *)a.constData())[i]);
+            y = format.sampleType() == QAudioFormat::SignedInt ? qreal(((const qint16 *)b.constData())[i])
+                                                               : qreal(((const quint16 *)b.constData())[i]);
+            break;
+        default:
+            if (format.sampleType() == QAudioFormat::Float) {
+                x = ((const float *)a.constData())[i];
+                y = ((const float *)b.constData())[i];
+                if (!qFuzzyCompare(1.0f + float(x), 1.0f + float(y)))
+                    return false;
+                continue;
+            }
+            x = format.sampleType() == QAudioFormat::SignedInt ? qreal(((const qint32 *)a.constData())[i])
+                                                               : qreal(((const quint32 *)a.constData())[i]);
+            y = format.sampleType() == QAudioFormat::SignedInt ? qreal(((const qint32 *)b.constData())[i])
+                                                               : qreal(((const quint32 *)b.constData())[i]);
+            break;
+        }
+        if (qAbs(x - y) > 1.0)
+            return false;
+    }
+    return true;
+}
+
+void tst_QAudioHelpers::addFormatRows()
+{
+    QTest::addColumn<int>("sampleSize");
+    QTest::addColumn<QAudioFormat::SampleType>("sampleType");
+    QTest::addColumn<qreal>("factor");
+
+    const qreal factors[] = { 0.0, 0.25, 0.5, 0.77, 1.0, 1.5, 4.0 };
+    for (size_t i = 0; i < sizeof(factors) / sizeof(factors[0]); ++i) {
+        const qreal f = factors[i];
+        QTest::newRow(qPrintable(QString("s8 %1").arg(f))) << 8 << QAudioFormat::SignedInt << f;
+        QTest::newRow(qPrintable(QString("u8 %1").arg(f))) << 8 << QAudioFormat::UnSignedInt << f;
+        QTest::newRow(qPrintable(QString("s16 %1").arg(f))) << 16 << QAudioFormat::SignedInt << f;
+        QTest::newRow(qPrintable(QString("u16 %1").arg(f))) << 16 << QAudioFormat::UnSignedInt << f;
+        QTest::newRow(qPrintable(QString("s32 %1").arg(f))) << 32 << QAudioFormat::SignedInt << f;
+        QTest::newRow(qPrintable(QString("u32 %1").arg(f))) << 32 << QAudioFormat::UnSignedInt << f;
+        QTest::newRow(qPrintable(QString("float %1").arg(f))) << 32 << QAudioFormat::Float << f;
+    }
+}
+
+void tst_QAudioHelpers::multiplySamples_data()
+{
+    addFormatRows();
+}
+
+void tst_QAudioHelpers::multiplySamples()
+{
+    QFETCH(int, sampleSize);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(qreal, factor);
+
+    const QAudioFormat format = pcmFormat(44100, sampleSize, sampleType);
+    // odd count so the scalar tail of the kernels is exercised too
+    const QByteArray source = makeSamples(format, 1027);
+
+    QByteArray expected(source.size(), 0);
+    QAudioHelperInternal::qMultiplySamplesGeneric(factor, format, source.constData(), expected.data(), source.size());
+
+    QByteArray result(source.size(), 0);
+    QAudioHelperInternal::qMultiplySamples(factor, format, source.constData(), result.data(), source.size());
+
+    QVERIFY(fuzzyCompareSamples(format, expected, result));
+}
+
+void tst_QAudioHelpers::multiplySamplesInPlace_data()
+{
+    addFormatRows();
+}
+
+void tst_QAudioHelpers::multiplySamplesInPlace()
+{
+    QFETCH(int, sampleSize);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(qreal, factor);
+
+    const QAudioFormat format = pcmFormat(44100, sampleSize, sampleType);
+    const QByteArray source = makeSamples(format, 515);
+
+    QByteArray expected(source.size(), 0);
+    QAudioHelperInternal::qMultiplySamples(factor, format, source.constData(), expected.data(), source.size());
+
+    QByteArray result = source;
+    QAudioHelperInternal::qMultiplySamples(factor, format, result.constData(), result.data(), result.size());
+
+    QCOMPARE(result, expected);
+}
+
+void tst_QAudioHelpers::saturation()
+{
+    const QAudioFormat format = pcmFormat(44100, 16, QAudioFormat::SignedInt);
+
+    qint16 source[19];
+    for (int i = 0; i < 19; ++i)
+        source[i] = (i % 2) ? 30000 : -30000;
+
+    qint16 result[19];
+    QAudioHelperInternal::qMultiplySamples(2.0, format, source, result, sizeof(source));
+    for (int i = 0; i < 19; ++i)
+        QCOMPARE(result[i], qint16((i % 2) ? 32767 : -32768));
+
+    const QAudioFormat unsignedFormat = pcmFormat(44100, 8, QAudioFormat::UnSignedInt);
+    quint8 unsignedSource[37];
+    for (int i = 0; i < 37; ++i)
+        unsignedSource[i] = (i % 2) ? 250 : 5;
+
+    quint8 unsignedResult[37];
+    QAudioHelperInternal::qMultiplySamples(3.0, unsignedFormat, unsignedSource, unsignedResult, sizeof(unsignedSource));
+    for (int i = 0; i < 37; ++i)
+        QCOMPARE(unsignedResult[i], quint8((i % 2) ? 255 : 0));
+}
+
+void tst_QAudioHelpers::silence()
+{
+    const QAudioFormat format = pcmFormat(44100, 16, QAudioFormat::UnSignedInt);
+
+    quint16 samples[10];
+    for (int i = 0; i < 10; ++i)
+        samples[i] = quint16(i * 1000);
+
+    QAudioHelperInternal::qMultiplySamples(0.0, format, samples, samples, sizeof(samples));
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(samples[i], quint16(0x8000));
+}
+
+QTEST_MAIN(tst_QAudioHelpers)
+
+#include "tst_qaudiohelpers.moc"
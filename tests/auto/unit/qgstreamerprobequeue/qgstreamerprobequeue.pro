@@ -0,0 +1,20 @@
+CONFIG += no_private_qt_headers_warning testcase
+TARGET = tst_qgstreamerprobequeue
+
+QT += core multimedia-private testlib
+
+SOURCES += tst_qgstreamerprobequeue.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
+
+# The probe controls around the queue need GStreamer
+config_gstreamer {
+    DEFINES += HAVE_GSTREAMER
+    LIBS += -lqgsttools_p
+    CONFIG += link_pkgconfig
+    PKGCONFIG += \
+        gstreamer-0.10 \
+        gstreamer-base-0.10 \
+        gstreamer-audio-0.10 \
+        gstreamer-video-0.10
+}
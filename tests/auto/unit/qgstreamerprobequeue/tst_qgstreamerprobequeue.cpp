@@ -0,0 +1,258 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <QtCore/qthread.h>
+#include <private/qgstreamerprobequeue_p.h>
+#ifdef HAVE_GSTREAMER
+#include <private/qgstreameraudioprobecontrol_p.h>
+#endif
+
+typedef QGstreamerProbeQueue<int> IntQueue;
+
+class tst_QGstreamerProbeQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void wakeup();
+    void dropOldest();
+    void dropNewest();
+    void unbounded();
+    void blockTimeout();
+    void blockUntilDrained();
+    void setSettingsClears();
+#ifdef HAVE_GSTREAMER
+    void audioProbeDroppedCount();
+#endif
+};
+
+// Drains the queue from another thread after a delay, like the probe
+// control does from its own thread
+class DelayedConsumer : public QThread
+{
+public:
+    DelayedConsumer(IntQueue *queue, int delay) : m_queue(queue), m_delay(delay) {}
+
+    QVector<int> items;
+
+protected:
+    void run()
+    {
+        msleep(m_delay);
+        m_queue->takeAll(&items);
+    }
+
+private:
+    IntQueue *m_queue;
+    int m_delay;
+};
+
+static QVector<int> takeAll(IntQueue &queue)
+{
+    QVector<int> items;
+    queue.takeAll(&items);
+    return items;
+}
+
+void tst_QGstreamerProbeQueue::initTestCase()
+{
+#ifdef HAVE_GSTREAMER
+    gst_init(NULL, NULL);
+#endif
+}
+
+void tst_QGstreamerProbeQueue::wakeup()
+{
+    IntQueue queue(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::DropOldest, 4));
+
+    // Only the first item after a drain asks for the consumer
+    QVERIFY(queue.enqueue(1));
+    QVERIFY(!queue.enqueue(2));
+    QVERIFY(!queue.enqueue(3));
+    QCOMPARE(takeAll(queue), QVector<int>() << 1 << 2 << 3);
+
+    QVERIFY(queue.enqueue(4));
+    QCOMPARE(takeAll(queue), QVector<int>() << 4);
+    QVERIFY(takeAll(queue).isEmpty());
+}
+
+void tst_QGstreamerProbeQueue::dropOldest()
+{
+    IntQueue queue(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::DropOldest, 3));
+
+    for (int i = 1; i <= 5; ++i)
+        queue.enqueue(i);
+
+    QCOMPARE(takeAll(queue), QVector<int>() << 3 << 4 << 5);
+    QCOMPARE(queue.droppedCount(), quint64(2));
+
+    // The ring starts over after a drain
+    for (int i = 6; i <= 9; ++i)
+        queue.enqueue(i);
+
+    QCOMPARE(takeAll(queue), QVector<int>() << 7 << 8 << 9);
+    QCOMPARE(queue.droppedCount(), quint64(3));
+}
+
+void tst_QGstreamerProbeQueue::dropNewest()
+{
+    IntQueue queue(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::DropNewest, 3));
+
+    for (int i = 1; i <= 5; ++i)
+        queue.enqueue(i);
+
+    QCOMPARE(takeAll(queue), QVector<int>() << 1 << 2 << 3);
+    QCOMPARE(queue.droppedCount(), quint64(2));
+}
+
+void tst_QGstreamerProbeQueue::unbounded()
+{
+    IntQueue queue(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::Unbounded, 2));
+
+    QVector<int> expected;
+    for (int i = 1; i <= 100; ++i) {
+        queue.enqueue(i);
+        expected << i;
+    }
+
+    QCOMPARE(takeAll(queue), expected);
+    QCOMPARE(queue.droppedCount(), quint64(0));
+
+    // Still in order after the grown ring has been used again
+    queue.enqueue(101);
+    queue.enqueue(102);
+    QCOMPARE(takeAll(queue), QVector<int>() << 101 << 102);
+}
+
+void tst_QGstreamerProbeQueue::blockTimeout()
+{
+    IntQueue queue(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::Block, 1, 50));
+
+    queue.enqueue(1);
+
+    // Nobody drains, so the producer gives up after the timeout and drops
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!queue.enqueue(2));
+    QVERIFY(timer.elapsed() >= 40);
+    QCOMPARE(queue.droppedCount(), quint64(1));
+
+    QCOMPARE(takeAll(queue), QVector<int>() << 1);
+}
+
+void tst_QGstreamerProbeQueue::blockUntilDrained()
+{
+    IntQueue queue(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::Block, 1, 10000));
+
+    queue.enqueue(1);
+
+    DelayedConsumer consumer(&queue, 20);
+    consumer.start();
+
+    // Released by the drain long before the timeout, nothing is lost
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(queue.enqueue(2));
+    QVERIFY(timer.elapsed() < 5000);
+    QVERIFY(consumer.wait());
+
+    QCOMPARE(consumer.items, QVector<int>() << 1);
+    QCOMPARE(takeAll(queue), QVector<int>() << 2);
+    QCOMPARE(queue.droppedCount(), quint64(0));
+}
+
+void tst_QGstreamerProbeQueue::setSettingsClears()
+{
+    IntQueue queue(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::DropOldest, 4));
+
+    queue.enqueue(1);
+    queue.enqueue(2);
+    queue.setSettings(QGstreamerProbeQueueSettings(QGstreamerProbeQueueSettings::DropNewest, 0));
+
+    // Capacity is at least one
+    QCOMPARE(queue.settings().capacity, 1);
+    QVERIFY(takeAll(queue).isEmpty());
+
+    queue.enqueue(3);
+    queue.enqueue(4);
+    QCOMPARE(takeAll(queue), QVector<int>() << 3);
+}
+
+#ifdef HAVE_GSTREAMER
+void tst_QGstreamerProbeQueue::audioProbeDroppedCount()
+{
+    qputenv("QT_GSTREAMER_AUDIO_PROBE_QUEUE", "drop-oldest:2");
+    QGstreamerAudioProbeControl control(0);
+    qunsetenv("QT_GSTREAMER_AUDIO_PROBE_QUEUE");
+
+    QSignalSpy probedSpy(&control, SIGNAL(audioBufferProbed(QAudioBuffer)));
+
+    GstCaps *caps = gst_caps_new_simple("audio/x-raw-int",
+                                        "rate", G_TYPE_INT, 8000,
+                                        "channels", G_TYPE_INT, 1,
+                                        "width", G_TYPE_INT, 16,
+                                        "depth", G_TYPE_INT, 16,
+                                        "signed", G_TYPE_BOOLEAN, TRUE,
+                                        "endianness", G_TYPE_INT, 1234,
+                                        NULL);
+
+    // Nothing drains the queue until the event loop runs
+    for (int i = 0; i < 5; ++i) {
+        GstBuffer *buffer = gst_buffer_new_and_alloc(160);
+        gst_buffer_set_caps(buffer, caps);
+        control.bufferProbed(buffer);
+        gst_buffer_unref(buffer);
+    }
+    gst_caps_unref(caps);
+
+    QCOMPARE(control.droppedCount(), quint64(3));
+    QTRY_COMPARE(probedSpy.count(), 2);
+    QCOMPARE(control.droppedCount(), quint64(3));
+}
+#endif
+
+QTEST_MAIN(tst_QGstreamerProbeQueue)
+
+#include "tst_qgstreamerprobequeue.moc"
@@ -87,6 +87,7 @@ private slots:
     void saveAndLoad();
     void loadM3uFile();
     void loadPLSFile();
+    void loadInBatches();
     void playbackMode();
     void playbackMode_data();
     void shuffle();
@@ -458,6 +459,37 @@ void tst_QMediaPlaylist::loadM3uFile()
     QVERIFY(loadFailedSpy.isEmpty());
 }
 
+void tst_QMediaPlaylist::loadInBatches()
+{
+    QMediaPlaylist playlist;
+
+    QSignalSpy loadSpy(&playlist, SIGNAL(loaded()));
+    QSignalSpy progressSpy(&playlist, SIGNAL(loadProgress(qint64,qint64)));
+    QSignalSpy aboutToBeInsertedSpy(&playlist, SIGNAL(mediaAboutToBeInserted(int,int)));
+    QSignalSpy insertedSpy(&playlist, SIGNAL(mediaInserted(int,int)));
+
+    const QString testFileName = QFINDTESTDATA("testdata/test.m3u");
+    playlist.load(QUrl::fromLocalFile(testFileName));
+    QTRY_VERIFY(!loadSpy.isEmpty());
+    QCOMPARE(playlist.mediaCount(), 7);
+
+    // The items arrive in ranges rather than one by one.
+    QVERIFY(insertedSpy.count() < playlist.mediaCount());
+    QCOMPARE(aboutToBeInsertedSpy.count(), insertedSpy.count());
+
+    int expectedStart = 0;
+    foreach (const QList<QVariant> &args, insertedSpy) {
+        QCOMPARE(args.at(0).toInt(), expectedStart);
+        QVERIFY(args.at(1).toInt() >= expectedStart);
+        expectedStart = args.at(1).toInt() + 1;
+    }
+    QCOMPARE(expectedStart, playlist.mediaCount());
+
+    // Progress ends with the whole file parsed.
+    QVERIFY(!progressSpy.isEmpty());
+    QCOMPARE(progressSpy.last().at(0).toLongLong(), QFileInfo(testFileName).size());
+}
+
 void tst_QMediaPlaylist::loadPLSFile()
 {
     QMediaPlaylist playlist;
@@ -66,12 +66,14 @@ private slots:
     void testEarliestLatest();
     void testContains();
     void testAddInterval();
+    void testAddIntervals();
     void testAddTimeRange();
     void testRemoveInterval();
     void testRemoveTimeRange();
     void testClear();
     void testComparisons();
     void testArithmetic();
+    void testManyIntervals();
 };
 
 void tst_QMediaTimeRange::testIntervalCtor()
@@ -375,6 +377,50 @@ void tst_QMediaTimeRange::testAddInterval()
     QVERIFY(x.isEmpty());
 }
 
+void tst_QMediaTimeRange::testAddIntervals()
+{
+    QList<QMediaTimeInterval> intervals;
+    intervals << QMediaTimeInterval(80, 90)     // Unsorted
+              << QMediaTimeInterval(10, 20)
+              << QMediaTimeInterval(15, 30)     // Overlapping
+              << QMediaTimeInterval(31, 40)     // Adjacent
+              << QMediaTimeInterval(70, 60)     // Not normal, ignored
+              << QMediaTimeInterval(85, 87)     // Contained
+              << QMediaTimeInterval(50, 50);
+
+    QMediaTimeRange a;
+    a.addIntervals(intervals);
+
+    QMediaTimeRange b;
+    foreach (const QMediaTimeInterval &i, intervals)
+        b.addInterval(i);
+
+    QCOMPARE(a.intervals().count(), 3);
+    QVERIFY(a.intervals()[0] == QMediaTimeInterval(10, 40));
+    QVERIFY(a.intervals()[1] == QMediaTimeInterval(50, 50));
+    QVERIFY(a.intervals()[2] == QMediaTimeInterval(80, 90));
+    QVERIFY(a == b);
+
+    // Merge with existing intervals
+    a = QMediaTimeRange();
+    a.addInterval(0, 5);
+    a.addInterval(45, 49);
+    a.addInterval(95, 100);
+    a.addIntervals(intervals);
+
+    QCOMPARE(a.intervals().count(), 5);
+    QVERIFY(a.intervals()[0] == QMediaTimeInterval(0, 5));
+    QVERIFY(a.intervals()[1] == QMediaTimeInterval(10, 40));
+    QVERIFY(a.intervals()[2] == QMediaTimeInterval(45, 50));
+    QVERIFY(a.intervals()[3] == QMediaTimeInterval(80, 90));
+    QVERIFY(a.intervals()[4] == QMediaTimeInterval(95, 100));
+
+    // Adding nothing
+    b = a;
+    a.addIntervals(QList<QMediaTimeInterval>());
+    QVERIFY(a == b);
+}
+
 void tst_QMediaTimeRange::testAddTimeRange()
 {
     // Add Time Range uses Add Interval internally,
@@ -801,6 +847,56 @@ void tst_QMediaTimeRange::testArithmetic()
     QVERIFY(a.latestTime() == 14);
 }
 
+// Correctness only; the timings for fragmented ranges are measured by
+// tests/benchmarks/multimedia/qmediatimerange.
+void tst_QMediaTimeRange::testManyIntervals()
+{
+    // A heavily fragmented range, like the buffered ranges of a network stream
+    const int count = 10000;
+
+    QList<QMediaTimeInterval> intervals;
+    for (int i = count - 1; i >= 0; --i)
+        intervals << QMediaTimeInterval(i * 10, i * 10 + 4);
+
+    QMediaTimeRange a;
+    a.addIntervals(intervals);
+
+    QMediaTimeRange b;
+    foreach (const QMediaTimeInterval &i, intervals)
+        b.addInterval(i);
+
+    QCOMPARE(a.intervals().count(), count);
+    QVERIFY(a == b);
+
+    for (int i = 0; i < count; i += 97) {
+        QVERIFY(a.contains(i * 10));
+        QVERIFY(a.contains(i * 10 + 4));
+        QVERIFY(!a.contains(i * 10 + 5));
+        QVERIFY(!a.contains(i * 10 - 1));
+    }
+
+    // Fill every other gap
+    for (int i = 0; i < count - 1; i += 2)
+        a.addInterval(i * 10 + 5, i * 10 + 9);
+
+    QCOMPARE(a.intervals().count(), count / 2);
+    QVERIFY(a.contains(5));
+    QVERIFY(!a.contains(15));
+
+    // Punch a hole in the middle of each interval
+    for (int i = 0; i < count - 1; i += 2)
+        a.removeInterval(i * 10 + 10, i * 10 + 12);
+
+    QCOMPARE(a.intervals().count(), count);
+    QVERIFY(a.intervals()[0] == QMediaTimeInterval(0, 9));
+    QVERIFY(a.intervals()[1] == QMediaTimeInterval(13, 14));
+    QVERIFY(!a.contains(11));
+
+    // Remove everything at once
+    a.removeInterval(a.earliestTime(), a.latestTime());
+    QVERIFY(a.isEmpty());
+}
+
 QTEST_MAIN(tst_QMediaTimeRange)
 
 #include "tst_qmediatimerange.moc"
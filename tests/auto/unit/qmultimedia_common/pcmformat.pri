@@ -0,0 +1,5 @@
+# stereo PCM format helper shared by the audio tests and benchmarks
+INCLUDEPATH += $$PWD
+
+HEADERS *= \
+    $$PWD/pcmformat.h
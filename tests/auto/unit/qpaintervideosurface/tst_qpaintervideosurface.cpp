@@ -251,14 +251,20 @@ void tst_QPainterVideoSurface::supportedFormat_data()
             << QAbstractVideoBuffer::NoHandle
             << QVideoFrame::Format_YUV420P
             << QSize(640, 480)
-            << false
-            << false;
+            << true
+            << true;
     QTest::newRow("YUV420P 640x-480")
             << QAbstractVideoBuffer::NoHandle
             << QVideoFrame::Format_YUV420P
             << QSize(640, -480)
-            << false
+            << true
             << false;
+    QTest::newRow("UYVY 640x480")
+            << QAbstractVideoBuffer::NoHandle
+            << QVideoFrame::Format_UYVY
+            << QSize(640, 480)
+            << true
+            << true;
     QTest::newRow("Y8 640x480")
             << QAbstractVideoBuffer::NoHandle
             << QVideoFrame::Format_Y8
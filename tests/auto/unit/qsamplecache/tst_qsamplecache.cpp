@@ -57,8 +57,17 @@ private slots:
     void testEnoughCapacity();
     void testNotEnoughCapacity();
     void testInvalidFile();
+    void testLeastRecentlyUsedEviction();
+    void testPinnedSample();
+    void testStatistics();
+    void testLocalFile();
+    void testPreload();
+    void testPreloadWithoutCapacity();
 
 private:
+    QUrl copyTestData(const QString &fileName);
+
+    QTemporaryDir m_dir;
 
 };
 
@@ -194,6 +203,271 @@ void tst_QSampleCache::testInvalidFile()
     QVERIFY(!cache.isCached(QUrl::fromLocalFile("invalid")));
 }
 
+QUrl tst_QSampleCache::copyTestData(const QString &fileName)
+{
+    const QString path = m_dir.path() + QLatin1Char('/') + fileName;
+    if (!QFile::exists(path))
+        QFile::copy(QFINDTESTDATA("testdata/test.wav"), path);
+    return QUrl::fromLocalFile(path);
+}
+
+// Returns the size of the sample, or -1 if it could not be loaded
+static int loadAndRelease(QSampleCache *cache, const QUrl &url)
+{
+    QSample *sample = cache->requestSample(url);
+
+    QElapsedTimer timer;
+    timer.start();
+    while ((sample->state() == QSample::Creating || sample->state() == QSample::Loading
+            || cache->isLoading()) && timer.elapsed() < 5000) {
+        QTest::qWait(10);
+    }
+
+    const int size = sample->state() == QSample::Ready ? sample->data().size() : -1;
+    sample->release();
+    return size;
+}
+
+void tst_QSampleCache::testLeastRecentlyUsedEviction()
+{
+    const QUrl a = copyTestData(QLatin1String("a.wav"));
+    const QUrl b = copyTestData(QLatin1String("b.wav"));
+    const QUrl c = copyTestData(QLatin1String("c.wav"));
+
+    QSampleCache cache;
+    cache.setCapacity(1024 * 1024);
+
+    const int sampleSize = loadAndRelease(&cache, a);
+    QVERIFY(sampleSize > 0);
+    QVERIFY(loadAndRelease(&cache, b) > 0);
+    QVERIFY(cache.isCached(a));
+    QVERIFY(cache.isCached(b));
+
+    // Room for two samples only
+    cache.setCapacity(sampleSize * 2 + sampleSize / 2);
+    QCOMPARE(cache.evictionCount(), 0);
+
+    // Makes a the most recently used sample
+    QVERIFY(loadAndRelease(&cache, a) > 0);
+
+    // b has to go, even though a sorts first
+    QVERIFY(loadAndRelease(&cache, c) > 0);
+    QVERIFY(cache.isCached(a));
+    QVERIFY(!cache.isCached(b));
+    QVERIFY(cache.isCached(c));
+    QCOMPARE(cache.evictionCount(), 1);
+    QCOMPARE(cache.usage(), qint64(sampleSize * 2));
+
+    // Shrinking the capacity evicts the least recently used first
+    cache.setCapacity(sampleSize + sampleSize / 2);
+    QVERIFY(!cache.isCached(a));
+    QVERIFY(cache.isCached(c));
+    QCOMPARE(cache.evictionCount(), 2);
+}
+
+void tst_QSampleCache::testPinnedSample()
+{
+    const QUrl a = copyTestData(QLatin1String("a.wav"));
+    const QUrl b = copyTestData(QLatin1String("b.wav"));
+    const QUrl c = copyTestData(QLatin1String("c.wav"));
+
+    // Pinned samples are kept even when nothing else is cached
+    QSampleCache cache;
+    cache.setPinned(a, true);
+    QVERIFY(cache.isPinned(a));
+
+    const int sampleSize = loadAndRelease(&cache, a);
+    QVERIFY(sampleSize > 0);
+    QVERIFY(cache.isCached(a));
+
+    QVERIFY(loadAndRelease(&cache, b) > 0);
+    QVERIFY(!cache.isCached(b));
+
+    // ... and are never evicted, although a is the least recently used
+    cache.setCapacity(sampleSize * 2 + sampleSize / 2);
+    QVERIFY(loadAndRelease(&cache, b) > 0);
+    QVERIFY(loadAndRelease(&cache, c) > 0);
+    QVERIFY(cache.isCached(a));
+    QVERIFY(!cache.isCached(b));
+    QVERIFY(cache.isCached(c));
+
+    // Unpinned samples become the most recently used ones
+    cache.setPinned(a, false);
+    QVERIFY(!cache.isPinned(a));
+    QVERIFY(loadAndRelease(&cache, b) > 0);
+    QVERIFY(cache.isCached(a));
+    QVERIFY(cache.isCached(b));
+    QVERIFY(!cache.isCached(c));
+
+    cache.setCapacity(0);
+    QVERIFY(!cache.isCached(a));
+    QVERIFY(!cache.isCached(b));
+}
+
+void tst_QSampleCache::testStatistics()
+{
+    const QUrl a = copyTestData(QLatin1String("a.wav"));
+
+    QSampleCache cache;
+    cache.setCapacity(1024 * 1024);
+
+    QVERIFY(loadAndRelease(&cache, a) > 0);
+    QCOMPARE(cache.missCount(), 1);
+    QCOMPARE(cache.hitCount(), 0);
+
+    QVERIFY(loadAndRelease(&cache, a) > 0);
+    QVERIFY(loadAndRelease(&cache, a) > 0);
+    QCOMPARE(cache.missCount(), 1);
+    QCOMPARE(cache.hitCount(), 2);
+    QVERIFY(cache.usage() > 0);
+
+    cache.resetStatistics();
+    QCOMPARE(cache.missCount(), 0);
+    QCOMPARE(cache.hitCount(), 0);
+    QCOMPARE(cache.evictionCount(), 0);
+
+    // Failed samples are loaded again on each request
+    const QUrl invalid = QUrl::fromLocalFile(QLatin1String("invalid"));
+    QSample *sample = cache.requestSample(invalid);
+    QTRY_COMPARE(sample->state(), QSample::Error);
+    QTRY_VERIFY(!cache.isLoading());
+    sample->release();
+    sample = cache.requestSample(invalid);
+    QTRY_COMPARE(sample->state(), QSample::Error);
+    QTRY_VERIFY(!cache.isLoading());
+    sample->release();
+    QCOMPARE(cache.missCount(), 2);
+}
+
+void tst_QSampleCache::testLocalFile()
+{
+    QSampleCache cache;
+
+    QSample *sample = cache.requestSample(QUrl::fromLocalFile(QFINDTESTDATA("testdata/test.wav")));
+    QTRY_COMPARE(sample->state(), QSample::Ready);
+
+    QCOMPARE(sample->data().size(), 88188);
+    QCOMPARE(sample->format().codec(), QLatin1String("audio/pcm"));
+    QCOMPARE(sample->format().sampleRate(), 44100);
+    QCOMPARE(sample->format().channelCount(), 1);
+    QCOMPARE(sample->format().sampleSize(), 16);
+    QCOMPARE(sample->format().sampleType(), QAudioFormat::SignedInt);
+    QCOMPARE(sample->format().byteOrder(), QAudioFormat::LittleEndian);
+
+    QTRY_VERIFY(!cache.isLoading());
+    sample->release();
+
+    // Files which are not wave files still end up as errors
+    QFile notAWave(m_dir.path() + QLatin1String("/notawave.wav"));
+    QVERIFY(notAWave.open(QIODevice::WriteOnly));
+    notAWave.write(QByteArray(1024, 'x'));
+    notAWave.close();
+
+    sample = cache.requestSample(QUrl::fromLocalFile(notAWave.fileName()));
+    QTRY_COMPARE(sample->state(), QSample::Error);
+    QTRY_VERIFY(!cache.isLoading());
+    sample->release();
+}
+
+void tst_QSampleCache::testPreload()
+{
+    QList<QUrl> urls;
+    urls << copyTestData(QLatin1String("a.wav"))
+         << copyTestData(QLatin1String("b.wav"))
+         << copyTestData(QLatin1String("c.wav"))
+         << copyTestData(QLatin1String("a.wav"))
+         << QUrl::fromLocalFile(QLatin1String("invalid"));
+
+    QSampleCache cache;
+    cache.setCapacity(1024 * 1024);
+    QSignalSpy finishedSpy(&cache, SIGNAL(preloadFinished()));
+
+    cache.preload(urls);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QVERIFY(cache.isCached(urls.at(0)));
+    QVERIFY(cache.isCached(urls.at(1)));
+    QVERIFY(cache.isCached(urls.at(2)));
+    QCOMPARE(cache.missCount(), 4);
+    QTRY_VERIFY(!cache.isLoading());
+
+    // Everything is cached now, but the signal is still asynchronous
+    cache.preload(urls.mid(0, 3));
+    QCOMPARE(finishedSpy.count(), 1);
+    QTRY_COMPARE(finishedSpy.count(), 2);
+    QCOMPARE(cache.hitCount(), 4);
+    QTRY_VERIFY(!cache.isLoading());
+
+    // With a capacity nothing is held back, the samples are ordinary
+    // unreferenced cache entries and go when the capacity does
+    cache.setCapacity(0);
+    QVERIFY(!cache.isCached(urls.at(0)));
+    QVERIFY(!cache.isCached(urls.at(1)));
+    QVERIFY(!cache.isCached(urls.at(2)));
+}
+
+void tst_QSampleCache::testPreloadWithoutCapacity()
+{
+    const QUrl a = copyTestData(QLatin1String("a.wav"));
+    const QUrl b = copyTestData(QLatin1String("b.wav"));
+
+    QSampleCache cache;
+    QSignalSpy finishedSpy(&cache, SIGNAL(preloadFinished()));
+
+    cache.preload(QList<QUrl>() << a << b);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QTRY_VERIFY(!cache.isLoading());
+    QVERIFY(cache.isCached(a));
+    QVERIFY(cache.isCached(b));
+    cache.resetStatistics();
+
+    QSample *sample = cache.requestSample(a);
+    QCOMPARE(sample->state(), QSample::Ready);
+    QCOMPARE(cache.hitCount(), 1);
+    QCOMPARE(cache.missCount(), 0);
+    QTRY_VERIFY(!cache.isLoading());
+
+    // Once the caller has it, the usual rules apply again
+    sample->release();
+    QVERIFY(!cache.isCached(a));
+    QVERIFY(cache.isCached(b));
+
+    cache.setPinned(b, true);
+    sample = cache.requestSample(b);
+    QCOMPARE(sample->state(), QSample::Ready);
+    QCOMPARE(cache.hitCount(), 2);
+    QTRY_VERIFY(!cache.isLoading());
+    sample->release();
+    QVERIFY(cache.isCached(b));
+
+    cache.setPinned(b, false);
+    QVERIFY(!cache.isCached(b));
+
+    // Held samples are released by the next preload...
+    cache.preload(QList<QUrl>() << a);
+    QTRY_COMPARE(finishedSpy.count(), 2);
+    QTRY_VERIFY(!cache.isLoading());
+    QVERIFY(cache.isCached(a));
+
+    cache.preload(QList<QUrl>() << b);
+    QVERIFY(!cache.isCached(a));
+    QTRY_COMPARE(finishedSpy.count(), 3);
+    QTRY_VERIFY(!cache.isLoading());
+    QVERIFY(cache.isCached(b));
+
+    // ...on request...
+    cache.releasePreloadedSamples();
+    QVERIFY(!cache.isCached(b));
+
+    // ...or handed over to the LRU list once there is a capacity
+    cache.preload(QList<QUrl>() << a);
+    QTRY_COMPARE(finishedSpy.count(), 4);
+    QTRY_VERIFY(!cache.isLoading());
+    cache.setCapacity(1024 * 1024);
+    QVERIFY(cache.isCached(a));
+    cache.setCapacity(0);
+    QVERIFY(!cache.isCached(a));
+}
+
 QTEST_MAIN(tst_QSampleCache)
 
 #include "tst_qsamplecache.moc"
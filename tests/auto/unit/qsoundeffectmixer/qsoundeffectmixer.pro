@@ -0,0 +1,8 @@
+CONFIG += no_private_qt_headers_warning testcase
+TARGET = tst_qsoundeffectmixer
+
+QT += core multimedia-private testlib
+
+SOURCES += tst_qsoundeffectmixer.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
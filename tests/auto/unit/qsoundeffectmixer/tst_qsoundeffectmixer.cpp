@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <private/qsoundeffectmixer_p.h>
+
+class TestObserver : public QSoundEffectVoiceObserver
+{
+public:
+    void voiceLooped(int serial, int loopsRemaining) { looped << qMakePair(serial, loopsRemaining); }
+    void voiceFinished(int serial) { finished << serial; }
+
+    QList<QPair<int, int> > looped;
+    QList<int> finished;
+};
+
+class tst_QSoundEffectMixer : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QSoundEffectMixer();
+
+private slots:
+    void maxChunk();
+    void mixVoices();
+    void clipping();
+    void chunking();
+    void loopsAndFinish();
+    void stop();
+    void sequential();
+
+private:
+    // Queues a voice directly, without play() starting an audio output
+    void queueVoice(QSoundEffectMixer &mixer, int id, int serial, const QVector<qint16> &samples,
+                    float volume, int loops);
+    QVector<qint16> read(QSoundEffectMixer &mixer, int frames);
+
+    QAudioFormat m_format;
+};
+
+tst_QSoundEffectMixer::tst_QSoundEffectMixer()
+{
+    m_format.setSampleRate(8000);
+    m_format.setChannelCount(1);
+    m_format.setSampleSize(16);
+    m_format.setSampleType(QAudioFormat::SignedInt);
+    m_format.setByteOrder(QAudioFormat::LittleEndian);
+    m_format.setCodec(QLatin1String("audio/pcm"));
+}
+
+void tst_QSoundEffectMixer::queueVoice(QSoundEffectMixer &mixer, int id, int serial,
+                                       const QVector<qint16> &samples, float volume, int loops)
+{
+    QSoundEffectMixer::Command command;
+    command.type = QSoundEffectMixer::Command::Play;
+    command.id = id;
+    command.serial = serial;
+    command.volume = volume;
+    command.loops = loops;
+    command.data = QByteArray(reinterpret_cast<const char *>(samples.constData()),
+                              samples.size() * sizeof(qint16));
+    mixer.enqueue(command);
+}
+
+QVector<qint16> tst_QSoundEffectMixer::read(QSoundEffectMixer &mixer, int frames)
+{
+    QVector<qint16> samples(frames);
+    const qint64 bytes = mixer.read(reinterpret_cast<char *>(samples.data()), frames * sizeof(qint16));
+    samples.resize(bytes / sizeof(qint16));
+    return samples;
+}
+
+void tst_QSoundEffectMixer::maxChunk()
+{
+    // Without a period size, 20 ms worth of frames
+    QCOMPARE(QSoundEffectMixer::maxChunkFor(m_format, 0), 320);
+    QCOMPARE(QSoundEffectMixer::maxChunkFor(m_format, 100), 200);
+
+    // A fresh mixer is never unbounded
+    QSoundEffectMixer mixer(m_format);
+    QCOMPARE(mixer.m_maxChunk.load(), 320);
+}
+
+void tst_QSoundEffectMixer::mixVoices()
+{
+    QSoundEffectMixer mixer(m_format);
+
+    queueVoice(mixer, 1, 1, QVector<qint16>() << 1000 << 2000 << -1000 << 0, 1.0f, 1);
+    queueVoice(mixer, 2, 2, QVector<qint16>() << 500 << 500 << 500 << 500, 0.5f, 1);
+
+    QCOMPARE(read(mixer, 4), QVector<qint16>() << 1250 << 2250 << -750 << 250);
+
+    // Silence keeps the stream running once the voices are done
+    QCOMPARE(read(mixer, 2), QVector<qint16>() << 0 << 0);
+}
+
+void tst_QSoundEffectMixer::clipping()
+{
+    QSoundEffectMixer mixer(m_format);
+
+    queueVoice(mixer, 1, 1, QVector<qint16>() << 30000 << -30000, 1.0f, 1);
+    queueVoice(mixer, 2, 2, QVector<qint16>() << 30000 << -30000, 1.0f, 1);
+
+    QCOMPARE(read(mixer, 2), QVector<qint16>() << 32767 << -32768);
+}
+
+void tst_QSoundEffectMixer::chunking()
+{
+    QSoundEffectMixer mixer(m_format);
+    mixer.m_maxChunk.store(8);
+
+    // Never more than the chunk, however much the output asks for
+    QCOMPARE(read(mixer, 100).size(), 4);
+
+    // and never a partial frame
+    mixer.m_maxChunk.store(7);
+    QCOMPARE(read(mixer, 100).size(), 3);
+}
+
+void tst_QSoundEffectMixer::loopsAndFinish()
+{
+    QSoundEffectMixer mixer(m_format);
+    TestObserver observer;
+    const int id = mixer.registerObserver(&observer);
+
+    queueVoice(mixer, id, 7, QVector<qint16>() << 100 << 200, 1.0f, 2);
+
+    QCOMPARE(read(mixer, 6), QVector<qint16>() << 100 << 200 << 100 << 200 << 0 << 0);
+
+    // Notifications arrive as queued calls
+    QVERIFY(observer.looped.isEmpty());
+    QCoreApplication::processEvents();
+
+    QCOMPARE(observer.looped.size(), 2);
+    QCOMPARE(observer.looped.at(0), qMakePair(7, 1));
+    QCOMPARE(observer.looped.at(1), qMakePair(7, 0));
+    QCOMPARE(observer.finished, QList<int>() << 7);
+
+    mixer.unregisterObserver(id);
+}
+
+void tst_QSoundEffectMixer::stop()
+{
+    QSoundEffectMixer mixer(m_format);
+
+    queueVoice(mixer, 1, 1, QVector<qint16>() << 100 << 100 << 100 << 100, 1.0f, 1);
+    QCOMPARE(read(mixer, 2), QVector<qint16>() << 100 << 100);
+
+    QSoundEffectMixer::Command command;
+    command.type = QSoundEffectMixer::Command::Stop;
+    command.id = 1;
+    mixer.enqueue(command);
+
+    QCOMPARE(read(mixer, 2), QVector<qint16>() << 0 << 0);
+}
+
+void tst_QSoundEffectMixer::sequential()
+{
+    QSoundEffectMixer mixer(m_format);
+
+    // A mix can't be rewound, so reads never move a position to seek back to
+    QVERIFY(mixer.isSequential());
+
+    queueVoice(mixer, 1, 1, QVector<qint16>() << 100 << 200, 1.0f, 1);
+    QCOMPARE(read(mixer, 1), QVector<qint16>() << 100);
+    QCOMPARE(read(mixer, 1), QVector<qint16>() << 200);
+    QCOMPARE(mixer.pos(), qint64(0));
+}
+
+QTEST_MAIN(tst_QSoundEffectMixer)
+
+#include "tst_qsoundeffectmixer.moc"
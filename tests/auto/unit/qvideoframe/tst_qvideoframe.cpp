@@ -87,6 +87,9 @@ private slots:
     void map();
     void mapImage_data();
     void mapImage();
+    void mapPlanes_data();
+    void mapPlanes();
+    void mapPlanarBuffer();
     void imageDetach();
     void formatConversion_data();
     void formatConversion();
@@ -124,6 +127,41 @@ public:
     void unmap() {}
 };
 
+class QtTestPlanarVideoBuffer : public QAbstractPlanarVideoBuffer
+{
+public:
+    QtTestPlanarVideoBuffer()
+        : QAbstractPlanarVideoBuffer(NoHandle)
+        , m_mapMode(NotMapped)
+    {
+        memset(m_data, 0, sizeof(m_data));
+    }
+
+    MapMode mapMode() const { return m_mapMode; }
+
+    int mapPlanes(MapMode mode, int *numBytes, int bytesPerLine[4], uchar *data[4])
+    {
+        m_mapMode = mode;
+        if (numBytes)
+            *numBytes = sizeof(m_data);
+
+        // A Y plane followed by two padded chroma planes.
+        bytesPerLine[0] = 64;
+        bytesPerLine[1] = 48;
+        bytesPerLine[2] = 40;
+        data[0] = m_data;
+        data[1] = m_data + 64 * 16;
+        data[2] = data[1] + 48 * 8;
+        return 3;
+    }
+
+    void unmap() { m_mapMode = NotMapped; }
+
+private:
+    MapMode m_mapMode;
+    uchar m_data[64 * 16 + 48 * 8 + 40 * 8];
+};
+
 tst_QVideoFrame::tst_QVideoFrame()
 {
 }
@@ -736,6 +774,99 @@ void tst_QVideoFrame::mapImage()
     QCOMPARE(frame.mapMode(), QAbstractVideoBuffer::NotMapped);
 }
 
+void tst_QVideoFrame::mapPlanes_data()
+{
+    QTest::addColumn<QVideoFrame>("frame");
+    QTest::addColumn<QList<int> >("strides");
+    QTest::addColumn<QList<int> >("offsets");
+
+    QTest::newRow("Packed")
+            << QVideoFrame(4096, QSize(16, 16), 64, QVideoFrame::Format_ARGB32)
+            << (QList<int>() << 64)
+            << QList<int>();
+    QTest::newRow("Planar")
+            << QVideoFrame(384, QSize(16, 16), 16, QVideoFrame::Format_YUV420P)
+            << (QList<int>() << 16 << 8 << 8)
+            << (QList<int>() << 256 << 320);
+    QTest::newRow("Padded planar")
+            << QVideoFrame(768, QSize(16, 16), 32, QVideoFrame::Format_YV12)
+            << (QList<int>() << 32 << 16 << 16)
+            << (QList<int>() << 512 << 640);
+    QTest::newRow("Semi planar")
+            << QVideoFrame(384, QSize(16, 16), 16, QVideoFrame::Format_NV12)
+            << (QList<int>() << 16 << 16)
+            << (QList<int>() << 256);
+    QTest::newRow("IMC1")
+            << QVideoFrame(512, QSize(16, 16), 16, QVideoFrame::Format_IMC1)
+            << (QList<int>() << 16 << 16 << 16)
+            << (QList<int>() << 256 << 384);
+}
+
+void tst_QVideoFrame::mapPlanes()
+{
+    QFETCH(QVideoFrame, frame);
+    QFETCH(QList<int>, strides);
+    QFETCH(QList<int>, offsets);
+
+    QCOMPARE(frame.planeCount(), 0);
+    QVERIFY(!frame.bits(0));
+    QCOMPARE(frame.bytesPerLine(0), 0);
+
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+
+    QCOMPARE(frame.planeCount(), strides.count());
+    QVERIFY(strides.count() > 0);
+    QCOMPARE(frame.bytesPerLine(0), strides.at(0));
+    QCOMPARE(frame.bits(0), frame.bits());
+
+    for (int i = 1; i < strides.count(); ++i) {
+        QCOMPARE(frame.bytesPerLine(i), strides.at(i));
+        QCOMPARE(int(frame.bits(i) - frame.bits()), offsets.at(i - 1));
+    }
+
+    // Out of range planes are null.
+    QVERIFY(!frame.bits(-1));
+    QVERIFY(!frame.bits(strides.count()));
+    QCOMPARE(frame.bytesPerLine(strides.count()), 0);
+
+    frame.unmap();
+
+    QCOMPARE(frame.planeCount(), 0);
+    QVERIFY(!frame.bits(0));
+    QCOMPARE(frame.bytesPerLine(0), 0);
+}
+
+void tst_QVideoFrame::mapPlanarBuffer()
+{
+    QVideoFrame frame(new QtTestPlanarVideoBuffer, QSize(16, 16), QVideoFrame::Format_YUV420P);
+
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+
+    // The layout reported by the buffer is used as is, even though it differs
+    // from what would be derived from the pixel format.
+    QCOMPARE(frame.planeCount(), 3);
+    QCOMPARE(frame.mappedBytes(), 64 * 16 + 48 * 8 + 40 * 8);
+    QCOMPARE(frame.bytesPerLine(), 64);
+    QCOMPARE(frame.bytesPerLine(0), 64);
+    QCOMPARE(frame.bytesPerLine(1), 48);
+    QCOMPARE(frame.bytesPerLine(2), 40);
+    QCOMPARE(int(frame.bits(1) - frame.bits(0)), 64 * 16);
+    QCOMPARE(int(frame.bits(2) - frame.bits(1)), 48 * 8);
+
+    frame.unmap();
+    QCOMPARE(frame.planeCount(), 0);
+    QCOMPARE(frame.mapMode(), QAbstractVideoBuffer::NotMapped);
+
+    // The single plane map() of a planar buffer returns the first plane.
+    QtTestPlanarVideoBuffer buffer;
+    int numBytes = 0;
+    int bytesPerLine = 0;
+    QVERIFY(buffer.map(QAbstractVideoBuffer::ReadOnly, &numBytes, &bytesPerLine));
+    QCOMPARE(numBytes, 64 * 16 + 48 * 8 + 40 * 8);
+    QCOMPARE(bytesPerLine, 64);
+    buffer.unmap();
+}
+
 void tst_QVideoFrame::imageDetach()
 {
     const uint red = qRgb(255, 0, 0);
@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <private/qvideoframepool_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QVideoFramePool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void allocate();
+    void reuse();
+    void keyedByFormat();
+    void highWaterMark();
+    void clear();
+    void outlivesPool();
+};
+
+static const QSize frameSize(64, 32);
+static const int bytesPerLine = 64 * 4;
+static const int frameBytes = bytesPerLine * 32;
+
+void tst_QVideoFramePool::allocate()
+{
+    QVideoFramePool pool;
+
+    QVideoFrame frame = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+    QVERIFY(frame.isValid());
+    QCOMPARE(frame.size(), frameSize);
+    QCOMPARE(frame.pixelFormat(), QVideoFrame::Format_RGB32);
+    QCOMPARE(frame.handleType(), QAbstractVideoBuffer::NoHandle);
+
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadWrite));
+    QCOMPARE(frame.mappedBytes(), frameBytes);
+    QCOMPARE(frame.bytesPerLine(), bytesPerLine);
+    QCOMPARE(quintptr(frame.bits()) % 64, quintptr(0));
+    frame.unmap();
+
+    QVERIFY(!pool.allocate(0, frameSize, bytesPerLine, QVideoFrame::Format_RGB32).isValid());
+
+    const QVideoFramePool::Statistics statistics = pool.statistics();
+    QCOMPARE(statistics.hits, 0);
+    QCOMPARE(statistics.misses, 1);
+    QCOMPARE(statistics.bytesResident, qint64(frameBytes));
+    QCOMPARE(statistics.bytesIdle, qint64(0));
+}
+
+void tst_QVideoFramePool::reuse()
+{
+    QVideoFramePool pool;
+
+    QVideoFrame frame = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+    QVERIFY(frame.map(QAbstractVideoBuffer::WriteOnly));
+    uchar *bits = frame.bits();
+
+    // Leave the frame mapped, the pool has to reset that.
+    QVideoFrame copy = frame;
+    frame = QVideoFrame();
+    QCOMPARE(pool.statistics().bytesIdle, qint64(0));
+    copy = QVideoFrame();
+    QCOMPARE(pool.statistics().bytesIdle, qint64(frameBytes));
+
+    frame = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+    QCOMPARE(frame.bits(), bits);
+    frame.unmap();
+
+    const QVideoFramePool::Statistics statistics = pool.statistics();
+    QCOMPARE(statistics.hits, 1);
+    QCOMPARE(statistics.misses, 1);
+    QCOMPARE(statistics.bytesResident, qint64(frameBytes));
+    QCOMPARE(statistics.bytesIdle, qint64(0));
+
+    pool.resetStatistics();
+    QCOMPARE(pool.statistics().hits, 0);
+    QCOMPARE(pool.statistics().misses, 0);
+    QCOMPARE(pool.statistics().bytesResident, qint64(frameBytes));
+}
+
+void tst_QVideoFramePool::keyedByFormat()
+{
+    QVideoFramePool pool;
+
+    pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+    QCOMPARE(pool.statistics().bytesIdle, qint64(frameBytes));
+
+    // Same amount of memory, but a different layout.
+    QVideoFrame frame = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_ARGB32);
+    QVERIFY(frame.isValid());
+    frame = pool.allocate(frameBytes, QSize(128, 16), bytesPerLine * 2, QVideoFrame::Format_RGB32);
+    QVERIFY(frame.isValid());
+
+    QCOMPARE(pool.statistics().hits, 0);
+    QCOMPARE(pool.statistics().misses, 3);
+}
+
+void tst_QVideoFramePool::highWaterMark()
+{
+    QVideoFramePool pool(2 * frameBytes);
+    QCOMPARE(pool.highWaterMark(), qint64(2 * frameBytes));
+
+    {
+        QVideoFrame a = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+        QVideoFrame b = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+        QVideoFrame c = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+        QVERIFY(c.isValid());
+        QCOMPARE(pool.statistics().bytesResident, qint64(3 * frameBytes));
+    }
+
+    // The first buffer returned found the pool over its limit and was freed.
+    QVideoFramePool::Statistics statistics = pool.statistics();
+    QCOMPARE(statistics.bytesResident, qint64(2 * frameBytes));
+    QCOMPARE(statistics.bytesIdle, qint64(2 * frameBytes));
+
+    // A miss evicts idle buffers to stay under the limit.
+    QVideoFrame frame = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB24);
+    QVERIFY(frame.isValid());
+    statistics = pool.statistics();
+    QCOMPARE(statistics.evictions, 1);
+    QCOMPARE(statistics.bytesResident, qint64(2 * frameBytes));
+    QCOMPARE(statistics.bytesIdle, qint64(frameBytes));
+
+    pool.setHighWaterMark(0);
+    frame = QVideoFrame();
+    QCOMPARE(pool.statistics().bytesIdle, qint64(frameBytes));
+    QCOMPARE(pool.statistics().bytesResident, qint64(frameBytes));
+}
+
+void tst_QVideoFramePool::clear()
+{
+    QVideoFramePool pool;
+
+    QVideoFrame frame = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+    pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+
+    pool.clear();
+    QCOMPARE(pool.statistics().bytesIdle, qint64(0));
+    QCOMPARE(pool.statistics().bytesResident, qint64(frameBytes));
+
+    frame = QVideoFrame();
+    QCOMPARE(pool.statistics().bytesIdle, qint64(frameBytes));
+}
+
+void tst_QVideoFramePool::outlivesPool()
+{
+    QVideoFrame frame;
+    {
+        QVideoFramePool pool;
+        frame = pool.allocate(frameBytes, frameSize, bytesPerLine, QVideoFrame::Format_RGB32);
+    }
+
+    QVERIFY(frame.map(QAbstractVideoBuffer::WriteOnly));
+    memset(frame.bits(), 0xff, frameBytes);
+    frame.unmap();
+
+    frame = QVideoFrame();
+}
+
+QTEST_MAIN(tst_QVideoFramePool)
+
+#include "tst_qvideoframepool.moc"
@@ -0,0 +1,16 @@
+CONFIG += no_private_qt_headers_warning testcase
+TARGET = tst_qvideosurfacegstsink
+
+QT += core multimedia-private testlib
+
+SOURCES += tst_qvideosurfacegstsink.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
+
+LIBS += -lqgsttools_p
+CONFIG += link_pkgconfig
+PKGCONFIG += \
+    gstreamer-0.10 \
+    gstreamer-base-0.10 \
+    gstreamer-interfaces-0.10 \
+    gstreamer-video-0.10
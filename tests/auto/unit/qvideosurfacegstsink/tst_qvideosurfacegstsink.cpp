@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <QtCore/qthread.h>
+#include <qabstractvideosurface.h>
+#include <qvideosurfaceformat.h>
+#include <private/qvideosurfacegstsink_p.h>
+
+class tst_QVideoSurfaceGstSink : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void asyncRenderDropsStaleFrames();
+    void asyncRenderCountsLateFrames();
+};
+
+class TestVideoSurface : public QAbstractVideoSurface
+{
+public:
+    TestVideoSurface() : presentedFrames(0), lastStartTime(-1) {}
+
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+            QAbstractVideoBuffer::HandleType handleType) const
+    {
+        QList<QVideoFrame::PixelFormat> formats;
+        if (handleType == QAbstractVideoBuffer::NoHandle)
+            formats << QVideoFrame::Format_RGB32;
+        return formats;
+    }
+
+    bool present(const QVideoFrame &frame)
+    {
+        ++presentedFrames;
+        lastStartTime = frame.startTime();
+        return true;
+    }
+
+    int presentedFrames;
+    qint64 lastStartTime;
+};
+
+// Renders from its own thread like the streaming thread of the sink does,
+// frames rendered from the delegate's thread are presented directly
+class RenderThread : public QThread
+{
+public:
+    RenderThread(QVideoSurfaceGstDelegate *delegate, int count, qint64 duration)
+        : m_delegate(delegate), m_count(count), m_duration(duration) {}
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < m_count; ++i) {
+            GstBuffer *buffer = gst_buffer_new_and_alloc(2 * 2 * 4);
+            GST_BUFFER_TIMESTAMP(buffer) = i * m_duration;
+            GST_BUFFER_DURATION(buffer) = m_duration;
+            m_delegate->render(buffer);
+            gst_buffer_unref(buffer);
+        }
+    }
+
+private:
+    QVideoSurfaceGstDelegate *m_delegate;
+    int m_count;
+    qint64 m_duration;
+};
+
+static QVideoSurfaceGstDelegate *createAsyncDelegate(QAbstractVideoSurface *surface)
+{
+    qputenv("QT_GSTREAMER_ASYNC_VIDEO_RENDER", "1");
+    QVideoSurfaceGstDelegate *delegate = new QVideoSurfaceGstDelegate(surface);
+    qunsetenv("QT_GSTREAMER_ASYNC_VIDEO_RENDER");
+    return delegate;
+}
+
+void tst_QVideoSurfaceGstSink::initTestCase()
+{
+    gst_init(NULL, NULL);
+}
+
+void tst_QVideoSurfaceGstSink::asyncRenderDropsStaleFrames()
+{
+    TestVideoSurface surface;
+    QScopedPointer<QVideoSurfaceGstDelegate> delegate(createAsyncDelegate(&surface));
+    QVERIFY(delegate->start(QVideoSurfaceFormat(QSize(2, 2), QVideoFrame::Format_RGB32), 2 * 4));
+
+    // render() must not wait for the GUI thread, which is not running its
+    // event loop here, so only the newest frame is left to present
+    RenderThread thread(delegate.data(), 3, 40 * GST_MSECOND);
+    thread.start();
+    QVERIFY(thread.wait(5000));
+
+    QCOMPARE(delegate->droppedFrames(), quint64(2));
+    QCOMPARE(delegate->renderedFrames(), quint64(0));
+    QCOMPARE(surface.presentedFrames, 0);
+
+    QTRY_COMPARE(delegate->renderedFrames(), quint64(1));
+    QCOMPARE(surface.presentedFrames, 1);
+    QCOMPARE(surface.lastStartTime, qint64(80000));
+    QCOMPARE(delegate->droppedFrames(), quint64(2));
+
+    delegate->stop();
+}
+
+void tst_QVideoSurfaceGstSink::asyncRenderCountsLateFrames()
+{
+    TestVideoSurface surface;
+    QScopedPointer<QVideoSurfaceGstDelegate> delegate(createAsyncDelegate(&surface));
+    QVERIFY(delegate->start(QVideoSurfaceFormat(QSize(2, 2), QVideoFrame::Format_RGB32), 2 * 4));
+
+    // The frame is shown for 1 ms but waits far longer for the GUI thread
+    RenderThread thread(delegate.data(), 1, GST_MSECOND);
+    thread.start();
+    QVERIFY(thread.wait(5000));
+    QTest::qSleep(20);
+
+    QTRY_COMPARE(delegate->renderedFrames(), quint64(1));
+    QCOMPARE(delegate->lateFrames(), quint64(1));
+    QCOMPARE(delegate->droppedFrames(), quint64(0));
+
+    delegate->stop();
+}
+
+QTEST_MAIN(tst_QVideoSurfaceGstSink)
+
+#include "tst_qvideosurfacegstsink.moc"
@@ -0,0 +1,8 @@
+CONFIG += no_private_qt_headers_warning testcase
+TARGET = tst_qvideoyuvconverter
+
+QT += multimedia-private multimediawidgets-private testlib
+
+SOURCES += tst_qvideoyuvconverter.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,332 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/multimediawidgets
+
+#include <QtTest/QtTest>
+#include <private/qvideoyuvconverter_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QVideoYuvConverter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rowKernel_data();
+    void rowKernel();
+    void blackAndWhite_data();
+    void blackAndWhite();
+    void planarLayouts_data();
+    void planarLayouts();
+    void packedLayouts();
+    void imageReused();
+};
+
+static const int frameWidth = 38;
+static const int frameHeight = 10;
+
+static uchar lumaAt(int x, int y)
+{
+    return uchar(16 + (x * 7 + y * 13) % 220);
+}
+
+static uchar cbAt(int x, int y)
+{
+    return uchar(20 + (x * 11 + y * 5) % 216);
+}
+
+static uchar crAt(int x, int y)
+{
+    return uchar(30 + (x * 3 + y * 17) % 200);
+}
+
+// Fills a 4:2:0 frame in \a pixelFormat with the pattern above.
+static QVideoFrame planarFrame(QVideoFrame::PixelFormat pixelFormat)
+{
+    const int bytesPerLine = (frameWidth + 3) & ~3;
+    const int chromaBytesPerLine = (bytesPerLine / 2 + 3) & ~3;
+    const int chromaHeight = (frameHeight + 1) / 2;
+
+    QVideoFrame frame(bytesPerLine * frameHeight + 2 * chromaBytesPerLine * chromaHeight,
+                      QSize(frameWidth, frameHeight), bytesPerLine, pixelFormat);
+    if (!frame.map(QAbstractVideoBuffer::WriteOnly))
+        return QVideoFrame();
+
+    uchar *bits = frame.bits();
+    for (int y = 0; y < frameHeight; ++y) {
+        for (int x = 0; x < frameWidth; ++x)
+            bits[y * bytesPerLine + x] = lumaAt(x, y);
+    }
+
+    uchar *chroma = bits + bytesPerLine * frameHeight;
+    for (int y = 0; y < chromaHeight; ++y) {
+        for (int x = 0; x < (frameWidth + 1) / 2; ++x) {
+            switch (pixelFormat) {
+            case QVideoFrame::Format_YUV420P:
+                chroma[y * chromaBytesPerLine + x] = cbAt(x, y);
+                chroma[(chromaHeight + y) * chromaBytesPerLine + x] = crAt(x, y);
+                break;
+            case QVideoFrame::Format_YV12:
+                chroma[y * chromaBytesPerLine + x] = crAt(x, y);
+                chroma[(chromaHeight + y) * chromaBytesPerLine + x] = cbAt(x, y);
+                break;
+            case QVideoFrame::Format_NV12:
+                chroma[y * bytesPerLine + 2 * x] = cbAt(x, y);
+                chroma[y * bytesPerLine + 2 * x + 1] = crAt(x, y);
+                break;
+            case QVideoFrame::Format_NV21:
+                chroma[y * bytesPerLine + 2 * x] = crAt(x, y);
+                chroma[y * bytesPerLine + 2 * x + 1] = cbAt(x, y);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    frame.unmap();
+    return frame;
+}
+
+static QVideoFrame packedFrame(QVideoFrame::PixelFormat pixelFormat)
+{
+    const int bytesPerLine = frameWidth * 2;
+    QVideoFrame frame(bytesPerLine * frameHeight, QSize(frameWidth, frameHeight),
+                      bytesPerLine, pixelFormat);
+    if (!frame.map(QAbstractVideoBuffer::WriteOnly))
+        return QVideoFrame();
+
+    for (int y = 0; y < frameHeight; ++y) {
+        uchar *line = frame.bits() + y * bytesPerLine;
+        for (int x = 0; x < frameWidth / 2; ++x, line += 4) {
+            if (pixelFormat == QVideoFrame::Format_UYVY) {
+                line[0] = cbAt(x, y);
+                line[1] = lumaAt(2 * x, y);
+                line[2] = crAt(x, y);
+                line[3] = lumaAt(2 * x + 1, y);
+            } else {
+                line[0] = lumaAt(2 * x, y);
+                line[1] = cbAt(x, y);
+                line[2] = lumaAt(2 * x + 1, y);
+                line[3] = crAt(x, y);
+            }
+        }
+    }
+    frame.unmap();
+    return frame;
+}
+
+// Converts the pattern with the reference implementation, using chroma row
+// y / 2 for 4:2:0 sampling and chroma row y otherwise.
+static QImage expectedImage(const QYuvToRgbMatrix &matrix, bool verticalSubsampling)
+{
+    QImage image(frameWidth, frameHeight, QImage::Format_RGB32);
+    QVector<uchar> luma(frameWidth);
+    QVector<uchar> cb((frameWidth + 1) / 2);
+    QVector<uchar> cr((frameWidth + 1) / 2);
+
+    for (int y = 0; y < frameHeight; ++y) {
+        const int chromaRow = verticalSubsampling ? y / 2 : y;
+        for (int x = 0; x < frameWidth; ++x)
+            luma[x] = lumaAt(x, y);
+        for (int x = 0; x < cb.size(); ++x) {
+            cb[x] = cbAt(x, chromaRow);
+            cr[x] = crAt(x, chromaRow);
+        }
+        qt_convertYuvRowGeneric(luma.constData(), cb.constData(), cr.constData(),
+                                reinterpret_cast<quint32 *>(image.scanLine(y)), frameWidth, matrix);
+    }
+    return image;
+}
+
+static QImage convertFrame(QVideoYuvConverter *converter, QVideoFrame frame)
+{
+    QImage image;
+    if (frame.map(QAbstractVideoBuffer::ReadOnly)) {
+        if (!converter->convert(frame, &image))
+            image = QImage();
+        frame.unmap();
+    }
+    return image;
+}
+
+void tst_QVideoYuvConverter::rowKernel_data()
+{
+    QTest::addColumn<QVideoSurfaceFormat::YCbCrColorSpace>("colorSpace");
+    QTest::addColumn<int>("brightness");
+    QTest::addColumn<int>("contrast");
+    QTest::addColumn<int>("hue");
+    QTest::addColumn<int>("saturation");
+
+    QTest::newRow("bt601") << QVideoSurfaceFormat::YCbCr_BT601 << 0 << 0 << 0 << 0;
+    QTest::newRow("bt709") << QVideoSurfaceFormat::YCbCr_BT709 << 0 << 0 << 0 << 0;
+    QTest::newRow("jpeg") << QVideoSurfaceFormat::YCbCr_JPEG << 0 << 0 << 0 << 0;
+    QTest::newRow("bt601 adjusted") << QVideoSurfaceFormat::YCbCr_BT601 << 30 << -20 << 45 << 60;
+    QTest::newRow("bt709 extreme") << QVideoSurfaceFormat::YCbCr_BT709 << -100 << 100 << -100 << 100;
+}
+
+void tst_QVideoYuvConverter::rowKernel()
+{
+    QFETCH(QVideoSurfaceFormat::YCbCrColorSpace, colorSpace);
+    QFETCH(int, brightness);
+    QFETCH(int, contrast);
+    QFETCH(int, hue);
+    QFETCH(int, saturation);
+
+    const QYuvToRgbMatrix matrix = QVideoYuvConverter::matrix(
+                colorSpace, brightness, contrast, hue, saturation);
+    const QYuvToRgbRowFunc kernel = qt_selectYuvRowKernel();
+
+    // Cover widths below, at and around the vector sizes so that the scalar
+    // tails are exercised as well.
+    for (int width = 1; width <= 67; ++width) {
+        QVector<uchar> luma(width);
+        QVector<uchar> cb((width + 1) / 2);
+        QVector<uchar> cr((width + 1) / 2);
+        for (int i = 0; i < width; ++i)
+            luma[i] = uchar(qrand());
+        for (int i = 0; i < cb.size(); ++i) {
+            cb[i] = uchar(qrand());
+            cr[i] = uchar(qrand());
+        }
+
+        QVector<quint32> expected(width);
+        QVector<quint32> result(width);
+        qt_convertYuvRowGeneric(luma.constData(), cb.constData(), cr.constData(),
+                                expected.data(), width, matrix);
+        kernel(luma.constData(), cb.constData(), cr.constData(), result.data(), width, matrix);
+
+        QCOMPARE(result, expected);
+    }
+}
+
+void tst_QVideoYuvConverter::blackAndWhite_data()
+{
+    QTest::addColumn<QVideoSurfaceFormat::YCbCrColorSpace>("colorSpace");
+    QTest::addColumn<int>("black");
+    QTest::addColumn<int>("white");
+
+    QTest::newRow("bt601") << QVideoSurfaceFormat::YCbCr_BT601 << 16 << 235;
+    QTest::newRow("bt709") << QVideoSurfaceFormat::YCbCr_BT709 << 16 << 235;
+    QTest::newRow("jpeg") << QVideoSurfaceFormat::YCbCr_JPEG << 0 << 255;
+}
+
+void tst_QVideoYuvConverter::blackAndWhite()
+{
+    QFETCH(QVideoSurfaceFormat::YCbCrColorSpace, colorSpace);
+    QFETCH(int, black);
+    QFETCH(int, white);
+
+    const QYuvToRgbMatrix matrix = QVideoYuvConverter::matrix(colorSpace);
+    const uchar luma[2] = { uchar(black), uchar(white) };
+    const uchar chroma[1] = { 128 };
+    quint32 pixels[2];
+
+    qt_convertYuvRowGeneric(luma, chroma, chroma, pixels, 2, matrix);
+
+    for (int channel = 0; channel < 24; channel += 8) {
+        QVERIFY(qAbs(int((pixels[0] >> channel) & 0xff) - 0) <= 2);
+        QVERIFY(qAbs(int((pixels[1] >> channel) & 0xff) - 255) <= 2);
+    }
+    QCOMPARE(pixels[0] >> 24, 0xffu);
+    QCOMPARE(pixels[1] >> 24, 0xffu);
+}
+
+void tst_QVideoYuvConverter::planarLayouts_data()
+{
+    QTest::addColumn<QVideoFrame::PixelFormat>("pixelFormat");
+
+    QTest::newRow("YUV420P") << QVideoFrame::Format_YUV420P;
+    QTest::newRow("YV12") << QVideoFrame::Format_YV12;
+    QTest::newRow("NV12") << QVideoFrame::Format_NV12;
+    QTest::newRow("NV21") << QVideoFrame::Format_NV21;
+}
+
+void tst_QVideoYuvConverter::planarLayouts()
+{
+    QFETCH(QVideoFrame::PixelFormat, pixelFormat);
+
+    QVERIFY(QVideoYuvConverter::canConvert(pixelFormat));
+
+    QVideoYuvConverter converter;
+    converter.setMatrix(QVideoYuvConverter::matrix(QVideoSurfaceFormat::YCbCr_BT601));
+
+    const QVideoFrame frame = planarFrame(pixelFormat);
+    QVERIFY(frame.isValid());
+
+    const QImage image = convertFrame(&converter, frame);
+    QCOMPARE(image.format(), QImage::Format_RGB32);
+    QCOMPARE(image, expectedImage(converter.matrix(), true));
+}
+
+void tst_QVideoYuvConverter::packedLayouts()
+{
+    QVideoYuvConverter converter;
+    converter.setMatrix(QVideoYuvConverter::matrix(QVideoSurfaceFormat::YCbCr_BT709, 10, 10, 10, 10));
+
+    const QImage expected = expectedImage(converter.matrix(), false);
+
+    QCOMPARE(convertFrame(&converter, packedFrame(QVideoFrame::Format_UYVY)), expected);
+    QCOMPARE(convertFrame(&converter, packedFrame(QVideoFrame::Format_YUYV)), expected);
+}
+
+void tst_QVideoYuvConverter::imageReused()
+{
+    QVideoYuvConverter converter;
+
+    QVideoFrame frame = planarFrame(QVideoFrame::Format_YUV420P);
+    QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+
+    QImage image;
+    QVERIFY(converter.convert(frame, &image));
+    const uchar *bits = image.constBits();
+    QVERIFY(converter.convert(frame, &image));
+    QCOMPARE(image.constBits(), bits);
+
+    frame.unmap();
+
+    QVERIFY(!QVideoYuvConverter::canConvert(QVideoFrame::Format_RGB32));
+    QVERIFY(!QVideoYuvConverter::canConvert(QVideoFrame::Format_Y8));
+}
+
+QTEST_MAIN(tst_QVideoYuvConverter)
+
+#include "tst_qvideoyuvconverter.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+SUBDIRS += \
+    qaudiobuffer \
+    qaudiohelpers \
+    qmediaplaylist \
+    qmediatimerange \
+    qsamplecache \
+    qvideoframe \
+    qwavedecoder
@@ -0,0 +1,8 @@
+CONFIG += release
+TARGET = tst_bench_qaudiobuffer
+
+QT += multimedia testlib
+
+SOURCES += tst_bench_qaudiobuffer.cpp
+
+include (../../../auto/unit/qmultimedia_common/pcmformat.pri)
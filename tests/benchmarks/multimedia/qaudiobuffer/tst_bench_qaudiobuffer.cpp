@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <qaudiobuffer.h>
+#include "pcmformat.h"
+
+class tst_QAudioBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromData_data();
+    void fromData();
+    void fromFrameCount_data();
+    void fromFrameCount();
+    void copy_data();
+    void copy();
+};
+
+Q_DECLARE_METATYPE(QAudioFormat::SampleType)
+
+static void addBufferRows()
+{
+    QTest::addColumn<int>("sampleSize");
+    QTest::addColumn<QAudioFormat::SampleType>("sampleType");
+    QTest::addColumn<int>("frameCount");
+
+    QTest::newRow("s16, 1024 frames") << 16 << QAudioFormat::SignedInt << 1024;
+    QTest::newRow("s16, 1s") << 16 << QAudioFormat::SignedInt << 48000;
+    QTest::newRow("float, 1024 frames") << 32 << QAudioFormat::Float << 1024;
+    QTest::newRow("float, 1s") << 32 << QAudioFormat::Float << 48000;
+}
+
+void tst_QAudioBuffer::fromData_data()
+{
+    addBufferRows();
+}
+
+void tst_QAudioBuffer::fromData()
+{
+    QFETCH(int, sampleSize);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(int, frameCount);
+
+    const QAudioFormat format = pcmFormat(48000, sampleSize, sampleType);
+    const QByteArray data(format.bytesForFrames(frameCount), '\0');
+
+    QBENCHMARK {
+        QAudioBuffer buffer(data, format);
+        QCOMPARE(buffer.frameCount(), frameCount);
+    }
+}
+
+void tst_QAudioBuffer::fromFrameCount_data()
+{
+    addBufferRows();
+}
+
+void tst_QAudioBuffer::fromFrameCount()
+{
+    QFETCH(int, sampleSize);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(int, frameCount);
+
+    const QAudioFormat format = pcmFormat(48000, sampleSize, sampleType);
+
+    QBENCHMARK {
+        QAudioBuffer buffer(frameCount, format);
+        QCOMPARE(buffer.frameCount(), frameCount);
+    }
+}
+
+void tst_QAudioBuffer::copy_data()
+{
+    addBufferRows();
+}
+
+void tst_QAudioBuffer::copy()
+{
+    QFETCH(int, sampleSize);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(int, frameCount);
+
+    const QAudioFormat format = pcmFormat(48000, sampleSize, sampleType);
+    const QAudioBuffer buffer(frameCount, format);
+
+    // Writing to a copy detaches it from the original
+    QBENCHMARK {
+        QAudioBuffer other(buffer);
+        static_cast<char *>(other.data())[0] = 1;
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QAudioBuffer)
+
+#include "tst_bench_qaudiobuffer.moc"
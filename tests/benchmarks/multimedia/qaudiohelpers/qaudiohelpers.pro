@@ -0,0 +1,8 @@
+CONFIG += no_private_qt_headers_warning release
+TARGET = tst_bench_qaudiohelpers
+
+QT += multimedia-private testlib
+
+SOURCES += tst_bench_qaudiohelpers.cpp
+
+include (../../../auto/unit/qmultimedia_common/pcmformat.pri)
@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <private/qaudiohelpers_p.h>
+#include "pcmformat.h"
+
+class tst_QAudioHelpers : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void multiplySamples_data();
+    void multiplySamples();
+    void multiplySamplesGeneric_data();
+    void multiplySamplesGeneric();
+};
+
+Q_DECLARE_METATYPE(QAudioFormat::SampleType)
+
+// One second of stereo audio at 48kHz
+static const int sampleCount = 2 * 48000;
+
+static QByteArray makeSamples(const QAudioFormat &format)
+{
+    QByteArray data(sampleCount * format.sampleSize() / 8, Qt::Uninitialized);
+    if (format.sampleType() == QAudioFormat::Float) {
+        float *p = reinterpret_cast<float *>(data.data());
+        for (int i = 0; i < sampleCount; ++i)
+            p[i] = float(qrand() % 20001 - 10000) / 10000.0f;
+    } else {
+        for (int i = 0; i < data.size(); ++i)
+            data[i] = char(qrand());
+    }
+    return data;
+}
+
+static void addFormatRows()
+{
+    QTest::addColumn<int>("sampleSize");
+    QTest::addColumn<QAudioFormat::SampleType>("sampleType");
+    QTest::addColumn<qreal>("factor");
+
+    QTest::newRow("s8") << 8 << QAudioFormat::SignedInt << qreal(0.5);
+    QTest::newRow("u8") << 8 << QAudioFormat::UnSignedInt << qreal(0.5);
+    QTest::newRow("s16") << 16 << QAudioFormat::SignedInt << qreal(0.5);
+    QTest::newRow("u16") << 16 << QAudioFormat::UnSignedInt << qreal(0.5);
+    QTest::newRow("s32") << 32 << QAudioFormat::SignedInt << qreal(0.5);
+    QTest::newRow("u32") << 32 << QAudioFormat::UnSignedInt << qreal(0.5);
+    QTest::newRow("float") << 32 << QAudioFormat::Float << qreal(0.5);
+    QTest::newRow("s16 unity") << 16 << QAudioFormat::SignedInt << qreal(1.0);
+    QTest::newRow("s16 mute") << 16 << QAudioFormat::SignedInt << qreal(0.0);
+}
+
+void tst_QAudioHelpers::multiplySamples_data()
+{
+    addFormatRows();
+}
+
+void tst_QAudioHelpers::multiplySamples()
+{
+    QFETCH(int, sampleSize);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(qreal, factor);
+
+    const QAudioFormat format = pcmFormat(48000, sampleSize, sampleType);
+    const QByteArray src = makeSamples(format);
+    QByteArray dest(src.size(), Qt::Uninitialized);
+
+    QBENCHMARK {
+        QAudioHelperInternal::qMultiplySamples(factor, format, src.constData(), dest.data(), src.size());
+    }
+}
+
+void tst_QAudioHelpers::multiplySamplesGeneric_data()
+{
+    addFormatRows();
+}
+
+void tst_QAudioHelpers::multiplySamplesGeneric()
+{
+    QFETCH(int, sampleSize);
+    QFETCH(QAudioFormat::SampleType, sampleType);
+    QFETCH(qreal, factor);
+
+    const QAudioFormat format = pcmFormat(48000, sampleSize, sampleType);
+    const QByteArray src = makeSamples(format);
+    QByteArray dest(src.size(), Qt::Uninitialized);
+
+    QBENCHMARK {
+        QAudioHelperInternal::qMultiplySamplesGeneric(factor, format, src.constData(), dest.data(), src.size());
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QAudioHelpers)
+
+#include "tst_bench_qaudiohelpers.moc"
@@ -0,0 +1,6 @@
+CONFIG += release
+TARGET = tst_bench_qmediaplaylist
+
+QT += multimedia testlib
+
+SOURCES += tst_bench_qmediaplaylist.cpp
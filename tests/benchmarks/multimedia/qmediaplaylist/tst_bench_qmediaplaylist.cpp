@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <qmediaplaylist.h>
+
+class tst_QMediaPlaylist : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void addMedia();
+    void addMediaList();
+    void insertMedia();
+    void removeMedia();
+    void removeMediaRange();
+    void shuffle();
+    void next();
+
+private:
+    QList<QMediaContent> m_items;
+};
+
+static const int itemCount = 100000;
+
+void tst_QMediaPlaylist::initTestCase()
+{
+    for (int i = 0; i < itemCount; ++i)
+        m_items << QMediaContent(QUrl(QString::fromLatin1("file:///music/track%1.ogg").arg(i)));
+}
+
+void tst_QMediaPlaylist::addMedia()
+{
+    QBENCHMARK {
+        QMediaPlaylist playlist;
+        foreach (const QMediaContent &item, m_items)
+            playlist.addMedia(item);
+        QCOMPARE(playlist.mediaCount(), itemCount);
+    }
+}
+
+void tst_QMediaPlaylist::addMediaList()
+{
+    QBENCHMARK {
+        QMediaPlaylist playlist;
+        playlist.addMedia(m_items);
+        QCOMPARE(playlist.mediaCount(), itemCount);
+    }
+}
+
+void tst_QMediaPlaylist::insertMedia()
+{
+    QBENCHMARK {
+        QMediaPlaylist playlist;
+        foreach (const QMediaContent &item, m_items)
+            playlist.insertMedia(0, item);
+        QCOMPARE(playlist.mediaCount(), itemCount);
+    }
+}
+
+void tst_QMediaPlaylist::removeMedia()
+{
+    QMediaPlaylist playlist;
+
+    QBENCHMARK {
+        playlist.addMedia(m_items);
+        playlist.setCurrentIndex(itemCount / 2);
+        while (!playlist.isEmpty())
+            playlist.removeMedia(0);
+    }
+}
+
+void tst_QMediaPlaylist::removeMediaRange()
+{
+    QMediaPlaylist playlist;
+
+    QBENCHMARK {
+        playlist.addMedia(m_items);
+        playlist.removeMedia(itemCount / 4, itemCount * 3 / 4 - 1);
+        playlist.clear();
+    }
+}
+
+void tst_QMediaPlaylist::shuffle()
+{
+    QMediaPlaylist playlist;
+    playlist.addMedia(m_items);
+    playlist.setCurrentIndex(0);
+
+    QBENCHMARK {
+        playlist.shuffle();
+    }
+}
+
+void tst_QMediaPlaylist::next()
+{
+    QMediaPlaylist playlist;
+    playlist.addMedia(m_items);
+    playlist.setPlaybackMode(QMediaPlaylist::Sequential);
+
+    QBENCHMARK {
+        playlist.setCurrentIndex(0);
+        for (int i = 0; i < 1000; ++i)
+            playlist.next();
+    }
+}
+
+QTEST_MAIN(tst_QMediaPlaylist)
+
+#include "tst_bench_qmediaplaylist.moc"
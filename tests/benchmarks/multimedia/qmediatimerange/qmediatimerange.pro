@@ -0,0 +1,6 @@
+CONFIG += release
+TARGET = tst_bench_qmediatimerange
+
+QT += multimedia testlib
+
+SOURCES += tst_bench_qmediatimerange.cpp
@@ -0,0 +1,218 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <qmediatimerange.h>
+
+class tst_QMediaTimeRange : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addInterval_data();
+    void addInterval();
+    void addIntervals_data();
+    void addIntervals();
+    void addTimeRange_data();
+    void addTimeRange();
+    void removeInterval_data();
+    void removeInterval();
+    void contains_data();
+    void contains();
+    void addAndContains_data();
+    void addAndContains();
+};
+
+// Disjoint intervals of 5ms every 10ms, in random order
+static QList<QMediaTimeInterval> makeFragments(int count)
+{
+    QList<QMediaTimeInterval> intervals;
+    for (int i = 0; i < count; ++i)
+        intervals << QMediaTimeInterval(i * 10, i * 10 + 4);
+
+    qsrand(count);
+    for (int i = count - 1; i > 0; --i)
+        intervals.swap(i, qrand() % (i + 1));
+
+    return intervals;
+}
+
+static QMediaTimeRange makeRange(int count)
+{
+    QMediaTimeRange range;
+    range.addIntervals(makeFragments(count));
+    return range;
+}
+
+static void addCountRows()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void tst_QMediaTimeRange::addInterval_data()
+{
+    addCountRows();
+}
+
+void tst_QMediaTimeRange::addInterval()
+{
+    QFETCH(int, count);
+
+    const QList<QMediaTimeInterval> intervals = makeFragments(count);
+
+    QBENCHMARK {
+        QMediaTimeRange range;
+        foreach (const QMediaTimeInterval &interval, intervals)
+            range.addInterval(interval);
+    }
+}
+
+void tst_QMediaTimeRange::addIntervals_data()
+{
+    addCountRows();
+}
+
+void tst_QMediaTimeRange::addIntervals()
+{
+    QFETCH(int, count);
+
+    const QList<QMediaTimeInterval> intervals = makeFragments(count);
+
+    QBENCHMARK {
+        QMediaTimeRange range;
+        range.addIntervals(intervals);
+    }
+}
+
+void tst_QMediaTimeRange::addTimeRange_data()
+{
+    addCountRows();
+}
+
+void tst_QMediaTimeRange::addTimeRange()
+{
+    QFETCH(int, count);
+
+    const QMediaTimeRange range = makeRange(count);
+
+    // Fills the gaps of range
+    QMediaTimeRange gaps;
+    for (int i = 0; i < count; ++i)
+        gaps.addInterval(i * 10 + 5, i * 10 + 9);
+
+    QBENCHMARK {
+        QMediaTimeRange merged(range);
+        merged.addTimeRange(gaps);
+    }
+}
+
+void tst_QMediaTimeRange::removeInterval_data()
+{
+    addCountRows();
+}
+
+void tst_QMediaTimeRange::removeInterval()
+{
+    QFETCH(int, count);
+
+    const QMediaTimeRange range = makeRange(count);
+    const QList<QMediaTimeInterval> intervals = makeFragments(count);
+
+    QBENCHMARK {
+        QMediaTimeRange remaining(range);
+        foreach (const QMediaTimeInterval &interval, intervals)
+            remaining.removeInterval(interval.start() + 1, interval.end() - 1);
+    }
+}
+
+void tst_QMediaTimeRange::contains_data()
+{
+    addCountRows();
+}
+
+void tst_QMediaTimeRange::contains()
+{
+    QFETCH(int, count);
+
+    const QMediaTimeRange range = makeRange(count);
+    const qint64 end = qint64(count) * 10;
+
+    QBENCHMARK {
+        int hits = 0;
+        for (qint64 time = 0; time < end; time += 7)
+            hits += range.contains(time);
+        QVERIFY(hits > 0);
+    }
+}
+
+void tst_QMediaTimeRange::addAndContains_data()
+{
+    addCountRows();
+}
+
+// Buffering progress: each new fragment is followed by a lookup, as a
+// player does when it checks whether the playback position is buffered
+void tst_QMediaTimeRange::addAndContains()
+{
+    QFETCH(int, count);
+
+    const QList<QMediaTimeInterval> intervals = makeFragments(count);
+
+    QBENCHMARK {
+        QMediaTimeRange range;
+        int hits = 0;
+        foreach (const QMediaTimeInterval &interval, intervals) {
+            range.addInterval(interval);
+            hits += range.contains(interval.start() + 2);
+        }
+        QCOMPARE(hits, count);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QMediaTimeRange)
+
+#include "tst_bench_qmediatimerange.moc"
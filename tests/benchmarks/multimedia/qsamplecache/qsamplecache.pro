@@ -0,0 +1,6 @@
+CONFIG += no_private_qt_headers_warning release
+TARGET = tst_bench_qsamplecache
+
+QT += multimedia-private testlib
+
+SOURCES += tst_bench_qsamplecache.cpp
@@ -0,0 +1,188 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <private/qsamplecache_p.h>
+
+#include <QtCore/qendian.h>
+#include <QtCore/qtemporarydir.h>
+
+class tst_QSampleCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void requestUncached();
+    void requestCached();
+    void evict();
+
+private:
+    QUrl writeSample(const QString &fileName, int dataSize);
+
+    QTemporaryDir m_dir;
+    QUrl m_first;
+    QUrl m_second;
+    int m_sampleSize;
+};
+
+static bool waitForSample(QSample *sample)
+{
+    QEventLoop loop;
+    QObject::connect(sample, SIGNAL(ready()), &loop, SLOT(quit()));
+    QObject::connect(sample, SIGNAL(error()), &loop, SLOT(quit()));
+    if (sample->state() != QSample::Ready && sample->state() != QSample::Error)
+        loop.exec();
+    return sample->state() == QSample::Ready;
+}
+
+static void waitForIdle(QSampleCache *cache)
+{
+    while (cache->isLoading())
+        QTest::qWait(1);
+}
+
+QUrl tst_QSampleCache::writeSample(const QString &fileName, int dataSize)
+{
+    // 16 bit stereo 44.1kHz
+    struct {
+        char riff[4];
+        quint32 riffSize;
+        char wave[4];
+        char fmt[4];
+        quint32 fmtSize;
+        quint16 audioFormat;
+        quint16 numChannels;
+        quint32 sampleRate;
+        quint32 byteRate;
+        quint16 blockAlign;
+        quint16 bitsPerSample;
+        char data[4];
+        quint32 dataSize;
+    } header = {
+        { 'R', 'I', 'F', 'F' }, qToLittleEndian<quint32>(36 + dataSize),
+        { 'W', 'A', 'V', 'E' },
+        { 'f', 'm', 't', ' ' }, qToLittleEndian<quint32>(16),
+        qToLittleEndian<quint16>(1), qToLittleEndian<quint16>(2),
+        qToLittleEndian<quint32>(44100), qToLittleEndian<quint32>(44100 * 4),
+        qToLittleEndian<quint16>(4), qToLittleEndian<quint16>(16),
+        { 'd', 'a', 't', 'a' }, qToLittleEndian<quint32>(dataSize)
+    };
+    Q_STATIC_ASSERT(sizeof(header) == 44);
+
+    QFile file(m_dir.path() + QLatin1Char('/') + fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return QUrl();
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(QByteArray(dataSize, '\0'));
+    return QUrl::fromLocalFile(file.fileName());
+}
+
+void tst_QSampleCache::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    // One second each, about the size of a typical sound effect
+    m_sampleSize = 44100 * 4;
+    m_first = writeSample(QLatin1String("first.wav"), m_sampleSize);
+    m_second = writeSample(QLatin1String("second.wav"), m_sampleSize);
+    QVERIFY(m_first.isValid());
+    QVERIFY(m_second.isValid());
+}
+
+void tst_QSampleCache::requestUncached()
+{
+    // Without a capacity samples are dropped as soon as they are released
+    QSampleCache cache;
+
+    QBENCHMARK {
+        QSample *sample = cache.requestSample(m_first);
+        QVERIFY(waitForSample(sample));
+        sample->release();
+    }
+
+    waitForIdle(&cache);
+}
+
+void tst_QSampleCache::requestCached()
+{
+    QSampleCache cache;
+    cache.setCapacity(m_sampleSize * 4);
+
+    QSample *sample = cache.requestSample(m_first);
+    QVERIFY(waitForSample(sample));
+    sample->release();
+    QVERIFY(cache.isCached(m_first));
+
+    QBENCHMARK {
+        sample = cache.requestSample(m_first);
+        QVERIFY(waitForSample(sample));
+        sample->release();
+    }
+
+    waitForIdle(&cache);
+}
+
+void tst_QSampleCache::evict()
+{
+    // Only one of the samples fits, so each request evicts the other one
+    QSampleCache cache;
+    cache.setCapacity(m_sampleSize + m_sampleSize / 2);
+
+    QBENCHMARK {
+        QSample *sample = cache.requestSample(m_first);
+        QVERIFY(waitForSample(sample));
+        sample->release();
+
+        sample = cache.requestSample(m_second);
+        QVERIFY(waitForSample(sample));
+        sample->release();
+    }
+
+    QVERIFY(!cache.isCached(m_first));
+    waitForIdle(&cache);
+}
+
+QTEST_MAIN(tst_QSampleCache)
+
+#include "tst_bench_qsamplecache.moc"
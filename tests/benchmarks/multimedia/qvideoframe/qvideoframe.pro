@@ -0,0 +1,6 @@
+CONFIG += release
+TARGET = tst_bench_qvideoframe
+
+QT += multimedia testlib
+
+SOURCES += tst_bench_qvideoframe.cpp
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <qvideoframe.h>
+
+class tst_QVideoFrame : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void map_data();
+    void map();
+    void copy_data();
+    void copy();
+    void copyPixels_data();
+    void copyPixels();
+};
+
+Q_DECLARE_METATYPE(QVideoFrame::PixelFormat)
+Q_DECLARE_METATYPE(QAbstractVideoBuffer::MapMode)
+
+static int frameBytes(QVideoFrame::PixelFormat format, const QSize &size, int *bytesPerLine)
+{
+    switch (format) {
+    case QVideoFrame::Format_YUV420P:
+    case QVideoFrame::Format_NV12:
+        *bytesPerLine = size.width();
+        return size.width() * size.height() * 3 / 2;
+    case QVideoFrame::Format_UYVY:
+        *bytesPerLine = size.width() * 2;
+        return *bytesPerLine * size.height();
+    default:
+        *bytesPerLine = size.width() * 4;
+        return *bytesPerLine * size.height();
+    }
+}
+
+static QVideoFrame makeFrame(QVideoFrame::PixelFormat format, const QSize &size)
+{
+    int bytesPerLine = 0;
+    const int bytes = frameBytes(format, size, &bytesPerLine);
+    return QVideoFrame(bytes, size, bytesPerLine, format);
+}
+
+static void addFrameRows()
+{
+    QTest::addColumn<QVideoFrame::PixelFormat>("pixelFormat");
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("ARGB32 640x480") << QVideoFrame::Format_ARGB32 << QSize(640, 480);
+    QTest::newRow("ARGB32 1920x1080") << QVideoFrame::Format_ARGB32 << QSize(1920, 1080);
+    QTest::newRow("UYVY 1920x1080") << QVideoFrame::Format_UYVY << QSize(1920, 1080);
+    QTest::newRow("YUV420P 1920x1080") << QVideoFrame::Format_YUV420P << QSize(1920, 1080);
+    QTest::newRow("NV12 1920x1080") << QVideoFrame::Format_NV12 << QSize(1920, 1080);
+}
+
+void tst_QVideoFrame::map_data()
+{
+    QTest::addColumn<QVideoFrame::PixelFormat>("pixelFormat");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<QAbstractVideoBuffer::MapMode>("mode");
+
+    QTest::newRow("ARGB32 1920x1080 read") << QVideoFrame::Format_ARGB32 << QSize(1920, 1080)
+                                           << QAbstractVideoBuffer::ReadOnly;
+    QTest::newRow("ARGB32 1920x1080 read/write") << QVideoFrame::Format_ARGB32 << QSize(1920, 1080)
+                                                 << QAbstractVideoBuffer::ReadWrite;
+    QTest::newRow("YUV420P 1920x1080 read") << QVideoFrame::Format_YUV420P << QSize(1920, 1080)
+                                            << QAbstractVideoBuffer::ReadOnly;
+    QTest::newRow("NV12 1920x1080 read") << QVideoFrame::Format_NV12 << QSize(1920, 1080)
+                                         << QAbstractVideoBuffer::ReadOnly;
+}
+
+void tst_QVideoFrame::map()
+{
+    QFETCH(QVideoFrame::PixelFormat, pixelFormat);
+    QFETCH(QSize, size);
+    QFETCH(QAbstractVideoBuffer::MapMode, mode);
+
+    QVideoFrame frame = makeFrame(pixelFormat, size);
+
+    QBENCHMARK {
+        frame.map(mode);
+        for (int plane = 0; plane < frame.planeCount(); ++plane)
+            frame.bits(plane);
+        frame.unmap();
+    }
+}
+
+void tst_QVideoFrame::copy_data()
+{
+    addFrameRows();
+}
+
+void tst_QVideoFrame::copy()
+{
+    QFETCH(QVideoFrame::PixelFormat, pixelFormat);
+    QFETCH(QSize, size);
+
+    QVideoFrame frame = makeFrame(pixelFormat, size);
+
+    // Frames are passed around by value, this must not touch the pixels
+    QBENCHMARK {
+        QVideoFrame other(frame);
+        Q_UNUSED(other);
+    }
+}
+
+void tst_QVideoFrame::copyPixels_data()
+{
+    addFrameRows();
+}
+
+void tst_QVideoFrame::copyPixels()
+{
+    QFETCH(QVideoFrame::PixelFormat, pixelFormat);
+    QFETCH(QSize, size);
+
+    QVideoFrame frame = makeFrame(pixelFormat, size);
+    QVideoFrame target = makeFrame(pixelFormat, size);
+
+    QBENCHMARK {
+        QVERIFY(frame.map(QAbstractVideoBuffer::ReadOnly));
+        QVERIFY(target.map(QAbstractVideoBuffer::WriteOnly));
+        memcpy(target.bits(), frame.bits(), frame.mappedBytes());
+        target.unmap();
+        frame.unmap();
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QVideoFrame)
+
+#include "tst_bench_qvideoframe.moc"
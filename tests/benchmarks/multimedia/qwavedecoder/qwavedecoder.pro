@@ -0,0 +1,7 @@
+CONFIG += no_private_qt_headers_warning release
+TARGET = tst_bench_qwavedecoder
+HEADERS += ../../../../src/multimedia/audio/qwavedecoder_p.h
+SOURCES += tst_bench_qwavedecoder.cpp \
+           ../../../../src/multimedia/audio/qwavedecoder_p.cpp
+
+QT += multimedia-private testlib
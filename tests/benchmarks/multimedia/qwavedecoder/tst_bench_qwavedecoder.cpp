@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <private/qwavedecoder_p.h>
+
+#include <QtCore/qbuffer.h>
+#include <QtCore/qendian.h>
+
+class tst_QWaveDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseHeader_data();
+    void parseHeader();
+    void readAll_data();
+    void readAll();
+};
+
+static void appendChunkHeader(QByteArray &wav, const char *id, quint32 size)
+{
+    char buffer[4];
+    wav.append(id, 4);
+    qToLittleEndian<quint32>(size, reinterpret_cast<uchar *>(buffer));
+    wav.append(buffer, 4);
+}
+
+static void appendValue16(QByteArray &wav, quint16 value)
+{
+    char buffer[2];
+    qToLittleEndian<quint16>(value, reinterpret_cast<uchar *>(buffer));
+    wav.append(buffer, 2);
+}
+
+static void appendValue32(QByteArray &wav, quint32 value)
+{
+    char buffer[4];
+    qToLittleEndian<quint32>(value, reinterpret_cast<uchar *>(buffer));
+    wav.append(buffer, 4);
+}
+
+// Builds a 16 bit stereo 44.1kHz little endian wave file, optionally with
+// an unknown chunk the decoder has to skip before the data chunk.
+static QByteArray makeWave(int dataSize, int junkSize)
+{
+    QByteArray wav;
+    const int junkChunkSize = junkSize > 0 ? 8 + junkSize : 0;
+    appendChunkHeader(wav, "RIFF", 4 + 8 + 16 + junkChunkSize + 8 + dataSize);
+    wav.append("WAVE", 4);
+
+    appendChunkHeader(wav, "fmt ", 16);
+    appendValue16(wav, 1);                  // PCM
+    appendValue16(wav, 2);                  // channels
+    appendValue32(wav, 44100);              // sample rate
+    appendValue32(wav, 44100 * 2 * 2);      // byte rate
+    appendValue16(wav, 2 * 2);              // block align
+    appendValue16(wav, 16);                 // bits per sample
+
+    if (junkSize > 0) {
+        appendChunkHeader(wav, "LIST", junkSize);
+        wav.append(QByteArray(junkSize, 'x'));
+    }
+
+    appendChunkHeader(wav, "data", dataSize);
+    wav.append(QByteArray(dataSize, '\0'));
+    return wav;
+}
+
+void tst_QWaveDecoder::parseHeader_data()
+{
+    QTest::addColumn<int>("junkSize");
+
+    QTest::newRow("plain") << 0;
+    QTest::newRow("junk 64KiB") << 64 * 1024;
+}
+
+void tst_QWaveDecoder::parseHeader()
+{
+    QFETCH(int, junkSize);
+
+    QByteArray wav = makeWave(4096, junkSize);
+
+    QBENCHMARK {
+        QBuffer buffer(&wav);
+        buffer.open(QIODevice::ReadOnly);
+
+        QWaveDecoder decoder(&buffer);
+        QSignalSpy spy(&decoder, SIGNAL(formatKnown()));
+        QVERIFY(spy.wait());
+    }
+}
+
+void tst_QWaveDecoder::readAll_data()
+{
+    QTest::addColumn<int>("dataSize");
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("1MiB, 4KiB reads") << 1024 * 1024 << 4096;
+    QTest::newRow("1MiB, 64KiB reads") << 1024 * 1024 << 64 * 1024;
+    QTest::newRow("16MiB, 64KiB reads") << 16 * 1024 * 1024 << 64 * 1024;
+}
+
+void tst_QWaveDecoder::readAll()
+{
+    QFETCH(int, dataSize);
+    QFETCH(int, chunkSize);
+
+    QByteArray wav = makeWave(dataSize, 0);
+    QByteArray chunk(chunkSize, Qt::Uninitialized);
+
+    QBENCHMARK {
+        QBuffer buffer(&wav);
+        buffer.open(QIODevice::ReadOnly);
+
+        QWaveDecoder decoder(&buffer);
+        QSignalSpy spy(&decoder, SIGNAL(formatKnown()));
+        QVERIFY(spy.wait());
+
+        qint64 total = 0;
+        qint64 read;
+        while ((read = decoder.read(chunk.data(), chunkSize)) > 0)
+            total += read;
+        QCOMPARE(total, qint64(dataSize));
+    }
+}
+
+QTEST_MAIN(tst_QWaveDecoder)
+
+#include "tst_bench_qwavedecoder.moc"
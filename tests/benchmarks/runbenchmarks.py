@@ -0,0 +1,222 @@
+#! /usr/bin/env python
+#############################################################################
+##
+## Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+## Contact: http://www.qt-project.org/legal
+##
+## This file is part of the build configuration tools of the Qt Toolkit.
+##
+## $QT_BEGIN_LICENSE:LGPL$
+## Commercial License Usage
+## Licensees holding valid commercial Qt licenses may use this file in
+## accordance with the commercial license agreement provided with the
+## Software or, alternatively, in accordance with the terms contained in
+## a written agreement between you and Digia.  For licensing terms and
+## conditions see http://qt.digia.com/licensing.  For further information
+## use the contact form at http://qt.digia.com/contact-us.
+##
+## GNU Lesser General Public License Usage
+## Alternatively, this file may be used under the terms of the GNU Lesser
+## General Public License version 2.1 as published by the Free Software
+## Foundation and appearing in the file LICENSE.LGPL included in the
+## packaging of this file.  Please review the following information to
+## ensure the GNU Lesser General Public License version 2.1 requirements
+## will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+##
+## In addition, as a special exception, Digia gives you certain additional
+## rights.  These rights are described in the Digia Qt LGPL Exception
+## version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+##
+## GNU General Public License Usage
+## Alternatively, this file may be used under the terms of the GNU
+## General Public License version 3.0 as published by the Free Software
+## Foundation and appearing in the file LICENSE.GPL included in the
+## packaging of this file.  Please review the following information to
+## ensure the GNU General Public License version 3.0 requirements will be
+## met: http://www.gnu.org/copyleft/gpl.html.
+##
+##
+## $QT_END_LICENSE$
+##
+#############################################################################
+
+
+from __future__ import print_function
+
+import csv
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+import xml.etree.ElementTree as ElementTree
+from optparse import OptionParser
+
+usage = """%prog [options] [builddir]
+
+Runs every tst_bench_* executable found below builddir (the current directory
+by default) and writes the results as CSV, one row per benchmark data row:
+
+    benchmark,function,tag,metric,value,iterations
+
+The rows are sorted, so the output of two builds can be compared with diff or
+with the --compare option, which reports the relative change of each value
+against a previous result file."""
+
+fields = ["benchmark", "function", "tag", "metric", "value", "iterations"]
+
+
+def findBenchmarks(root):
+    benchmarks = []
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            name, ext = os.path.splitext(filename)
+            if not name.startswith("tst_bench_"):
+                continue
+            path = os.path.join(dirpath, filename)
+            if os.name == "nt":
+                if ext == ".exe":
+                    benchmarks.append((name, path))
+            elif ext == "" and os.access(path, os.X_OK):
+                benchmarks.append((name, path))
+        # OS X application bundles
+        for dirname in dirnames:
+            m = re.match("^(tst_bench_\w+)\.app$", dirname)
+            if m:
+                path = os.path.join(dirpath, dirname, "Contents", "MacOS", m.group(1))
+                if os.access(path, os.X_OK):
+                    benchmarks.append((m.group(1), path))
+    return benchmarks
+
+
+def runBenchmark(name, path, args):
+    """Runs one benchmark and returns its result rows and whether it passed."""
+    handle, logFile = tempfile.mkstemp(suffix=".xml", prefix=name + "-")
+    os.close(handle)
+    try:
+        command = [path, "-o", logFile + ",xml"] + args
+        print("Running %s" % name, file=sys.stderr)
+        try:
+            returnCode = subprocess.call(command, cwd=os.path.dirname(path))
+        except OSError as e:
+            print("Could not run %s: %s" % (path, e.strerror), file=sys.stderr)
+            return [], False
+
+        if returnCode < 0:
+            print("%s exited with signal %d" % (name, -returnCode), file=sys.stderr)
+
+        try:
+            tree = ElementTree.parse(logFile)
+        except (ElementTree.ParseError, IOError):
+            print("%s did not write a valid result file" % name, file=sys.stderr)
+            return [], False
+    finally:
+        os.remove(logFile)
+
+    rows = []
+    passed = returnCode == 0
+    for function in tree.getroot().iter("TestFunction"):
+        for result in function.iter("BenchmarkResult"):
+            rows.append({
+                "benchmark": name,
+                "function": function.get("name"),
+                "tag": result.get("tag", ""),
+                "metric": result.get("metric"),
+                "value": result.get("value"),
+                "iterations": result.get("iterations"),
+            })
+        for incident in function.iter("Incident"):
+            if incident.get("type") in ("fail", "xpass"):
+                passed = False
+    return rows, passed
+
+
+def rowKey(row):
+    return (row["benchmark"], row["function"], row["tag"], row["metric"])
+
+
+def readResults(fileName):
+    with open(fileName) as f:
+        return dict((rowKey(row), row) for row in csv.DictReader(f))
+
+
+def compareResults(baseline, rows, threshold):
+    """Prints the change of each value and returns the number of regressions."""
+    regressions = 0
+    for row in rows:
+        old = baseline.get(rowKey(row))
+        if old is None:
+            continue
+        oldValue = float(old["value"])
+        newValue = float(row["value"])
+        if oldValue == 0:
+            continue
+        change = (newValue - oldValue) * 100.0 / oldValue
+        # All the metrics testlib reports are costs, so larger is worse
+        marker = ""
+        if change > threshold:
+            marker = " REGRESSION"
+            regressions += 1
+        elif change < -threshold:
+            marker = " improvement"
+        print("%s::%s(%s) %s: %g -> %g (%+.1f%%)%s"
+              % (row["benchmark"], row["function"], row["tag"], row["metric"],
+                 oldValue, newValue, change, marker), file=sys.stderr)
+    return regressions
+
+
+def main():
+    parser = OptionParser(usage=usage)
+    parser.add_option("-o", "--output", dest="output",
+                      help="write the results to FILE instead of standard output", metavar="FILE")
+    parser.add_option("-a", "--args", dest="args", default="",
+                      help="pass ARGS to every benchmark, for example \"-callgrind\" or \"-tickcounter\"",
+                      metavar="ARGS")
+    parser.add_option("-c", "--compare", dest="compare",
+                      help="compare the results against a previous result FILE", metavar="FILE")
+    parser.add_option("-t", "--threshold", dest="threshold", type="float", default=5.0,
+                      help="changes larger than PERCENT count as regressions [default: %default]",
+                      metavar="PERCENT")
+    (options, arguments) = parser.parse_args()
+
+    if len(arguments) > 1:
+        parser.error("too many arguments")
+    root = os.path.abspath(arguments[0] if arguments else os.getcwd())
+
+    benchmarks = findBenchmarks(root)
+    if not benchmarks:
+        print("No benchmarks found below %s" % root, file=sys.stderr)
+        return 1
+
+    rows = []
+    failed = []
+    for name, path in benchmarks:
+        result, passed = runBenchmark(name, path, shlex.split(options.args))
+        rows.extend(result)
+        if not passed:
+            failed.append(name)
+    rows.sort(key=rowKey)
+
+    output = open(options.output, "w") if options.output else sys.stdout
+    try:
+        writer = csv.DictWriter(output, fieldnames=fields, lineterminator="\n")
+        writer.writerow(dict((field, field) for field in fields))
+        writer.writerows(rows)
+    finally:
+        if output is not sys.stdout:
+            output.close()
+
+    regressions = 0
+    if options.compare:
+        regressions = compareResults(readResults(options.compare), rows, options.threshold)
+
+    if failed:
+        print("The following benchmarks failed: %s" % ", ".join(failed), file=sys.stderr)
+
+    return 1 if failed or regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())